@@ -7,9 +7,12 @@
       ],
       "include_dirs": [
         "src",
+        "bindings/c",
       ],
       "sources": [
         "bindings/node/binding.cc",
+        "bindings/c/src/cache.c",
+        "bindings/c/src/stream.c",
         "src/parser.c",
       ],
       "variables": {
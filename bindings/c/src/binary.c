@@ -0,0 +1,322 @@
+#include "tree_sitter/tree-sitter-red-binary.h"
+
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define X86_SIMD
+#include <immintrin.h>
+#endif
+
+typedef enum {
+  LevelScalar,
+  LevelSse2,
+  LevelSsse3,
+} Level;
+
+typedef struct {
+  uint8_t *buffer;
+  uint32_t capacity;
+  uint32_t size;
+} Output;
+
+// The values of base-16 and base-64 digits, and -1 for other bytes.
+static const int8_t hex_values[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+static const int8_t base64_values[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+static Level cpu_level(void) {
+#ifdef X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("ssse3")) {
+    return LevelSsse3;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return LevelSse2;
+  }
+#endif
+  return LevelScalar;
+}
+
+static bool put(Output *output, uint8_t byte) {
+  if (output->size == output->capacity) {
+    return false;
+  }
+  output->buffer[output->size++] = byte;
+  return true;
+}
+
+// Skip whitespace or a comment at `text[*i]`. Returns false if there is
+// neither.
+static bool skip(const char *text, uint32_t end, uint32_t *i) {
+  char c = text[*i];
+  if (c == ';') {
+    const char *newline = memchr(text + *i, '\n', end - *i);
+    *i = newline ? (uint32_t)(newline - text) + 1 : end;
+    return true;
+  }
+  if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+    (*i)++;
+    return true;
+  }
+  return false;
+}
+
+#ifdef X86_SIMD
+
+// Whether a block of digits decoded to 16 bytes fits.
+static bool has_room_for_block(const Output *output) {
+  return output->capacity - output->size >= 16;
+}
+
+// Bytes of `c` from `low` to `high`, for ASCII bounds.
+__attribute__((target("sse2"))) static inline __m128i
+in_range(__m128i c, char low, char high) {
+  return _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8((char)(low - 1))),
+                       _mm_cmplt_epi8(c, _mm_set1_epi8((char)(high + 1))));
+}
+
+// Decode 32 base-16 digits into 16 bytes, or return false if they are not
+// all digits.
+__attribute__((target("sse2"))) static bool base16_block(const char *text,
+                                                         uint8_t *out) {
+  __m128i halves[2];
+  for (int half = 0; half < 2; half++) {
+    __m128i c = _mm_loadu_si128((const __m128i *)(const void *)(text + 16 * half));
+    __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    __m128i digit = in_range(c, '0', '9');
+    __m128i letter = in_range(lower, 'a', 'f');
+    if (_mm_movemask_epi8(_mm_or_si128(digit, letter)) != 0xffff) {
+      return false;
+    }
+    __m128i value = _mm_or_si128(
+        _mm_and_si128(digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+        _mm_andnot_si128(digit,
+                         _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+    // Each 16-bit lane holds the high nibble, then the low one.
+    __m128i bytes =
+        _mm_or_si128(_mm_slli_epi16(value, 4), _mm_srli_epi16(value, 8));
+    halves[half] = _mm_and_si128(bytes, _mm_set1_epi16(0xff));
+  }
+  _mm_storeu_si128((__m128i *)(void *)out,
+                   _mm_packus_epi16(halves[0], halves[1]));
+  return true;
+}
+
+// Decode 16 base-64 digits into 12 bytes, storing 16, or return false if
+// they are not all digits.
+__attribute__((target("ssse3"))) static bool base64_block(const char *text,
+                                                          uint8_t *out) {
+  __m128i c = _mm_loadu_si128((const __m128i *)(const void *)text);
+  __m128i upper = in_range(c, 'A', 'Z');
+  __m128i lower = in_range(c, 'a', 'z');
+  __m128i digit = in_range(c, '0', '9');
+  __m128i plus = _mm_cmpeq_epi8(c, _mm_set1_epi8('+'));
+  __m128i slash = _mm_cmpeq_epi8(c, _mm_set1_epi8('/'));
+  __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower),
+                               _mm_or_si128(digit, _mm_or_si128(plus, slash)));
+  if (_mm_movemask_epi8(valid) != 0xffff) {
+    return false;
+  }
+  // What to add to each character to get its value.
+  __m128i shift = _mm_or_si128(
+      _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                   _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+      _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+                   _mm_or_si128(_mm_and_si128(plus, _mm_set1_epi8(62 - '+')),
+                                _mm_and_si128(slash, _mm_set1_epi8(63 - '/')))));
+  __m128i value = _mm_add_epi8(c, shift);
+  // Four 6-bit values make 24 bits in each 32-bit lane, whose three low
+  // bytes are then stored in big-endian order.
+  __m128i pairs = _mm_maddubs_epi16(value, _mm_set1_epi32(0x01400140));
+  __m128i quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+  __m128i bytes = _mm_shuffle_epi8(
+      quads, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1,
+                           -1));
+  _mm_storeu_si128((__m128i *)(void *)out, bytes);
+  return true;
+}
+
+#endif
+
+static bool decode_base2(const char *text, uint32_t i, uint32_t end,
+                         Output *output) {
+  uint32_t bits = 0;
+  uint8_t byte = 0;
+  while (i < end) {
+    char c = text[i];
+    if (c == '0' || c == '1') {
+      byte = (uint8_t)(byte << 1 | (c - '0'));
+      i++;
+      if (++bits % 8 == 0 && !put(output, byte)) {
+        return false;
+      }
+    } else if (!skip(text, end, &i)) {
+      return false;
+    }
+  }
+  return bits % 8 == 0;
+}
+
+static bool decode_base16(const char *text, uint32_t i, uint32_t end,
+                          Level level, Output *output) {
+  uint32_t nibbles = 0;
+  uint8_t byte = 0;
+#ifdef X86_SIMD
+  // Blocks start at digits. After a block that was not all digits, go on a
+  // digit at a time for as long as the block.
+  uint32_t scalar_until = 0;
+#else
+  (void)level;
+#endif
+  while (i < end) {
+    int8_t value = hex_values[(uint8_t)text[i]];
+    if (value < 0) {
+      if (!skip(text, end, &i)) {
+        return false;
+      }
+      continue;
+    }
+#ifdef X86_SIMD
+    if (level != LevelScalar && nibbles % 2 == 0 && i >= scalar_until &&
+        end - i >= 32 && has_room_for_block(output)) {
+      if (base16_block(text + i, output->buffer + output->size)) {
+        i += 32;
+        output->size += 16;
+        continue;
+      }
+      scalar_until = i + 32;
+    }
+#endif
+    byte = (uint8_t)(byte << 4 | value);
+    i++;
+    if (++nibbles % 2 == 0 && !put(output, byte)) {
+      return false;
+    }
+  }
+  return nibbles % 2 == 0;
+}
+
+static bool decode_base64(const char *text, uint32_t i, uint32_t end,
+                          Level level, Output *output) {
+  uint32_t bits = 0, digits = 0, padding = 0;
+#ifdef X86_SIMD
+  uint32_t scalar_until = 0;
+#else
+  (void)level;
+#endif
+  while (i < end) {
+    char c = text[i];
+    int8_t value = base64_values[(uint8_t)c];
+    if (value >= 0 && padding == 0) {
+#ifdef X86_SIMD
+      if (level == LevelSsse3 && digits % 4 == 0 && i >= scalar_until &&
+          end - i >= 16 && has_room_for_block(output)) {
+        if (base64_block(text + i, output->buffer + output->size)) {
+          i += 16;
+          output->size += 12;
+          continue;
+        }
+        scalar_until = i + 16;
+      }
+#endif
+      bits = bits << 6 | (uint32_t)value;
+      i++;
+      if (++digits % 4 == 0 &&
+          !(put(output, (uint8_t)(bits >> 16)) &&
+            put(output, (uint8_t)(bits >> 8)) && put(output, (uint8_t)bits))) {
+        return false;
+      }
+    } else if (c == '=' && padding < 2) {
+      padding++;
+      i++;
+    } else if (!skip(text, end, &i)) {
+      return false;
+    }
+  }
+
+  // The last two or three digits make one or two bytes, with or without
+  // padding.
+  uint32_t rest = digits % 4;
+  if (rest == 1 || (rest == 0 && padding > 0) || rest + padding > 4) {
+    return false;
+  }
+  if (rest == 2) {
+    return put(output, (uint8_t)(bits >> 4));
+  }
+  if (rest == 3) {
+    return put(output, (uint8_t)(bits >> 10)) &&
+           put(output, (uint8_t)(bits >> 2));
+  }
+  return true;
+}
+
+bool tree_sitter_red_binary_decode(const char *text, uint32_t length,
+                                   uint8_t *buffer, uint32_t capacity,
+                                   uint32_t *size) {
+  uint32_t start;
+  if (length >= 3 && memcmp(text, "#{", 2) == 0) {
+    start = 2;
+  } else if (length >= 4 && memcmp(text, "2#{", 3) == 0) {
+    start = 3;
+  } else if (length >= 5 && (memcmp(text, "16#{", 4) == 0 ||
+                             memcmp(text, "64#{", 4) == 0)) {
+    start = 4;
+  } else {
+    return false;
+  }
+  if (text[length - 1] != '}') {
+    return false;
+  }
+
+  Output output = {buffer, capacity, 0};
+  uint32_t end = length - 1;
+  bool decoded;
+  if (start == 3) {
+    decoded = decode_base2(text, start, end, &output);
+  } else if (text[0] == '6') {
+    decoded = decode_base64(text, start, end, cpu_level(), &output);
+  } else {
+    decoded = decode_base16(text, start, end, cpu_level(), &output);
+  }
+  *size = output.size;
+  return decoded;
+}
+
+const char *tree_sitter_red_binary_implementation(void) {
+  static const char *const names[] = {"scalar", "sse2", "ssse3"};
+  return names[cpu_level()];
+}
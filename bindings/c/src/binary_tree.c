@@ -0,0 +1,14 @@
+#include "tree_sitter/tree-sitter-red-binary.h"
+#include "tree_sitter/tree-sitter-red-symbols.h"
+
+#include <tree_sitter/api.h>
+
+bool tree_sitter_red_binary_from_node(TSNode node, const char *source,
+                                      uint8_t *buffer, uint32_t capacity,
+                                      uint32_t *size) {
+  uint32_t start = ts_node_start_byte(node);
+  return ts_node_symbol(node) == TSRedSymbolBinary &&
+         tree_sitter_red_binary_decode(source + start,
+                                       ts_node_end_byte(node) - start, buffer,
+                                       capacity, size);
+}
@@ -0,0 +1,624 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-red-cache.h"
+#include "tree_sitter/tree-sitter-red-symbols.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static uint64_t get_u32(const uint8_t *p) {
+  return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) |
+         ((uint64_t)p[3] << 24);
+}
+
+static uint64_t get_u64(const uint8_t *p) {
+  return get_u32(p) | (get_u32(p + 4) << 32);
+}
+
+// The full 128-bit product of `a` and `b`, low half in `a`.
+static void multiply(uint64_t *a, uint64_t *b) {
+#ifdef __SIZEOF_INT128__
+  __extension__ typedef unsigned __int128 uint128;
+  uint128 product = (uint128)*a * *b;
+  *a = (uint64_t)product;
+  *b = (uint64_t)(product >> 64);
+#else
+  uint64_t ha = *a >> 32, hb = *b >> 32;
+  uint64_t la = (uint32_t)*a, lb = (uint32_t)*b;
+  uint64_t high = ha * hb, middle0 = ha * lb, middle1 = hb * la, low = la * lb;
+  uint64_t t = low + (middle0 << 32), carry = t < low;
+  uint64_t lo = t + (middle1 << 32);
+  carry += lo < t;
+  *a = lo;
+  *b = high + (middle0 >> 32) + (middle1 >> 32) + carry;
+#endif
+}
+
+static uint64_t mix(uint64_t a, uint64_t b) {
+  multiply(&a, &b);
+  return a ^ b;
+}
+
+// wyhash by Wang Yi (public domain), reading input as little-endian so that
+// hashes, and with them cache files, are the same on every host.
+uint64_t tree_sitter_red_hash(const void *data, size_t length, uint64_t seed) {
+  static const uint64_t P0 = 0xa0761d6478bd642full;
+  static const uint64_t P1 = 0xe7037ed1a0b428dbull;
+  static const uint64_t P2 = 0x8ebc6af09c88c6e3ull;
+  static const uint64_t P3 = 0x589965cc75374cc3ull;
+  const uint8_t *p = data;
+  uint64_t a, b;
+
+  seed ^= mix(seed ^ P0, P1);
+  if (length <= 16) {
+    if (length >= 4) {
+      size_t shift = (length >> 3) << 2;
+      a = (get_u32(p) << 32) | get_u32(p + shift);
+      b = (get_u32(p + length - 4) << 32) | get_u32(p + length - 4 - shift);
+    } else if (length > 0) {
+      a = ((uint64_t)p[0] << 16) | ((uint64_t)p[length >> 1] << 8) |
+          p[length - 1];
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    size_t i = length;
+    if (i > 48) {
+      uint64_t see1 = seed, see2 = seed;
+      do {
+        seed = mix(get_u64(p) ^ P1, get_u64(p + 8) ^ seed);
+        see1 = mix(get_u64(p + 16) ^ P2, get_u64(p + 24) ^ see1);
+        see2 = mix(get_u64(p + 32) ^ P3, get_u64(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = mix(get_u64(p) ^ P1, get_u64(p + 8) ^ seed);
+      p += 16;
+      i -= 16;
+    }
+    a = get_u64(p + i - 16);
+    b = get_u64(p + i - 8);
+  }
+
+  a ^= P1;
+  b ^= seed;
+  multiply(&a, &b);
+  return mix(a ^ P0 ^ length, b ^ P1);
+}
+
+#ifndef _WIN32
+
+// A record is a little-endian header followed by the value:
+//
+//   offset  size  field
+//        0     4  magic, "RDC1"
+//        4     1  record type
+//        5     3  zero
+//        8     8  content hash
+//       16     8  grammar fingerprint
+//       24     4  kind
+//       28     4  value length, zero for a touch
+//       32     8  checksum of the value
+#define STORE_NAME "entries.rdc"
+#define RECORD_HEADER_SIZE 40
+#define SCAN_WINDOW (64 * 1024)
+
+static const uint8_t MAGIC[4] = {'R', 'D', 'C', '1'};
+
+enum {
+  RecordPut = 1,
+  RecordTouch = 2,
+};
+
+typedef struct {
+  uint64_t hash;
+  // Where the value starts in the store; zero marks an empty slot.
+  uint64_t offset;
+  uint64_t checksum;
+  // When the entry was last written or read; larger is more recent.
+  uint64_t tick;
+  uint32_t kind;
+  uint32_t length;
+} Entry;
+
+struct TSRedCache {
+  char *path;
+  int fd;
+  dev_t device;
+  ino_t inode;
+  uint64_t size_limit;
+  // The end of the last record indexed.
+  uint64_t scanned;
+  uint64_t clock;
+  // An open-addressed table of the entries of the current grammar.
+  Entry *entries;
+  size_t entry_count;
+  size_t capacity;
+};
+
+static void put_u32(uint8_t *p, uint32_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+  p[2] = (uint8_t)(value >> 16);
+  p[3] = (uint8_t)(value >> 24);
+}
+
+static void put_u64(uint8_t *p, uint64_t value) {
+  put_u32(p, (uint32_t)value);
+  put_u32(p + 4, (uint32_t)(value >> 32));
+}
+
+static uint64_t checksum(const void *value, size_t length, uint64_t hash,
+                         uint32_t kind) {
+  return tree_sitter_red_hash(value, length, hash ^ kind);
+}
+
+static void write_header(uint8_t *header, uint8_t type, uint64_t hash,
+                         uint32_t kind, uint32_t length, uint64_t sum) {
+  memcpy(header, MAGIC, sizeof(MAGIC));
+  header[4] = type;
+  header[5] = header[6] = header[7] = 0;
+  put_u64(header + 8, hash);
+  put_u64(header + 16, TREE_SITTER_RED_GRAMMAR_FINGERPRINT);
+  put_u32(header + 24, kind);
+  put_u32(header + 28, length);
+  put_u64(header + 32, sum);
+}
+
+static bool valid_header(const uint8_t *header) {
+  if (memcmp(header, MAGIC, sizeof(MAGIC)) != 0 || header[5] || header[6] ||
+      header[7]) {
+    return false;
+  }
+  return header[4] == RecordPut ||
+         (header[4] == RecordTouch && get_u32(header + 28) == 0);
+}
+
+static Entry *find(const TSRedCache *cache, uint64_t hash, uint32_t kind) {
+  size_t mask = cache->capacity - 1;
+  for (size_t i = (size_t)(hash ^ kind) & mask;; i = (i + 1) & mask) {
+    Entry *entry = &cache->entries[i];
+    if (!entry->offset || (entry->hash == hash && entry->kind == kind)) {
+      return entry;
+    }
+  }
+}
+
+static bool grow(TSRedCache *cache) {
+  if ((cache->entry_count + 1) * 4 <= cache->capacity * 3) {
+    return true;
+  }
+  Entry *old = cache->entries;
+  size_t old_capacity = cache->capacity;
+  cache->entries = calloc(old_capacity * 2, sizeof(Entry));
+  if (!cache->entries) {
+    cache->entries = old;
+    return false;
+  }
+  cache->capacity = old_capacity * 2;
+  for (size_t i = 0; i < old_capacity; i++) {
+    if (old[i].offset) {
+      *find(cache, old[i].hash, old[i].kind) = old[i];
+    }
+  }
+  free(old);
+  return true;
+}
+
+static bool index_record(TSRedCache *cache, const uint8_t *header,
+                         uint64_t offset) {
+  if (get_u64(header + 16) != TREE_SITTER_RED_GRAMMAR_FINGERPRINT) {
+    return true;
+  }
+  uint64_t hash = get_u64(header + 8);
+  uint32_t kind = (uint32_t)get_u32(header + 24);
+  if (header[4] == RecordTouch) {
+    Entry *entry = find(cache, hash, kind);
+    if (entry->offset) {
+      entry->tick = ++cache->clock;
+    }
+    return true;
+  }
+
+  if (!grow(cache)) {
+    return false;
+  }
+  Entry *entry = find(cache, hash, kind);
+  if (!entry->offset) {
+    cache->entry_count++;
+  }
+  entry->hash = hash;
+  entry->kind = kind;
+  entry->offset = offset;
+  entry->length = (uint32_t)get_u32(header + 28);
+  entry->checksum = get_u64(header + 32);
+  entry->tick = ++cache->clock;
+  return true;
+}
+
+static bool read_all(int fd, uint8_t *data, size_t size, uint64_t offset) {
+  while (size > 0) {
+    ssize_t n = pread(fd, data, size, (off_t)offset);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    size -= (size_t)n;
+    offset += (uint64_t)n;
+  }
+  return true;
+}
+
+// Whether `value` is the value of the record with `header`.
+static bool intact(const uint8_t *header, const uint8_t *value) {
+  return header[4] != RecordPut ||
+         checksum(value, get_u32(header + 28), get_u64(header + 8),
+                  (uint32_t)get_u32(header + 24)) == get_u64(header + 32);
+}
+
+// Index the records appended since the last scan. Bytes that do not start a
+// record are skipped one at a time until one does, and so is a put whose
+// value does not match its checksum.
+//
+// A put that runs past the end of the store is either still being written
+// or was torn, by a writer that crashed or ran out of space, and its length
+// then covers records appended after it. The scan goes on past it: if an
+// intact record follows, the put was torn and is dropped; otherwise the
+// next scan starts from it again.
+static bool scan(TSRedCache *cache) {
+  struct stat st;
+  if (fstat(cache->fd, &st) != 0) {
+    return false;
+  }
+  uint64_t end = (uint64_t)st.st_size;
+  if (end < cache->scanned + RECORD_HEADER_SIZE) {
+    return true;
+  }
+  uint8_t *window = malloc(SCAN_WINDOW);
+  if (!window) {
+    return false;
+  }
+
+  bool ok = true;
+  uint64_t pos = cache->scanned, window_start = 0, pending = UINT64_MAX;
+  size_t window_size = 0, buffer_size = 0;
+  // Values that reach past the window.
+  uint8_t *buffer = NULL;
+  while (end - pos >= RECORD_HEADER_SIZE) {
+    if (pos < window_start ||
+        pos + RECORD_HEADER_SIZE > window_start + window_size) {
+      ssize_t n = pread(cache->fd, window, SCAN_WINDOW, (off_t)pos);
+      if (n < RECORD_HEADER_SIZE) {
+        break;
+      }
+      window_start = pos;
+      window_size = (size_t)n;
+    }
+    const uint8_t *header = window + (pos - window_start);
+    if (!valid_header(header)) {
+      pos++;
+      continue;
+    }
+    uint64_t length = get_u32(header + 28);
+    if (end - pos - RECORD_HEADER_SIZE < length) {
+      pending = pending < pos ? pending : pos;
+      pos++;
+      continue;
+    }
+    const uint8_t *value = header + RECORD_HEADER_SIZE;
+    if (pos + RECORD_HEADER_SIZE + length > window_start + window_size) {
+      uint8_t *grown = length > buffer_size ? realloc(buffer, length) : buffer;
+      if (!grown) {
+        ok = false;
+        break;
+      }
+      buffer = grown;
+      buffer_size = length > buffer_size ? length : buffer_size;
+      if (!read_all(cache->fd, buffer, length, pos + RECORD_HEADER_SIZE)) {
+        ok = false;
+        break;
+      }
+      value = buffer;
+    }
+    if (!intact(header, value)) {
+      pos++;
+      continue;
+    }
+    if (!index_record(cache, header, pos + RECORD_HEADER_SIZE)) {
+      ok = false;
+      break;
+    }
+    pos += RECORD_HEADER_SIZE + length;
+    pending = UINT64_MAX;
+  }
+  cache->scanned = pending < pos ? pending : pos;
+  free(buffer);
+  free(window);
+  return ok;
+}
+
+// (Re)open the store at its path and index it from the start.
+static bool reopen(TSRedCache *cache) {
+  int fd = open(cache->path, O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0666);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return false;
+  }
+  if (cache->fd >= 0) {
+    close(cache->fd);
+  }
+  cache->fd = fd;
+  cache->device = st.st_dev;
+  cache->inode = st.st_ino;
+  cache->scanned = 0;
+  cache->entry_count = 0;
+  memset(cache->entries, 0, cache->capacity * sizeof(Entry));
+  return scan(cache);
+}
+
+// Catch up with other processes: follow a compaction that replaced the store,
+// or index what they appended.
+static bool refresh(TSRedCache *cache) {
+  struct stat st;
+  if (stat(cache->path, &st) == 0 &&
+      (st.st_dev != cache->device || st.st_ino != cache->inode)) {
+    return reopen(cache);
+  }
+  return scan(cache);
+}
+
+// Append a whole record with a single write, so that records appended
+// concurrently by other processes never interleave with it.
+static bool append(int fd, const uint8_t *record, size_t size) {
+  ssize_t n;
+  do {
+    n = write(fd, record, size);
+  } while (n < 0 && errno == EINTR);
+  return n == (ssize_t)size;
+}
+
+static bool write_all(int fd, const uint8_t *data, size_t size) {
+  while (size > 0) {
+    ssize_t n = write(fd, data, size);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    size -= (size_t)n;
+  }
+  return true;
+}
+
+TSRedCache *tree_sitter_red_cache_open(const char *directory,
+                                       uint64_t size_limit) {
+  if (mkdir(directory, 0777) != 0 && errno != EEXIST) {
+    return NULL;
+  }
+  TSRedCache *cache = calloc(1, sizeof(TSRedCache));
+  if (!cache) {
+    return NULL;
+  }
+  cache->fd = -1;
+  cache->size_limit =
+      size_limit ? size_limit : TREE_SITTER_RED_CACHE_DEFAULT_LIMIT;
+  size_t length = strlen(directory);
+  cache->path = malloc(length + sizeof("/" STORE_NAME));
+  cache->capacity = 256;
+  cache->entries = calloc(cache->capacity, sizeof(Entry));
+  if (!cache->path || !cache->entries) {
+    tree_sitter_red_cache_close(cache);
+    return NULL;
+  }
+  memcpy(cache->path, directory, length);
+  memcpy(cache->path + length, "/" STORE_NAME, sizeof("/" STORE_NAME));
+  if (!reopen(cache)) {
+    tree_sitter_red_cache_close(cache);
+    return NULL;
+  }
+  return cache;
+}
+
+void tree_sitter_red_cache_close(TSRedCache *cache) {
+  if (!cache) {
+    return;
+  }
+  if (cache->fd >= 0) {
+    close(cache->fd);
+  }
+  free(cache->path);
+  free(cache->entries);
+  free(cache);
+}
+
+bool tree_sitter_red_cache_get(TSRedCache *cache, uint64_t hash, uint32_t kind,
+                               uint8_t **value, size_t *length) {
+  // Two cheap system calls when nothing changed, and the freshest value for
+  // the key when another process replaced it.
+  if (!refresh(cache)) {
+    return false;
+  }
+  Entry *entry = find(cache, hash, kind);
+  if (!entry->offset) {
+    return false;
+  }
+
+  uint8_t *data = malloc(entry->length ? entry->length : 1);
+  if (!data || !read_all(cache->fd, data, entry->length, entry->offset) ||
+      checksum(data, entry->length, hash, kind) != entry->checksum) {
+    free(data);
+    return false;
+  }
+
+  uint8_t touch[RECORD_HEADER_SIZE];
+  write_header(touch, RecordTouch, hash, kind, 0, 0);
+  append(cache->fd, touch, sizeof(touch));
+  entry->tick = ++cache->clock;
+  *value = data;
+  *length = entry->length;
+
+  // Touches grow the store too, so a run that only reads must compact it as
+  // well. The scan above ended at the store's end, before this touch. A
+  // failed compaction costs only space; the value is read already.
+  if (cache->scanned + sizeof(touch) > cache->size_limit) {
+    tree_sitter_red_cache_compact(cache);
+  }
+  return true;
+}
+
+bool tree_sitter_red_cache_put(TSRedCache *cache, uint64_t hash, uint32_t kind,
+                               const void *value, size_t length) {
+  if (length > UINT32_MAX || length > cache->size_limit / 2) {
+    return false;
+  }
+  uint8_t *record = malloc(RECORD_HEADER_SIZE + length);
+  if (!record) {
+    return false;
+  }
+  write_header(record, RecordPut, hash, kind, (uint32_t)length,
+               checksum(value, length, hash, kind));
+  if (length > 0) {
+    memcpy(record + RECORD_HEADER_SIZE, value, length);
+  }
+  bool ok = append(cache->fd, record, RECORD_HEADER_SIZE + length);
+  free(record);
+  if (!ok || !refresh(cache)) {
+    return false;
+  }
+  if (cache->scanned > cache->size_limit) {
+    return tree_sitter_red_cache_compact(cache);
+  }
+  return true;
+}
+
+static int compare_recency(const void *a, const void *b) {
+  uint64_t ta = (*(const Entry *const *)a)->tick;
+  uint64_t tb = (*(const Entry *const *)b)->tick;
+  return ta < tb ? 1 : ta > tb ? -1 : 0;
+}
+
+bool tree_sitter_red_cache_compact(TSRedCache *cache) {
+  if (!refresh(cache)) {
+    return false;
+  }
+
+  Entry **order = malloc((cache->entry_count + 1) * sizeof(Entry *));
+  size_t temp_size = strlen(cache->path) + 32;
+  char *temp = malloc(temp_size);
+  if (!order || !temp) {
+    free(order);
+    free(temp);
+    return false;
+  }
+  size_t count = 0;
+  for (size_t i = 0; i < cache->capacity; i++) {
+    if (cache->entries[i].offset) {
+      order[count++] = &cache->entries[i];
+    }
+  }
+  qsort(order, count, sizeof(Entry *), compare_recency);
+  size_t keep = 0;
+  uint64_t size = 0;
+  while (keep < count &&
+         size + RECORD_HEADER_SIZE + order[keep]->length <=
+             cache->size_limit / 2) {
+    size += RECORD_HEADER_SIZE + order[keep]->length;
+    keep++;
+  }
+
+  snprintf(temp, temp_size, "%s.%ld.tmp", cache->path, (long)getpid());
+  int fd = open(temp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+  bool ok = fd >= 0;
+  uint8_t *record = NULL;
+  // Oldest first, so that indexing the new store restores the same order.
+  for (size_t i = keep; ok && i-- > 0;) {
+    const Entry *entry = order[i];
+    uint8_t *grown = realloc(record, RECORD_HEADER_SIZE + entry->length + 1);
+    if (!grown) {
+      ok = false;
+      break;
+    }
+    record = grown;
+    uint8_t *value = record + RECORD_HEADER_SIZE;
+    if (!read_all(cache->fd, value, entry->length, entry->offset) ||
+        checksum(value, entry->length, entry->hash, entry->kind) !=
+            entry->checksum) {
+      continue;
+    }
+    write_header(record, RecordPut, entry->hash, entry->kind, entry->length,
+                 entry->checksum);
+    ok = write_all(fd, record, RECORD_HEADER_SIZE + entry->length);
+  }
+  free(record);
+  free(order);
+  if (fd >= 0 && close(fd) != 0) {
+    ok = false;
+  }
+  if (ok && rename(temp, cache->path) != 0) {
+    ok = false;
+  }
+  if (!ok && fd >= 0) {
+    unlink(temp);
+  }
+  free(temp);
+  return ok && reopen(cache);
+}
+
+#else
+
+TSRedCache *tree_sitter_red_cache_open(const char *directory,
+                                       uint64_t size_limit) {
+  (void)directory;
+  (void)size_limit;
+  return NULL;
+}
+
+void tree_sitter_red_cache_close(TSRedCache *cache) { (void)cache; }
+
+bool tree_sitter_red_cache_get(TSRedCache *cache, uint64_t hash, uint32_t kind,
+                               uint8_t **value, size_t *length) {
+  (void)cache;
+  (void)hash;
+  (void)kind;
+  (void)value;
+  (void)length;
+  return false;
+}
+
+bool tree_sitter_red_cache_put(TSRedCache *cache, uint64_t hash, uint32_t kind,
+                               const void *value, size_t length) {
+  (void)cache;
+  (void)hash;
+  (void)kind;
+  (void)value;
+  (void)length;
+  return false;
+}
+
+bool tree_sitter_red_cache_compact(TSRedCache *cache) {
+  (void)cache;
+  return false;
+}
+
+#endif
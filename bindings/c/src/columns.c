@@ -0,0 +1,428 @@
+#include "tree_sitter/tree-sitter-red-columns.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum {
+  PushOk,
+  PushInvalid,
+  PushOutOfMemory,
+} PushResult;
+
+static bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+static int hex_digit(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+}
+
+// Dotted decimal bytes, as in tuples and IPv4 addresses: up to `max` of
+// them, each of 1 to 3 digits.
+static bool decode_bytes(const char *text, uint32_t length, uint8_t *bytes,
+                         uint8_t max, uint8_t *count) {
+  uint32_t i = 0;
+  *count = 0;
+  for (;;) {
+    uint32_t value = 0, digits = 0;
+    while (i < length && is_digit(text[i]) && digits < 3) {
+      value = value * 10 + (uint32_t)(text[i++] - '0');
+      digits++;
+    }
+    if (digits == 0 || value > 255 || *count == max) {
+      return false;
+    }
+    bytes[(*count)++] = (uint8_t)value;
+    if (i == length) {
+      return true;
+    }
+    if (text[i++] != '.') {
+      return false;
+    }
+  }
+}
+
+bool tree_sitter_red_tuple_decode(const char *text, uint32_t length,
+                                  uint8_t bytes[12], uint8_t *count) {
+  memset(bytes, 0, 12);
+  return decode_bytes(text, length, bytes, 12, count) && *count >= 3;
+}
+
+// Eight groups of hex digits, or fewer around one `::`, optionally ending
+// in an IPv4 address.
+static bool decode_address(const char *text, uint32_t length,
+                           uint8_t address[16]) {
+  uint16_t groups[8];
+  int count = 0, gap = -1;
+  uint32_t i = 0;
+  if (length >= 2 && text[0] == ':' && text[1] == ':') {
+    gap = 0;
+    i = 2;
+  }
+  while (i < length) {
+    uint32_t end = i;
+    uint32_t value = 0;
+    while (end < length && hex_digit(text[end]) >= 0) {
+      value = value * 16 + (uint32_t)hex_digit(text[end++]);
+    }
+    if (end < length && text[end] == '.') {
+      uint8_t ipv4[4], octets;
+      if (count > 6 || !decode_bytes(text + i, length - i, ipv4, 4, &octets) ||
+          octets != 4) {
+        return false;
+      }
+      groups[count++] = (uint16_t)(ipv4[0] << 8 | ipv4[1]);
+      groups[count++] = (uint16_t)(ipv4[2] << 8 | ipv4[3]);
+      break;
+    }
+    if (end == i || end - i > 4 || count == 8) {
+      return false;
+    }
+    groups[count++] = (uint16_t)value;
+    if (end == length) {
+      break;
+    }
+    // One colon before the next group, or two for the gap.
+    if (text[end] != ':' || end + 1 == length) {
+      return false;
+    }
+    i = end + 1;
+    if (text[i] == ':') {
+      if (gap >= 0) {
+        return false;
+      }
+      gap = count;
+      i++;
+    }
+  }
+  if (gap < 0 ? count != 8 : count > 7) {
+    return false;
+  }
+
+  int zeros = 8 - count;
+  for (int g = 0, from = 0; g < 8; g++) {
+    uint16_t group =
+        gap >= 0 && g >= gap && g < gap + zeros ? 0 : groups[from++];
+    address[2 * g] = (uint8_t)(group >> 8);
+    address[2 * g + 1] = (uint8_t)group;
+  }
+  return true;
+}
+
+bool tree_sitter_red_ipv6_decode(const char *text, uint32_t length,
+                                 TSRedIpv6 *ipv6) {
+  uint32_t end = 0;
+  while (end < length && text[end] != '%' && text[end] != '/') {
+    end++;
+  }
+  if (!decode_address(text, end, ipv6->address)) {
+    return false;
+  }
+  ipv6->zone = NULL;
+  ipv6->zone_length = 0;
+  ipv6->prefix = TREE_SITTER_RED_NO_PREFIX;
+  uint32_t i = end;
+  if (i < length && text[i] == '%') {
+    ipv6->zone = text + ++i;
+    while (i < length && text[i] != '/') {
+      i++;
+    }
+    ipv6->zone_length = (uint32_t)(text + i - ipv6->zone);
+    if (ipv6->zone_length == 0) {
+      return false;
+    }
+  }
+  if (i < length) {
+    uint32_t prefix = 0, digits = 0;
+    for (i++; i < length && is_digit(text[i]) && digits < 3; i++, digits++) {
+      prefix = prefix * 10 + (uint32_t)(text[i] - '0');
+    }
+    if (digits == 0 || i < length || prefix > 128) {
+      return false;
+    }
+    ipv6->prefix = (uint8_t)prefix;
+  }
+  return true;
+}
+
+// The capacity a table needs for `extra` more rows: its own if it has room
+// for them, otherwise the next power of two. Returns false on overflow.
+static bool needed_capacity(uint32_t count, uint32_t capacity, uint32_t extra,
+                            uint32_t *needed) {
+  *needed = capacity;
+  if (extra <= capacity - count) {
+    return true;
+  }
+  uint64_t grown = capacity ? capacity : 64;
+  while (grown - count < extra) {
+    grown *= 2;
+  }
+  *needed = (uint32_t)grown;
+  return grown <= UINT32_MAX;
+}
+
+// Grow `array` to `count` elements, or return false from the caller. The
+// arrays of a table grow one at a time, and the table keeps its old
+// capacity until they all have: an array that grew before another failed to
+// is only larger than it needs to be.
+#define GROW(array, count)                                                     \
+  do {                                                                         \
+    void *grown = realloc((array), (size_t)(count) * sizeof(*(array)));        \
+    if (!grown) {                                                              \
+      return false;                                                            \
+    }                                                                          \
+    (array) = grown;                                                           \
+  } while (0)
+
+// A string column's offsets grow with its table, with one more than its
+// capacity.
+static bool grow_offsets(TSRedStringColumn *column, uint32_t capacity) {
+  bool first = column->offsets == NULL;
+  GROW(column->offsets, capacity + (size_t)1);
+  if (first) {
+    column->offsets[0] = 0;
+  }
+  return true;
+}
+
+static bool reserve_data(TSRedStringColumn *column, uint32_t length) {
+  if (length <= column->capacity - column->size) {
+    return true;
+  }
+  uint64_t capacity = column->capacity ? column->capacity : 4096;
+  while (capacity - column->size < length) {
+    capacity *= 2;
+  }
+  if (capacity > UINT32_MAX) {
+    return false;
+  }
+  GROW(column->data, capacity);
+  column->capacity = (uint32_t)capacity;
+  return true;
+}
+
+// Append a value to a column with `row` values, which must have room for it.
+static void push_data(TSRedStringColumn *column, uint32_t row, const char *text,
+                      uint32_t length) {
+  if (length) {
+    memcpy(column->data + column->size, text, length);
+  }
+  column->size += length;
+  column->offsets[row + 1] = column->size;
+}
+
+static bool reserve_tuples(TSRedTupleColumns *table, uint32_t extra) {
+  uint32_t capacity;
+  if (!needed_capacity(table->count, table->capacity, extra, &capacity)) {
+    return false;
+  }
+  if (capacity != table->capacity) {
+    GROW(table->file, capacity);
+    GROW(table->start_byte, capacity);
+    GROW(table->bytes, 12 * (size_t)capacity);
+    GROW(table->length, capacity);
+    table->capacity = capacity;
+  }
+  return true;
+}
+
+static bool reserve_ipv6(TSRedIpv6Columns *table, uint32_t extra,
+                         uint32_t zone_length) {
+  uint32_t capacity;
+  if (!needed_capacity(table->count, table->capacity, extra, &capacity)) {
+    return false;
+  }
+  if (capacity != table->capacity) {
+    GROW(table->file, capacity);
+    GROW(table->start_byte, capacity);
+    GROW(table->address, 16 * (size_t)capacity);
+    GROW(table->prefix, capacity);
+    if (!grow_offsets(&table->zone, capacity)) {
+      return false;
+    }
+    table->capacity = capacity;
+  }
+  return reserve_data(&table->zone, zone_length);
+}
+
+static bool reserve_text(TSRedTextColumns *table, uint32_t extra,
+                         uint32_t length) {
+  uint32_t capacity;
+  if (!needed_capacity(table->count, table->capacity, extra, &capacity)) {
+    return false;
+  }
+  if (capacity != table->capacity) {
+    GROW(table->file, capacity);
+    GROW(table->start_byte, capacity);
+    GROW(table->head_length, capacity);
+    if (!grow_offsets(&table->text, capacity)) {
+      return false;
+    }
+    table->capacity = capacity;
+  }
+  return reserve_data(&table->text, length);
+}
+
+static PushResult push_text(TSRedTextColumns *table, char separator,
+                            uint32_t file, uint32_t start_byte,
+                            const char *text, uint32_t length) {
+  const char *head = memchr(text, separator, length);
+  if (!head) {
+    return PushInvalid;
+  }
+  if (!reserve_text(table, 1, length)) {
+    return PushOutOfMemory;
+  }
+  uint32_t row = table->count++;
+  table->file[row] = file;
+  table->start_byte[row] = start_byte;
+  table->head_length[row] = (uint32_t)(head - text);
+  push_data(&table->text, row, text, length);
+  return PushOk;
+}
+
+static PushResult push(TSRedLiteralColumns *columns, TSRedSymbol symbol,
+                       uint32_t file, uint32_t start_byte, const char *text,
+                       uint32_t length) {
+  switch (symbol) {
+  case TSRedSymbolTuple: {
+    TSRedTupleColumns *table = &columns->tuples;
+    uint8_t bytes[12], count;
+    if (!tree_sitter_red_tuple_decode(text, length, bytes, &count)) {
+      return PushInvalid;
+    }
+    if (!reserve_tuples(table, 1)) {
+      return PushOutOfMemory;
+    }
+    uint32_t row = table->count++;
+    table->file[row] = file;
+    table->start_byte[row] = start_byte;
+    memcpy(table->bytes + 12 * (size_t)row, bytes, 12);
+    table->length[row] = count;
+    return PushOk;
+  }
+  case TSRedSymbolIpv6: {
+    TSRedIpv6Columns *table = &columns->ipv6;
+    TSRedIpv6 ipv6;
+    if (!tree_sitter_red_ipv6_decode(text, length, &ipv6)) {
+      return PushInvalid;
+    }
+    if (!reserve_ipv6(table, 1, ipv6.zone_length)) {
+      return PushOutOfMemory;
+    }
+    uint32_t row = table->count++;
+    table->file[row] = file;
+    table->start_byte[row] = start_byte;
+    memcpy(table->address + 16 * (size_t)row, ipv6.address, 16);
+    table->prefix[row] = ipv6.prefix;
+    push_data(&table->zone, row, ipv6.zone, ipv6.zone_length);
+    return PushOk;
+  }
+  case TSRedSymbolUrl:
+    return push_text(&columns->urls, ':', file, start_byte, text, length);
+  case TSRedSymbolEmail:
+    return push_text(&columns->emails, '@', file, start_byte, text, length);
+  default:
+    return PushInvalid;
+  }
+}
+
+bool tree_sitter_red_columns_push(TSRedLiteralColumns *columns,
+                                  TSRedSymbol symbol, uint32_t file,
+                                  uint32_t start_byte, const char *text,
+                                  uint32_t length) {
+  return push(columns, symbol, file, start_byte, text, length) !=
+         PushOutOfMemory;
+}
+
+// Append the values of `from`, which has `count` of them, after the `row`
+// values of `to`, which has room for them.
+static void append_data(TSRedStringColumn *to, uint32_t row,
+                        const TSRedStringColumn *from, uint32_t count) {
+  if (count == 0) {
+    return;
+  }
+  memcpy(to->data + to->size, from->data, from->size);
+  for (uint32_t i = 1; i <= count; i++) {
+    to->offsets[row + i] = to->size + from->offsets[i];
+  }
+  to->size += from->size;
+}
+
+// Copy the rows of a column of `from` after those of `to`, with `width`
+// values per row.
+#define APPEND(to, from, column, width)                                        \
+  memcpy((to)->column + (size_t)(to)->count * (width), (from)->column,         \
+         (size_t)(from)->count * (width) * sizeof(*(from)->column))
+
+bool tree_sitter_red_columns_append(TSRedLiteralColumns *to,
+                                    const TSRedLiteralColumns *from) {
+  const TSRedTupleColumns *tuples = &from->tuples;
+  const TSRedIpv6Columns *ipv6 = &from->ipv6;
+  const TSRedTextColumns *urls = &from->urls, *emails = &from->emails;
+  if (!reserve_tuples(&to->tuples, tuples->count) ||
+      !reserve_ipv6(&to->ipv6, ipv6->count, ipv6->zone.size) ||
+      !reserve_text(&to->urls, urls->count, urls->text.size) ||
+      !reserve_text(&to->emails, emails->count, emails->text.size)) {
+    return false;
+  }
+
+  if (tuples->count) {
+    APPEND(&to->tuples, tuples, file, 1);
+    APPEND(&to->tuples, tuples, start_byte, 1);
+    APPEND(&to->tuples, tuples, bytes, 12);
+    APPEND(&to->tuples, tuples, length, 1);
+    to->tuples.count += tuples->count;
+  }
+  if (ipv6->count) {
+    APPEND(&to->ipv6, ipv6, file, 1);
+    APPEND(&to->ipv6, ipv6, start_byte, 1);
+    APPEND(&to->ipv6, ipv6, address, 16);
+    APPEND(&to->ipv6, ipv6, prefix, 1);
+    append_data(&to->ipv6.zone, to->ipv6.count, &ipv6->zone, ipv6->count);
+    to->ipv6.count += ipv6->count;
+  }
+  TSRedTextColumns *text_tables[] = {&to->urls, &to->emails};
+  const TSRedTextColumns *from_tables[] = {urls, emails};
+  for (int t = 0; t < 2; t++) {
+    TSRedTextColumns *table = text_tables[t];
+    const TSRedTextColumns *rows = from_tables[t];
+    if (rows->count) {
+      APPEND(table, rows, file, 1);
+      APPEND(table, rows, start_byte, 1);
+      APPEND(table, rows, head_length, 1);
+      append_data(&table->text, table->count, &rows->text, rows->count);
+      table->count += rows->count;
+    }
+  }
+  return true;
+}
+
+static void delete_data(TSRedStringColumn *column) {
+  free(column->offsets);
+  free(column->data);
+}
+
+void tree_sitter_red_columns_delete(TSRedLiteralColumns *columns) {
+  free(columns->tuples.file);
+  free(columns->tuples.start_byte);
+  free(columns->tuples.bytes);
+  free(columns->tuples.length);
+  free(columns->ipv6.file);
+  free(columns->ipv6.start_byte);
+  free(columns->ipv6.address);
+  free(columns->ipv6.prefix);
+  delete_data(&columns->ipv6.zone);
+  TSRedTextColumns *tables[] = {&columns->urls, &columns->emails};
+  for (int t = 0; t < 2; t++) {
+    free(tables[t]->file);
+    free(tables[t]->start_byte);
+    free(tables[t]->head_length);
+    delete_data(&tables[t]->text);
+  }
+  memset(columns, 0, sizeof(*columns));
+}
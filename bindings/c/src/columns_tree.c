@@ -0,0 +1,154 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "io.h"
+#include "tree_sitter/tree-sitter-red-columns.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <tree_sitter/api.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+static bool is_literal(TSSymbol symbol) {
+  return symbol == TSRedSymbolTuple || symbol == TSRedSymbolIpv6 ||
+         symbol == TSRedSymbolUrl || symbol == TSRedSymbolEmail;
+}
+
+bool tree_sitter_red_columns_extract(const TSTree *tree, const char *source,
+                                     uint32_t file,
+                                     TSRedLiteralColumns *columns) {
+  TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+  bool ok = true;
+  for (;;) {
+    TSNode node = ts_tree_cursor_current_node(&cursor);
+    TSSymbol symbol = ts_node_symbol(node);
+    if (is_literal(symbol)) {
+      uint32_t start = ts_node_start_byte(node);
+      uint32_t length = ts_node_end_byte(node) - start;
+      if (!tree_sitter_red_columns_push(columns, (TSRedSymbol)symbol, file,
+                                        start, source + start, length)) {
+        ok = false;
+        break;
+      }
+    } else if (ts_tree_cursor_goto_first_child(&cursor)) {
+      // The children of literals, such as the address of an ipv6 or a url,
+      // are not literals of their own.
+      continue;
+    }
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        goto done;
+      }
+    }
+  }
+
+done:
+  ts_tree_cursor_delete(&cursor);
+  return ok;
+}
+
+#ifndef _WIN32
+
+typedef struct {
+  const char *const *paths;
+  uint32_t count;
+  // The columns of each file, merged in path order once all are scanned.
+  TSRedLiteralColumns *results;
+  uint32_t next;
+  bool out_of_memory;
+  pthread_mutex_t lock;
+} Scan;
+
+static void *scan_worker(void *payload) {
+  Scan *scan = payload;
+  TSParser *parser = ts_parser_new();
+  if (!parser || !ts_parser_set_language(parser, tree_sitter_red())) {
+    ts_parser_delete(parser);
+    return NULL;
+  }
+  for (;;) {
+    pthread_mutex_lock(&scan->lock);
+    uint32_t i = scan->next++;
+    pthread_mutex_unlock(&scan->lock);
+    if (i >= scan->count) {
+      break;
+    }
+    uint32_t length;
+    char *source = tree_sitter_red_read_file(scan->paths[i], &length);
+    if (!source) {
+      continue;
+    }
+    TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+    if (tree &&
+        !tree_sitter_red_columns_extract(tree, source, i, &scan->results[i])) {
+      pthread_mutex_lock(&scan->lock);
+      scan->out_of_memory = true;
+      pthread_mutex_unlock(&scan->lock);
+    }
+    ts_tree_delete(tree);
+    free(source);
+  }
+  ts_parser_delete(parser);
+  return NULL;
+}
+
+bool tree_sitter_red_columns_scan(const char *const *paths, uint32_t count,
+                                  unsigned threads,
+                                  TSRedLiteralColumns *columns) {
+  Scan scan = {paths, count, NULL, 0, false, PTHREAD_MUTEX_INITIALIZER};
+  pthread_t *workers = NULL;
+  unsigned started = 0;
+  scan.results = calloc(count + 1, sizeof(TSRedLiteralColumns));
+  if (!scan.results) {
+    return false;
+  }
+
+  if (threads == 0) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = online > 0 ? (unsigned)online : 1;
+  }
+  if (threads > count) {
+    threads = count ? count : 1;
+  }
+  workers = malloc(threads * sizeof(pthread_t));
+  while (workers && started < threads &&
+         pthread_create(&workers[started], NULL, scan_worker, &scan) == 0) {
+    started++;
+  }
+  if (started == 0) {
+    // Scan on this thread instead.
+    scan_worker(&scan);
+  }
+  for (unsigned i = 0; i < started; i++) {
+    pthread_join(workers[i], NULL);
+  }
+
+  bool ok = !scan.out_of_memory;
+  for (uint32_t i = 0; i < count; i++) {
+    ok = ok && tree_sitter_red_columns_append(columns, &scan.results[i]);
+    tree_sitter_red_columns_delete(&scan.results[i]);
+  }
+  free(workers);
+  free(scan.results);
+  pthread_mutex_destroy(&scan.lock);
+  return ok;
+}
+
+#else
+
+bool tree_sitter_red_columns_scan(const char *const *paths, uint32_t count,
+                                  unsigned threads,
+                                  TSRedLiteralColumns *columns) {
+  (void)paths;
+  (void)count;
+  (void)threads;
+  (void)columns;
+  return false;
+}
+
+#endif
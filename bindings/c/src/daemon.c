@@ -0,0 +1,304 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-red-daemon.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#define FRAME_HEADER_SIZE 4
+
+static bool reserve(TSRedMessage *message, size_t extra) {
+  if (message->failed) {
+    return false;
+  }
+  if (message->size + extra <= message->capacity) {
+    return true;
+  }
+  size_t capacity = message->capacity ? message->capacity * 2 : 256;
+  while (capacity < message->size + extra) {
+    capacity *= 2;
+  }
+  uint8_t *data = realloc(message->data, capacity);
+  if (!data) {
+    message->failed = true;
+    return false;
+  }
+  message->data = data;
+  message->capacity = capacity;
+  return true;
+}
+
+static void put_u32(uint8_t *p, uint32_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+  p[2] = (uint8_t)(value >> 16);
+  p[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+void tree_sitter_red_message_init(TSRedMessage *message) {
+  memset(message, 0, sizeof(*message));
+  tree_sitter_red_message_reset(message);
+}
+
+void tree_sitter_red_message_reset(TSRedMessage *message) {
+  message->size = 0;
+  message->failed = false;
+  if (reserve(message, FRAME_HEADER_SIZE)) {
+    message->size = FRAME_HEADER_SIZE;
+  }
+}
+
+void tree_sitter_red_message_delete(TSRedMessage *message) {
+  free(message->data);
+  memset(message, 0, sizeof(*message));
+}
+
+void tree_sitter_red_message_put_u8(TSRedMessage *message, uint8_t value) {
+  if (reserve(message, 1)) {
+    message->data[message->size++] = value;
+  }
+}
+
+void tree_sitter_red_message_put_u16(TSRedMessage *message, uint16_t value) {
+  if (reserve(message, 2)) {
+    message->data[message->size++] = (uint8_t)value;
+    message->data[message->size++] = (uint8_t)(value >> 8);
+  }
+}
+
+void tree_sitter_red_message_put_u32(TSRedMessage *message, uint32_t value) {
+  if (reserve(message, 4)) {
+    put_u32(message->data + message->size, value);
+    message->size += 4;
+  }
+}
+
+void tree_sitter_red_message_put_bytes(TSRedMessage *message, const void *data,
+                                       uint32_t length) {
+  tree_sitter_red_message_put_u32(message, length);
+  if (length > 0 && reserve(message, length)) {
+    memcpy(message->data + message->size, data, length);
+    message->size += length;
+  }
+}
+
+TSRedMessageReader tree_sitter_red_message_reader(const TSRedMessage *message) {
+  TSRedMessageReader reader = {NULL, 0, 0, false};
+  if (message->size >= FRAME_HEADER_SIZE) {
+    reader.data = message->data + FRAME_HEADER_SIZE;
+    reader.size = message->size - FRAME_HEADER_SIZE;
+  }
+  return reader;
+}
+
+static const uint8_t *take(TSRedMessageReader *reader, size_t length) {
+  if (reader->failed || reader->size - reader->offset < length) {
+    reader->failed = true;
+    return NULL;
+  }
+  const uint8_t *p = reader->data + reader->offset;
+  reader->offset += length;
+  return p;
+}
+
+uint8_t tree_sitter_red_message_get_u8(TSRedMessageReader *reader) {
+  const uint8_t *p = take(reader, 1);
+  return p ? p[0] : 0;
+}
+
+uint16_t tree_sitter_red_message_get_u16(TSRedMessageReader *reader) {
+  const uint8_t *p = take(reader, 2);
+  return p ? (uint16_t)(p[0] | (p[1] << 8)) : 0;
+}
+
+uint32_t tree_sitter_red_message_get_u32(TSRedMessageReader *reader) {
+  const uint8_t *p = take(reader, 4);
+  return p ? get_u32(p) : 0;
+}
+
+const uint8_t *tree_sitter_red_message_get_bytes(TSRedMessageReader *reader,
+                                                 uint32_t *length) {
+  *length = tree_sitter_red_message_get_u32(reader);
+  const uint8_t *p = take(reader, *length);
+  if (!p) {
+    *length = 0;
+  }
+  return p;
+}
+
+#ifndef _WIN32
+
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+
+// The most a receive reserves ahead of the bytes that have arrived.
+#define RECEIVE_CHUNK (64u << 10)
+
+TSRedTransferStatus tree_sitter_red_message_send_some(int fd,
+                                                      TSRedMessage *message,
+                                                      size_t *sent) {
+  if (*sent == 0) {
+    if (message->failed || message->size < FRAME_HEADER_SIZE ||
+        message->size - FRAME_HEADER_SIZE > TREE_SITTER_RED_DAEMON_MAX_PAYLOAD) {
+      return TSRedTransferFailed;
+    }
+    put_u32(message->data, (uint32_t)(message->size - FRAME_HEADER_SIZE));
+  }
+  while (*sent < message->size) {
+    ssize_t n = send(fd, message->data + *sent, message->size - *sent,
+                     SEND_FLAGS);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return TSRedTransferPending;
+    }
+    if (n <= 0) {
+      return TSRedTransferFailed;
+    }
+    *sent += (size_t)n;
+  }
+  return TSRedTransferDone;
+}
+
+TSRedTransferStatus tree_sitter_red_message_receive_some(int fd,
+                                                         TSRedMessage *message,
+                                                         size_t *received) {
+  for (;;) {
+    size_t wanted;
+    if (*received < FRAME_HEADER_SIZE) {
+      wanted = FRAME_HEADER_SIZE - *received;
+    } else {
+      uint32_t length = get_u32(message->data);
+      if (length > TREE_SITTER_RED_DAEMON_MAX_PAYLOAD) {
+        return TSRedTransferFailed;
+      }
+      wanted = FRAME_HEADER_SIZE + (size_t)length - *received;
+    }
+    message->size = *received;
+    if (wanted == 0) {
+      return TSRedTransferDone;
+    }
+    // Grow with what arrives rather than with the length the frame claims.
+    if (wanted > RECEIVE_CHUNK) {
+      wanted = RECEIVE_CHUNK;
+    }
+    if (!reserve(message, wanted)) {
+      return TSRedTransferFailed;
+    }
+    ssize_t n = recv(fd, message->data + *received, wanted, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return TSRedTransferPending;
+    }
+    if (n <= 0) {
+      return TSRedTransferFailed;
+    }
+    *received += (size_t)n;
+  }
+}
+
+bool tree_sitter_red_message_send(int fd, TSRedMessage *message) {
+  size_t sent = 0;
+  return tree_sitter_red_message_send_some(fd, message, &sent) ==
+         TSRedTransferDone;
+}
+
+bool tree_sitter_red_message_receive(int fd, TSRedMessage *message) {
+  size_t received = 0;
+  tree_sitter_red_message_reset(message);
+  return tree_sitter_red_message_receive_some(fd, message, &received) ==
+         TSRedTransferDone;
+}
+
+int tree_sitter_red_daemon_connect(const char *socket_path) {
+  struct sockaddr_un address;
+  size_t length = strlen(socket_path);
+  if (length >= sizeof(address.sun_path)) {
+    return -1;
+  }
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  memcpy(address.sun_path, socket_path, length + 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return -1;
+  }
+#ifdef SO_NOSIGPIPE
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+  if (connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+bool tree_sitter_red_daemon_call(int fd, TSRedMessage *message) {
+  return tree_sitter_red_message_send(fd, message) &&
+         tree_sitter_red_message_receive(fd, message);
+}
+
+#else
+
+TSRedTransferStatus tree_sitter_red_message_send_some(int fd,
+                                                      TSRedMessage *message,
+                                                      size_t *sent) {
+  (void)fd;
+  (void)message;
+  (void)sent;
+  return TSRedTransferFailed;
+}
+
+TSRedTransferStatus tree_sitter_red_message_receive_some(int fd,
+                                                         TSRedMessage *message,
+                                                         size_t *received) {
+  (void)fd;
+  (void)message;
+  (void)received;
+  return TSRedTransferFailed;
+}
+
+bool tree_sitter_red_message_send(int fd, TSRedMessage *message) {
+  (void)fd;
+  (void)message;
+  return false;
+}
+
+bool tree_sitter_red_message_receive(int fd, TSRedMessage *message) {
+  (void)fd;
+  (void)message;
+  return false;
+}
+
+int tree_sitter_red_daemon_connect(const char *socket_path) {
+  (void)socket_path;
+  return -1;
+}
+
+bool tree_sitter_red_daemon_call(int fd, TSRedMessage *message) {
+  (void)fd;
+  (void)message;
+  return false;
+}
+
+#endif
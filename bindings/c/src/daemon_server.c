@@ -0,0 +1,735 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-red-daemon.h"
+#include "tree_sitter/tree-sitter-red-errors.h"
+#include "tree_sitter/tree-sitter-red-parse.h"
+#include "tree_sitter/tree-sitter-red-query.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <tree_sitter/api.h>
+
+// Open files beyond this are closed, least recently used first.
+#define MAX_FILES 256
+#define MAX_CLIENTS 64
+#define DEFAULT_IDLE_TIMEOUT_MICROS 10000000u
+
+typedef struct {
+  char *name;
+  uint32_t name_length;
+  char *source;
+  uint32_t length;
+  // Where each line of the source starts, to find the points of an edit
+  // without scanning the source.
+  uint32_t *lines;
+  uint32_t line_count;
+  uint32_t line_capacity;
+  TSTree *tree;
+  uint64_t used;
+} File;
+
+struct TSRedDaemon {
+  TSParser *parser;
+  TSQueryCursor *cursor;
+  TSRedQuery *highlights;
+  TSRedQuery *outline;
+  // Capture ids of the outline query, or UINT32_MAX.
+  uint32_t outline_item;
+  uint32_t outline_name;
+  uint32_t outline_context;
+  File files[MAX_FILES];
+  uint32_t file_count;
+  uint64_t clock;
+  uint64_t timeout_micros;
+  uint64_t idle_timeout_micros;
+};
+
+static TSRedQuery *load_query(const char *directory, const char *name) {
+  if (!directory) {
+    return NULL;
+  }
+  size_t length = strlen(directory) + strlen(name) + 2;
+  char *path = malloc(length);
+  if (!path) {
+    return NULL;
+  }
+  snprintf(path, length, "%s/%s", directory, name);
+  TSRedQuery *query = tree_sitter_red_query_load(path);
+  free(path);
+  return query;
+}
+
+static uint32_t capture_id(const TSRedQuery *query, const char *name) {
+  const TSQuery *raw = tree_sitter_red_query_raw(query);
+  uint32_t count = ts_query_capture_count(raw);
+  for (uint32_t id = 0; id < count; id++) {
+    uint32_t length;
+    const char *capture = ts_query_capture_name_for_id(raw, id, &length);
+    if (length == strlen(name) && memcmp(capture, name, length) == 0) {
+      return id;
+    }
+  }
+  return UINT32_MAX;
+}
+
+TSRedDaemon *tree_sitter_red_daemon_new(const char *queries_directory) {
+  TSRedDaemon *self = calloc(1, sizeof(TSRedDaemon));
+  if (!self) {
+    return NULL;
+  }
+  self->idle_timeout_micros = DEFAULT_IDLE_TIMEOUT_MICROS;
+  self->parser = ts_parser_new();
+  self->cursor = ts_query_cursor_new();
+  if (!self->parser || !self->cursor ||
+      !ts_parser_set_language(self->parser, tree_sitter_red())) {
+    tree_sitter_red_daemon_delete(self);
+    return NULL;
+  }
+  self->highlights = load_query(queries_directory, "highlights.scm");
+  self->outline = load_query(queries_directory, "outline.scm");
+  if (self->outline) {
+    self->outline_item = capture_id(self->outline, "item");
+    self->outline_name = capture_id(self->outline, "name");
+    self->outline_context = capture_id(self->outline, "context");
+  }
+  return self;
+}
+
+static void close_file(TSRedDaemon *self, File *file) {
+  free(file->name);
+  free(file->source);
+  free(file->lines);
+  ts_tree_delete(file->tree);
+  *file = self->files[--self->file_count];
+}
+
+void tree_sitter_red_daemon_delete(TSRedDaemon *self) {
+  if (!self) {
+    return;
+  }
+  while (self->file_count > 0) {
+    close_file(self, &self->files[0]);
+  }
+  tree_sitter_red_query_delete(self->highlights);
+  tree_sitter_red_query_delete(self->outline);
+  if (self->cursor) {
+    ts_query_cursor_delete(self->cursor);
+  }
+  if (self->parser) {
+    ts_parser_delete(self->parser);
+  }
+  free(self);
+}
+
+void tree_sitter_red_daemon_set_timeout(TSRedDaemon *self,
+                                        uint64_t timeout_micros) {
+  self->timeout_micros = timeout_micros;
+}
+
+void tree_sitter_red_daemon_set_idle_timeout(TSRedDaemon *self,
+                                             uint64_t timeout_micros) {
+  self->idle_timeout_micros = timeout_micros;
+}
+
+// Parse under the daemon's timeout. A parse that stops is discarded rather
+// than resumed, since the next request may be for another file.
+static TSRedDaemonStatus parse_source(TSRedDaemon *self,
+                                      const TSTree *old_tree,
+                                      const char *source, uint32_t length,
+                                      TSTree **tree) {
+  TSRedParseOptions options = {self->timeout_micros, NULL, 0};
+  TSRedParseResult result;
+  TSRedParseStatus status = tree_sitter_red_parse(
+      self->parser, old_tree, source, length, &options, &result);
+  *tree = result.tree;
+  if (status == TSRedParseTimedOut) {
+    ts_parser_reset(self->parser);
+    return TSRedDaemonTimedOut;
+  }
+  return result.tree ? TSRedDaemonOk : TSRedDaemonParseFailed;
+}
+
+static File *find_file(TSRedDaemon *self, const uint8_t *name,
+                       uint32_t length) {
+  for (uint32_t i = 0; i < self->file_count; i++) {
+    File *file = &self->files[i];
+    if (file->name_length == length && memcmp(file->name, name, length) == 0) {
+      file->used = ++self->clock;
+      return file;
+    }
+  }
+  return NULL;
+}
+
+// Find or add the file called `name`, closing the least recently used one
+// when all slots are taken.
+static File *open_file(TSRedDaemon *self, const uint8_t *name,
+                       uint32_t length) {
+  File *file = find_file(self, name, length);
+  if (file) {
+    return file;
+  }
+  if (self->file_count == MAX_FILES) {
+    File *oldest = &self->files[0];
+    for (uint32_t i = 1; i < self->file_count; i++) {
+      if (self->files[i].used < oldest->used) {
+        oldest = &self->files[i];
+      }
+    }
+    close_file(self, oldest);
+  }
+  char *copy = malloc(length + 1);
+  if (!copy) {
+    return NULL;
+  }
+  memcpy(copy, name, length);
+  copy[length] = '\0';
+  file = &self->files[self->file_count++];
+  memset(file, 0, sizeof(*file));
+  file->name = copy;
+  file->name_length = length;
+  file->used = ++self->clock;
+  return file;
+}
+
+static void patch_u32(TSRedMessage *message, size_t offset, uint32_t value) {
+  if (!message->failed) {
+    message->data[offset] = (uint8_t)value;
+    message->data[offset + 1] = (uint8_t)(value >> 8);
+    message->data[offset + 2] = (uint8_t)(value >> 16);
+    message->data[offset + 3] = (uint8_t)(value >> 24);
+  }
+}
+
+static void put_node(TSRedMessage *response, TSNode node) {
+  TSPoint start = ts_node_start_point(node);
+  tree_sitter_red_message_put_u32(response, ts_node_start_byte(node));
+  tree_sitter_red_message_put_u32(response, ts_node_end_byte(node));
+  tree_sitter_red_message_put_u32(response, start.row);
+  tree_sitter_red_message_put_u32(response, start.column);
+}
+
+static void put_text(TSRedMessage *response, const File *file, TSNode node) {
+  uint32_t start = ts_node_start_byte(node);
+  tree_sitter_red_message_put_bytes(response, file->source + start,
+                                    ts_node_end_byte(node) - start);
+}
+
+static uint32_t count_lines(const void *text, uint32_t length) {
+  uint32_t count = 0;
+  for (const char *p = text, *end = p + length;
+       (p = memchr(p, '\n', (size_t)(end - p))); p++) {
+    count++;
+  }
+  return count;
+}
+
+// Store where each line after a newline in `text` starts, for `text` at
+// `offset` in the source.
+static void put_lines(uint32_t *lines, uint32_t offset, const void *text,
+                      uint32_t length) {
+  const char *start = text, *end = start + length;
+  for (const char *p = start; (p = memchr(p, '\n', (size_t)(end - p))); p++) {
+    *lines++ = offset + (uint32_t)(p - start) + 1;
+  }
+}
+
+static TSRedDaemonStatus parse(TSRedDaemon *self, TSRedMessageReader *request,
+                               TSRedMessage *response) {
+  uint32_t name_length, length;
+  const uint8_t *name = tree_sitter_red_message_get_bytes(request, &name_length);
+  const uint8_t *source = tree_sitter_red_message_get_bytes(request, &length);
+  if (request->failed) {
+    return TSRedDaemonBadRequest;
+  }
+
+  char *copy = malloc(length + 1);
+  uint32_t line_count = 1 + count_lines(source, length);
+  uint32_t *lines = malloc(line_count * sizeof(uint32_t));
+  if (!copy || !lines) {
+    free(copy);
+    free(lines);
+    return TSRedDaemonOutOfMemory;
+  }
+  if (length > 0) {
+    memcpy(copy, source, length);
+  }
+  copy[length] = '\0';
+  lines[0] = 0;
+  put_lines(lines + 1, 0, copy, length);
+  TSTree *tree;
+  TSRedDaemonStatus status = parse_source(self, NULL, copy, length, &tree);
+  if (status != TSRedDaemonOk) {
+    free(copy);
+    free(lines);
+    return status;
+  }
+  File *file = open_file(self, name, name_length);
+  if (!file) {
+    free(copy);
+    free(lines);
+    ts_tree_delete(tree);
+    return TSRedDaemonOutOfMemory;
+  }
+  free(file->source);
+  free(file->lines);
+  if (file->tree) {
+    ts_tree_delete(file->tree);
+  }
+  file->source = copy;
+  file->length = length;
+  file->lines = lines;
+  file->line_count = file->line_capacity = line_count;
+  file->tree = tree;
+  tree_sitter_red_message_put_u8(response,
+                                 ts_node_has_error(ts_tree_root_node(tree)));
+  return TSRedDaemonOk;
+}
+
+static TSPoint point_at(const File *file, uint32_t byte) {
+  // The last line that starts at or before `byte`.
+  uint32_t low = 0, high = file->line_count;
+  while (high - low > 1) {
+    uint32_t middle = low + (high - low) / 2;
+    if (file->lines[middle] <= byte) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+  return (TSPoint){low, byte - file->lines[low]};
+}
+
+static TSPoint advance(TSPoint point, const char *text, uint32_t length) {
+  for (uint32_t i = 0; i < length; i++) {
+    if (text[i] == '\n') {
+      point.row++;
+      point.column = 0;
+    } else {
+      point.column++;
+    }
+  }
+  return point;
+}
+
+static TSRedDaemonStatus edit(TSRedDaemon *self, TSRedMessageReader *request,
+                              TSRedMessage *response) {
+  uint32_t name_length, text_length;
+  const uint8_t *name = tree_sitter_red_message_get_bytes(request, &name_length);
+  uint32_t start = tree_sitter_red_message_get_u32(request);
+  uint32_t old_end = tree_sitter_red_message_get_u32(request);
+  const uint8_t *text = tree_sitter_red_message_get_bytes(request, &text_length);
+  if (request->failed) {
+    return TSRedDaemonBadRequest;
+  }
+  File *file = find_file(self, name, name_length);
+  if (!file) {
+    return TSRedDaemonUnknownFile;
+  }
+  if (start > old_end || old_end > file->length ||
+      text_length > UINT32_MAX - 1 - (file->length - (old_end - start))) {
+    return TSRedDaemonBadRequest;
+  }
+
+  uint32_t length = file->length - (old_end - start) + text_length;
+  TSPoint start_point = point_at(file, start);
+  TSPoint old_end_point = point_at(file, old_end);
+  uint32_t added = count_lines(text, text_length);
+  uint32_t line_count =
+      file->line_count - (old_end_point.row - start_point.row) + added;
+  if (line_count > file->line_capacity) {
+    uint32_t capacity = file->line_capacity * 2;
+    capacity = capacity > line_count ? capacity : line_count;
+    uint32_t *lines = realloc(file->lines, capacity * sizeof(uint32_t));
+    if (!lines) {
+      return TSRedDaemonOutOfMemory;
+    }
+    file->lines = lines;
+    file->line_capacity = capacity;
+  }
+  char *source = malloc(length + 1);
+  if (!source) {
+    return TSRedDaemonOutOfMemory;
+  }
+  memcpy(source, file->source, start);
+  if (text_length > 0) {
+    memcpy(source + start, text, text_length);
+  }
+  memcpy(source + start + text_length, file->source + old_end,
+         file->length - old_end);
+  source[length] = '\0';
+
+  TSInputEdit input_edit = {
+      .start_byte = start,
+      .old_end_byte = old_end,
+      .new_end_byte = start + text_length,
+      .start_point = start_point,
+      .old_end_point = old_end_point,
+      .new_end_point = advance(start_point, source + start, text_length),
+  };
+  ts_tree_edit(file->tree, &input_edit);
+  TSTree *tree;
+  TSRedDaemonStatus status =
+      parse_source(self, file->tree, source, length, &tree);
+  if (status != TSRedDaemonOk) {
+    // The old tree was edited already and no longer matches its source.
+    free(source);
+    close_file(self, file);
+    return status;
+  }
+  ts_tree_delete(file->tree);
+  free(file->source);
+  file->tree = tree;
+  file->source = source;
+  file->length = length;
+
+  // Replace the lines that started in the edited bytes with those of the
+  // new text, and move the ones after them.
+  uint32_t *after = file->lines + old_end_point.row + 1;
+  uint32_t moved = file->line_count - old_end_point.row - 1;
+  // Wraps around when the edit shrinks the source, which adds up the same.
+  uint32_t shift = text_length - (old_end - start);
+  memmove(file->lines + start_point.row + 1 + added, after,
+          moved * sizeof(uint32_t));
+  for (uint32_t i = 0; i < moved; i++) {
+    file->lines[start_point.row + 1 + added + i] += shift;
+  }
+  put_lines(file->lines + start_point.row + 1, start, text, text_length);
+  file->line_count = line_count;
+  tree_sitter_red_message_put_u8(response,
+                                 ts_node_has_error(ts_tree_root_node(tree)));
+  return TSRedDaemonOk;
+}
+
+static File *requested_file(TSRedDaemon *self, TSRedMessageReader *request,
+                            TSRedDaemonStatus *status) {
+  uint32_t length;
+  const uint8_t *name = tree_sitter_red_message_get_bytes(request, &length);
+  if (request->failed) {
+    *status = TSRedDaemonBadRequest;
+    return NULL;
+  }
+  File *file = find_file(self, name, length);
+  *status = file ? TSRedDaemonOk : TSRedDaemonUnknownFile;
+  return file;
+}
+
+// Report ERROR and MISSING nodes, visiting only subtrees that contain them.
+static TSRedDaemonStatus diagnostics(TSRedDaemon *self,
+                                     TSRedMessageReader *request,
+                                     TSRedMessage *response) {
+  TSRedDaemonStatus status;
+  File *file = requested_file(self, request, &status);
+  if (!file) {
+    return status;
+  }
+  TSRedErrorList errors = {0};
+  if (!tree_sitter_red_errors_collect(file->tree, &errors)) {
+    tree_sitter_red_errors_delete(&errors);
+    return TSRedDaemonOutOfMemory;
+  }
+  const TSLanguage *language = ts_tree_language(file->tree);
+  tree_sitter_red_message_put_u32(response, errors.count);
+  for (uint32_t i = 0; i < errors.count; i++) {
+    const TSRedError *error = &errors.items[i];
+    bool missing = error->kind == TSRedErrorMissing;
+    const char *symbol =
+        missing ? ts_language_symbol_name(language, error->symbol) : "ERROR";
+    tree_sitter_red_message_put_u8(response, missing);
+    tree_sitter_red_message_put_bytes(response, symbol,
+                                      (uint32_t)strlen(symbol));
+    tree_sitter_red_message_put_u32(response, error->start_byte);
+    tree_sitter_red_message_put_u32(response, error->end_byte);
+    tree_sitter_red_message_put_u32(response, error->row);
+    tree_sitter_red_message_put_u32(response, error->column);
+  }
+  tree_sitter_red_errors_delete(&errors);
+  return TSRedDaemonOk;
+}
+
+static TSRedDaemonStatus outline(TSRedDaemon *self, TSRedMessageReader *request,
+                                 TSRedMessage *response) {
+  TSRedDaemonStatus status;
+  File *file = requested_file(self, request, &status);
+  if (!file) {
+    return status;
+  }
+  if (!self->outline) {
+    return TSRedDaemonNoQuery;
+  }
+  size_t count_offset = response->size;
+  uint32_t count = 0;
+  tree_sitter_red_message_put_u32(response, 0);
+
+  ts_query_cursor_set_byte_range(self->cursor, 0, UINT32_MAX);
+  ts_query_cursor_exec(self->cursor, tree_sitter_red_query_raw(self->outline),
+                       ts_tree_root_node(file->tree));
+  TSQueryMatch match;
+  while (ts_query_cursor_next_match(self->cursor, &match)) {
+    if (!tree_sitter_red_query_satisfies(self->outline, &match, file->source)) {
+      continue;
+    }
+    const TSNode *item = NULL, *name = NULL, *context = NULL;
+    for (uint16_t i = 0; i < match.capture_count; i++) {
+      const TSQueryCapture *capture = &match.captures[i];
+      if (capture->index == self->outline_item) {
+        item = &capture->node;
+      } else if (capture->index == self->outline_name) {
+        name = &capture->node;
+      } else if (capture->index == self->outline_context) {
+        context = &capture->node;
+      }
+    }
+    if (!item) {
+      continue;
+    }
+    put_node(response, *item);
+    if (context) {
+      put_text(response, file, *context);
+    } else {
+      tree_sitter_red_message_put_bytes(response, NULL, 0);
+    }
+    if (name) {
+      put_text(response, file, *name);
+    } else {
+      tree_sitter_red_message_put_bytes(response, NULL, 0);
+    }
+    count++;
+  }
+  patch_u32(response, count_offset, count);
+  return TSRedDaemonOk;
+}
+
+static TSRedDaemonStatus highlights(TSRedDaemon *self,
+                                    TSRedMessageReader *request,
+                                    TSRedMessage *response) {
+  TSRedDaemonStatus status;
+  File *file = requested_file(self, request, &status);
+  uint32_t start = tree_sitter_red_message_get_u32(request);
+  uint32_t end = tree_sitter_red_message_get_u32(request);
+  if (request->failed) {
+    return TSRedDaemonBadRequest;
+  }
+  if (!file) {
+    return status;
+  }
+  if (!self->highlights) {
+    return TSRedDaemonNoQuery;
+  }
+
+  const TSQuery *query = tree_sitter_red_query_raw(self->highlights);
+  uint32_t name_count = ts_query_capture_count(query);
+  tree_sitter_red_message_put_u32(response, name_count);
+  for (uint32_t id = 0; id < name_count; id++) {
+    uint32_t length;
+    const char *name = ts_query_capture_name_for_id(query, id, &length);
+    tree_sitter_red_message_put_bytes(response, name, length);
+  }
+  size_t count_offset = response->size;
+  uint32_t count = 0;
+  tree_sitter_red_message_put_u32(response, 0);
+
+  ts_query_cursor_set_byte_range(self->cursor, start, end);
+  ts_query_cursor_exec(self->cursor, query, ts_tree_root_node(file->tree));
+  TSQueryMatch match;
+  uint32_t capture_index;
+  while (ts_query_cursor_next_capture(self->cursor, &match, &capture_index)) {
+    if (!tree_sitter_red_query_satisfies(self->highlights, &match,
+                                         file->source)) {
+      continue;
+    }
+    const TSQueryCapture *capture = &match.captures[capture_index];
+    tree_sitter_red_message_put_u32(response, ts_node_start_byte(capture->node));
+    tree_sitter_red_message_put_u32(response, ts_node_end_byte(capture->node));
+    tree_sitter_red_message_put_u16(response, (uint16_t)capture->index);
+    count++;
+  }
+  patch_u32(response, count_offset, count);
+  return TSRedDaemonOk;
+}
+
+bool tree_sitter_red_daemon_handle(TSRedDaemon *self,
+                                   TSRedMessageReader *request,
+                                   TSRedMessage *response) {
+  tree_sitter_red_message_reset(response);
+  tree_sitter_red_message_put_u8(response, TSRedDaemonOk);
+
+  uint8_t op = tree_sitter_red_message_get_u8(request);
+  TSRedDaemonStatus status = TSRedDaemonOk;
+  File *file;
+  switch (op) {
+  case TSRedDaemonPing:
+  case TSRedDaemonShutdown:
+    break;
+  case TSRedDaemonParse:
+    status = parse(self, request, response);
+    break;
+  case TSRedDaemonEdit:
+    status = edit(self, request, response);
+    break;
+  case TSRedDaemonDiagnostics:
+    status = diagnostics(self, request, response);
+    break;
+  case TSRedDaemonOutline:
+    status = outline(self, request, response);
+    break;
+  case TSRedDaemonHighlights:
+    status = highlights(self, request, response);
+    break;
+  case TSRedDaemonClose:
+    file = requested_file(self, request, &status);
+    if (file) {
+      close_file(self, file);
+    }
+    break;
+  default:
+    status = TSRedDaemonBadRequest;
+    break;
+  }
+  if (request->failed || request->offset != request->size) {
+    status = TSRedDaemonBadRequest;
+  } else if (response->failed) {
+    status = TSRedDaemonOutOfMemory;
+  }
+  if (status != TSRedDaemonOk) {
+    tree_sitter_red_message_reset(response);
+    tree_sitter_red_message_put_u8(response, status);
+  }
+  return op != TSRedDaemonShutdown || status != TSRedDaemonOk;
+}
+
+// A connection, which holds its request while it arrives and then its
+// response until it is written.
+typedef struct {
+  TSRedMessage message;
+  size_t transferred;
+  bool sending;
+  // When the client is dropped, if it is part way through a frame and makes
+  // no progress before.
+  uint64_t deadline;
+} Client;
+
+static uint64_t now_micros(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000u + (uint64_t)now.tv_nsec / 1000u;
+}
+
+static bool mid_frame(const Client *client) {
+  return client->sending || client->transferred > 0;
+}
+
+// Move the client along as far as its socket allows. Returns false once it
+// should be dropped.
+static bool serve_client(TSRedDaemon *self, Client *client, int fd,
+                         TSRedMessage *spare, bool *running) {
+  TSRedTransferStatus status;
+  if (!client->sending) {
+    status = tree_sitter_red_message_receive_some(fd, &client->message,
+                                                  &client->transferred);
+    if (status != TSRedTransferDone) {
+      return status == TSRedTransferPending;
+    }
+    TSRedMessageReader reader = tree_sitter_red_message_reader(&client->message);
+    *running = tree_sitter_red_daemon_handle(self, &reader, spare);
+    // The client keeps the response, and its request is reused for the next.
+    TSRedMessage request = client->message;
+    client->message = *spare;
+    *spare = request;
+    client->sending = true;
+    client->transferred = 0;
+  }
+  status = tree_sitter_red_message_send_some(fd, &client->message,
+                                             &client->transferred);
+  if (status == TSRedTransferDone) {
+    tree_sitter_red_message_reset(&client->message);
+    client->sending = false;
+    client->transferred = 0;
+  }
+  return status != TSRedTransferFailed;
+}
+
+bool tree_sitter_red_daemon_serve(TSRedDaemon *self, int fd) {
+  // Client i is polled as fds[i]; fds[0] is the listening socket.
+  struct pollfd fds[1 + MAX_CLIENTS];
+  Client clients[1 + MAX_CLIENTS];
+  nfds_t count = 1;
+  fds[0].fd = fd;
+  fds[0].events = POLLIN;
+
+  TSRedMessage spare;
+  tree_sitter_red_message_init(&spare);
+  bool running = true, ok = true;
+  while (running) {
+    int wait = -1;
+    uint64_t now = now_micros();
+    for (nfds_t i = 1; i < count; i++) {
+      if (mid_frame(&clients[i])) {
+        uint64_t left = clients[i].deadline > now ? clients[i].deadline - now : 0;
+        int millis = left / 1000u >= INT32_MAX ? INT32_MAX : (int)((left + 999u) / 1000u);
+        if (wait < 0 || millis < wait) {
+          wait = millis;
+        }
+      }
+    }
+    if (poll(fds, count, wait) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      ok = false;
+      break;
+    }
+    now = now_micros();
+    if (fds[0].revents & POLLIN) {
+      int client = accept(fd, NULL, NULL);
+      int flags = client >= 0 ? fcntl(client, F_GETFL) : -1;
+      if (count < 1 + MAX_CLIENTS && flags >= 0 &&
+          fcntl(client, F_SETFL, flags | O_NONBLOCK) == 0) {
+        fds[count].fd = client;
+        fds[count].events = POLLIN;
+        fds[count].revents = 0;
+        clients[count] = (Client){.transferred = 0};
+        tree_sitter_red_message_init(&clients[count].message);
+        count++;
+      } else if (client >= 0) {
+        close(client);
+      }
+    }
+    // Backwards, so that a closed client can be swapped with the last one.
+    for (nfds_t i = count - 1; running && i >= 1; i--) {
+      Client *client = &clients[i];
+      bool keep;
+      if (fds[i].revents & POLLNVAL) {
+        keep = false;
+      } else if (fds[i].revents) {
+        keep = serve_client(self, client, fds[i].fd, &spare, &running);
+        client->deadline = now + self->idle_timeout_micros;
+      } else {
+        keep = !mid_frame(client) || now < client->deadline;
+      }
+      if (keep) {
+        fds[i].events = client->sending ? POLLOUT : POLLIN;
+      } else {
+        close(fds[i].fd);
+        tree_sitter_red_message_delete(&client->message);
+        fds[i] = fds[--count];
+        clients[i] = clients[count];
+      }
+    }
+  }
+  for (nfds_t i = 1; i < count; i++) {
+    close(fds[i].fd);
+    tree_sitter_red_message_delete(&clients[i].message);
+  }
+  tree_sitter_red_message_delete(&spare);
+  return ok;
+}
@@ -0,0 +1,364 @@
+#include "tree_sitter/tree-sitter-red-dates.h"
+
+#define NS_PER_SECOND 1000000000LL
+
+static bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+static char to_lower(char c) { return c >= 'A' && c <= 'Z' ? c + 32 : c; }
+
+// Read the digits at `*i`, at most `max` of them, and return how many there
+// were, or 0 if there were none or more than `max`.
+static uint32_t scan_digits(const char *text, uint32_t length, uint32_t *i,
+                            uint32_t max, int64_t *value) {
+  uint32_t start = *i;
+  *value = 0;
+  for (; *i < length && is_digit(text[*i]); (*i)++) {
+    if (*i - start == max) {
+      return 0;
+    }
+    *value = *value * 10 + (text[*i] - '0');
+  }
+  return *i - start;
+}
+
+static bool is_leap_year(int64_t year) {
+  return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+}
+
+static int days_in_month(int64_t year, int64_t month) {
+  static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  return month == 2 && is_leap_year(year) ? 29 : days[month - 1];
+}
+
+// Days since 1970-01-01 in the proleptic Gregorian calendar, for any year.
+static int64_t days_from_civil(int64_t year, int64_t month, int64_t day) {
+  year -= month <= 2;
+  int64_t era = (year >= 0 ? year : year - 399) / 400;
+  int64_t year_of_era = year - era * 400;
+  int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int64_t day_of_era =
+      year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+  return era * 146097 + day_of_era - 719468;
+}
+
+static void civil_from_days(int64_t days, TSRedDate *date) {
+  days += 719468;
+  int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+  int64_t day_of_era = days - era * 146097;
+  int64_t year_of_era = (day_of_era - day_of_era / 1460 +
+                         day_of_era / 36524 - day_of_era / 146096) / 365;
+  int64_t day_of_year =
+      day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+  int64_t month_index = (5 * day_of_year + 2) / 153;
+  date->day = (uint8_t)(day_of_year - (153 * month_index + 2) / 5 + 1);
+  date->month = (uint8_t)(month_index < 10 ? month_index + 3 : month_index - 9);
+  date->year = (int32_t)(year_of_era + era * 400 + (date->month <= 2));
+}
+
+// The ISO weekday of a day since the epoch, from 1 for Monday to 7.
+static int64_t weekday(int64_t days) {
+  int64_t remainder = (days + 3) % 7;
+  return (remainder < 0 ? remainder + 7 : remainder) + 1;
+}
+
+// Whether ISO `year` has 53 weeks: it starts or, in a leap year, ends on a
+// Thursday.
+static bool has_week_53(int64_t year) {
+  int64_t first = weekday(days_from_civil(year, 1, 1));
+  return first == 4 || (first == 3 && is_leap_year(year));
+}
+
+// A month number, or a name or its abbreviation in any case: `Jan` or
+// `January`, also `Sept`.
+static int64_t scan_month(const char *text, uint32_t length, uint32_t *i) {
+  static const char *const names[] = {
+      "january", "february", "march",     "april",   "may",      "june",
+      "july",    "august",   "september", "october", "november", "december",
+  };
+  int64_t month;
+  if (scan_digits(text, length, i, 2, &month)) {
+    return month;
+  }
+  uint32_t start = *i;
+  while (*i < length && to_lower(text[*i]) >= 'a' && to_lower(text[*i]) <= 'z') {
+    (*i)++;
+  }
+  uint32_t count = *i - start;
+  for (int64_t m = 0; m < 12; m++) {
+    const char *name = names[m];
+    uint32_t k = 0;
+    while (k < count && name[k] && to_lower(text[start + k]) == name[k]) {
+      k++;
+    }
+    if (k == count && (count == 3 || !name[k] || (m == 8 && count == 4))) {
+      return m + 1;
+    }
+  }
+  return 0;
+}
+
+// `h:m`, `h:m:s`, `h:m:s.fraction`, or `m:s.fraction`, in seconds and
+// nanoseconds.
+static bool scan_clock(const char *text, uint32_t length, uint32_t *i,
+                       int64_t *seconds, int64_t *ns, uint8_t *flags) {
+  int64_t a, b, c = 0, fraction = 0;
+  if (!scan_digits(text, length, i, 9, &a) || *i == length ||
+      text[(*i)++] != ':' || !scan_digits(text, length, i, 9, &b)) {
+    return false;
+  }
+  bool has_seconds = *i < length && text[*i] == ':';
+  if (has_seconds) {
+    (*i)++;
+    if (!scan_digits(text, length, i, 9, &c)) {
+      return false;
+    }
+    *flags |= TSRedDateHasSeconds;
+  }
+  if (*i < length && text[*i] == '.') {
+    (*i)++;
+    uint32_t digits = scan_digits(text, length, i, 9, &fraction);
+    if (!digits) {
+      return false;
+    }
+    for (; digits < 9; digits++) {
+      fraction *= 10;
+    }
+    if (!has_seconds) {
+      // Red reads `1:23.5` as minutes and seconds.
+      c = b;
+      b = a;
+      a = 0;
+    }
+    *flags |= TSRedDateHasSeconds | TSRedDateHasFraction;
+  }
+  *seconds = (a * 60 + b) * 60 + c;
+  *ns = fraction;
+  return true;
+}
+
+// `Z`, `+hhmm`, `+h`, `+hh`, `+h:mm` or `+hh:mm`, and the minus forms.
+static bool scan_zone(const char *text, uint32_t length, uint32_t *i,
+                      int16_t *minutes) {
+  if (text[*i] == 'Z') {
+    (*i)++;
+    *minutes = 0;
+    return true;
+  }
+  if (text[*i] != '+' && text[*i] != '-') {
+    return false;
+  }
+  bool negative = text[(*i)++] == '-';
+  int64_t hours, rest = 0;
+  uint32_t digits = scan_digits(text, length, i, 4, &hours);
+  if (digits == 4) {
+    rest = hours % 100;
+    hours /= 100;
+  } else if (digits == 0 || digits == 3) {
+    return false;
+  } else if (*i < length && text[*i] == ':') {
+    (*i)++;
+    if (scan_digits(text, length, i, 2, &rest) != 2) {
+      return false;
+    }
+  }
+  if (hours > 15 || rest > 59) {
+    return false;
+  }
+  *minutes = (int16_t)((negative ? -1 : 1) * (hours * 60 + rest));
+  return true;
+}
+
+// Read the time after a date whose fields are set, and set the rest.
+static bool finish(const char *text, uint32_t length, uint32_t i, int64_t days,
+                   TSRedDate *date) {
+  int64_t seconds = 0, ns = 0;
+  date->zone_minutes = 0;
+  date->flags = 0;
+  if (i < length && (text[i] == '/' || text[i] == 'T')) {
+    i++;
+    if (!scan_clock(text, length, &i, &seconds, &ns, &date->flags)) {
+      return false;
+    }
+    date->flags |= TSRedDateHasTime;
+    if (i < length) {
+      if (!scan_zone(text, length, &i, &date->zone_minutes)) {
+        return false;
+      }
+      date->flags |= TSRedDateHasZone;
+    }
+  }
+  if (i != length) {
+    return false;
+  }
+  date->epoch_seconds = days * 86400 + seconds - date->zone_minutes * 60;
+  date->nanoseconds = (uint32_t)ns;
+  return true;
+}
+
+static bool valid_day(int64_t year, int64_t month, int64_t day) {
+  return month >= 1 && month <= 12 && day >= 1 &&
+         day <= days_in_month(year, month);
+}
+
+// 20240115T103000[.fraction][zone] or 20240115T1030Z.
+static bool decode_compact(const char *text, uint32_t length,
+                           TSRedDate *date) {
+  uint32_t i = 0;
+  int64_t ymd, hms, fraction = 0;
+  if (scan_digits(text, length, &i, 8, &ymd) != 8 || i == length ||
+      text[i++] != 'T') {
+    return false;
+  }
+  int64_t year = ymd / 10000, month = ymd / 100 % 100, day = ymd % 100;
+  if (!valid_day(year, month, day)) {
+    return false;
+  }
+  uint32_t digits = scan_digits(text, length, &i, 6, &hms);
+  date->flags = TSRedDateHasTime;
+  date->zone_minutes = 0;
+  if (digits == 4) {
+    if (i + 1 != length || text[i] != 'Z') {
+      return false;
+    }
+    hms *= 100;
+    date->flags |= TSRedDateHasZone;
+    i++;
+  } else if (digits == 6) {
+    date->flags |= TSRedDateHasSeconds;
+    if (i < length && text[i] == '.') {
+      i++;
+      uint32_t count = scan_digits(text, length, &i, 9, &fraction);
+      if (!count) {
+        return false;
+      }
+      for (; count < 9; count++) {
+        fraction *= 10;
+      }
+      date->flags |= TSRedDateHasFraction;
+    }
+    if (i < length) {
+      if (!scan_zone(text, length, &i, &date->zone_minutes)) {
+        return false;
+      }
+      date->flags |= TSRedDateHasZone;
+    }
+  } else {
+    return false;
+  }
+  if (i != length) {
+    return false;
+  }
+  int64_t seconds = (hms / 10000 * 60 + hms / 100 % 100) * 60 + hms % 100;
+  date->year = (int32_t)year;
+  date->month = (uint8_t)month;
+  date->day = (uint8_t)day;
+  date->epoch_seconds = days_from_civil(year, month, day) * 86400 + seconds -
+                        date->zone_minutes * 60;
+  date->nanoseconds = (uint32_t)fraction;
+  return true;
+}
+
+bool tree_sitter_red_date_decode(const char *text, uint32_t length,
+                                 TSRedDate *date) {
+  uint32_t i = 0;
+  while (i < length && i < 8 && is_digit(text[i])) {
+    i++;
+  }
+  if (i == 8) {
+    return decode_compact(text, length, date);
+  }
+
+  i = 0;
+  int64_t first;
+  uint32_t digits = scan_digits(text, length, &i, 4, &first);
+  if (!digits || i == length || (text[i] != '-' && text[i] != '/')) {
+    return false;
+  }
+  char separator = text[i++];
+  int64_t year, month, day;
+
+  if (digits >= 3) {
+    year = first;
+    if (separator == '-' && i < length && text[i] == 'W') {
+      // An ISO week date: Monday of week 1 is in the week of January 4.
+      int64_t week, weekday_number = 1;
+      i++;
+      if (scan_digits(text, length, &i, 2, &week) != 2) {
+        return false;
+      }
+      if (i + 1 < length && text[i] == '-' && is_digit(text[i + 1])) {
+        i++;
+        scan_digits(text, length, &i, 1, &weekday_number);
+        if (weekday_number < 1 || weekday_number > 7) {
+          return false;
+        }
+      }
+      if (week < 1 || week > 53 || (week == 53 && !has_week_53(year))) {
+        return false;
+      }
+      int64_t january_4 = days_from_civil(year, 1, 4);
+      int64_t days =
+          january_4 - weekday(january_4) + (week - 1) * 7 + weekday_number;
+      civil_from_days(days, date);
+      return finish(text, length, i, days, date);
+    }
+    uint32_t start = i;
+    int64_t ordinal;
+    if (separator == '-' && scan_digits(text, length, &i, 3, &ordinal) == 3 &&
+        (i == length || text[i] == '/' || text[i] == 'T')) {
+      // An ordinal date.
+      if (ordinal < 1 || ordinal > 365 + is_leap_year(year)) {
+        return false;
+      }
+      int64_t days = days_from_civil(year, 1, 1) + ordinal - 1;
+      civil_from_days(days, date);
+      return finish(text, length, i, days, date);
+    }
+    i = start;
+    if (!(month = scan_month(text, length, &i)) || i == length ||
+        text[i++] != separator || !scan_digits(text, length, &i, 2, &day)) {
+      return false;
+    }
+  } else {
+    day = first;
+    if (!(month = scan_month(text, length, &i)) || i == length ||
+        text[i++] != separator) {
+      return false;
+    }
+    bool negative = separator == '/' && i < length && text[i] == '-';
+    i += negative;
+    digits = scan_digits(text, length, &i, 4, &year);
+    if (digits == 0 || (negative && digits < 3)) {
+      return false;
+    }
+    if (digits <= 2) {
+      year += year < 50 ? 2000 : 1900;
+    }
+    year = negative ? -year : year;
+  }
+  if (!valid_day(year, month, day)) {
+    return false;
+  }
+  date->year = (int32_t)year;
+  date->month = (uint8_t)month;
+  date->day = (uint8_t)day;
+  return finish(text, length, i, days_from_civil(year, month, day), date);
+}
+
+bool tree_sitter_red_time_decode(const char *text, uint32_t length,
+                                 TSRedTime *time) {
+  uint32_t i = 0;
+  bool negative = false;
+  if (i < length && (text[i] == '-' || text[i] == '+')) {
+    negative = text[i++] == '-';
+  }
+  int64_t seconds, ns;
+  time->flags = 0;
+  if (!scan_clock(text, length, &i, &seconds, &ns, &time->flags) ||
+      i != length || seconds > INT64_MAX / NS_PER_SECOND - 1) {
+    return false;
+  }
+  ns += seconds * NS_PER_SECOND;
+  time->ns = negative ? -ns : ns;
+  return true;
+}
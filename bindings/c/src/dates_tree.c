@@ -0,0 +1,20 @@
+#include "tree_sitter/tree-sitter-red-dates.h"
+#include "tree_sitter/tree-sitter-red-symbols.h"
+
+#include <tree_sitter/api.h>
+
+bool tree_sitter_red_date_from_node(TSNode node, const char *source,
+                                    TSRedDate *date) {
+  uint32_t start = ts_node_start_byte(node);
+  return ts_node_symbol(node) == TSRedSymbolDate &&
+         tree_sitter_red_date_decode(source + start,
+                                     ts_node_end_byte(node) - start, date);
+}
+
+bool tree_sitter_red_time_from_node(TSNode node, const char *source,
+                                    TSRedTime *time) {
+  uint32_t start = ts_node_start_byte(node);
+  return ts_node_symbol(node) == TSRedSymbolTime &&
+         tree_sitter_red_time_decode(source + start,
+                                     ts_node_end_byte(node) - start, time);
+}
@@ -0,0 +1,438 @@
+#include "tree_sitter/tree-sitter-red-deps.h"
+#include "tree_sitter/tree-sitter-red-cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+bool tree_sitter_red_deps_list_push(TSRedDependencyList *list,
+                                    TSRedDependencyKind kind, const char *path,
+                                    uint32_t path_length, uint32_t row) {
+  if (list->count == list->capacity) {
+    uint32_t capacity = list->capacity ? list->capacity * 2 : 8;
+    TSRedDependency *items =
+        realloc(list->items, capacity * sizeof(TSRedDependency));
+    if (!items) {
+      return false;
+    }
+    list->items = items;
+    list->capacity = capacity;
+  }
+  char *copy = malloc(path_length + 1);
+  if (!copy) {
+    return false;
+  }
+  memcpy(copy, path, path_length);
+  copy[path_length] = '\0';
+  list->items[list->count++] = (TSRedDependency){kind, copy, row};
+  return true;
+}
+
+void tree_sitter_red_deps_list_delete(TSRedDependencyList *list) {
+  for (uint32_t i = 0; i < list->count; i++) {
+    free(list->items[i].path);
+  }
+  free(list->items);
+  memset(list, 0, sizeof(*list));
+}
+
+// The encoding is a u32 count followed by, for each dependency, a u8 kind,
+// a u32 row and a u32 length before the path bytes. Integers are
+// little-endian.
+
+static uint8_t *put_u32(uint8_t *p, uint32_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+  p[2] = (uint8_t)(value >> 16);
+  p[3] = (uint8_t)(value >> 24);
+  return p + 4;
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+bool tree_sitter_red_deps_encode(const TSRedDependencyList *list,
+                                 uint8_t **data, size_t *size) {
+  size_t total = 4;
+  for (uint32_t i = 0; i < list->count; i++) {
+    total += 9 + strlen(list->items[i].path);
+  }
+  uint8_t *p = *data = malloc(total);
+  if (!p) {
+    return false;
+  }
+  p = put_u32(p, list->count);
+  for (uint32_t i = 0; i < list->count; i++) {
+    const TSRedDependency *item = &list->items[i];
+    uint32_t length = (uint32_t)strlen(item->path);
+    *p++ = (uint8_t)item->kind;
+    p = put_u32(p, item->row);
+    p = put_u32(p, length);
+    memcpy(p, item->path, length);
+    p += length;
+  }
+  *size = total;
+  return true;
+}
+
+bool tree_sitter_red_deps_decode(const uint8_t *data, size_t size,
+                                 TSRedDependencyList *list) {
+  memset(list, 0, sizeof(*list));
+  if (size < 4) {
+    return false;
+  }
+  uint32_t count = get_u32(data);
+  size_t offset = 4;
+  for (uint32_t i = 0; i < count; i++) {
+    if (size - offset < 9 || data[offset] > TSRedDependencyLoad) {
+      goto fail;
+    }
+    TSRedDependencyKind kind = (TSRedDependencyKind)data[offset];
+    uint32_t row = get_u32(data + offset + 1);
+    uint32_t length = get_u32(data + offset + 5);
+    offset += 9;
+    if (size - offset < length ||
+        !tree_sitter_red_deps_list_push(list, kind, (const char *)data + offset,
+                                        length, row)) {
+      goto fail;
+    }
+    offset += length;
+  }
+  if (offset == size) {
+    return true;
+  }
+fail:
+  tree_sitter_red_deps_list_delete(list);
+  return false;
+}
+
+char *tree_sitter_red_deps_resolve(const char *from, const char *target) {
+  size_t directory = 0;
+  if (target[0] != '/') {
+    const char *slash = strrchr(from, '/');
+    directory = slash ? (size_t)(slash - from) + 1 : 0;
+  }
+  size_t length = directory + strlen(target);
+  char *joined = malloc(length + 1);
+  if (!joined) {
+    return NULL;
+  }
+  memcpy(joined, from, directory);
+  strcpy(joined + directory, target);
+
+  // Rewrite in place, keeping the start of every kept segment so that `..`
+  // can drop the one before it.
+  size_t *starts = malloc((length / 2 + 1) * sizeof(size_t));
+  if (!starts) {
+    free(joined);
+    return NULL;
+  }
+  bool absolute = joined[0] == '/';
+  size_t in = absolute, out = absolute, depth = 0, kept_parents = 0;
+  while (in < length) {
+    size_t end = in;
+    while (end < length && joined[end] != '/') {
+      end++;
+    }
+    size_t segment = end - in;
+    if (segment == 0 || (segment == 1 && joined[in] == '.')) {
+      // Skip empty and `.` segments.
+    } else if (segment == 2 && joined[in] == '.' && joined[in + 1] == '.' &&
+               depth > kept_parents) {
+      out = starts[--depth];
+    } else if (segment == 2 && joined[in] == '.' && joined[in + 1] == '.' &&
+               absolute) {
+      // `..` at the root stays at the root.
+    } else {
+      if (segment == 2 && joined[in] == '.' && joined[in + 1] == '.') {
+        kept_parents++;
+      }
+      starts[depth++] = out;
+      memmove(joined + out, joined + in, segment);
+      out += segment;
+      if (end < length) {
+        joined[out++] = '/';
+      }
+    }
+    in = end + 1;
+  }
+  // A trailing slash is only kept when the target named a directory.
+  size_t target_length = strlen(target);
+  if (out > 1 && joined[out - 1] == '/' &&
+      (target_length == 0 || target[target_length - 1] != '/')) {
+    out--;
+  }
+  joined[out] = '\0';
+  free(starts);
+  return joined;
+}
+
+typedef struct {
+  char *path;
+  uint64_t hash;
+  bool exists;
+} File;
+
+typedef struct {
+  uint32_t from;
+  uint32_t to;
+  TSRedDependencyKind kind;
+} Edge;
+
+struct TSRedDependencyGraph {
+  File *files;
+  uint32_t file_count;
+  uint32_t file_capacity;
+  // Open-addressed file indices plus one, by path hash; zero is empty.
+  uint32_t *index;
+  uint32_t index_size;
+  Edge *edges;
+  uint32_t edge_count;
+  uint32_t edge_capacity;
+};
+
+TSRedDependencyGraph *tree_sitter_red_deps_graph_new(void) {
+  return calloc(1, sizeof(TSRedDependencyGraph));
+}
+
+void tree_sitter_red_deps_graph_delete(TSRedDependencyGraph *graph) {
+  if (!graph) {
+    return;
+  }
+  for (uint32_t i = 0; i < graph->file_count; i++) {
+    free(graph->files[i].path);
+  }
+  free(graph->files);
+  free(graph->index);
+  free(graph->edges);
+  free(graph);
+}
+
+static bool grow_index(TSRedDependencyGraph *graph) {
+  uint32_t size = graph->index_size ? graph->index_size * 2 : 64;
+  uint32_t *index = calloc(size, sizeof(uint32_t));
+  if (!index) {
+    return false;
+  }
+  for (uint32_t i = 0; i < graph->file_count; i++) {
+    uint32_t slot = (uint32_t)graph->files[i].hash & (size - 1);
+    while (index[slot]) {
+      slot = (slot + 1) & (size - 1);
+    }
+    index[slot] = i + 1;
+  }
+  free(graph->index);
+  graph->index = index;
+  graph->index_size = size;
+  return true;
+}
+
+uint32_t tree_sitter_red_deps_graph_add_file(TSRedDependencyGraph *graph,
+                                             const char *path) {
+  size_t length = strlen(path);
+  uint64_t hash = tree_sitter_red_hash(path, length, 0);
+  if (graph->index_size) {
+    uint32_t slot = (uint32_t)hash & (graph->index_size - 1);
+    for (; graph->index[slot]; slot = (slot + 1) & (graph->index_size - 1)) {
+      File *file = &graph->files[graph->index[slot] - 1];
+      if (file->hash == hash && strcmp(file->path, path) == 0) {
+        return graph->index[slot] - 1;
+      }
+    }
+  }
+
+  if ((graph->file_count + 1) * 2 > graph->index_size && !grow_index(graph)) {
+    return UINT32_MAX;
+  }
+  if (graph->file_count == graph->file_capacity) {
+    uint32_t capacity = graph->file_capacity ? graph->file_capacity * 2 : 16;
+    File *files = realloc(graph->files, capacity * sizeof(File));
+    if (!files) {
+      return UINT32_MAX;
+    }
+    graph->files = files;
+    graph->file_capacity = capacity;
+  }
+  char *copy = malloc(length + 1);
+  if (!copy) {
+    return UINT32_MAX;
+  }
+  memcpy(copy, path, length + 1);
+  uint32_t id = graph->file_count++;
+  graph->files[id] = (File){copy, hash, false};
+  uint32_t slot = (uint32_t)hash & (graph->index_size - 1);
+  while (graph->index[slot]) {
+    slot = (slot + 1) & (graph->index_size - 1);
+  }
+  graph->index[slot] = id + 1;
+  return id;
+}
+
+bool tree_sitter_red_deps_graph_add_edge(TSRedDependencyGraph *graph,
+                                         uint32_t from, uint32_t to,
+                                         TSRedDependencyKind kind) {
+  if (from >= graph->file_count || to >= graph->file_count) {
+    return false;
+  }
+  if (graph->edge_count == graph->edge_capacity) {
+    uint32_t capacity = graph->edge_capacity ? graph->edge_capacity * 2 : 32;
+    Edge *edges = realloc(graph->edges, capacity * sizeof(Edge));
+    if (!edges) {
+      return false;
+    }
+    graph->edges = edges;
+    graph->edge_capacity = capacity;
+  }
+  graph->edges[graph->edge_count++] = (Edge){from, to, kind};
+  return true;
+}
+
+uint32_t tree_sitter_red_deps_graph_file_count(const TSRedDependencyGraph *graph) {
+  return graph->file_count;
+}
+
+const char *tree_sitter_red_deps_graph_path(const TSRedDependencyGraph *graph,
+                                            uint32_t file) {
+  return file < graph->file_count ? graph->files[file].path : NULL;
+}
+
+bool tree_sitter_red_deps_graph_exists(const TSRedDependencyGraph *graph,
+                                       uint32_t file) {
+  return file < graph->file_count && graph->files[file].exists;
+}
+
+void tree_sitter_red_deps_graph_set_exists(TSRedDependencyGraph *graph,
+                                           uint32_t file, bool exists) {
+  if (file < graph->file_count) {
+    graph->files[file].exists = exists;
+  }
+}
+
+void tree_sitter_red_deps_graph_edges(
+    const TSRedDependencyGraph *graph,
+    void (*visit)(void *payload, uint32_t from, uint32_t to,
+                  TSRedDependencyKind kind),
+    void *payload) {
+  for (uint32_t i = 0; i < graph->edge_count; i++) {
+    const Edge *edge = &graph->edges[i];
+    visit(payload, edge->from, edge->to, edge->kind);
+  }
+}
+
+// Tarjan's algorithm, with an explicit stack so that long include chains
+// cannot overflow the C stack. It completes a component only after every
+// component reachable from it, which puts dependencies first.
+bool tree_sitter_red_deps_graph_sort(const TSRedDependencyGraph *graph,
+                                     TSRedDependencyOrder *order) {
+  uint32_t n = graph->file_count, m = graph->edge_count;
+  memset(order, 0, sizeof(*order));
+  order->order = malloc((n + 1) * sizeof(uint32_t));
+  order->component = malloc((n + 1) * sizeof(uint32_t));
+  // Adjacency in compressed rows: the targets of file i are
+  // targets[first[i]..first[i + 1]].
+  uint32_t *first = calloc(n + 1, sizeof(uint32_t));
+  uint32_t *targets = malloc((m + 1) * sizeof(uint32_t));
+  uint32_t *index = malloc((n + 1) * sizeof(uint32_t));
+  uint32_t *low = malloc((n + 1) * sizeof(uint32_t));
+  uint32_t *next_edge = malloc((n + 1) * sizeof(uint32_t));
+  uint32_t *stack = malloc((n + 1) * sizeof(uint32_t));
+  uint32_t *calls = malloc((n + 1) * sizeof(uint32_t));
+  bool *on_stack = calloc(n + 1, sizeof(bool));
+  bool ok = order->order && order->component && first && targets && index &&
+            low && next_edge && stack && calls && on_stack;
+  if (!ok) {
+    goto done;
+  }
+
+  for (uint32_t i = 0; i < m; i++) {
+    first[graph->edges[i].from]++;
+    order->has_cycle |= graph->edges[i].from == graph->edges[i].to;
+  }
+  for (uint32_t i = 0, sum = 0; i <= n; i++) {
+    uint32_t count = i < n ? first[i] : 0;
+    first[i] = sum;
+    sum += count;
+  }
+  // Fill rows in edge order, using next_edge as the fill cursor.
+  for (uint32_t i = 0; i < n; i++) {
+    next_edge[i] = first[i];
+  }
+  for (uint32_t i = 0; i < m; i++) {
+    targets[next_edge[graph->edges[i].from]++] = graph->edges[i].to;
+  }
+
+  const uint32_t unvisited = UINT32_MAX;
+  for (uint32_t i = 0; i < n; i++) {
+    index[i] = unvisited;
+  }
+  uint32_t counter = 0, stack_size = 0, emitted = 0;
+  for (uint32_t root = 0; root < n; root++) {
+    if (index[root] != unvisited) {
+      continue;
+    }
+    uint32_t depth = 0;
+    calls[depth++] = root;
+    index[root] = low[root] = counter++;
+    next_edge[root] = first[root];
+    stack[stack_size++] = root;
+    on_stack[root] = true;
+
+    while (depth > 0) {
+      uint32_t v = calls[depth - 1];
+      if (next_edge[v] < first[v + 1]) {
+        uint32_t w = targets[next_edge[v]++];
+        if (index[w] == unvisited) {
+          index[w] = low[w] = counter++;
+          next_edge[w] = first[w];
+          stack[stack_size++] = w;
+          on_stack[w] = true;
+          calls[depth++] = w;
+        } else if (on_stack[w] && index[w] < low[v]) {
+          low[v] = index[w];
+        }
+        continue;
+      }
+
+      depth--;
+      if (depth > 0) {
+        uint32_t parent = calls[depth - 1];
+        if (low[v] < low[parent]) {
+          low[parent] = low[v];
+        }
+      }
+      if (low[v] == index[v]) {
+        uint32_t size = 0, w;
+        do {
+          w = stack[--stack_size];
+          on_stack[w] = false;
+          order->component[w] = order->component_count;
+          order->order[emitted++] = w;
+          size++;
+        } while (w != v);
+        order->has_cycle |= size > 1;
+        order->component_count++;
+      }
+    }
+  }
+
+done:
+  free(first);
+  free(targets);
+  free(index);
+  free(low);
+  free(next_edge);
+  free(stack);
+  free(calls);
+  free(on_stack);
+  if (!ok) {
+    tree_sitter_red_deps_order_delete(order);
+  }
+  return ok;
+}
+
+void tree_sitter_red_deps_order_delete(TSRedDependencyOrder *order) {
+  free(order->order);
+  free(order->component);
+  memset(order, 0, sizeof(*order));
+}
@@ -0,0 +1,404 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "io.h"
+#include "tree_sitter/tree-sitter-red-cache.h"
+#include "tree_sitter/tree-sitter-red-deps.h"
+#include "tree_sitter/tree-sitter-red-symbols.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tree_sitter/api.h>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// What the last expression at a level makes of a following file, or -1.
+typedef int Pending;
+
+static bool is_command(const char *text, uint32_t length, const char *name) {
+  if (length != strlen(name)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < length; i++) {
+    char c = text[i];
+    if ((c >= 'A' && c <= 'Z' ? c + 32 : c) != name[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static Pending pending_for(TSNode node, const char *source, Pending previous) {
+  const char *text = source + ts_node_start_byte(node);
+  uint32_t length = ts_node_end_byte(node) - ts_node_start_byte(node);
+  uint32_t head = 0;
+  switch (ts_node_symbol(node)) {
+  case TSRedSymbolComment:
+    return previous;
+  case TSRedSymbolIssue:
+    return is_command(text, length, "#include") ? TSRedDependencyInclude : -1;
+  case TSRedSymbolPath:
+    // `do/args` and `load/all` refine the command; only the head matters.
+    while (head < length && text[head] != '/') {
+      head++;
+    }
+    length = head;
+    // Fall through.
+  case TSRedSymbolWord:
+    if (is_command(text, length, "do")) {
+      return TSRedDependencyDo;
+    }
+    if (is_command(text, length, "load")) {
+      return TSRedDependencyLoad;
+    }
+    return -1;
+  default:
+    return -1;
+  }
+}
+
+static int hex_digit(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+}
+
+// Decode `%name%20with%20spaces.red` or `%"name with spaces.red"` in place
+// of its own text, which it never outgrows.
+static uint32_t decode_file(const char *text, uint32_t length, char *out) {
+  uint32_t size = 0;
+  if (length >= 3 && text[1] == '"') {
+    memcpy(out, text + 2, length - 3);
+    return length - 3;
+  }
+  for (uint32_t i = 1; i < length; i++) {
+    if (text[i] == '%' && i + 2 < length && hex_digit(text[i + 1]) >= 0 &&
+        hex_digit(text[i + 2]) >= 0) {
+      out[size++] = (char)(hex_digit(text[i + 1]) * 16 + hex_digit(text[i + 2]));
+      i += 2;
+    } else {
+      out[size++] = text[i];
+    }
+  }
+  return size;
+}
+
+bool tree_sitter_red_deps_extract(const TSTree *tree, const char *source,
+                                  TSRedDependencyList *list) {
+  TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+  uint32_t depth = 0, capacity = 64;
+  Pending *pending = malloc(capacity * sizeof(Pending));
+  if (!pending) {
+    ts_tree_cursor_delete(&cursor);
+    return false;
+  }
+  pending[0] = -1;
+
+  bool ok = true;
+  for (;;) {
+    TSNode node = ts_tree_cursor_current_node(&cursor);
+    if (ts_node_is_named(node)) {
+      if (ts_node_symbol(node) == TSRedSymbolFile && pending[depth] >= 0) {
+        uint32_t start = ts_node_start_byte(node);
+        uint32_t length = ts_node_end_byte(node) - start;
+        char *path = malloc(length + 1);
+        ok = path != NULL;
+        if (ok) {
+          uint32_t size = decode_file(source + start, length, path);
+          ok = tree_sitter_red_deps_list_push(
+              list, (TSRedDependencyKind)pending[depth], path, size,
+              ts_node_start_point(node).row);
+          free(path);
+        }
+        if (!ok) {
+          break;
+        }
+      }
+      pending[depth] = pending_for(node, source, pending[depth]);
+    }
+
+    if (ts_tree_cursor_goto_first_child(&cursor)) {
+      if (++depth == capacity) {
+        capacity *= 2;
+        Pending *grown = realloc(pending, capacity * sizeof(Pending));
+        if (!grown) {
+          ok = false;
+          break;
+        }
+        pending = grown;
+      }
+      pending[depth] = -1;
+      continue;
+    }
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        goto done;
+      }
+      depth--;
+    }
+  }
+
+done:
+  free(pending);
+  ts_tree_cursor_delete(&cursor);
+  return ok;
+}
+
+#ifndef _WIN32
+
+typedef struct {
+  char **paths;
+  uint32_t count;
+  uint32_t capacity;
+} PathList;
+
+static bool push_path(PathList *list, char *path) {
+  if (list->count == list->capacity) {
+    uint32_t capacity = list->capacity ? list->capacity * 2 : 64;
+    char **paths = realloc(list->paths, capacity * sizeof(char *));
+    if (!paths) {
+      return false;
+    }
+    list->paths = paths;
+    list->capacity = capacity;
+  }
+  list->paths[list->count++] = path;
+  return true;
+}
+
+// Symbolic links to scripts are followed, but not those to directories, which
+// could lead back up the tree.
+static bool walk(const char *directory, PathList *list) {
+  DIR *dir = opendir(directory);
+  if (!dir) {
+    return false;
+  }
+  bool ok = true;
+  struct dirent *entry;
+  while (ok && (entry = readdir(dir))) {
+    if (entry->d_name[0] == '.') {
+      continue;
+    }
+    size_t length = strlen(directory) + strlen(entry->d_name) + 2;
+    char *path = malloc(length);
+    if (!path) {
+      ok = false;
+      break;
+    }
+    snprintf(path, length, "%s/%s", directory, entry->d_name);
+    struct stat info;
+    int found = lstat(path, &info);
+    bool linked = found == 0 && S_ISLNK(info.st_mode);
+    if (linked) {
+      found = stat(path, &info);
+    }
+    if (found != 0) {
+      free(path);
+    } else if (S_ISDIR(info.st_mode) && !linked) {
+      ok = walk(path, list);
+      free(path);
+    } else if (S_ISREG(info.st_mode) && tree_sitter_red_has_script_extension(entry->d_name)) {
+      ok = push_path(list, path);
+      if (!ok) {
+        free(path);
+      }
+    } else {
+      free(path);
+    }
+  }
+  closedir(dir);
+  return ok;
+}
+
+static int compare_paths(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+typedef struct {
+  const PathList *paths;
+  TSRedDependencyList *results;
+  TSRedCache *cache;
+  uint32_t next;
+  pthread_mutex_t lock;
+} Scan;
+
+static void scan_file(Scan *scan, TSParser *parser, uint32_t i) {
+  const char *path = scan->paths->paths[i];
+  TSRedDependencyList *result = &scan->results[i];
+  uint32_t length;
+  char *source = tree_sitter_red_read_file(path, &length);
+  if (!source) {
+    return;
+  }
+
+  uint64_t hash = tree_sitter_red_hash(source, length, 0);
+  if (scan->cache) {
+    uint8_t *value;
+    size_t size;
+    pthread_mutex_lock(&scan->lock);
+    bool hit = tree_sitter_red_cache_get(scan->cache, hash,
+                                         TSRedCacheDependencies, &value, &size);
+    pthread_mutex_unlock(&scan->lock);
+    if (hit) {
+      hit = tree_sitter_red_deps_decode(value, size, result);
+      free(value);
+      if (hit) {
+        free(source);
+        return;
+      }
+    }
+  }
+
+  // A file that cannot be read or parsed is left without dependencies.
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+  if (tree && tree_sitter_red_deps_extract(tree, source, result) &&
+      scan->cache) {
+    uint8_t *value;
+    size_t size;
+    if (tree_sitter_red_deps_encode(result, &value, &size)) {
+      pthread_mutex_lock(&scan->lock);
+      tree_sitter_red_cache_put(scan->cache, hash, TSRedCacheDependencies,
+                                value, size);
+      pthread_mutex_unlock(&scan->lock);
+      free(value);
+    }
+  }
+  ts_tree_delete(tree);
+  free(source);
+}
+
+static void *scan_worker(void *payload) {
+  Scan *scan = payload;
+  TSParser *parser = ts_parser_new();
+  if (!parser || !ts_parser_set_language(parser, tree_sitter_red())) {
+    ts_parser_delete(parser);
+    return NULL;
+  }
+  for (;;) {
+    pthread_mutex_lock(&scan->lock);
+    uint32_t i = scan->next++;
+    pthread_mutex_unlock(&scan->lock);
+    if (i >= scan->paths->count) {
+      break;
+    }
+    scan_file(scan, parser, i);
+  }
+  ts_parser_delete(parser);
+  return NULL;
+}
+
+static bool add_edges(TSRedDependencyGraph *graph, uint32_t from,
+                      const TSRedDependencyList *list) {
+  const char *path = tree_sitter_red_deps_graph_path(graph, from);
+  for (uint32_t i = 0; i < list->count; i++) {
+    char *target = tree_sitter_red_deps_resolve(path, list->items[i].path);
+    if (!target) {
+      return false;
+    }
+    uint32_t to = tree_sitter_red_deps_graph_add_file(graph, target);
+    free(target);
+    // Adding a file may move the paths.
+    path = tree_sitter_red_deps_graph_path(graph, from);
+    if (to == UINT32_MAX ||
+        !tree_sitter_red_deps_graph_add_edge(graph, from, to,
+                                             list->items[i].kind)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TSRedDependencyGraph *tree_sitter_red_deps_scan(const char *directory,
+                                                unsigned threads,
+                                                TSRedCache *cache) {
+  PathList paths = {0};
+  TSRedDependencyGraph *graph = NULL;
+  pthread_t *workers = NULL;
+  unsigned started = 0;
+  Scan scan = {&paths, NULL, cache, 0, PTHREAD_MUTEX_INITIALIZER};
+  if (!walk(directory, &paths)) {
+    goto done;
+  }
+  qsort(paths.paths, paths.count, sizeof(char *), compare_paths);
+  scan.results = calloc(paths.count + 1, sizeof(TSRedDependencyList));
+  graph = tree_sitter_red_deps_graph_new();
+  if (!scan.results || !graph) {
+    goto fail;
+  }
+
+  if (threads == 0) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = online > 0 ? (unsigned)online : 1;
+  }
+  if (threads > paths.count) {
+    threads = paths.count ? paths.count : 1;
+  }
+  workers = malloc(threads * sizeof(pthread_t));
+  while (workers && started < threads &&
+         pthread_create(&workers[started], NULL, scan_worker, &scan) == 0) {
+    started++;
+  }
+  if (started == 0) {
+    // Scan on this thread instead.
+    scan_worker(&scan);
+  }
+  for (unsigned i = 0; i < started; i++) {
+    pthread_join(workers[i], NULL);
+  }
+
+  // Add the scanned files first, in path order, so that their indices do
+  // not depend on the order the threads finished in.
+  for (uint32_t i = 0; i < paths.count; i++) {
+    uint32_t file = tree_sitter_red_deps_graph_add_file(graph, paths.paths[i]);
+    if (file == UINT32_MAX) {
+      goto fail;
+    }
+    tree_sitter_red_deps_graph_set_exists(graph, file, true);
+  }
+  for (uint32_t i = 0; i < paths.count; i++) {
+    if (!add_edges(graph, i, &scan.results[i])) {
+      goto fail;
+    }
+  }
+  goto done;
+
+fail:
+  tree_sitter_red_deps_graph_delete(graph);
+  graph = NULL;
+done:
+  for (uint32_t i = 0; i < paths.count; i++) {
+    free(paths.paths[i]);
+    if (scan.results) {
+      tree_sitter_red_deps_list_delete(&scan.results[i]);
+    }
+  }
+  free(workers);
+  free(paths.paths);
+  free(scan.results);
+  pthread_mutex_destroy(&scan.lock);
+  return graph;
+}
+
+#else
+
+TSRedDependencyGraph *tree_sitter_red_deps_scan(const char *directory,
+                                                unsigned threads,
+                                                TSRedCache *cache) {
+  (void)directory;
+  (void)threads;
+  (void)cache;
+  return NULL;
+}
+
+#endif
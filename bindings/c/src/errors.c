@@ -0,0 +1,155 @@
+#include "tree_sitter/tree-sitter-red-errors.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+bool tree_sitter_red_errors_push(TSRedErrorList *list, const TSRedError *error,
+                                 const uint16_t *expected,
+                                 uint32_t expected_count) {
+  if (list->count == list->capacity) {
+    uint32_t capacity = list->capacity ? list->capacity * 2 : 8;
+    TSRedError *items = realloc(list->items, capacity * sizeof(TSRedError));
+    if (!items) {
+      return false;
+    }
+    list->items = items;
+    list->capacity = capacity;
+  }
+  if (list->expected_count + expected_count > list->expected_capacity) {
+    uint32_t capacity = list->expected_capacity ? list->expected_capacity : 64;
+    while (capacity < list->expected_count + expected_count) {
+      capacity *= 2;
+    }
+    uint16_t *grown = realloc(list->expected, capacity * sizeof(uint16_t));
+    if (!grown) {
+      return false;
+    }
+    list->expected = grown;
+    list->expected_capacity = capacity;
+  }
+  TSRedError *added = &list->items[list->count++];
+  *added = *error;
+  added->expected_offset = list->expected_count;
+  added->expected_count = expected_count;
+  if (expected_count) {
+    memcpy(list->expected + list->expected_count, expected,
+           expected_count * sizeof(uint16_t));
+  }
+  list->expected_count += expected_count;
+  return true;
+}
+
+void tree_sitter_red_errors_delete(TSRedErrorList *list) {
+  free(list->items);
+  free(list->expected);
+  memset(list, 0, sizeof(*list));
+}
+
+// The encoding is a u32 count followed by, for each error, a u8 kind, six
+// u32 positions in field order, a u16 symbol and a u32 count before the
+// u16 expected symbols. Integers are little-endian.
+#define ERROR_SIZE (1 + 6 * 4 + 2 + 4)
+
+static uint8_t *put_u16(uint8_t *p, uint16_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+  return p + 2;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t value) {
+  p = put_u16(p, (uint16_t)value);
+  return put_u16(p, (uint16_t)(value >> 16));
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+  return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+bool tree_sitter_red_errors_encode(const TSRedErrorList *list, uint8_t **data,
+                                   size_t *size) {
+  size_t total = 4 + (size_t)list->count * ERROR_SIZE;
+  for (uint32_t i = 0; i < list->count; i++) {
+    total += (size_t)list->items[i].expected_count * 2;
+  }
+  uint8_t *p = *data = malloc(total);
+  if (!p) {
+    return false;
+  }
+  p = put_u32(p, list->count);
+  for (uint32_t i = 0; i < list->count; i++) {
+    const TSRedError *error = &list->items[i];
+    *p++ = (uint8_t)error->kind;
+    p = put_u32(p, error->start_byte);
+    p = put_u32(p, error->end_byte);
+    p = put_u32(p, error->row);
+    p = put_u32(p, error->column);
+    p = put_u32(p, error->token_start);
+    p = put_u32(p, error->token_end);
+    p = put_u16(p, error->symbol);
+    p = put_u32(p, error->expected_count);
+    for (uint32_t j = 0; j < error->expected_count; j++) {
+      p = put_u16(p, list->expected[error->expected_offset + j]);
+    }
+  }
+  *size = total;
+  return true;
+}
+
+bool tree_sitter_red_errors_decode(const uint8_t *data, size_t size,
+                                   TSRedErrorList *list) {
+  memset(list, 0, sizeof(*list));
+  if (size < 4) {
+    return false;
+  }
+  uint32_t count = get_u32(data);
+  size_t offset = 4;
+  uint16_t *expected = NULL;
+  for (uint32_t i = 0; i < count; i++) {
+    const uint8_t *p = data + offset;
+    if (size - offset < ERROR_SIZE || p[0] > TSRedErrorMissing) {
+      goto fail;
+    }
+    TSRedError error = {
+        .kind = (TSRedErrorKind)p[0],
+        .start_byte = get_u32(p + 1),
+        .end_byte = get_u32(p + 5),
+        .row = get_u32(p + 9),
+        .column = get_u32(p + 13),
+        .token_start = get_u32(p + 17),
+        .token_end = get_u32(p + 21),
+        .symbol = get_u16(p + 25),
+    };
+    uint32_t expected_count = get_u32(p + 27);
+    offset += ERROR_SIZE;
+    if ((size - offset) / 2 < expected_count) {
+      goto fail;
+    }
+    uint16_t *grown = realloc(expected, (expected_count + 1) * sizeof(uint16_t));
+    if (!grown) {
+      goto fail;
+    }
+    expected = grown;
+    for (uint32_t j = 0; j < expected_count; j++) {
+      expected[j] = get_u16(data + offset + 2 * j);
+    }
+    offset += (size_t)expected_count * 2;
+    if (!tree_sitter_red_errors_push(list, &error, expected, expected_count)) {
+      goto fail;
+    }
+  }
+  free(expected);
+  if (offset == size) {
+    return true;
+  }
+  tree_sitter_red_errors_delete(list);
+  return false;
+
+fail:
+  free(expected);
+  tree_sitter_red_errors_delete(list);
+  return false;
+}
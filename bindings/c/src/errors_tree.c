@@ -0,0 +1,158 @@
+#include "tree_sitter/tree-sitter-red-errors.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <tree_sitter/api.h>
+
+static const TSNode null_node = {{0, 0, 0, 0}, NULL, NULL};
+
+static TSNode first_leaf(TSNode node) {
+  while (ts_node_child_count(node) > 0) {
+    node = ts_node_child(node, 0);
+  }
+  return node;
+}
+
+// The last non-extra leaf of `node`, or a null node. Comments are the only
+// extras, and they are leaves.
+static TSNode last_leaf(TSNode node) {
+  uint32_t count;
+  while ((count = ts_node_child_count(node)) > 0) {
+    TSNode child;
+    do {
+      child = ts_node_child(node, --count);
+    } while (ts_node_is_extra(child) && count > 0);
+    node = child;
+  }
+  return ts_node_is_extra(node) ? null_node : node;
+}
+
+typedef struct {
+  const TSLanguage *language;
+  TSLookaheadIterator *lookahead;
+  uint16_t *expected;
+  uint32_t capacity;
+} Collector;
+
+// The visible symbols valid in `state`, once per name: aliases and
+// case-insensitive keywords share names.
+static uint32_t expected_in(Collector *self, TSStateId state) {
+  if (!self->lookahead) {
+    self->lookahead = ts_lookahead_iterator_new(self->language, state);
+    if (!self->lookahead) {
+      return 0;
+    }
+  } else if (!ts_lookahead_iterator_reset_state(self->lookahead, state)) {
+    return 0;
+  }
+  uint32_t count = 0;
+  while (ts_lookahead_iterator_next(self->lookahead)) {
+    TSSymbol symbol = ts_lookahead_iterator_current_symbol(self->lookahead);
+    TSSymbolType type = ts_language_symbol_type(self->language, symbol);
+    if (type != TSSymbolTypeRegular && type != TSSymbolTypeAnonymous) {
+      continue;
+    }
+    const char *name = ts_language_symbol_name(self->language, symbol);
+    bool seen = false;
+    for (uint32_t i = 0; i < count && !seen; i++) {
+      seen = strcmp(ts_language_symbol_name(self->language, self->expected[i]),
+                    name) == 0;
+    }
+    if (seen) {
+      continue;
+    }
+    if (count == self->capacity) {
+      uint32_t capacity = self->capacity ? self->capacity * 2 : 32;
+      uint16_t *grown = realloc(self->expected, capacity * sizeof(uint16_t));
+      if (!grown) {
+        break;
+      }
+      self->expected = grown;
+      self->capacity = capacity;
+    }
+    self->expected[count++] = symbol;
+  }
+  return count;
+}
+
+// `previous` is the last non-extra leaf that ends before `node`, or a null
+// node.
+static bool report(Collector *self, TSNode node, TSNode previous,
+                   TSRedErrorList *list) {
+  TSPoint start = ts_node_start_point(node);
+  TSRedError error = {
+      .start_byte = ts_node_start_byte(node),
+      .end_byte = ts_node_end_byte(node),
+      .row = start.row,
+      .column = start.column,
+  };
+  uint32_t expected_count = 0;
+
+  if (ts_node_is_missing(node)) {
+    // What was valid after the token before the gap.
+    TSNode token = ts_node_is_null(previous) ? node : previous;
+    error.kind = TSRedErrorMissing;
+    error.symbol = ts_node_symbol(node);
+    error.token_start = ts_node_start_byte(token);
+    error.token_end = ts_node_end_byte(token);
+    expected_count = expected_in(
+        self, ts_node_is_null(previous) ? ts_node_parse_state(node)
+                                        : ts_node_next_parse_state(previous));
+  } else {
+    // What was valid where the first skipped token was met, or failing
+    // that, after the token before it.
+    TSNode token = first_leaf(node);
+    error.kind = TSRedErrorUnexpected;
+    error.symbol = ts_node_symbol(token);
+    error.token_start = ts_node_start_byte(token);
+    error.token_end = ts_node_end_byte(token);
+    expected_count = expected_in(self, ts_node_parse_state(token));
+    if (expected_count == 0 && !ts_node_is_null(previous)) {
+      expected_count = expected_in(self, ts_node_next_parse_state(previous));
+    }
+  }
+  return tree_sitter_red_errors_push(list, &error, self->expected,
+                                     expected_count);
+}
+
+bool tree_sitter_red_errors_collect(const TSTree *tree, TSRedErrorList *list) {
+  TSNode root = ts_tree_root_node(tree);
+  if (!ts_node_has_error(root)) {
+    return true;
+  }
+  Collector collector = {ts_tree_language(tree), NULL, NULL, 0};
+  TSTreeCursor cursor = ts_tree_cursor_new(root);
+  // The leaf before each error is tracked as the walk passes it, rather than
+  // searched for from the error, which takes time in the depth of the tree.
+  TSNode previous = null_node;
+  bool ok = true;
+  for (;;) {
+    TSNode node = ts_tree_cursor_current_node(&cursor);
+    if (ts_node_is_missing(node) || ts_node_is_error(node)) {
+      if (!report(&collector, node, previous, list)) {
+        ok = false;
+        break;
+      }
+    } else if (ts_node_has_error(node) &&
+               ts_tree_cursor_goto_first_child(&cursor)) {
+      continue;
+    }
+    TSNode last = last_leaf(node);
+    if (!ts_node_is_null(last)) {
+      previous = last;
+    }
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        goto done;
+      }
+    }
+  }
+done:
+  ts_tree_cursor_delete(&cursor);
+  if (collector.lookahead) {
+    ts_lookahead_iterator_delete(collector.lookahead);
+  }
+  free(collector.expected);
+  return ok;
+}
@@ -0,0 +1,445 @@
+#include "tree_sitter/tree-sitter-red-header.h"
+#include "tree_sitter/tree-sitter-red-strings.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum {
+  LexOk,
+  // The input ended before the header did.
+  LexIncomplete,
+  LexInvalid,
+} LexResult;
+
+// How deep blocks and parens may nest in a header value. Their closing
+// brackets are kept on a fixed stack, and deeper values are invalid.
+#define MAX_DEPTH 256
+
+typedef struct {
+  const char *source;
+  uint32_t length;
+  uint32_t pos;
+} Lexer;
+
+static bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' ||
+         c == '\v';
+}
+
+static bool is_delimiter(char c) {
+  return is_space(c) || (c != '\0' && strchr("[](){}\";", c) != NULL);
+}
+
+static char lower(char c) {
+  return c >= 'A' && c <= 'Z' ? (char)(c + ('a' - 'A')) : c;
+}
+
+static bool equal_ignoring_case(const char *a, uint32_t length, const char *b) {
+  for (uint32_t i = 0; i < length; i++) {
+    if (!b[i] || lower(a[i]) != lower(b[i])) {
+      return false;
+    }
+  }
+  return b[length] == '\0';
+}
+
+static LexResult skip_space(Lexer *lexer) {
+  while (lexer->pos < lexer->length) {
+    char c = lexer->source[lexer->pos];
+    if (c == ';') {
+      while (lexer->pos < lexer->length && lexer->source[lexer->pos] != '\n') {
+        lexer->pos++;
+      }
+    } else if (is_space(c)) {
+      lexer->pos++;
+    } else {
+      return LexOk;
+    }
+  }
+  return LexIncomplete;
+}
+
+// A run of characters up to the next delimiter.
+static LexResult lex_token(Lexer *lexer) {
+  while (lexer->pos < lexer->length) {
+    if (is_delimiter(lexer->source[lexer->pos])) {
+      return LexOk;
+    }
+    lexer->pos++;
+  }
+  return LexIncomplete;
+}
+
+// A "quoted" string, with the lexer on the opening quote.
+static LexResult lex_quoted(Lexer *lexer) {
+  lexer->pos++;
+  while (lexer->pos < lexer->length) {
+    char c = lexer->source[lexer->pos++];
+    if (c == '^') {
+      lexer->pos++;
+    } else if (c == '"') {
+      return LexOk;
+    } else if (c == '\n') {
+      return LexInvalid;
+    }
+  }
+  return LexIncomplete;
+}
+
+// A {braced} string, with the lexer on the opening brace.
+static LexResult lex_braced(Lexer *lexer) {
+  uint32_t depth = 0;
+  while (lexer->pos < lexer->length) {
+    char c = lexer->source[lexer->pos++];
+    if (c == '^') {
+      lexer->pos++;
+    } else if (c == '{') {
+      depth++;
+    } else if (c == '}' && --depth == 0) {
+      return LexOk;
+    }
+  }
+  return LexIncomplete;
+}
+
+// A raw string, %{...}% with any number of percent signs on both ends, with
+// the lexer on the first percent sign.
+static LexResult lex_raw(Lexer *lexer) {
+  uint32_t percents = 0;
+  while (lexer->pos < lexer->length && lexer->source[lexer->pos] == '%') {
+    percents++;
+    lexer->pos++;
+  }
+  if (lexer->pos == lexer->length) {
+    return LexIncomplete;
+  }
+  if (lexer->source[lexer->pos] != '{') {
+    return LexInvalid;
+  }
+  while (++lexer->pos < lexer->length) {
+    if (lexer->source[lexer->pos] != '}') {
+      continue;
+    }
+    uint32_t i = 0;
+    while (i < percents && lexer->pos + 1 + i < lexer->length &&
+           lexer->source[lexer->pos + 1 + i] == '%') {
+      i++;
+    }
+    if (i == percents) {
+      lexer->pos += 1 + percents;
+      return LexOk;
+    }
+    if (lexer->pos + 1 + i == lexer->length) {
+      return LexIncomplete;
+    }
+  }
+  return LexIncomplete;
+}
+
+static TSRedHeaderValueType classify(const char *token, uint32_t length) {
+  uint32_t start = token[0] == '+' || token[0] == '-' ? 1 : 0;
+  if (start < length && token[start] >= '0' && token[start] <= '9') {
+    uint32_t dots = 0;
+    bool digits_and_dots = true, numeric = true;
+    for (uint32_t i = start; i < length; i++) {
+      char c = token[i];
+      if (c == '.') {
+        dots++;
+      } else if (c < '0' || c > '9') {
+        digits_and_dots = false;
+        numeric &= strchr("'eE+-%", c) != NULL;
+      }
+    }
+    if (digits_and_dots && dots >= 2 && start == 0) {
+      return TSRedHeaderTuple;
+    }
+    return numeric ? TSRedHeaderNumber : TSRedHeaderOther;
+  }
+  for (uint32_t i = 0; i < length; i++) {
+    if (strchr("@:/'<>%$", token[i]) && !(i == 0 && strchr("<>", token[i]))) {
+      return TSRedHeaderOther;
+    }
+  }
+  return TSRedHeaderWord;
+}
+
+// One value, except that a block or paren is only opened: the lexer is left
+// after its opening bracket and `*close` is set to its closing one, which is
+// otherwise '\0'.
+static LexResult lex_item(Lexer *lexer, TSRedHeaderValueType *type,
+                          char *close) {
+  const char *source = lexer->source;
+  uint32_t start = lexer->pos;
+  char c = source[start];
+  char next = start + 1 < lexer->length ? source[start + 1] : '\0';
+  bool at_end = start + 1 >= lexer->length;
+
+  *close = '\0';
+  switch (c) {
+  case '"':
+    *type = TSRedHeaderString;
+    return lex_quoted(lexer);
+  case '{':
+    *type = TSRedHeaderString;
+    return lex_braced(lexer);
+  case '[':
+  case '(':
+    *type = TSRedHeaderBlock;
+    *close = c == '[' ? ']' : ')';
+    lexer->pos++;
+    return LexOk;
+  case ']':
+  case ')':
+  case '}':
+    return LexInvalid;
+  case '%':
+    if (at_end) {
+      return LexIncomplete;
+    }
+    if (next == '%' || next == '{') {
+      *type = TSRedHeaderString;
+      return lex_raw(lexer);
+    }
+    *type = TSRedHeaderFile;
+    lexer->pos++;
+    return next == '"' ? lex_quoted(lexer) : lex_token(lexer);
+  case '#':
+    if (at_end) {
+      return LexIncomplete;
+    }
+    *type = TSRedHeaderOther;
+    lexer->pos++;
+    switch (next) {
+    case '"':
+      return lex_quoted(lexer);
+    case '{':
+      return lex_braced(lexer);
+    case '[':
+    case '(':
+      *close = next == '[' ? ']' : ')';
+      lexer->pos++;
+      return LexOk;
+    default:
+      return lex_token(lexer);
+    }
+  default: {
+    LexResult result = lex_token(lexer);
+    if (result == LexOk) {
+      *type = classify(source + start, lexer->pos - start);
+    }
+    return result;
+  }
+  }
+}
+
+// One value, blocks and parens to their closing bracket.
+static LexResult lex_value(Lexer *lexer, TSRedHeaderValueType *type) {
+  char closes[MAX_DEPTH];
+  LexResult result = lex_item(lexer, type, &closes[0]);
+  uint32_t depth = closes[0] ? 1 : 0;
+  while (result == LexOk && depth > 0) {
+    if ((result = skip_space(lexer)) != LexOk) {
+      break;
+    }
+    if (lexer->source[lexer->pos] == closes[depth - 1]) {
+      lexer->pos++;
+      depth--;
+      continue;
+    }
+    TSRedHeaderValueType inner;
+    char close;
+    result = lex_item(lexer, &inner, &close);
+    if (result == LexOk && close) {
+      if (depth == MAX_DEPTH) {
+        return LexInvalid;
+      }
+      closes[depth++] = close;
+    }
+  }
+  return result;
+}
+
+// Decode the contents of a string or file value. Decoding never grows the
+// text, so the output fits in the raw length.
+static bool decode(TSRedHeaderField *field) {
+  field->text = malloc(field->raw_length + 1);
+  if (!field->text) {
+    return false;
+  }
+  TSRedString string;
+  if (!tree_sitter_red_string_decode(field->raw, field->raw_length,
+                                     field->text, field->raw_length,
+                                     &string)) {
+    // A lone `%`.
+    string.length = 0;
+  } else if (string.text != field->text) {
+    memcpy(field->text, string.text, string.length);
+  }
+  field->text[string.length] = '\0';
+  field->text_length = string.length;
+  return true;
+}
+
+static bool add_field(TSRedHeader *header, uint32_t *capacity,
+                      const TSRedHeaderField *field) {
+  if (header->field_count == *capacity) {
+    *capacity = *capacity ? *capacity * 2 : 8;
+    TSRedHeaderField *fields =
+        realloc(header->fields, *capacity * sizeof(TSRedHeaderField));
+    if (!fields) {
+      return false;
+    }
+    header->fields = fields;
+  }
+  TSRedHeaderField *added = &header->fields[header->field_count++];
+  *added = *field;
+  if (added->type == TSRedHeaderString || added->type == TSRedHeaderFile) {
+    return decode(added);
+  }
+  return true;
+}
+
+static void clear(TSRedHeader *header) {
+  for (uint32_t i = 0; i < header->field_count; i++) {
+    free(header->fields[i].text);
+  }
+  free(header->fields);
+  header->fields = NULL;
+  header->field_count = 0;
+}
+
+static LexResult lex_header(const char *source, uint32_t length,
+                            TSRedHeader *header) {
+  Lexer lexer = {source, length, 0};
+  if (length >= 3 && memcmp(source, "\xef\xbb\xbf", 3) == 0) {
+    lexer.pos = 3;
+  }
+  if (length - lexer.pos >= 2 && memcmp(source + lexer.pos, "#!", 2) == 0) {
+    while (lexer.pos < length && source[lexer.pos] != '\n') {
+      lexer.pos++;
+    }
+  }
+
+  LexResult result = skip_space(&lexer);
+  if (result != LexOk) {
+    return result;
+  }
+  header->start_byte = lexer.pos;
+  if ((result = lex_token(&lexer)) != LexOk) {
+    return result;
+  }
+  const char *word = source + header->start_byte;
+  uint32_t word_length = lexer.pos - header->start_byte;
+  if (equal_ignoring_case(word, word_length, "red/system")) {
+    header->is_red_system = true;
+  } else if (!equal_ignoring_case(word, word_length, "red")) {
+    return LexInvalid;
+  }
+  if ((result = skip_space(&lexer)) != LexOk) {
+    return result;
+  }
+  if (source[lexer.pos++] != '[') {
+    return LexInvalid;
+  }
+
+  uint32_t capacity = 0;
+  for (;;) {
+    if ((result = skip_space(&lexer)) != LexOk) {
+      return result;
+    }
+    if (source[lexer.pos] == ']') {
+      header->end_byte = ++lexer.pos;
+      return LexOk;
+    }
+    TSRedHeaderField field = {0};
+    uint32_t key_start = lexer.pos;
+    if ((result = lex_value(&lexer, &field.type)) != LexOk) {
+      return result;
+    }
+    // Anything but a set-word is skipped.
+    uint32_t key_length = lexer.pos - key_start;
+    if (field.type != TSRedHeaderOther || key_length < 2 ||
+        source[lexer.pos - 1] != ':' || strchr("#%':", source[key_start]) ||
+        memchr(source + key_start, '/', key_length)) {
+      continue;
+    }
+    field.key = source + key_start;
+    field.key_length = key_length - 1;
+
+    if ((result = skip_space(&lexer)) != LexOk) {
+      return result;
+    }
+    field.raw = source + lexer.pos;
+    if ((result = lex_value(&lexer, &field.type)) != LexOk) {
+      return result;
+    }
+    field.raw_length = (uint32_t)(source + lexer.pos - field.raw);
+    if (!add_field(header, &capacity, &field)) {
+      return LexInvalid;
+    }
+  }
+}
+
+bool tree_sitter_red_header_parse(const char *source, uint32_t length,
+                                  TSRedHeader *header) {
+  memset(header, 0, sizeof(*header));
+  if (lex_header(source, length, header) != LexOk) {
+    tree_sitter_red_header_delete(header);
+    return false;
+  }
+  return true;
+}
+
+bool tree_sitter_red_header_read(const char *path, TSRedHeader *header) {
+  memset(header, 0, sizeof(*header));
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    return false;
+  }
+
+  char *buffer = NULL;
+  size_t size = 0, capacity = 4096;
+  LexResult result = LexIncomplete;
+  bool more = true;
+  while (result == LexIncomplete && more && capacity <= UINT32_MAX) {
+    char *grown = realloc(buffer, capacity);
+    if (!grown) {
+      break;
+    }
+    buffer = grown;
+    size += fread(buffer + size, 1, capacity - size, file);
+    more = size == capacity;
+    clear(header);
+    memset(header, 0, sizeof(*header));
+    result = lex_header(buffer, (uint32_t)size, header);
+    capacity *= 2;
+  }
+  fclose(file);
+
+  if (result != LexOk) {
+    clear(header);
+    free(buffer);
+    memset(header, 0, sizeof(*header));
+    return false;
+  }
+  header->buffer = buffer;
+  return true;
+}
+
+void tree_sitter_red_header_delete(TSRedHeader *header) {
+  clear(header);
+  free(header->buffer);
+  memset(header, 0, sizeof(*header));
+}
+
+const TSRedHeaderField *tree_sitter_red_header_find(const TSRedHeader *header,
+                                                    const char *key) {
+  for (uint32_t i = 0; i < header->field_count; i++) {
+    const TSRedHeaderField *field = &header->fields[i];
+    if (equal_ignoring_case(field->key, field->key_length, key)) {
+      return field;
+    }
+  }
+  return NULL;
+}
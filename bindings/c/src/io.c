@@ -0,0 +1,51 @@
+#include "io.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+char *tree_sitter_red_read_file(const char *path, uint32_t *length) {
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    return NULL;
+  }
+  char *data = NULL;
+  size_t size = 0, capacity = 0;
+  bool ok = true;
+  for (;;) {
+    // Keep room for the NUL.
+    if (size + 1 >= capacity) {
+      if (capacity >= UINT32_MAX || capacity > SIZE_MAX / 2) {
+        ok = false;
+        break;
+      }
+      capacity = capacity ? capacity * 2 : 65536;
+      char *grown = realloc(data, capacity);
+      if (!grown) {
+        ok = false;
+        break;
+      }
+      data = grown;
+    }
+    size_t n = fread(data + size, 1, capacity - 1 - size, file);
+    if (n == 0) {
+      break;
+    }
+    size += n;
+  }
+  ok = ok && !ferror(file);
+  fclose(file);
+  if (!ok) {
+    free(data);
+    return NULL;
+  }
+  data[size] = '\0';
+  *length = (uint32_t)size;
+  return data;
+}
+
+bool tree_sitter_red_has_script_extension(const char *name) {
+  size_t length = strlen(name);
+  return (length > 4 && strcmp(name + length - 4, ".red") == 0) ||
+         (length > 5 && strcmp(name + length - 5, ".reds") == 0);
+}
@@ -0,0 +1,17 @@
+#ifndef TREE_SITTER_RED_IO_H_
+#define TREE_SITTER_RED_IO_H_
+
+// File helpers shared by the helpers library and the tools. Not installed.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// The whole of the file at `path`, which may be a pipe, followed by a NUL that
+// `*length` does not count. NULL if it cannot be read or is 4 GiB or more.
+// The caller releases it with `free`.
+char *tree_sitter_red_read_file(const char *path, uint32_t *length);
+
+// Whether `name` ends in .red or .reds.
+bool tree_sitter_red_has_script_extension(const char *name);
+
+#endif // TREE_SITTER_RED_IO_H_
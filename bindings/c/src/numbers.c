@@ -0,0 +1,275 @@
+#include "tree_sitter/tree-sitter-red-numbers.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Significant digits handed to strtod. A halfway point between two doubles
+// has at most 767 of them, so keeping more and standing in a 1 for any
+// nonzero digits dropped after them does not change the rounding.
+#define MAX_DIGITS 780
+
+// Exponents beyond this overflow or underflow any double anyway.
+#define MAX_EXPONENT 100000
+
+typedef struct {
+  // The significant digits, without leading zeros: the value is
+  // `digits * 10^exponent`.
+  char digits[MAX_DIGITS];
+  uint32_t count;
+  int32_t exponent;
+  // The first 19 digits as an integer.
+  uint64_t mantissa;
+  // Nonzero digits were dropped after MAX_DIGITS.
+  bool truncated;
+} Decimal;
+
+static const double powers_of_ten[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// Not an initializer, which would clear all the digits.
+static void decimal_init(Decimal *decimal) {
+  decimal->count = 0;
+  decimal->exponent = 0;
+  decimal->mantissa = 0;
+  decimal->truncated = false;
+}
+
+static bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+static char to_upper(char c) { return c >= 'a' && c <= 'z' ? c - 32 : c; }
+
+static bool is_letter(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static void push_digit(Decimal *decimal, char c, bool fraction) {
+  if (decimal->count == 0 && c == '0') {
+    decimal->exponent -= fraction;
+  } else if (decimal->count < MAX_DIGITS) {
+    if (decimal->count < 19) {
+      decimal->mantissa = decimal->mantissa * 10 + (uint64_t)(c - '0');
+    }
+    decimal->digits[decimal->count++] = c;
+    decimal->exponent -= fraction;
+  } else {
+    decimal->truncated |= c != '0';
+    decimal->exponent += !fraction;
+  }
+}
+
+// Scan `digits('digits)*` from `*i`. Returns false if there is no digit.
+static bool scan_digits(const char *text, uint32_t length, uint32_t *i,
+                        Decimal *decimal, bool fraction) {
+  uint32_t start = *i;
+  while (*i < length) {
+    char c = text[*i];
+    if (is_digit(c)) {
+      push_digit(decimal, c, fraction);
+    } else if (c != '\'' || *i == start || *i + 1 == length ||
+               !is_digit(text[*i + 1])) {
+      break;
+    }
+    (*i)++;
+  }
+  return *i > start;
+}
+
+static double to_double(const Decimal *decimal) {
+  if (decimal->count == 0) {
+    return 0.0;
+  }
+  // Both the mantissa and the power of ten are exact doubles, so one
+  // multiplication or division rounds correctly.
+  if (!decimal->truncated && decimal->count <= 15 &&
+      decimal->exponent >= -22 && decimal->exponent <= 22) {
+    double mantissa = (double)decimal->mantissa;
+    return decimal->exponent < 0 ? mantissa / powers_of_ten[-decimal->exponent]
+                                 : mantissa * powers_of_ten[decimal->exponent];
+  }
+  // Without a decimal point, strtod reads this the same in every locale.
+  char buffer[MAX_DIGITS + 16];
+  uint32_t n = decimal->count;
+  for (uint32_t i = 0; i < n; i++) {
+    buffer[i] = decimal->digits[i];
+  }
+  int32_t exponent = decimal->exponent;
+  if (decimal->truncated) {
+    buffer[n++] = '1';
+    exponent--;
+  }
+  snprintf(buffer + n, sizeof(buffer) - n, "e%d", (int)exponent);
+  return strtod(buffer, NULL);
+}
+
+// Whether `text[i..length]` is `1.#inf` or `1.#nan`, in any case, and which.
+static bool scan_special(const char *text, uint32_t length, uint32_t i,
+                         double *value) {
+  if (length - i != 6 || text[i] != '1' || text[i + 2] != '#') {
+    return false;
+  }
+  char a = to_upper(text[i + 3]), b = to_upper(text[i + 4]),
+       c = to_upper(text[i + 5]);
+  if (a == 'I' && b == 'N' && c == 'F') {
+    *value = INFINITY;
+  } else if (a == 'N' && b == 'A' && c == 'N') {
+    *value = NAN;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool tree_sitter_red_number_decode(const char *text, uint32_t length,
+                                   TSRedNumber *number) {
+  uint32_t i = 0;
+  bool negative = false;
+  if (i < length && (text[i] == '-' || text[i] == '+')) {
+    negative = text[i++] == '-';
+  }
+  bool percent = length > i && text[length - 1] == '%';
+  length -= percent;
+  if (i == length) {
+    return false;
+  }
+
+  double special;
+  if (scan_special(text, length, i, &special)) {
+    number->kind = percent ? TSRedNumberPercent : TSRedNumberFloat;
+    number->integer = 0;
+    number->value = negative ? -special : special;
+    if (percent && !isnan(special)) {
+      number->value /= 100;
+    }
+    return true;
+  }
+
+  Decimal decimal;
+  decimal_init(&decimal);
+  bool is_float = false;
+  if (text[i] != '.' && !scan_digits(text, length, &i, &decimal, false)) {
+    return false;
+  }
+  if (i < length && text[i] == '.') {
+    i++;
+    if (!scan_digits(text, length, &i, &decimal, true)) {
+      return false;
+    }
+    is_float = true;
+  }
+  if (i < length && (text[i] == 'e' || text[i] == 'E')) {
+    i++;
+    bool negative_exponent = false;
+    if (i < length && (text[i] == '-' || text[i] == '+')) {
+      negative_exponent = text[i++] == '-';
+    }
+    if (i == length || !is_digit(text[i])) {
+      return false;
+    }
+    int32_t exponent = 0;
+    for (; i < length && is_digit(text[i]); i++) {
+      if (exponent < MAX_EXPONENT) {
+        exponent = exponent * 10 + (text[i] - '0');
+      }
+    }
+    decimal.exponent += negative_exponent ? -exponent : exponent;
+    is_float = true;
+  }
+  if (i != length) {
+    return false;
+  }
+
+  // Red's integers are 32 bits; longer integer literals load as floats.
+  if (!is_float && !percent && decimal.count <= 10 &&
+      decimal.mantissa <= (uint64_t)INT32_MAX + negative) {
+    int64_t integer = (int64_t)decimal.mantissa;
+    number->kind = TSRedNumberInteger;
+    number->integer = negative ? -integer : integer;
+    number->value = (double)number->integer;
+    return true;
+  }
+  double value = to_double(&decimal);
+  number->kind = percent ? TSRedNumberPercent : TSRedNumberFloat;
+  number->integer = 0;
+  number->value = (negative ? -value : value) / (percent ? 100 : 1);
+  return true;
+}
+
+bool tree_sitter_red_money_decode(const char *text, uint32_t length,
+                                  TSRedMoney *money) {
+  uint32_t i = 0;
+  money->negative = false;
+  if (i < length && (text[i] == '-' || text[i] == '+')) {
+    money->negative = text[i++] == '-';
+  }
+  money->currency[0] = '\0';
+  if (length - i > 3 && is_letter(text[i]) && is_letter(text[i + 1]) &&
+      is_letter(text[i + 2])) {
+    for (int k = 0; k < 3; k++) {
+      money->currency[k] = to_upper(text[i++]);
+    }
+    money->currency[3] = '\0';
+  }
+  if (i == length || text[i++] != '$') {
+    return false;
+  }
+
+  Decimal decimal;
+  decimal_init(&decimal);
+  if (!scan_digits(text, length, &i, &decimal, false) || decimal.count > 17) {
+    return false;
+  }
+  money->whole = decimal.mantissa;
+  money->fraction = 0;
+  if (i < length && text[i] == '.') {
+    uint32_t start = ++i, digits = 0;
+    for (; i < length && is_digit(text[i]); i++, digits++) {
+      if (digits < 5) {
+        money->fraction = money->fraction * 10 + (uint32_t)(text[i] - '0');
+      }
+    }
+    if (i == start) {
+      return false;
+    }
+    for (; digits < 5; digits++) {
+      money->fraction *= 10;
+    }
+    if (i - start > 5 && text[start + 5] >= '5' && ++money->fraction == 100000) {
+      money->fraction = 0;
+      if (++money->whole == 100000000000000000u) {
+        return false;
+      }
+    }
+  }
+  return i == length;
+}
+
+static bool scan_int32(const char *text, uint32_t length, uint32_t *i,
+                       int32_t *value) {
+  bool negative = false;
+  if (*i < length && (text[*i] == '-' || text[*i] == '+')) {
+    negative = text[(*i)++] == '-';
+  }
+  Decimal decimal;
+  decimal_init(&decimal);
+  if (!scan_digits(text, length, i, &decimal, false) || decimal.count > 10 ||
+      decimal.mantissa > (uint64_t)INT32_MAX + negative) {
+    return false;
+  }
+  int64_t magnitude = (int64_t)decimal.mantissa;
+  *value = (int32_t)(negative ? -magnitude : magnitude);
+  return true;
+}
+
+bool tree_sitter_red_pair_decode(const char *text, uint32_t length,
+                                 TSRedPair *pair) {
+  uint32_t i = 0;
+  if (!scan_int32(text, length, &i, &pair->x) || i == length ||
+      (text[i] != 'x' && text[i] != 'X')) {
+    return false;
+  }
+  i++;
+  return scan_int32(text, length, &i, &pair->y) && i == length;
+}
@@ -0,0 +1,59 @@
+#include "tree_sitter/tree-sitter-red-numbers.h"
+#include "tree_sitter/tree-sitter-red-symbols.h"
+
+#include <tree_sitter/api.h>
+
+bool tree_sitter_red_number_from_node(TSNode node, const char *source,
+                                      TSRedNumber *number) {
+  uint32_t start = ts_node_start_byte(node);
+  return ts_node_symbol(node) == TSRedSymbolNumber &&
+         tree_sitter_red_number_decode(source + start,
+                                       ts_node_end_byte(node) - start, number);
+}
+
+bool tree_sitter_red_money_from_node(TSNode node, const char *source,
+                                     TSRedMoney *money) {
+  uint32_t start = ts_node_start_byte(node);
+  return ts_node_symbol(node) == TSRedSymbolMoney &&
+         tree_sitter_red_money_decode(source + start,
+                                      ts_node_end_byte(node) - start, money);
+}
+
+bool tree_sitter_red_pair_from_node(TSNode node, const char *source,
+                                    TSRedPair *pair) {
+  uint32_t start = ts_node_start_byte(node);
+  return ts_node_symbol(node) == TSRedSymbolPair &&
+         tree_sitter_red_pair_decode(source + start,
+                                     ts_node_end_byte(node) - start, pair);
+}
+
+// Red keeps the coordinates of points as 32-bit floats.
+bool tree_sitter_red_point_from_node(TSNode node, const char *source,
+                                     TSRedPoint *point) {
+  if (ts_node_symbol(node) != TSRedSymbolPoint) {
+    return false;
+  }
+  float coordinates[3] = {0, 0, 0};
+  uint8_t count = 0;
+  uint32_t child_count = ts_node_named_child_count(node);
+  for (uint32_t i = 0; i < child_count; i++) {
+    TSNode child = ts_node_named_child(node, i);
+    TSRedNumber number;
+    if (ts_node_symbol(child) != TSRedSymbolNumber) {
+      // Comments between the coordinates.
+      continue;
+    }
+    if (count == 3 || !tree_sitter_red_number_from_node(child, source, &number)) {
+      return false;
+    }
+    coordinates[count++] = (float)number.value;
+  }
+  if (count < 2) {
+    return false;
+  }
+  point->dimensions = count;
+  point->x = coordinates[0];
+  point->y = coordinates[1];
+  point->z = coordinates[2];
+  return true;
+}
@@ -0,0 +1,88 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-red-parse.h"
+
+#include <time.h>
+
+typedef struct {
+  const char *source;
+  uint32_t length;
+  const size_t *cancellation_flag;
+  uint64_t deadline;
+  TSRedParseStatus status;
+  TSRedParseResult *result;
+} Parse;
+
+static uint64_t now_micros(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (uint64_t)time.tv_sec * 1000000u + (uint64_t)time.tv_nsec / 1000u;
+}
+
+// The flag is written by another thread, as the runtime's own
+// cancellation flag was.
+static bool is_set(const size_t *flag) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __atomic_load_n(flag, __ATOMIC_RELAXED) != 0;
+#else
+  return *(const volatile size_t *)flag != 0;
+#endif
+}
+
+static const char *read_source(void *payload, uint32_t byte_index,
+                               TSPoint position, uint32_t *bytes_read) {
+  Parse *parse = payload;
+  (void)position;
+  if (byte_index >= parse->length) {
+    *bytes_read = 0;
+    return "";
+  }
+  *bytes_read = parse->length - byte_index;
+  return parse->source + byte_index;
+}
+
+static bool progress(TSParseState *state) {
+  Parse *parse = state->payload;
+  parse->result->offset = state->current_byte_offset;
+  parse->result->has_error = state->has_error;
+  if (parse->cancellation_flag && is_set(parse->cancellation_flag)) {
+    parse->status = TSRedParseCancelled;
+  } else if (parse->deadline && now_micros() >= parse->deadline) {
+    parse->status = TSRedParseTimedOut;
+  }
+  return parse->status != TSRedParseDone;
+}
+
+TSRedParseStatus tree_sitter_red_parse(TSParser *parser,
+                                       const TSTree *old_tree,
+                                       const char *source, uint32_t length,
+                                       const TSRedParseOptions *options,
+                                       TSRedParseResult *result) {
+  Parse parse = {source, length, NULL, 0, TSRedParseDone, result};
+  uint32_t budget = 0;
+  if (options) {
+    parse.cancellation_flag = options->cancellation_flag;
+    if (options->timeout_micros) {
+      parse.deadline = now_micros() + options->timeout_micros;
+    }
+    budget = options->scanner_budget;
+  }
+  *result = (TSRedParseResult){NULL, 0, false};
+  TSInput input = {&parse, read_source, TSInputEncodingUTF8, NULL};
+  TSParseOptions parse_options = {&parse, progress};
+  // The scanner reads its budget on this thread, which the parse runs on.
+  uint32_t previous =
+      budget ? tree_sitter_red_external_scanner_set_budget(budget) : 0;
+  result->tree =
+      ts_parser_parse_with_options(parser, old_tree, input, parse_options);
+  if (budget) {
+    tree_sitter_red_external_scanner_set_budget(previous);
+  }
+  if (result->tree) {
+    result->offset = length;
+    result->has_error = ts_node_has_error(ts_tree_root_node(result->tree));
+    return TSRedParseDone;
+  }
+  // Without a tree, the parse stopped or the parser has no language.
+  return parse.status;
+}
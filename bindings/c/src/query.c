@@ -0,0 +1,345 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-red-query.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <regex.h>
+#endif
+
+typedef enum {
+  PredicateEq,
+  PredicateMatch,
+  PredicateAnyOf,
+} PredicateType;
+
+typedef struct {
+  const char *text;
+  uint32_t length;
+} Value;
+
+typedef struct {
+  PredicateType type;
+  bool negated;
+  uint32_t capture;
+  // The capture compared by `#eq? @a @b`, or UINT32_MAX.
+  uint32_t other;
+  // The strings compared with, as a range of `values`.
+  uint32_t first_value;
+  uint32_t value_count;
+#ifndef _WIN32
+  regex_t regex;
+#endif
+} Predicate;
+
+struct TSRedQuery {
+  TSQuery *query;
+  Predicate *predicates;
+  uint32_t predicate_count;
+  // The predicates of pattern `i` are those from `pattern_start[i]` up to
+  // `pattern_start[i + 1]`.
+  uint32_t *pattern_start;
+  Value *values;
+  uint32_t value_count;
+};
+
+static Value string_value(const TSQuery *query, uint32_t id) {
+  Value value;
+  value.text = ts_query_string_value_for_id(query, id, &value.length);
+  return value;
+}
+
+static bool push_value(TSRedQuery *self, Value value, uint32_t *capacity) {
+  if (self->value_count == *capacity) {
+    *capacity = *capacity ? *capacity * 2 : 16;
+    Value *values = realloc(self->values, *capacity * sizeof(Value));
+    if (!values) {
+      return false;
+    }
+    self->values = values;
+  }
+  self->values[self->value_count++] = value;
+  return true;
+}
+
+#ifndef _WIN32
+static bool compile_regex(Predicate *predicate, Value pattern) {
+  int flags = REG_EXTENDED | REG_NOSUB;
+  if (pattern.length >= 4 && memcmp(pattern.text, "(?i)", 4) == 0) {
+    flags |= REG_ICASE;
+    pattern.text += 4;
+    pattern.length -= 4;
+  }
+  char *text = malloc(pattern.length + 1);
+  if (!text) {
+    return false;
+  }
+  memcpy(text, pattern.text, pattern.length);
+  text[pattern.length] = '\0';
+  bool ok = regcomp(&predicate->regex, text, flags) == 0;
+  free(text);
+  return ok;
+}
+#endif
+
+// Compile the predicate made of `steps[0..count)`. Sets `*kept` when it is one
+// this module checks.
+static bool compile_predicate(TSRedQuery *self, const TSQueryPredicateStep *steps,
+                              uint32_t count, Predicate *predicate,
+                              uint32_t *value_capacity, bool *kept) {
+  *kept = false;
+  if (count == 0 || steps[0].type != TSQueryPredicateStepTypeString) {
+    return false;
+  }
+  Value name = string_value(self->query, steps[0].value_id);
+  memset(predicate, 0, sizeof(*predicate));
+  predicate->other = UINT32_MAX;
+  if (name.length > 4 && memcmp(name.text, "not-", 4) == 0) {
+    predicate->negated = true;
+    name.text += 4;
+    name.length -= 4;
+  }
+  if (name.length == 3 && memcmp(name.text, "eq?", 3) == 0) {
+    predicate->type = PredicateEq;
+  } else if (name.length == 6 && memcmp(name.text, "match?", 6) == 0) {
+    predicate->type = PredicateMatch;
+  } else if (name.length == 7 && memcmp(name.text, "any-of?", 7) == 0 &&
+             !predicate->negated) {
+    predicate->type = PredicateAnyOf;
+  } else {
+    return true;
+  }
+
+  if (count < 3 || steps[1].type != TSQueryPredicateStepTypeCapture) {
+    return false;
+  }
+  predicate->capture = steps[1].value_id;
+  predicate->first_value = self->value_count;
+  for (uint32_t i = 2; i < count; i++) {
+    if (steps[i].type == TSQueryPredicateStepTypeCapture) {
+      if (predicate->type != PredicateEq || count != 3) {
+        return false;
+      }
+      predicate->other = steps[i].value_id;
+    } else if (!push_value(self, string_value(self->query, steps[i].value_id),
+                           value_capacity)) {
+      return false;
+    } else {
+      predicate->value_count++;
+    }
+  }
+  if (predicate->type != PredicateAnyOf && count != 3) {
+    return false;
+  }
+  if (predicate->type == PredicateMatch) {
+#ifndef _WIN32
+    if (!compile_regex(predicate, self->values[predicate->first_value])) {
+      return false;
+    }
+#endif
+  }
+  *kept = true;
+  return true;
+}
+
+static bool compile_predicates(TSRedQuery *self) {
+  uint32_t pattern_count = ts_query_pattern_count(self->query);
+  uint32_t capacity = 0, value_capacity = 0;
+  self->pattern_start = calloc(pattern_count + 1, sizeof(uint32_t));
+  if (!self->pattern_start) {
+    return false;
+  }
+  for (uint32_t pattern = 0; pattern < pattern_count; pattern++) {
+    self->pattern_start[pattern] = self->predicate_count;
+    uint32_t step_count;
+    const TSQueryPredicateStep *steps =
+        ts_query_predicates_for_pattern(self->query, pattern, &step_count);
+    uint32_t start = 0;
+    for (uint32_t i = 0; i < step_count; i++) {
+      if (steps[i].type != TSQueryPredicateStepTypeDone) {
+        continue;
+      }
+      if (self->predicate_count == capacity) {
+        capacity = capacity ? capacity * 2 : 8;
+        Predicate *predicates =
+            realloc(self->predicates, capacity * sizeof(Predicate));
+        if (!predicates) {
+          return false;
+        }
+        self->predicates = predicates;
+      }
+      bool kept;
+      if (!compile_predicate(self, steps + start, i - start,
+                             &self->predicates[self->predicate_count],
+                             &value_capacity, &kept)) {
+        return false;
+      }
+      if (kept) {
+        self->predicate_count++;
+      }
+      start = i + 1;
+    }
+  }
+  self->pattern_start[pattern_count] = self->predicate_count;
+  return true;
+}
+
+TSRedQuery *tree_sitter_red_query_new(const char *source, uint32_t length,
+                                      uint32_t *error_offset,
+                                      TSQueryError *error_type) {
+  TSRedQuery *self = calloc(1, sizeof(TSRedQuery));
+  if (!self) {
+    return NULL;
+  }
+  self->query =
+      ts_query_new(tree_sitter_red(), source, length, error_offset, error_type);
+  if (!self->query) {
+    free(self);
+    return NULL;
+  }
+  if (!compile_predicates(self)) {
+    *error_offset = 0;
+    *error_type = TSQueryErrorSyntax;
+    tree_sitter_red_query_delete(self);
+    return NULL;
+  }
+  return self;
+}
+
+TSRedQuery *tree_sitter_red_query_load(const char *path) {
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    return NULL;
+  }
+  char *source = NULL;
+  size_t length = 0, capacity = 0;
+  for (;;) {
+    if (length == capacity) {
+      capacity = capacity ? capacity * 2 : 4096;
+      char *grown = realloc(source, capacity);
+      if (!grown) {
+        break;
+      }
+      source = grown;
+    }
+    size_t n = fread(source + length, 1, capacity - length, file);
+    if (n == 0) {
+      break;
+    }
+    length += n;
+  }
+  bool ok = !ferror(file) && source && length < UINT32_MAX;
+  fclose(file);
+
+  TSRedQuery *query = NULL;
+  if (ok) {
+    uint32_t error_offset;
+    TSQueryError error_type;
+    query = tree_sitter_red_query_new(source, (uint32_t)length, &error_offset,
+                                      &error_type);
+  }
+  free(source);
+  return query;
+}
+
+void tree_sitter_red_query_delete(TSRedQuery *self) {
+  if (!self) {
+    return;
+  }
+#ifndef _WIN32
+  for (uint32_t i = 0; i < self->predicate_count; i++) {
+    if (self->predicates[i].type == PredicateMatch) {
+      regfree(&self->predicates[i].regex);
+    }
+  }
+#endif
+  ts_query_delete(self->query);
+  free(self->predicates);
+  free(self->pattern_start);
+  free(self->values);
+  free(self);
+}
+
+const TSQuery *tree_sitter_red_query_raw(const TSRedQuery *self) {
+  return self->query;
+}
+
+static Value node_text(TSNode node, const char *source) {
+  Value value;
+  value.text = source + ts_node_start_byte(node);
+  value.length = ts_node_end_byte(node) - ts_node_start_byte(node);
+  return value;
+}
+
+static bool same_text(Value a, Value b) {
+  return a.length == b.length && memcmp(a.text, b.text, a.length) == 0;
+}
+
+static bool holds(const TSRedQuery *self, const Predicate *predicate,
+                  const TSQueryMatch *match, Value text, const char *source) {
+  switch (predicate->type) {
+  case PredicateEq:
+    if (predicate->other == UINT32_MAX) {
+      return same_text(text, self->values[predicate->first_value]);
+    }
+    for (uint16_t i = 0; i < match->capture_count; i++) {
+      if (match->captures[i].index == predicate->other) {
+        return same_text(text, node_text(match->captures[i].node, source));
+      }
+    }
+    return false;
+
+  case PredicateMatch: {
+#ifndef _WIN32
+    char small[256];
+    char *buffer = text.length < sizeof(small) ? small : malloc(text.length + 1);
+    if (!buffer) {
+      return false;
+    }
+    memcpy(buffer, text.text, text.length);
+    buffer[text.length] = '\0';
+    bool matched = regexec(&predicate->regex, buffer, 0, NULL, 0) == 0;
+    if (buffer != small) {
+      free(buffer);
+    }
+    return matched;
+#else
+    return true;
+#endif
+  }
+
+  case PredicateAnyOf:
+    for (uint32_t i = 0; i < predicate->value_count; i++) {
+      if (same_text(text, self->values[predicate->first_value + i])) {
+        return true;
+      }
+    }
+    return false;
+  }
+  return false;
+}
+
+bool tree_sitter_red_query_satisfies(const TSRedQuery *self,
+                                     const TSQueryMatch *match,
+                                     const char *source) {
+  uint32_t end = self->pattern_start[match->pattern_index + 1];
+  for (uint32_t p = self->pattern_start[match->pattern_index]; p < end; p++) {
+    const Predicate *predicate = &self->predicates[p];
+    // Like the runtime's own bindings, every node of a quantified capture
+    // must satisfy the predicate, and a capture that matched no node does.
+    for (uint16_t i = 0; i < match->capture_count; i++) {
+      if (match->captures[i].index != predicate->capture) {
+        continue;
+      }
+      Value text = node_text(match->captures[i].node, source);
+      if (holds(self, predicate, match, text, source) == predicate->negated) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
@@ -0,0 +1,359 @@
+#include "tree_sitter/tree-sitter-red-serialize.h"
+#include "tree_sitter/tree-sitter-red-symbols.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const uint8_t MAGIC[4] = {'R', 'D', 'T', 'S'};
+
+struct TSRedTreeWriterFrame {
+  size_t size_offset;
+  uint32_t start_byte;
+  uint32_t end_byte;
+  uint32_t previous_end;
+  uint32_t children_left;
+};
+
+static void put_u16(uint8_t *p, uint16_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+  p[2] = (uint8_t)(value >> 16);
+  p[3] = (uint8_t)(value >> 24);
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+static bool reserve(TSRedTreeWriter *writer, size_t extra) {
+  if (writer->failed) {
+    return false;
+  }
+  if (writer->size + extra <= writer->capacity) {
+    return true;
+  }
+  size_t capacity = writer->capacity ? writer->capacity * 2 : 4096;
+  while (capacity < writer->size + extra) {
+    capacity *= 2;
+  }
+  uint8_t *data = realloc(writer->data, capacity);
+  if (!data) {
+    writer->failed = true;
+    return false;
+  }
+  writer->data = data;
+  writer->capacity = capacity;
+  return true;
+}
+
+static void put_varint(TSRedTreeWriter *writer, uint32_t value) {
+  if (!reserve(writer, 5)) {
+    return;
+  }
+  while (value >= 0x80) {
+    writer->data[writer->size++] = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  writer->data[writer->size++] = (uint8_t)value;
+}
+
+void tree_sitter_red_tree_writer_init(TSRedTreeWriter *writer,
+                                      uint32_t source_length) {
+  memset(writer, 0, sizeof(*writer));
+  writer->source_length = source_length;
+  if (reserve(writer, TREE_SITTER_RED_TREE_HEADER_SIZE)) {
+    writer->size = TREE_SITTER_RED_TREE_HEADER_SIZE;
+  }
+}
+
+void tree_sitter_red_tree_writer_enter(TSRedTreeWriter *writer,
+                                       uint16_t symbol, uint16_t field_id,
+                                       uint16_t flags, uint32_t start_byte,
+                                       uint32_t end_byte,
+                                       uint32_t child_count) {
+  if (writer->failed) {
+    return;
+  }
+
+  uint32_t base = 0;
+  if (writer->depth > 0) {
+    struct TSRedTreeWriterFrame *parent = &writer->frames[writer->depth - 1];
+    if (parent->children_left == 0) {
+      writer->failed = true;
+      return;
+    }
+    parent->children_left--;
+    base = parent->previous_end;
+  } else if (writer->node_count > 0) {
+    // Only one root.
+    writer->failed = true;
+    return;
+  }
+  if (start_byte < base || end_byte < start_byte) {
+    writer->failed = true;
+    return;
+  }
+
+  flags &= ~TSRedTreeNodeHasField;
+  if (field_id) {
+    flags |= TSRedTreeNodeHasField;
+  }
+  put_varint(writer, ((uint32_t)symbol << 5) | flags);
+  if (field_id) {
+    put_varint(writer, field_id);
+  }
+  put_varint(writer, start_byte - base);
+  put_varint(writer, end_byte - start_byte);
+  put_varint(writer, child_count);
+  writer->node_count++;
+
+  if (writer->depth == writer->frame_capacity) {
+    uint32_t capacity = writer->frame_capacity ? writer->frame_capacity * 2 : 64;
+    struct TSRedTreeWriterFrame *frames =
+        realloc(writer->frames, capacity * sizeof(*frames));
+    if (!frames) {
+      writer->failed = true;
+      return;
+    }
+    writer->frames = frames;
+    writer->frame_capacity = capacity;
+  }
+  struct TSRedTreeWriterFrame *frame = &writer->frames[writer->depth++];
+  frame->start_byte = start_byte;
+  frame->end_byte = end_byte;
+  frame->previous_end = start_byte;
+  frame->children_left = child_count;
+  frame->size_offset = 0;
+  if (child_count > 0 && reserve(writer, 4)) {
+    frame->size_offset = writer->size;
+    writer->size += 4;
+  }
+}
+
+void tree_sitter_red_tree_writer_leave(TSRedTreeWriter *writer) {
+  if (writer->failed) {
+    return;
+  }
+  if (writer->depth == 0) {
+    writer->failed = true;
+    return;
+  }
+  struct TSRedTreeWriterFrame *frame = &writer->frames[--writer->depth];
+  if (frame->children_left != 0) {
+    writer->failed = true;
+    return;
+  }
+  if (frame->size_offset) {
+    size_t descendants = writer->size - frame->size_offset - 4;
+    if (descendants > UINT32_MAX) {
+      writer->failed = true;
+      return;
+    }
+    put_u32(writer->data + frame->size_offset, (uint32_t)descendants);
+  }
+  if (writer->depth > 0) {
+    writer->frames[writer->depth - 1].previous_end = frame->end_byte;
+  }
+}
+
+bool tree_sitter_red_tree_writer_finish(TSRedTreeWriter *writer,
+                                        uint8_t **data, size_t *size) {
+  size_t body = writer->size - TREE_SITTER_RED_TREE_HEADER_SIZE;
+  if (writer->failed || writer->depth != 0 || writer->node_count == 0 ||
+      body > UINT32_MAX) {
+    tree_sitter_red_tree_writer_delete(writer);
+    return false;
+  }
+
+  uint8_t *header = writer->data;
+  memcpy(header, MAGIC, sizeof(MAGIC));
+  put_u16(header + 4, TREE_SITTER_RED_TREE_FORMAT_VERSION);
+  put_u16(header + 6, TREE_SITTER_RED_LANGUAGE_VERSION);
+  put_u16(header + 8, TREE_SITTER_RED_SYMBOL_COUNT);
+  put_u16(header + 10, TREE_SITTER_RED_FIELD_COUNT);
+  put_u32(header + 12, writer->node_count);
+  put_u32(header + 16, writer->source_length);
+  put_u32(header + 20, (uint32_t)body);
+
+  *data = writer->data;
+  *size = writer->size;
+  writer->data = NULL;
+  tree_sitter_red_tree_writer_delete(writer);
+  return true;
+}
+
+void tree_sitter_red_tree_writer_delete(TSRedTreeWriter *writer) {
+  free(writer->data);
+  free(writer->frames);
+  memset(writer, 0, sizeof(*writer));
+}
+
+bool tree_sitter_red_tree_file_open(TSRedTreeFile *file, const void *data,
+                                    size_t size) {
+  const uint8_t *header = data;
+  if (size < TREE_SITTER_RED_TREE_HEADER_SIZE ||
+      memcmp(header, MAGIC, sizeof(MAGIC)) != 0 ||
+      get_u16(header + 4) != TREE_SITTER_RED_TREE_FORMAT_VERSION ||
+      get_u16(header + 6) != TREE_SITTER_RED_LANGUAGE_VERSION ||
+      get_u16(header + 8) != TREE_SITTER_RED_SYMBOL_COUNT ||
+      get_u16(header + 10) != TREE_SITTER_RED_FIELD_COUNT ||
+      get_u32(header + 20) != size - TREE_SITTER_RED_TREE_HEADER_SIZE) {
+    return false;
+  }
+  file->data = header;
+  file->size = size;
+  file->node_count = get_u32(header + 12);
+  file->source_length = get_u32(header + 16);
+  file->mapping = NULL;
+  file->mapping_size = 0;
+  return true;
+}
+
+#ifndef _WIN32
+
+bool tree_sitter_red_tree_file_map(TSRedTreeFile *file, const char *path) {
+  memset(file, 0, sizeof(*file));
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  void *mapping = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+  if (!tree_sitter_red_tree_file_open(file, mapping, (size_t)st.st_size)) {
+    munmap(mapping, (size_t)st.st_size);
+    return false;
+  }
+  file->mapping = mapping;
+  file->mapping_size = (size_t)st.st_size;
+  return true;
+}
+
+void tree_sitter_red_tree_file_unmap(TSRedTreeFile *file) {
+  if (file->mapping) {
+    munmap(file->mapping, file->mapping_size);
+  }
+  memset(file, 0, sizeof(*file));
+}
+
+#else
+
+bool tree_sitter_red_tree_file_map(TSRedTreeFile *file, const char *path) {
+  (void)path;
+  memset(file, 0, sizeof(*file));
+  return false;
+}
+
+void tree_sitter_red_tree_file_unmap(TSRedTreeFile *file) {
+  memset(file, 0, sizeof(*file));
+}
+
+#endif
+
+static bool get_varint(const uint8_t **p, const uint8_t *end,
+                       uint32_t *value) {
+  uint32_t result = 0;
+  for (unsigned shift = 0; shift < 35; shift += 7) {
+    if (*p >= end) {
+      return false;
+    }
+    uint8_t byte = *(*p)++;
+    result |= (uint32_t)(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Decode the record at `p`, whose start is relative to `base` and which must
+// end before `end`.
+static bool read_node(const uint8_t *p, const uint8_t *end, uint32_t base,
+                      TSRedTreeNode *node) {
+  uint32_t head, field_id = 0, delta, length, child_count;
+  if (!get_varint(&p, end, &head)) {
+    return false;
+  }
+  if ((head & TSRedTreeNodeHasField) && !get_varint(&p, end, &field_id)) {
+    return false;
+  }
+  if (!get_varint(&p, end, &delta) || !get_varint(&p, end, &length) ||
+      !get_varint(&p, end, &child_count)) {
+    return false;
+  }
+  if (head >> 5 > UINT16_MAX || field_id > UINT16_MAX ||
+      delta > UINT32_MAX - base || length > UINT32_MAX - base - delta) {
+    return false;
+  }
+
+  node->symbol = (uint16_t)(head >> 5);
+  node->field_id = (uint16_t)field_id;
+  node->flags = (uint16_t)(head & 0x1f);
+  node->start_byte = base + delta;
+  node->end_byte = node->start_byte + length;
+  node->child_count = child_count;
+  if (child_count == 0) {
+    node->children = p;
+    node->subtree_end = p;
+    return true;
+  }
+  if (end - p < 4) {
+    return false;
+  }
+  uint32_t descendants = get_u32(p);
+  p += 4;
+  if ((size_t)(end - p) < descendants) {
+    return false;
+  }
+  node->children = p;
+  node->subtree_end = p + descendants;
+  return true;
+}
+
+bool tree_sitter_red_tree_file_root(const TSRedTreeFile *file,
+                                    TSRedTreeNode *root) {
+  return read_node(file->data + TREE_SITTER_RED_TREE_HEADER_SIZE,
+                   file->data + file->size, 0, root);
+}
+
+bool tree_sitter_red_tree_node_first_child(const TSRedTreeNode *parent,
+                                           TSRedTreeNode *child) {
+  if (parent->child_count == 0) {
+    return false;
+  }
+  return read_node(parent->children, parent->subtree_end, parent->start_byte,
+                   child);
+}
+
+bool tree_sitter_red_tree_node_next_sibling(const TSRedTreeNode *parent,
+                                            TSRedTreeNode *node) {
+  if (node->subtree_end >= parent->subtree_end) {
+    return false;
+  }
+  return read_node(node->subtree_end, parent->subtree_end, node->end_byte,
+                   node);
+}
@@ -0,0 +1,47 @@
+#include "tree_sitter/tree-sitter-red-serialize.h"
+
+#include <tree_sitter/api.h>
+
+static uint16_t node_flags(TSNode node) {
+  uint16_t flags = 0;
+  if (ts_node_is_named(node)) {
+    flags |= TSRedTreeNodeNamed;
+  }
+  if (ts_node_is_missing(node)) {
+    flags |= TSRedTreeNodeMissing;
+  }
+  if (ts_node_is_extra(node)) {
+    flags |= TSRedTreeNodeExtra;
+  }
+  if (ts_node_is_error(node)) {
+    flags |= TSRedTreeNodeError;
+  }
+  return flags;
+}
+
+bool tree_sitter_red_tree_serialize(const TSTree *tree, uint8_t **data,
+                                    size_t *size) {
+  TSNode root = ts_tree_root_node(tree);
+  TSRedTreeWriter writer;
+  tree_sitter_red_tree_writer_init(&writer, ts_node_end_byte(root));
+
+  TSTreeCursor cursor = ts_tree_cursor_new(root);
+  for (;;) {
+    TSNode node = ts_tree_cursor_current_node(&cursor);
+    tree_sitter_red_tree_writer_enter(
+        &writer, ts_node_symbol(node), ts_tree_cursor_current_field_id(&cursor),
+        node_flags(node), ts_node_start_byte(node), ts_node_end_byte(node),
+        ts_node_child_count(node));
+    if (ts_tree_cursor_goto_first_child(&cursor)) {
+      continue;
+    }
+    tree_sitter_red_tree_writer_leave(&writer);
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        ts_tree_cursor_delete(&cursor);
+        return tree_sitter_red_tree_writer_finish(&writer, data, size);
+      }
+      tree_sitter_red_tree_writer_leave(&writer);
+    }
+  }
+}
@@ -0,0 +1,286 @@
+#include "tree_sitter/tree-sitter-red-split.h"
+
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define X86_SIMD
+#include <immintrin.h>
+#endif
+
+typedef enum {
+  LevelScalar,
+  LevelSse2,
+} Level;
+
+typedef enum {
+  // Code, at the top level or in blocks, parens and maps.
+  StateCode,
+  StateString,
+  StateBraces,
+  // Binaries, which hold no braces but may hold comments.
+  StateBinary,
+  StateRaw,
+  StateComment,
+  StateTag,
+  // Quoted attribute values of a tag, which may hold `>`.
+  StateTagQuote,
+  StateTagApostrophe,
+  StateCount,
+} State;
+
+// The bytes that can change each state, or the depth of its nesting.
+// Newlines are in all of them, to count rows.
+static const char *const specials[StateCount] = {
+    "\n[]()\"{;%<", "\n\"^", "\n{}^", "\n};", "\n}%", "\n", "\n>\"'",
+    "\n\"",         "\n'",
+};
+
+static Level cpu_level(void) {
+#ifdef X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2")) {
+    return LevelSse2;
+  }
+#endif
+  return LevelScalar;
+}
+
+#ifdef X86_SIMD
+
+// Skip to the first byte of `set` at or after `i`, 16 bytes at a time,
+// stopping before the last 16.
+__attribute__((target("sse2"))) static uint32_t
+skip_blocks(const char *text, uint32_t i, uint32_t end, const char *set) {
+  __m128i needles[10];
+  int count = 0;
+  for (; set[count]; count++) {
+    needles[count] = _mm_set1_epi8(set[count]);
+  }
+  while (end - i >= 16) {
+    __m128i c = _mm_loadu_si128((const __m128i *)(const void *)(text + i));
+    __m128i hits = _mm_setzero_si128();
+    for (int j = 0; j < count; j++) {
+      hits = _mm_or_si128(hits, _mm_cmpeq_epi8(c, needles[j]));
+    }
+    int mask = _mm_movemask_epi8(hits);
+    if (mask) {
+      return i + (uint32_t)__builtin_ctz((unsigned)mask);
+    }
+    i += 16;
+  }
+  return i;
+}
+
+#endif
+
+// Whether a `%` or `<` at `i` starts a token, rather than being in a word,
+// file or url.
+static bool starts_token(const char *text, uint32_t i) {
+  if (i == 0) {
+    return true;
+  }
+  switch (text[i - 1]) {
+  case ' ':
+  case '\t':
+  case '\r':
+  case '\n':
+  case '[':
+  case ']':
+  case '(':
+  case ')':
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Whether the `{` at `i` opens a binary: it follows `#`, `2#`, `16#` or `64#`
+// at the start of a token.
+static bool opens_binary(const char *text, uint32_t i) {
+  if (i == 0 || text[i - 1] != '#') {
+    return false;
+  }
+  uint32_t base = i - 1;
+  if (base >= 1 && text[base - 1] == '2') {
+    base -= 1;
+  } else if (base >= 2 && (memcmp(text + base - 2, "16", 2) == 0 ||
+                           memcmp(text + base - 2, "64", 2) == 0)) {
+    base -= 2;
+  }
+  return starts_token(text, base);
+}
+
+// Whether `c` may follow the `<` of a tag.
+static bool starts_tag(char c) {
+  return c != '\0' && !strchr(" \t\r\n[](){};\"<>=", c);
+}
+
+uint32_t tree_sitter_red_split(const char *source, uint32_t length,
+                               uint32_t chunk_size, TSRedSplit *splits,
+                               uint32_t capacity) {
+  // Bit s of a byte is set if it is special in state s.
+  uint16_t classes[256];
+  memset(classes, 0, sizeof(classes));
+  for (int state = 0; state < StateCount; state++) {
+    for (const char *c = specials[state]; *c; c++) {
+      classes[(uint8_t)*c] |= (uint16_t)(1u << state);
+    }
+  }
+#ifdef X86_SIMD
+  Level level = cpu_level();
+#endif
+
+  State state = StateCode;
+  // Open brackets and parens, and open braces. For a raw string, the `%`
+  // that opened it, those of its closing delimiter so far, and where the
+  // next of them has to be, or -1.
+  uint32_t depth = 0, braces = 0, percents = 0, closing = 0;
+  int64_t closing_at = -1;
+  uint32_t row = 0, count = 0, chunk_start = 0;
+  chunk_size = chunk_size ? chunk_size : 1;
+  for (uint32_t i = 0; i < length && count < capacity; i++) {
+    uint16_t bit = (uint16_t)(1u << state);
+    if (state == StateComment) {
+      const char *newline = memchr(source + i, '\n', length - i);
+      i = newline ? (uint32_t)(newline - source) : length;
+    } else {
+#ifdef X86_SIMD
+      if (level == LevelSse2 && !(classes[(uint8_t)source[i]] & bit)) {
+        i = skip_blocks(source, i, length, specials[state]);
+      }
+#endif
+      while (i < length && !(classes[(uint8_t)source[i]] & bit)) {
+        i++;
+      }
+    }
+    if (i == length) {
+      break;
+    }
+
+    char c = source[i];
+    if (c == '\n') {
+      row++;
+      // Strings and comments end with their line.
+      if (state == StateString || state == StateComment) {
+        state = StateCode;
+      }
+      if (state == StateCode && depth == 0 && i + 1 < length &&
+          i + 1 - chunk_start >= chunk_size) {
+        chunk_start = i + 1;
+        splits[count++] = (TSRedSplit){chunk_start, row};
+      }
+      continue;
+    }
+
+    switch (state) {
+    case StateCode:
+      switch (c) {
+      case '[':
+      case '(':
+        depth++;
+        break;
+      case ']':
+      case ')':
+        depth -= depth > 0;
+        break;
+      case '"':
+        state = StateString;
+        break;
+      case '{':
+        if (opens_binary(source, i)) {
+          state = StateBinary;
+        } else {
+          state = StateBraces;
+          braces = 1;
+        }
+        break;
+      case ';':
+        state = StateComment;
+        break;
+      case '%':
+        if (starts_token(source, i)) {
+          uint32_t j = i;
+          while (j < length && source[j] == '%') {
+            j++;
+          }
+          if (j < length && source[j] == '{') {
+            state = StateRaw;
+            percents = j - i;
+            closing_at = -1;
+          }
+          // Go on after the braces, or at the last `%`.
+          i = j < length && source[j] == '{' ? j : j - 1;
+        }
+        break;
+      case '<':
+        if (starts_token(source, i) && i + 1 < length &&
+            starts_tag(source[i + 1])) {
+          state = StateTag;
+        }
+        break;
+      default:
+        break;
+      }
+      break;
+    case StateString:
+      // `^` escapes the next character, but not a newline.
+      if (c == '^') {
+        i += i + 1 < length && source[i + 1] != '\n';
+      } else {
+        state = StateCode;
+      }
+      break;
+    case StateBraces:
+      // As the scanner does, `^` escapes only `^`, `{` and `}`.
+      if (c == '^') {
+        char next = i + 1 < length ? source[i + 1] : '\0';
+        i += next == '^' || next == '{' || next == '}';
+      } else if (c == '{') {
+        braces++;
+      } else if (--braces == 0) {
+        state = StateCode;
+      }
+      break;
+    case StateBinary:
+      if (c == ';') {
+        // Go on at the newline that ends the comment.
+        const char *newline = memchr(source + i, '\n', length - i);
+        i = newline ? (uint32_t)(newline - source) - 1 : length - 1;
+      } else {
+        state = StateCode;
+      }
+      break;
+    case StateRaw:
+      // The body ends at a `}` followed by as many `%` as opened it.
+      if (c == '}') {
+        closing = 0;
+        closing_at = (int64_t)i + 1;
+      } else if (closing_at == (int64_t)i) {
+        closing_at++;
+        if (++closing == percents) {
+          state = StateCode;
+        }
+      } else {
+        closing_at = -1;
+      }
+      break;
+    case StateTag:
+      state = c == '>'   ? StateCode
+              : c == '"' ? StateTagQuote
+                         : StateTagApostrophe;
+      break;
+    case StateTagQuote:
+    case StateTagApostrophe:
+      state = StateTag;
+      break;
+    default:
+      break;
+    }
+  }
+  return count;
+}
+
+const char *tree_sitter_red_split_implementation(void) {
+  static const char *const names[] = {"scalar", "sse2"};
+  return names[cpu_level()];
+}
@@ -0,0 +1,176 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-red-split.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <stdlib.h>
+
+#include <tree_sitter/api.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+static const TSNode null_node = {{0, 0, 0, 0}, NULL, NULL};
+
+uint32_t tree_sitter_red_chunks_find(const TSRedChunks *chunks, uint32_t byte) {
+  // The last chunk that starts at or before `byte`.
+  uint32_t low = 0, high = chunks->count;
+  while (high - low > 1) {
+    uint32_t middle = low + (high - low) / 2;
+    if (chunks->starts[middle].byte <= byte) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+TSNode tree_sitter_red_chunks_descendant_for_byte_range(
+    const TSRedChunks *chunks, uint32_t start_byte, uint32_t end_byte) {
+  if (chunks->count == 0) {
+    return null_node;
+  }
+  uint32_t chunk = tree_sitter_red_chunks_find(chunks, start_byte);
+  uint32_t end = chunk + 1 < chunks->count ? chunks->starts[chunk + 1].byte
+                                           : chunks->length;
+  if (end_byte > end) {
+    return null_node;
+  }
+  return ts_node_descendant_for_byte_range(
+      ts_tree_root_node(chunks->trees[chunk]), start_byte, end_byte);
+}
+
+bool tree_sitter_red_chunks_has_error(const TSRedChunks *chunks) {
+  for (uint32_t i = 0; i < chunks->count; i++) {
+    if (ts_node_has_error(ts_tree_root_node(chunks->trees[i]))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void tree_sitter_red_chunks_delete(TSRedChunks *chunks) {
+  for (uint32_t i = 0; chunks->trees && i < chunks->count; i++) {
+    if (chunks->trees[i]) {
+      ts_tree_delete(chunks->trees[i]);
+    }
+  }
+  free(chunks->trees);
+  free(chunks->starts);
+  chunks->trees = NULL;
+  chunks->starts = NULL;
+  chunks->count = 0;
+  chunks->length = 0;
+}
+
+typedef struct {
+  const char *source;
+  TSRedChunks *chunks;
+  uint32_t next;
+#ifndef _WIN32
+  pthread_mutex_t lock;
+#endif
+} Parse;
+
+static TSTree *parse_chunk(Parse *parse, TSParser *parser, uint32_t i) {
+  const TSRedChunks *chunks = parse->chunks;
+  TSRange range = {
+      .start_point = {chunks->starts[i].row, 0},
+      .end_point = {UINT32_MAX, UINT32_MAX},
+      .start_byte = chunks->starts[i].byte,
+      .end_byte = chunks->length,
+  };
+  if (i + 1 < chunks->count) {
+    range.end_point = (TSPoint){chunks->starts[i + 1].row, 0};
+    range.end_byte = chunks->starts[i + 1].byte;
+  }
+  if (!ts_parser_set_included_ranges(parser, &range, 1)) {
+    return NULL;
+  }
+  return ts_parser_parse_string(parser, NULL, parse->source, chunks->length);
+}
+
+static uint32_t next_chunk(Parse *parse) {
+#ifndef _WIN32
+  pthread_mutex_lock(&parse->lock);
+#endif
+  uint32_t i = parse->next++;
+#ifndef _WIN32
+  pthread_mutex_unlock(&parse->lock);
+#endif
+  return i;
+}
+
+static void *parse_worker(void *payload) {
+  Parse *parse = payload;
+  TSParser *parser = ts_parser_new();
+  if (!parser || !ts_parser_set_language(parser, tree_sitter_red())) {
+    ts_parser_delete(parser);
+    return NULL;
+  }
+  for (uint32_t i; (i = next_chunk(parse)) < parse->chunks->count;) {
+    parse->chunks->trees[i] = parse_chunk(parse, parser, i);
+  }
+  ts_parser_delete(parser);
+  return NULL;
+}
+
+bool tree_sitter_red_parse_chunks(const char *source, uint32_t length,
+                                  uint32_t chunk_size, unsigned threads,
+                                  TSRedChunks *chunks) {
+  chunk_size = chunk_size ? chunk_size : 1;
+  uint32_t capacity = length / chunk_size;
+  *chunks = (TSRedChunks){NULL, NULL, 0, length};
+  chunks->starts = malloc((capacity + 1) * sizeof(TSRedSplit));
+  if (!chunks->starts) {
+    return false;
+  }
+  chunks->starts[0] = (TSRedSplit){0, 0};
+  chunks->count = 1 + tree_sitter_red_split(source, length, chunk_size,
+                                            chunks->starts + 1, capacity);
+  chunks->trees = calloc(chunks->count, sizeof(TSTree *));
+  if (!chunks->trees) {
+    tree_sitter_red_chunks_delete(chunks);
+    return false;
+  }
+
+  Parse parse = {.source = source, .chunks = chunks, .next = 0};
+#ifndef _WIN32
+  pthread_mutex_init(&parse.lock, NULL);
+  if (threads == 0) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = online > 0 ? (unsigned)online : 1;
+  }
+  if (threads > chunks->count) {
+    threads = chunks->count;
+  }
+  // This thread parses too.
+  pthread_t *workers =
+      threads > 1 ? malloc((threads - 1) * sizeof(pthread_t)) : NULL;
+  unsigned started = 0;
+  while (workers && started < threads - 1 &&
+         pthread_create(&workers[started], NULL, parse_worker, &parse) == 0) {
+    started++;
+  }
+  parse_worker(&parse);
+  for (unsigned i = 0; i < started; i++) {
+    pthread_join(workers[i], NULL);
+  }
+  free(workers);
+  pthread_mutex_destroy(&parse.lock);
+#else
+  (void)threads;
+  parse_worker(&parse);
+#endif
+
+  for (uint32_t i = 0; i < chunks->count; i++) {
+    if (!chunks->trees[i]) {
+      tree_sitter_red_chunks_delete(chunks);
+      return false;
+    }
+  }
+  return true;
+}
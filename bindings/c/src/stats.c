@@ -0,0 +1,59 @@
+#include "tree_sitter/tree-sitter-red-stats.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static bool starts_with(const char *message, const char *prefix) {
+  return strncmp(message, prefix, strlen(prefix)) == 0;
+}
+
+// The number after `key` in `message`, or 0.
+static uint32_t field(const char *message, const char *key) {
+  const char *found = strstr(message, key);
+  return found ? (uint32_t)strtoul(found + strlen(key), NULL, 10) : 0;
+}
+
+void tree_sitter_red_stats_record(TSRedParseStats *stats, const char *message) {
+  if (starts_with(message, "consume character")) {
+    stats->consumed++;
+  } else if (starts_with(message, "skip character")) {
+    stats->skipped++;
+  } else if (starts_with(message, "process version:")) {
+    uint32_t versions = field(message, "version_count:");
+    if (versions > stats->max_versions) {
+      stats->max_versions = versions;
+    }
+  } else if (starts_with(message, "lex_external") ||
+             starts_with(message, "lex_internal")) {
+    uint32_t row = field(message, "row:");
+    uint32_t column = field(message, "column:");
+    if (stats->lexes > 0 && row == stats->last_row &&
+        column == stats->last_column) {
+      stats->relexes++;
+    }
+    stats->lexes++;
+    stats->external_lexes += message[4] == 'e';
+    stats->last_row = row;
+    stats->last_column = column;
+  } else if (starts_with(message, "detect_error")) {
+    stats->errors++;
+  } else if (starts_with(message, "recover_")) {
+    stats->recoveries++;
+  } else if (starts_with(message, "skip_token")) {
+    stats->skipped_tokens++;
+  } else if (starts_with(message, "reuse_node")) {
+    stats->reused_nodes++;
+  }
+}
+
+const char *tree_sitter_red_scanner_token_name(TSRedScannerToken token) {
+  static const char *const names[] = {
+      [TSRedScannerInfixOp] = "_infix_op",
+      [TSRedScannerHexa] = "hexa",
+      [TSRedScannerRawString] = "raw_string",
+      [TSRedScannerMultilineString] = "multiline_string",
+      [TSRedScannerIpv6Address] = "ipv6_address",
+      [TSRedScannerErrorSentinel] = "error_sentinel",
+  };
+  return (unsigned)token < TSRedScannerTokenCount ? names[token] : NULL;
+}
@@ -0,0 +1,16 @@
+#include "tree_sitter/tree-sitter-red-stats.h"
+
+#include <tree_sitter/api.h>
+
+static void log_message(void *payload, TSLogType type, const char *message) {
+  (void)type;
+  tree_sitter_red_stats_record(payload, message);
+}
+
+void tree_sitter_red_stats_attach(TSParser *parser, TSRedParseStats *stats) {
+  ts_parser_set_logger(parser, (TSLogger){stats, log_message});
+}
+
+void tree_sitter_red_stats_detach(TSParser *parser) {
+  ts_parser_set_logger(parser, (TSLogger){NULL, NULL});
+}
@@ -0,0 +1,413 @@
+// For madvise, which POSIX does not have.
+#define _DEFAULT_SOURCE
+
+#include "tree_sitter/tree-sitter-red-stream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct TSRedStream {
+  uint32_t window;
+  TSRedStreamEncoding encoding;
+  uint32_t bom;
+  // A mapped file, when there is no reader, and the page size. Its pages
+  // before `released` have been dropped.
+  const char *map;
+  uint64_t map_length;
+  uint64_t page;
+  uint64_t released;
+  // A reader, and a buffer of what it read at `buffer_offset` of the file.
+  TSRedStreamRead read;
+  void *payload;
+  char *buffer;
+  uint64_t buffer_offset;
+  uint32_t buffer_length;
+  bool buffer_at_end;
+  // A file that the stream opened and reads, on Windows.
+  FILE *file;
+  // The text is valid up to `checked`, and was not read past it yet. Once
+  // a byte is not valid, `invalid` is its offset and checking stops.
+  uint64_t checked;
+  uint32_t invalid;
+  bool failed;
+};
+
+static TSRedStream *create(uint32_t window) {
+  TSRedStream *stream = calloc(1, sizeof(TSRedStream));
+  if (!stream) {
+    return NULL;
+  }
+  window = window ? window : TREE_SITTER_RED_STREAM_DEFAULT_WINDOW;
+  stream->window = window < TREE_SITTER_RED_STREAM_MIN_WINDOW
+                       ? TREE_SITTER_RED_STREAM_MIN_WINDOW
+                       : window;
+  stream->invalid = UINT32_MAX;
+  return stream;
+}
+
+// Take the encoding from the first bytes of the file.
+static void detect(TSRedStream *stream, const char *head, uint64_t length) {
+  const uint8_t *b = (const uint8_t *)head;
+  if (length >= 3 && b[0] == 0xEF && b[1] == 0xBB && b[2] == 0xBF) {
+    stream->bom = 3;
+  } else if (length >= 2 && b[0] == 0xFF && b[1] == 0xFE) {
+    stream->encoding = TSRedStreamUtf16LE;
+    stream->bom = 2;
+  } else if (length >= 2 && b[0] == 0xFE && b[1] == 0xFF) {
+    stream->encoding = TSRedStreamUtf16BE;
+    stream->bom = 2;
+  } else if (length >= 2 && (b[0] == 0) != (b[1] == 0)) {
+    // An ASCII character in UTF-16.
+    stream->encoding = b[1] == 0 ? TSRedStreamUtf16LE : TSRedStreamUtf16BE;
+  }
+}
+
+// How many of the `size` bytes of `text` are whole, valid characters, and
+// whether it stops at an invalid byte rather than at a character that the
+// end of `text` cuts short.
+static uint32_t valid_utf8(const uint8_t *text, uint32_t size, bool *invalid) {
+  *invalid = false;
+  uint32_t i = 0;
+  while (i < size) {
+    // ASCII, a word at a time.
+    if (size - i >= 8) {
+      uint64_t word;
+      memcpy(&word, text + i, 8);
+      if (!(word & 0x8080808080808080ull)) {
+        i += 8;
+        continue;
+      }
+    }
+    uint8_t c = text[i];
+    if (c < 0x80) {
+      i++;
+      continue;
+    }
+    // The range of the second byte excludes overlong forms, surrogates and
+    // code points past U+10FFFF.
+    uint32_t length;
+    uint8_t low = 0x80, high = 0xBF;
+    if (c >= 0xC2 && c <= 0xDF) {
+      length = 2;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+      length = 3;
+      low = c == 0xE0 ? 0xA0 : low;
+      high = c == 0xED ? 0x9F : high;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+      length = 4;
+      low = c == 0xF0 ? 0x90 : low;
+      high = c == 0xF4 ? 0x8F : high;
+    } else {
+      *invalid = true;
+      return i;
+    }
+    for (uint32_t j = 1; j < length; j++) {
+      if (i + j == size) {
+        return i;
+      }
+      uint8_t next = text[i + j];
+      if (next < (j == 1 ? low : 0x80) || next > (j == 1 ? high : 0xBF)) {
+        *invalid = true;
+        return i;
+      }
+    }
+    i += length;
+  }
+  return i;
+}
+
+// As `valid_utf8`, where surrogates have to come in pairs.
+static uint32_t valid_utf16(const uint8_t *text, uint32_t size,
+                            bool big_endian, bool *invalid) {
+  *invalid = false;
+  uint32_t i = 0;
+  while (size - i >= 2) {
+    unsigned unit = big_endian ? (unsigned)text[i] << 8 | text[i + 1]
+                               : (unsigned)text[i + 1] << 8 | text[i];
+    if (unit < 0xD800 || unit > 0xDFFF) {
+      i += 2;
+      continue;
+    }
+    if (unit >= 0xDC00) {
+      *invalid = true;
+      return i;
+    }
+    if (size - i < 4) {
+      return i;
+    }
+    unsigned next = big_endian ? (unsigned)text[i + 2] << 8 | text[i + 3]
+                               : (unsigned)text[i + 3] << 8 | text[i + 2];
+    if (next < 0xDC00 || next > 0xDFFF) {
+      *invalid = true;
+      return i;
+    }
+    i += 4;
+  }
+  return i;
+}
+
+// Check the part of `text`, the `size` bytes at `start` of the text, that
+// was not checked yet.
+static void check(TSRedStream *stream, const char *text, uint64_t start,
+                  uint32_t size, bool at_end) {
+  if (stream->invalid != UINT32_MAX || start > stream->checked ||
+      start + size <= stream->checked) {
+    return;
+  }
+  uint32_t skip = (uint32_t)(stream->checked - start);
+  const uint8_t *bytes = (const uint8_t *)text + skip;
+  bool invalid;
+  uint32_t valid =
+      stream->encoding == TSRedStreamUtf8
+          ? valid_utf8(bytes, size - skip, &invalid)
+          : valid_utf16(bytes, size - skip,
+                        stream->encoding == TSRedStreamUtf16BE, &invalid);
+  stream->checked += valid;
+  if (invalid || (at_end && skip + valid < size)) {
+    stream->invalid = (uint32_t)stream->checked;
+  }
+}
+
+// Drop the pages more than a window behind `offset`, a window or a page at
+// a time, whichever is more.
+static void release(TSRedStream *stream, uint64_t offset) {
+#ifndef _WIN32
+  uint64_t step = stream->window > stream->page ? stream->window : stream->page;
+  if (offset < stream->released + stream->window + step) {
+    return;
+  }
+  uint64_t end = (offset - stream->window) & ~(stream->page - 1);
+  madvise((void *)(stream->map + stream->released),
+          (size_t)(end - stream->released), MADV_DONTNEED);
+  stream->released = end;
+#else
+  (void)stream;
+  (void)offset;
+#endif
+}
+
+static const char *read_map(TSRedStream *stream, uint64_t offset,
+                            uint32_t *size) {
+  if (offset >= stream->map_length) {
+    return "";
+  }
+  uint64_t left = stream->map_length - offset;
+  *size = left < stream->window ? (uint32_t)left : stream->window;
+  // Along with anything the parser skipped, which is all mapped.
+  uint64_t end = offset + *size;
+  if (stream->checked + stream->bom < end) {
+    check(stream, stream->map + stream->bom + stream->checked, stream->checked,
+          (uint32_t)(end - stream->bom - stream->checked),
+          end == stream->map_length);
+  }
+  release(stream, offset);
+  return stream->map + offset;
+}
+
+// Read a window at `offset` of the file into the buffer.
+static bool fill(TSRedStream *stream, uint64_t offset) {
+  uint32_t length = 0;
+  int64_t count = 1;
+  while (length < stream->window && count > 0) {
+    count = stream->read(stream->payload, offset + length,
+                         stream->buffer + length, stream->window - length);
+    if (count < 0 || count > stream->window - length) {
+      stream->failed = true;
+      stream->buffer_length = 0;
+      return false;
+    }
+    length += (uint32_t)count;
+  }
+  stream->buffer_offset = offset;
+  stream->buffer_length = length;
+  stream->buffer_at_end = count == 0;
+  return true;
+}
+
+// Check the text in the buffer, which starts with the mark at first.
+static void check_buffer(TSRedStream *stream) {
+  uint64_t skip = stream->buffer_offset < stream->bom
+                      ? stream->bom - stream->buffer_offset
+                      : 0;
+  if (skip < stream->buffer_length) {
+    check(stream, stream->buffer + skip,
+          stream->buffer_offset + skip - stream->bom,
+          stream->buffer_length - (uint32_t)skip, stream->buffer_at_end);
+  }
+}
+
+static const char *read_reader(TSRedStream *stream, uint64_t offset,
+                               uint32_t *size) {
+  uint64_t end = stream->buffer_offset + stream->buffer_length;
+  // What is left of the buffer serves if it holds a whole character.
+  bool buffered = offset >= stream->buffer_offset && offset < end &&
+                  (end - offset >= 4 || stream->buffer_at_end);
+  if (!buffered) {
+    // Check anything the parser skipped, a window at a time.
+    while (stream->invalid == UINT32_MAX &&
+           stream->checked + stream->bom < offset && !stream->buffer_at_end) {
+      if (!fill(stream, stream->checked + stream->bom)) {
+        return "";
+      }
+      check_buffer(stream);
+    }
+    if (!fill(stream, offset)) {
+      return "";
+    }
+    end = offset + stream->buffer_length;
+  }
+  check_buffer(stream);
+  if (offset >= end) {
+    return "";
+  }
+  *size = (uint32_t)(end - offset);
+  return stream->buffer + (offset - stream->buffer_offset);
+}
+
+const char *tree_sitter_red_stream_read(TSRedStream *stream, uint32_t byte,
+                                        uint32_t *size) {
+  *size = 0;
+  if (stream->failed) {
+    return "";
+  }
+  uint64_t offset = (uint64_t)byte + stream->bom;
+  return stream->read ? read_reader(stream, offset, size)
+                      : read_map(stream, offset, size);
+}
+
+TSRedStream *tree_sitter_red_stream_new(TSRedStreamRead read, void *payload,
+                                        uint32_t window) {
+  TSRedStream *stream = create(window);
+  if (!stream) {
+    return NULL;
+  }
+  stream->read = read;
+  stream->payload = payload;
+  stream->buffer = malloc(stream->window);
+  if (!stream->buffer || !fill(stream, 0)) {
+    tree_sitter_red_stream_delete(stream);
+    return NULL;
+  }
+  detect(stream, stream->buffer, stream->buffer_length);
+  return stream;
+}
+
+#ifdef _WIN32
+
+static int64_t read_file(void *payload, uint64_t offset, char *buffer,
+                         uint32_t size) {
+  FILE *file = payload;
+  if (_fseeki64(file, (long long)offset, SEEK_SET) != 0) {
+    return -1;
+  }
+  size_t count = fread(buffer, 1, size, file);
+  return count == 0 && ferror(file) ? -1 : (int64_t)count;
+}
+
+TSRedStream *tree_sitter_red_stream_open(const char *path, uint32_t window) {
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    return NULL;
+  }
+  TSRedStream *stream = tree_sitter_red_stream_new(read_file, file, window);
+  if (!stream) {
+    fclose(file);
+    return NULL;
+  }
+  stream->file = file;
+  return stream;
+}
+
+#else
+
+TSRedStream *tree_sitter_red_stream_open(const char *path, uint32_t window) {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return NULL;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    return NULL;
+  }
+  uint64_t length = (uint64_t)info.st_size;
+  if (!S_ISREG(info.st_mode) || length > SIZE_MAX ||
+      length > (uint64_t)UINT32_MAX + 3) {
+    close(fd);
+    errno = S_ISREG(info.st_mode) ? EFBIG : EINVAL;
+    return NULL;
+  }
+  TSRedStream *stream = create(window);
+  if (!stream) {
+    close(fd);
+    errno = ENOMEM;
+    return NULL;
+  }
+  long page = sysconf(_SC_PAGESIZE);
+  stream->page = page > 0 ? (uint64_t)page : 4096;
+  // An empty file has no mapping.
+  if (length > 0) {
+    void *map = mmap(NULL, (size_t)length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+      int error = errno;
+      close(fd);
+      free(stream);
+      errno = error;
+      return NULL;
+    }
+    madvise(map, (size_t)length, MADV_SEQUENTIAL);
+    stream->map = map;
+    stream->map_length = length;
+  }
+  close(fd);
+  detect(stream, stream->map, length);
+  if (length - stream->bom > UINT32_MAX) {
+    tree_sitter_red_stream_delete(stream);
+    errno = EFBIG;
+    return NULL;
+  }
+  return stream;
+}
+
+#endif
+
+void tree_sitter_red_stream_delete(TSRedStream *stream) {
+  if (!stream) {
+    return;
+  }
+#ifndef _WIN32
+  if (stream->map) {
+    munmap((void *)stream->map, (size_t)stream->map_length);
+  }
+#endif
+  if (stream->file) {
+    fclose(stream->file);
+  }
+  free(stream->buffer);
+  free(stream);
+}
+
+TSRedStreamEncoding tree_sitter_red_stream_encoding(const TSRedStream *stream) {
+  return stream->encoding;
+}
+
+uint32_t tree_sitter_red_stream_bom_length(const TSRedStream *stream) {
+  return stream->bom;
+}
+
+uint32_t tree_sitter_red_stream_invalid_offset(const TSRedStream *stream) {
+  return stream->invalid;
+}
+
+bool tree_sitter_red_stream_failed(const TSRedStream *stream) {
+  return stream->failed;
+}
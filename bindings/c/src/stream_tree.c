@@ -0,0 +1,19 @@
+#include "tree_sitter/tree-sitter-red-stream.h"
+
+#include <tree_sitter/api.h>
+
+static const char *read_stream(void *payload, uint32_t byte_index,
+                               TSPoint position, uint32_t *bytes_read) {
+  (void)position;
+  return tree_sitter_red_stream_read(payload, byte_index, bytes_read);
+}
+
+TSInput tree_sitter_red_stream_input(TSRedStream *stream) {
+  static const TSInputEncoding encodings[] = {
+      TSInputEncodingUTF8,
+      TSInputEncodingUTF16LE,
+      TSInputEncodingUTF16BE,
+  };
+  return (TSInput){stream, read_stream,
+                   encodings[tree_sitter_red_stream_encoding(stream)], NULL};
+}
@@ -0,0 +1,240 @@
+#include "tree_sitter/tree-sitter-red-strings.h"
+
+#include <string.h>
+
+typedef struct {
+  char *buffer;
+  uint32_t capacity;
+  uint32_t size;
+} Output;
+
+static bool put(Output *output, const char *text, uint32_t length) {
+  if (length > output->capacity - output->size) {
+    return false;
+  }
+  memcpy(output->buffer + output->size, text, length);
+  output->size += length;
+  return true;
+}
+
+static char lower(char c) {
+  return c >= 'A' && c <= 'Z' ? (char)(c + ('a' - 'A')) : c;
+}
+
+static bool equal_ignoring_case(const char *a, uint32_t length, const char *b) {
+  for (uint32_t i = 0; i < length; i++) {
+    if (!b[i] || lower(a[i]) != lower(b[i])) {
+      return false;
+    }
+  }
+  return b[length] == '\0';
+}
+
+static int hex_digit(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  c = lower(c);
+  return c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+}
+
+static uint32_t put_utf8(char *out, uint32_t code_point) {
+  if (code_point < 0x80) {
+    out[0] = (char)code_point;
+    return 1;
+  }
+  if (code_point < 0x800) {
+    out[0] = (char)(0xc0 | (code_point >> 6));
+    out[1] = (char)(0x80 | (code_point & 0x3f));
+    return 2;
+  }
+  if (code_point < 0x10000) {
+    out[0] = (char)(0xe0 | (code_point >> 12));
+    out[1] = (char)(0x80 | ((code_point >> 6) & 0x3f));
+    out[2] = (char)(0x80 | (code_point & 0x3f));
+    return 3;
+  }
+  out[0] = (char)(0xf0 | (code_point >> 18));
+  out[1] = (char)(0x80 | ((code_point >> 12) & 0x3f));
+  out[2] = (char)(0x80 | ((code_point >> 6) & 0x3f));
+  out[3] = (char)(0x80 | (code_point & 0x3f));
+  return 4;
+}
+
+// Decode the escape after a caret at `text[*i]` into `out`, advancing `*i`
+// past it. Returns the length of the decoded character.
+static uint32_t decode_caret(const char *text, uint32_t end, uint32_t *i,
+                             char *out) {
+  static const struct {
+    const char *name;
+    char value;
+  } names[] = {{"null", 0},  {"back", 8},  {"tab", 9},   {"line", 10},
+               {"page", 12}, {"esc", 27},  {"del", 127}};
+
+  char c = text[(*i)++];
+  if (c == '(') {
+    uint32_t close = *i;
+    while (close < end && close - *i <= 6 && text[close] != ')') {
+      close++;
+    }
+    if (close < end && text[close] == ')') {
+      for (size_t n = 0; n < sizeof(names) / sizeof(names[0]); n++) {
+        if (equal_ignoring_case(text + *i, close - *i, names[n].name)) {
+          out[0] = names[n].value;
+          *i = close + 1;
+          return 1;
+        }
+      }
+      uint32_t code_point = 0;
+      bool hex = close > *i && close - *i <= 6;
+      for (uint32_t j = *i; hex && j < close; j++) {
+        int digit = hex_digit(text[j]);
+        hex = digit >= 0;
+        code_point = code_point * 16 + (uint32_t)(digit < 0 ? 0 : digit);
+      }
+      if (hex && code_point <= 0x10ffff) {
+        *i = close + 1;
+        return put_utf8(out, code_point);
+      }
+    }
+    out[0] = c;
+    return 1;
+  }
+  switch (c) {
+  case '/':
+    out[0] = '\n';
+    break;
+  case '-':
+    out[0] = '\t';
+    break;
+  case '~':
+    out[0] = 127;
+    break;
+  case '@':
+    out[0] = 0;
+    break;
+  default:
+    if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '[' ||
+        c == '\\' || c == ']' || c == '_') {
+      out[0] = (char)(c & 0x1f);
+    } else {
+      out[0] = c;
+    }
+    break;
+  }
+  return 1;
+}
+
+// Decode `%20` at `text[*i]`, after the percent sign, into `out`. A percent
+// sign without two hex digits after it stands for itself.
+static uint32_t decode_percent(const char *text, uint32_t end, uint32_t *i,
+                               char *out) {
+  int high = *i + 1 < end ? hex_digit(text[*i]) : -1;
+  int low = high >= 0 ? hex_digit(text[*i + 1]) : -1;
+  if (low < 0) {
+    out[0] = '%';
+    return 1;
+  }
+  out[0] = (char)(high * 16 + low);
+  *i += 2;
+  return 1;
+}
+
+// Decode `text[start..end)`, where `mark` starts every escape. Finding the
+// marks is memchr's job, which C libraries vectorize: runs of text between
+// escapes are skipped at memory speed and copied with memcpy.
+static bool decode_body(const char *text, uint32_t start, uint32_t end,
+                        char mark, char *buffer, uint32_t capacity,
+                        TSRedString *string) {
+  const char *escape = memchr(text + start, mark, end - start);
+  if (!escape) {
+    string->text = text + start;
+    string->length = end - start;
+    return true;
+  }
+
+  Output output = {buffer, capacity, 0};
+  uint32_t i = start;
+  while (escape) {
+    uint32_t at = (uint32_t)(escape - text);
+    char decoded[4];
+    uint32_t size = 1;
+    if (!put(&output, text + i, at - i)) {
+      return false;
+    }
+    i = at + 1;
+    if (i == end) {
+      // A trailing caret stands for itself.
+      decoded[0] = mark;
+    } else if (mark == '^') {
+      size = decode_caret(text, end, &i, decoded);
+    } else {
+      size = decode_percent(text, end, &i, decoded);
+    }
+    if (!put(&output, decoded, size)) {
+      return false;
+    }
+    // Escapes often come in runs, such as `^(tab)^(tab)`.
+    if (i < end && text[i] == mark) {
+      escape = text + i;
+    } else {
+      escape = i < end ? memchr(text + i, mark, end - i) : NULL;
+    }
+  }
+  if (!put(&output, text + i, end - i)) {
+    return false;
+  }
+  string->text = buffer;
+  string->length = output.size;
+  return true;
+}
+
+bool tree_sitter_red_string_decode(const char *text, uint32_t length,
+                                   char *buffer, uint32_t capacity,
+                                   TSRedString *string) {
+  if (length < 2) {
+    return false;
+  }
+  char last = text[length - 1];
+  switch (text[0]) {
+  case '"':
+    return last == '"' &&
+           decode_body(text, 1, length - 1, '^', buffer, capacity, string);
+  case '{':
+    return last == '}' &&
+           decode_body(text, 1, length - 1, '^', buffer, capacity, string);
+  case '#':
+    return length >= 3 && text[1] == '"' && last == '"' &&
+           decode_body(text, 2, length - 1, '^', buffer, capacity, string);
+  case '%':
+    break;
+  default:
+    return false;
+  }
+
+  if (text[1] == '"') {
+    return length >= 3 && last == '"' &&
+           decode_body(text, 2, length - 1, '^', buffer, capacity, string);
+  }
+  if (text[1] != '{' && text[1] != '%') {
+    return decode_body(text, 1, length, '%', buffer, capacity, string);
+  }
+
+  // A raw string, %{...}% with as many percent signs on both ends.
+  uint32_t percents = 0;
+  while (percents < length && text[percents] == '%') {
+    percents++;
+  }
+  if (length < 2 * percents + 2 || text[percents] != '{' ||
+      text[length - percents - 1] != '}') {
+    return false;
+  }
+  for (uint32_t i = length - percents; i < length; i++) {
+    if (text[i] != '%') {
+      return false;
+    }
+  }
+  string->text = text + percents + 1;
+  string->length = length - 2 * percents - 2;
+  return true;
+}
@@ -0,0 +1,23 @@
+#include "tree_sitter/tree-sitter-red-strings.h"
+#include "tree_sitter/tree-sitter-red-symbols.h"
+
+#include <tree_sitter/api.h>
+
+bool tree_sitter_red_string_from_node(TSNode node, const char *source,
+                                      char *buffer, uint32_t capacity,
+                                      TSRedString *string) {
+  switch (ts_node_symbol(node)) {
+  case TSRedSymbolString:
+  case TSRedSymbolChar:
+  case TSRedSymbolFile:
+  case TSRedSymbolMultilineString:
+  case TSRedSymbolRawString:
+    break;
+  default:
+    return false;
+  }
+  uint32_t start = ts_node_start_byte(node);
+  return tree_sitter_red_string_decode(source + start,
+                                       ts_node_end_byte(node) - start, buffer,
+                                       capacity, string);
+}
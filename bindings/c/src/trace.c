@@ -0,0 +1,365 @@
+#include "tree_sitter/tree-sitter-red-trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool grow(void **items, uint32_t *capacity, uint32_t needed,
+                 size_t width) {
+  if (needed <= *capacity) {
+    return true;
+  }
+  uint32_t grown = *capacity ? *capacity : 64;
+  while (grown < needed) {
+    if (grown > UINT32_MAX / 2) {
+      return false;
+    }
+    grown *= 2;
+  }
+  void *resized = realloc(*items, grown * width);
+  if (!resized) {
+    return false;
+  }
+  *items = resized;
+  *capacity = grown;
+  return true;
+}
+
+bool tree_sitter_red_trace_set_source(TSRedTrace *trace, const char *path) {
+  char *copy = malloc(strlen(path) + 1);
+  if (!copy) {
+    return false;
+  }
+  strcpy(copy, path);
+  free(trace->source);
+  trace->source = copy;
+  return true;
+}
+
+static TSRedTracePoint advance(TSRedTracePoint point, const char *text,
+                               uint32_t length) {
+  const char *end = text + length;
+  for (const char *line; (line = memchr(text, '\n', (size_t)(end - text)));) {
+    point.row++;
+    point.column = 0;
+    text = line + 1;
+  }
+  point.column += (uint32_t)(end - text);
+  return point;
+}
+
+static bool push_edit(TSRedTrace *trace, const TSRedTraceEdit *edit,
+                      const char *text, uint32_t length) {
+  if (trace->text_size > UINT32_MAX - length ||
+      !grow((void **)&trace->edits, &trace->capacity, trace->count + 1,
+            sizeof(TSRedTraceEdit)) ||
+      !grow((void **)&trace->text, &trace->text_capacity,
+            trace->text_size + length, 1)) {
+    return false;
+  }
+  TSRedTraceEdit *added = &trace->edits[trace->count++];
+  *added = *edit;
+  added->text_offset = trace->text_size;
+  if (length) {
+    memcpy(trace->text + trace->text_size, text, length);
+  }
+  trace->text_size += length;
+  return true;
+}
+
+bool tree_sitter_red_trace_record(TSRedTrace *trace, const char *document,
+                                  uint32_t length, uint32_t start_byte,
+                                  uint32_t old_end_byte, const char *text,
+                                  uint32_t text_length, bool joined) {
+  if (start_byte > old_end_byte || old_end_byte > length ||
+      text_length > UINT32_MAX - start_byte) {
+    return false;
+  }
+  TSRedTraceEdit edit = {0};
+  edit.start_byte = start_byte;
+  edit.old_end_byte = old_end_byte;
+  edit.new_end_byte = start_byte + text_length;
+  edit.start_point = advance(edit.start_point, document, start_byte);
+  edit.old_end_point = advance(edit.start_point, document + start_byte,
+                               old_end_byte - start_byte);
+  edit.new_end_point = advance(edit.start_point, text, text_length);
+  edit.joined = joined && trace->count > 0;
+  return push_edit(trace, &edit, text, text_length);
+}
+
+bool tree_sitter_red_trace_apply(const TSRedTrace *trace,
+                                 const TSRedTraceEdit *edit, char **document,
+                                 uint32_t *length, uint32_t *capacity) {
+  uint32_t removed = edit->old_end_byte - edit->start_byte;
+  uint32_t inserted = edit->new_end_byte - edit->start_byte;
+  if (edit->start_byte > edit->old_end_byte ||
+      edit->start_byte > edit->new_end_byte || edit->old_end_byte > *length ||
+      inserted > UINT32_MAX - (*length - removed)) {
+    return false;
+  }
+  uint32_t new_length = *length - removed + inserted;
+  if (!grow((void **)document, capacity, new_length, 1)) {
+    return false;
+  }
+  memmove(*document + edit->new_end_byte, *document + edit->old_end_byte,
+          *length - edit->old_end_byte);
+  if (inserted) {
+    memcpy(*document + edit->start_byte, trace->text + edit->text_offset,
+           inserted);
+  }
+  *length = new_length;
+  return true;
+}
+
+typedef struct {
+  char *data;
+  uint32_t size;
+  uint32_t capacity;
+} Buffer;
+
+static bool put(Buffer *buffer, const char *text, uint32_t length) {
+  if (length > UINT32_MAX - buffer->size ||
+      !grow((void **)&buffer->data, &buffer->capacity, buffer->size + length,
+            1)) {
+    return false;
+  }
+  memcpy(buffer->data + buffer->size, text, length);
+  buffer->size += length;
+  return true;
+}
+
+static bool put_quoted(Buffer *buffer, const char *text, uint32_t length) {
+  if (!put(buffer, "\"", 1)) {
+    return false;
+  }
+  uint32_t run = 0;
+  for (uint32_t i = 0; i < length; i++) {
+    unsigned char c = (unsigned char)text[i];
+    char escape[5];
+    uint32_t escape_length = 2;
+    escape[0] = '\\';
+    switch (c) {
+    case '"':
+    case '\\':
+      escape[1] = (char)c;
+      break;
+    case '\n':
+      escape[1] = 'n';
+      break;
+    case '\t':
+      escape[1] = 't';
+      break;
+    case '\r':
+      escape[1] = 'r';
+      break;
+    default:
+      if (c >= 0x20 && c != 0x7f) {
+        continue;
+      }
+      snprintf(escape, sizeof(escape), "\\x%02x", c);
+      escape_length = 4;
+      break;
+    }
+    if (!put(buffer, text + run, i - run) ||
+        !put(buffer, escape, escape_length)) {
+      return false;
+    }
+    run = i + 1;
+  }
+  return put(buffer, text + run, length - run) && put(buffer, "\"\n", 2);
+}
+
+bool tree_sitter_red_trace_encode(const TSRedTrace *trace, char **data,
+                                  size_t *size) {
+  Buffer buffer = {0};
+  char line[160];
+  bool ok = true;
+  if (trace->source) {
+    ok = put(&buffer, "source ", 7) &&
+         put(&buffer, trace->source, (uint32_t)strlen(trace->source)) &&
+         put(&buffer, "\n", 1);
+  }
+  for (uint32_t i = 0; ok && i < trace->count; i++) {
+    const TSRedTraceEdit *edit = &trace->edits[i];
+    int length =
+        snprintf(line, sizeof(line), "%s %u %u %u %u:%u %u:%u %u:%u ",
+                 edit->joined ? "also" : "edit", edit->start_byte,
+                 edit->old_end_byte, edit->new_end_byte, edit->start_point.row,
+                 edit->start_point.column, edit->old_end_point.row,
+                 edit->old_end_point.column, edit->new_end_point.row,
+                 edit->new_end_point.column);
+    ok = put(&buffer, line, (uint32_t)length) &&
+         put_quoted(&buffer, trace->text + edit->text_offset,
+                    edit->new_end_byte - edit->start_byte);
+  }
+  if (!ok) {
+    free(buffer.data);
+    return false;
+  }
+  *data = buffer.data;
+  *size = buffer.size;
+  return true;
+}
+
+typedef struct {
+  const char *p;
+  const char *end;
+} Reader;
+
+static bool read_number(Reader *reader, uint32_t *value) {
+  uint64_t number = 0;
+  const char *start = reader->p;
+  while (reader->p < reader->end && *reader->p >= '0' && *reader->p <= '9') {
+    number = number * 10 + (uint64_t)(*reader->p++ - '0');
+    if (number > UINT32_MAX) {
+      return false;
+    }
+  }
+  *value = (uint32_t)number;
+  return reader->p > start;
+}
+
+static bool read_char(Reader *reader, char c) {
+  if (reader->p < reader->end && *reader->p == c) {
+    reader->p++;
+    return true;
+  }
+  return false;
+}
+
+static bool read_point(Reader *reader, TSRedTracePoint *point) {
+  return read_number(reader, &point->row) && read_char(reader, ':') &&
+         read_number(reader, &point->column) && read_char(reader, ' ');
+}
+
+static int hex_digit(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+}
+
+// Unescape the quoted text at the reader into `buffer`.
+static bool read_quoted(Reader *reader, Buffer *buffer) {
+  if (!read_char(reader, '"')) {
+    return false;
+  }
+  while (reader->p < reader->end && *reader->p != '"') {
+    char c = *reader->p++;
+    if (c == '\n') {
+      return false;
+    }
+    if (c == '\\') {
+      if (reader->p == reader->end) {
+        return false;
+      }
+      switch (c = *reader->p++) {
+      case 'n':
+        c = '\n';
+        break;
+      case 't':
+        c = '\t';
+        break;
+      case 'r':
+        c = '\r';
+        break;
+      case 'x': {
+        int high = reader->end - reader->p >= 2 ? hex_digit(reader->p[0]) : -1;
+        int low = high >= 0 ? hex_digit(reader->p[1]) : -1;
+        if (low < 0) {
+          return false;
+        }
+        c = (char)(high * 16 + low);
+        reader->p += 2;
+        break;
+      }
+      case '"':
+      case '\\':
+        break;
+      default:
+        return false;
+      }
+    }
+    if (!put(buffer, &c, 1)) {
+      return false;
+    }
+  }
+  return read_char(reader, '"');
+}
+
+static bool read_edit(Reader *reader, TSRedTrace *trace, Buffer *text,
+                      bool joined) {
+  TSRedTraceEdit edit = {0};
+  text->size = 0;
+  if (!read_number(reader, &edit.start_byte) || !read_char(reader, ' ') ||
+      !read_number(reader, &edit.old_end_byte) || !read_char(reader, ' ') ||
+      !read_number(reader, &edit.new_end_byte) || !read_char(reader, ' ') ||
+      !read_point(reader, &edit.start_point) ||
+      !read_point(reader, &edit.old_end_point) ||
+      !read_point(reader, &edit.new_end_point) || !read_quoted(reader, text) ||
+      edit.start_byte > edit.old_end_byte ||
+      edit.new_end_byte < edit.start_byte ||
+      edit.new_end_byte - edit.start_byte != text->size) {
+    return false;
+  }
+  edit.joined = joined;
+  return push_edit(trace, &edit, text->data, text->size);
+}
+
+bool tree_sitter_red_trace_decode(const char *data, size_t size,
+                                  TSRedTrace *trace, uint32_t *line) {
+  memset(trace, 0, sizeof(*trace));
+  Reader reader = {data, data + size};
+  Buffer text = {0};
+  *line = 0;
+  while (reader.p < reader.end) {
+    const char *newline = memchr(reader.p, '\n', (size_t)(reader.end - reader.p));
+    const char *end = newline ? newline : reader.end;
+    size_t length = (size_t)(end - reader.p);
+    bool ok = true;
+    ++*line;
+    if (length == 0 || reader.p[0] == '#') {
+      reader.p = end;
+    } else if (length > 7 && memcmp(reader.p, "source ", 7) == 0 &&
+               trace->count == 0 && !trace->source) {
+      char *path = malloc(length - 6);
+      if ((ok = path != NULL)) {
+        memcpy(path, reader.p + 7, length - 7);
+        path[length - 7] = '\0';
+        trace->source = path;
+      }
+      reader.p = end;
+    } else if (length > 5 && (memcmp(reader.p, "edit ", 5) == 0 ||
+                              (memcmp(reader.p, "also ", 5) == 0 &&
+                               trace->count > 0))) {
+      bool joined = reader.p[0] == 'a';
+      reader.p += 5;
+      Reader fields = {reader.p, end};
+      ok = read_edit(&fields, trace, &text, joined) && fields.p == end;
+      reader.p = end;
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      free(text.data);
+      tree_sitter_red_trace_delete(trace);
+      return false;
+    }
+    if (newline) {
+      reader.p++;
+    }
+  }
+  free(text.data);
+  *line = 0;
+  return true;
+}
+
+void tree_sitter_red_trace_delete(TSRedTrace *trace) {
+  free(trace->source);
+  free(trace->edits);
+  free(trace->text);
+  memset(trace, 0, sizeof(*trace));
+}
@@ -0,0 +1,67 @@
+#include "tree_sitter/tree-sitter-red-walk.h"
+
+bool tree_sitter_red_walk(TSNode node, const TSRedWalker *walker) {
+  TSTreeCursor cursor = ts_tree_cursor_new(node);
+  uint32_t depth = 0;
+  bool finished = true;
+  for (;;) {
+    TSNode current = ts_tree_cursor_current_node(&cursor);
+    TSRedWalkAction action = walker->enter(walker->payload, current, depth);
+    if (action == TSRedWalkStop) {
+      finished = false;
+      break;
+    }
+    if (action == TSRedWalkInto) {
+      if (ts_tree_cursor_goto_first_child(&cursor)) {
+        depth++;
+        continue;
+      }
+      if (walker->leave) {
+        walker->leave(walker->payload, current, depth);
+      }
+    }
+    // The cursor cannot leave the node it started from, so the walk ends
+    // when it is back there.
+    while (depth > 0 && !ts_tree_cursor_goto_next_sibling(&cursor)) {
+      ts_tree_cursor_goto_parent(&cursor);
+      depth--;
+      if (walker->leave) {
+        walker->leave(walker->payload, ts_tree_cursor_current_node(&cursor),
+                      depth);
+      }
+    }
+    if (depth == 0) {
+      break;
+    }
+  }
+  ts_tree_cursor_delete(&cursor);
+  return finished;
+}
+
+TSRedTreeShape tree_sitter_red_tree_shape(TSNode node) {
+  TSRedTreeShape shape = {0, 0, 0, 0};
+  TSTreeCursor cursor = ts_tree_cursor_new(node);
+  uint32_t depth = 0;
+  for (;;) {
+    TSNode current = ts_tree_cursor_current_node(&cursor);
+    uint32_t children = ts_node_child_count(current);
+    shape.nodes++;
+    shape.named_nodes += ts_node_is_named(current);
+    shape.depth = depth > shape.depth ? depth : shape.depth;
+    shape.max_children =
+        children > shape.max_children ? children : shape.max_children;
+    if (ts_tree_cursor_goto_first_child(&cursor)) {
+      depth++;
+      continue;
+    }
+    while (depth > 0 && !ts_tree_cursor_goto_next_sibling(&cursor)) {
+      ts_tree_cursor_goto_parent(&cursor);
+      depth--;
+    }
+    if (depth == 0) {
+      break;
+    }
+  }
+  ts_tree_cursor_delete(&cursor);
+  return shape;
+}
@@ -0,0 +1,167 @@
+#include "tree_sitter/tree-sitter-red-binary.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static uint8_t buffer[4096];
+
+static bool decodes_to(const char *text, const char *bytes, uint32_t count) {
+  uint32_t size;
+  return tree_sitter_red_binary_decode(text, (uint32_t)strlen(text), buffer,
+                                       sizeof(buffer), &size) &&
+         size == count && memcmp(buffer, bytes, count) == 0;
+}
+
+#define DECODES_TO(text, bytes) decodes_to(text, bytes, sizeof(bytes) - 1)
+
+static bool rejects(const char *text) {
+  uint32_t size;
+  return !tree_sitter_red_binary_decode(text, (uint32_t)strlen(text), buffer,
+                                        sizeof(buffer), &size);
+}
+
+static uint32_t next_random(void) {
+  static uint64_t state = 0x9e3779b97f4a7c15u;
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return (uint32_t)(state >> 32);
+}
+
+// Append a digit, and sometimes whitespace or a comment after it.
+static void append(char *text, uint32_t *length, char digit) {
+  text[(*length)++] = digit;
+  switch (next_random() % 64) {
+  case 0:
+    text[(*length)++] = ' ';
+    break;
+  case 1:
+    memcpy(text + *length, "\r\n\t", 3);
+    *length += 3;
+    break;
+  case 2:
+    memcpy(text + *length, " ; a ^{comment} 0F\n", 19);
+    *length += 19;
+    break;
+  }
+}
+
+// Random bytes in each base, with digits in runs long enough for the
+// blocks and runs broken up by whitespace and comments.
+static void test_random(void) {
+  static const char hex[] = "0123456789abcdef0123456789ABCDEF";
+  static const char base64[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  static char text[40000];
+  uint8_t bytes[1024];
+
+  for (int round = 0; round < 3000; round++) {
+    uint32_t count = next_random() % sizeof(bytes);
+    for (uint32_t i = 0; i < count; i++) {
+      bytes[i] = (uint8_t)next_random();
+    }
+    int base = round % 3 == 0 ? 16 : round % 3 == 1 ? 64 : 2;
+    uint32_t length = (uint32_t)sprintf(text, "%s#{", round % 6 ? "" : "16");
+    if (base != 16) {
+      length = (uint32_t)sprintf(text, "%d#{", base);
+    }
+    if (base == 16) {
+      for (uint32_t i = 0; i < count; i++) {
+        append(text, &length, hex[(bytes[i] >> 4) + (next_random() & 16)]);
+        append(text, &length, hex[(bytes[i] & 15) + (next_random() & 16)]);
+      }
+    } else if (base == 2) {
+      for (uint32_t i = 0; i < count; i++) {
+        for (int bit = 7; bit >= 0; bit--) {
+          append(text, &length, (char)('0' + ((bytes[i] >> bit) & 1)));
+        }
+      }
+    } else {
+      for (uint32_t i = 0; i < count; i += 3) {
+        uint32_t group = (uint32_t)bytes[i] << 16 |
+                         (i + 1 < count ? (uint32_t)bytes[i + 1] << 8 : 0) |
+                         (i + 2 < count ? bytes[i + 2] : 0);
+        uint32_t digits = count - i >= 3 ? 4 : count - i + 1;
+        for (uint32_t d = 0; d < digits; d++) {
+          append(text, &length, base64[(group >> (18 - 6 * d)) & 63]);
+        }
+        for (uint32_t d = digits; d < 4 && round % 2; d++) {
+          text[length++] = '=';
+        }
+      }
+    }
+    text[length++] = '}';
+
+    uint32_t size;
+    if (!tree_sitter_red_binary_decode(text, length, buffer, sizeof(buffer),
+                                       &size) ||
+        size != count || memcmp(buffer, bytes, count) != 0) {
+      fprintf(stderr, "cannot decode %.*s\n", (int)length, text);
+      failures++;
+      return;
+    }
+  }
+}
+
+int main(void) {
+  CHECK(DECODES_TO("#{}", ""));
+  CHECK(DECODES_TO("#{CAFEbabe}", "\xca\xfe\xba\xbe"));
+  CHECK(DECODES_TO("16#{00 ff ; a comment\n 80}", "\x00\xff\x80"));
+  CHECK(DECODES_TO("#{\n\t80 80 ;-- 07h\r\n\t40 40 ;-- 0Fh\n}",
+                   "\x80\x80\x40\x40"));
+  CHECK(DECODES_TO("#{8 0}", "\x80"));
+  CHECK(DECODES_TO("2#{0000 11 11}", "\x0f"));
+  CHECK(DECODES_TO("2#{\n00 1 1\n11\n01\n\n}", "\x3d"));
+  CHECK(DECODES_TO("64#{SGVsbG8gTmljZSBXb3JsZCE=}", "Hello Nice World!"));
+  CHECK(DECODES_TO("64#{SGVsbG8gTh}", "Hello N"));
+  CHECK(DECODES_TO("64#{////////////////}",
+                   "\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff"));
+  CHECK(DECODES_TO("64#{QQ==}", "A"));
+  CHECK(DECODES_TO("64#{QUI=\n}", "AB"));
+  CHECK(DECODES_TO("64#{QUJD ; ABC\n REVG}", "ABCDEF"));
+  // Sixteen-digit lines, as blocks of 12 bytes.
+  CHECK(DECODES_TO("64#{QUJDREVGR0hJSktM\nTU5PUFFSU1RVVldY\n}",
+                   "ABCDEFGHIJKLMNOPQRSTUVWX"));
+  // A thirty-two-digit line, as a block of 16 bytes.
+  CHECK(DECODES_TO("#{000102030405060708090A0B0C0D0E0F}",
+                   "\x00\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a\x0b\x0c\x0d"
+                   "\x0e\x0f"));
+
+  CHECK(rejects(""));
+  CHECK(rejects("#{"));
+  CHECK(rejects("#{ABC}"));
+  CHECK(rejects("#{GG}"));
+  CHECK(rejects("#{00112233445566778899aabbccddeeGG}"));
+  CHECK(rejects("2#{0101}"));
+  CHECK(rejects("2#{01012101}"));
+  CHECK(rejects("64#{Q}"));
+  CHECK(rejects("64#{QQ===}"));
+  CHECK(rejects("64#{QUJD=}"));
+  CHECK(rejects("64#{QQ=A}"));
+  CHECK(rejects("64#{QUJDREVGR0hJSkt-}"));
+  CHECK(rejects("8#{00}"));
+  CHECK(rejects("#[00]"));
+
+  // The buffer must hold every byte.
+  uint32_t size;
+  static const char block[] = "#{000102030405060708090A0B0C0D0E0F1011}";
+  CHECK(tree_sitter_red_binary_decode(block, sizeof(block) - 1, buffer, 18,
+                                      &size) &&
+        size == 18);
+  CHECK(!tree_sitter_red_binary_decode(block, sizeof(block) - 1, buffer, 17,
+                                       &size));
+
+  test_random();
+  return failures ? 1 : 0;
+}
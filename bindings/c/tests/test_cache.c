@@ -0,0 +1,191 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-red-cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static void check_hash(void) {
+  static const char text[] = "Red [] print \"hello\" repeat i 10 [probe i]";
+  uint64_t seen[sizeof(text)];
+  for (size_t length = 0; length < sizeof(text); length++) {
+    seen[length] = tree_sitter_red_hash(text, length, 0);
+    CHECK(seen[length] == tree_sitter_red_hash(text, length, 0));
+    CHECK(seen[length] != tree_sitter_red_hash(text, length, 1));
+    for (size_t i = 0; i < length; i++) {
+      CHECK(seen[i] != seen[length]);
+    }
+  }
+}
+
+#ifndef _WIN32
+
+static bool has(TSRedCache *cache, uint64_t hash, uint32_t kind,
+                const char *expected) {
+  uint8_t *value;
+  size_t length;
+  if (!tree_sitter_red_cache_get(cache, hash, kind, &value, &length)) {
+    return false;
+  }
+  bool same = length == strlen(expected) && memcmp(value, expected, length) == 0;
+  free(value);
+  return same;
+}
+
+static void check_store(const char *directory) {
+  TSRedCache *cache = tree_sitter_red_cache_open(directory, 0);
+  CHECK(cache != NULL);
+  if (!cache) {
+    return;
+  }
+  CHECK(!has(cache, 1, TSRedCacheErrors, ""));
+  CHECK(tree_sitter_red_cache_put(cache, 1, TSRedCacheErrors, "none", 4));
+  CHECK(tree_sitter_red_cache_put(cache, 1, TSRedCacheOutline, "main", 4));
+  CHECK(tree_sitter_red_cache_put(cache, 2, TSRedCacheErrors, "", 0));
+  CHECK(has(cache, 1, TSRedCacheErrors, "none"));
+  CHECK(has(cache, 1, TSRedCacheOutline, "main"));
+  CHECK(has(cache, 2, TSRedCacheErrors, ""));
+  CHECK(!has(cache, 2, TSRedCacheOutline, ""));
+
+  // A second handle sees what the first one appends, and later puts win.
+  TSRedCache *other = tree_sitter_red_cache_open(directory, 0);
+  CHECK(other && has(other, 1, TSRedCacheErrors, "none"));
+  CHECK(tree_sitter_red_cache_put(cache, 1, TSRedCacheErrors, "1:1", 3));
+  CHECK(other && has(other, 1, TSRedCacheErrors, "1:1"));
+
+  // ... and follows a compaction that replaced the store.
+  CHECK(tree_sitter_red_cache_compact(cache));
+  CHECK(tree_sitter_red_cache_put(cache, 3, TSRedCacheSymbols, "f", 1));
+  CHECK(other && has(other, 3, TSRedCacheSymbols, "f"));
+  CHECK(other && has(other, 1, TSRedCacheOutline, "main"));
+  tree_sitter_red_cache_close(other);
+  tree_sitter_red_cache_close(cache);
+
+  // Entries persist.
+  cache = tree_sitter_red_cache_open(directory, 0);
+  CHECK(cache && has(cache, 3, TSRedCacheSymbols, "f"));
+  CHECK(cache && has(cache, 1, TSRedCacheErrors, "1:1"));
+  tree_sitter_red_cache_close(cache);
+
+  // A corrupted value reads as a miss.
+  char path[512];
+  snprintf(path, sizeof(path), "%s/entries.rdc", directory);
+  remove(path);
+  cache = tree_sitter_red_cache_open(directory, 0);
+  CHECK(cache && tree_sitter_red_cache_put(cache, 4, TSRedCacheUser, "ok", 2));
+  tree_sitter_red_cache_close(cache);
+  FILE *file = fopen(path, "r+b");
+  CHECK(file != NULL);
+  if (file) {
+    fseek(file, -1, SEEK_END);
+    fputc('K', file);
+    fclose(file);
+  }
+  cache = tree_sitter_red_cache_open(directory, 0);
+  CHECK(cache && !has(cache, 4, TSRedCacheUser, "oK"));
+  CHECK(cache && !has(cache, 4, TSRedCacheUser, "ok"));
+  tree_sitter_red_cache_close(cache);
+  remove(path);
+
+  // A put cut short, as by a writer that crashed, hides none of the records
+  // appended after it, and neither does a compaction.
+  char value[100];
+  memset(value, 'x', sizeof(value));
+  cache = tree_sitter_red_cache_open(directory, 0);
+  CHECK(cache && tree_sitter_red_cache_put(cache, 5, TSRedCacheUser, value,
+                                           sizeof(value)));
+  tree_sitter_red_cache_close(cache);
+  struct stat st;
+  CHECK(stat(path, &st) == 0 && truncate(path, st.st_size - 50) == 0);
+  cache = tree_sitter_red_cache_open(directory, 0);
+  CHECK(cache && tree_sitter_red_cache_put(cache, 6, TSRedCacheUser, "a", 1));
+  CHECK(cache && has(cache, 6, TSRedCacheUser, "a"));
+  CHECK(cache && !has(cache, 5, TSRedCacheUser, ""));
+  CHECK(cache && tree_sitter_red_cache_compact(cache));
+  tree_sitter_red_cache_close(cache);
+  cache = tree_sitter_red_cache_open(directory, 0);
+  CHECK(cache && has(cache, 6, TSRedCacheUser, "a"));
+  tree_sitter_red_cache_close(cache);
+  remove(path);
+}
+
+static void check_eviction(const char *directory) {
+  const uint64_t limit = 8192;
+  TSRedCache *cache = tree_sitter_red_cache_open(directory, limit);
+  CHECK(cache != NULL);
+  if (!cache) {
+    return;
+  }
+  char value[100];
+  memset(value, 'x', sizeof(value));
+  CHECK(tree_sitter_red_cache_put(cache, 0, TSRedCacheTree, value, 100));
+  for (uint64_t hash = 1; hash < 200; hash++) {
+    CHECK(tree_sitter_red_cache_put(cache, hash, TSRedCacheTree, value, 100));
+    // Keep the first entry in use.
+    uint8_t *data;
+    size_t length;
+    CHECK(tree_sitter_red_cache_get(cache, 0, TSRedCacheTree, &data, &length));
+    free(data);
+  }
+  CHECK(!tree_sitter_red_cache_put(cache, 999, TSRedCacheTree, value,
+                                   sizeof(value) * 100));
+  tree_sitter_red_cache_close(cache);
+
+  char path[512];
+  snprintf(path, sizeof(path), "%s/entries.rdc", directory);
+  struct stat st;
+  CHECK(stat(path, &st) == 0 && (uint64_t)st.st_size <= limit);
+
+  cache = tree_sitter_red_cache_open(directory, limit);
+  char expected[101];
+  memset(expected, 'x', 100);
+  expected[100] = '\0';
+  CHECK(cache && has(cache, 0, TSRedCacheTree, expected));
+  CHECK(cache && has(cache, 199, TSRedCacheTree, expected));
+  CHECK(cache && !has(cache, 1, TSRedCacheTree, expected));
+
+  // Hits alone, which append touches, keep the store in its limit too.
+  for (int i = 0; cache && i < 1000; i++) {
+    uint8_t *data;
+    size_t length;
+    CHECK(tree_sitter_red_cache_get(cache, 199, TSRedCacheTree, &data,
+                                    &length));
+    free(data);
+  }
+  tree_sitter_red_cache_close(cache);
+  CHECK(stat(path, &st) == 0 && (uint64_t)st.st_size <= limit);
+  cache = tree_sitter_red_cache_open(directory, limit);
+  CHECK(cache && has(cache, 199, TSRedCacheTree, expected));
+  tree_sitter_red_cache_close(cache);
+  remove(path);
+}
+
+#endif
+
+int main(void) {
+  check_hash();
+#ifndef _WIN32
+  char directory[] = "/tmp/test-cache-XXXXXX";
+  CHECK(mkdtemp(directory) != NULL);
+  check_store(directory);
+  check_eviction(directory);
+  rmdir(directory);
+#endif
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-red-columns.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#endif
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static bool is_tuple(const char *text, const char *bytes, uint8_t count) {
+  uint8_t decoded[12], decoded_count;
+  return tree_sitter_red_tuple_decode(text, (uint32_t)strlen(text), decoded,
+                                      &decoded_count) &&
+         decoded_count == count && memcmp(decoded, bytes, count) == 0;
+}
+
+static bool is_ipv6(const char *text, const char *address, uint8_t prefix,
+                    const char *zone) {
+  TSRedIpv6 ipv6;
+  return tree_sitter_red_ipv6_decode(text, (uint32_t)strlen(text), &ipv6) &&
+         memcmp(ipv6.address, address, 16) == 0 && ipv6.prefix == prefix &&
+         ipv6.zone_length == strlen(zone) &&
+         memcmp(ipv6.zone ? ipv6.zone : "", zone, ipv6.zone_length) == 0;
+}
+
+static bool rejects_ipv6(const char *text) {
+  TSRedIpv6 ipv6;
+  return !tree_sitter_red_ipv6_decode(text, (uint32_t)strlen(text), &ipv6);
+}
+
+static bool text_is(const TSRedStringColumn *column, uint32_t row,
+                    const char *text) {
+  uint32_t start = column->offsets[row], end = column->offsets[row + 1];
+  return end - start == strlen(text) &&
+         memcmp(column->data + start, text, end - start) == 0;
+}
+
+static bool push(TSRedLiteralColumns *columns, TSRedSymbol symbol,
+                 uint32_t file, uint32_t start_byte, const char *text) {
+  return tree_sitter_red_columns_push(columns, symbol, file, start_byte, text,
+                                      (uint32_t)strlen(text));
+}
+
+#ifndef _WIN32
+// Random addresses, written by inet_ntop with its `::` and IPv4 forms.
+static void test_random_addresses(void) {
+  srand(7);
+  for (int round = 0; round < 100000; round++) {
+    uint8_t address[16];
+    for (int i = 0; i < 16; i++) {
+      // Mostly zeros, so that there are gaps to compress.
+      address[i] = rand() % 3 ? 0 : (uint8_t)rand();
+    }
+    char text[INET6_ADDRSTRLEN];
+    inet_ntop(AF_INET6, address, text, sizeof(text));
+    TSRedIpv6 ipv6;
+    if (!tree_sitter_red_ipv6_decode(text, (uint32_t)strlen(text), &ipv6) ||
+        memcmp(ipv6.address, address, 16) != 0) {
+      fprintf(stderr, "cannot decode %s\n", text);
+      failures++;
+      return;
+    }
+  }
+}
+#endif
+
+int main(void) {
+  CHECK(is_tuple("1.2.3", "\x01\x02\x03", 3));
+  CHECK(is_tuple("192.168.0.1", "\xc0\xa8\x00\x01", 4));
+  CHECK(is_tuple("255.0.255.128", "\xff\x00\xff\x80", 4));
+  CHECK(is_tuple("1.2.3.4.5.6.7.8.9.10.11.12",
+                 "\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a\x0b\x0c", 12));
+  CHECK(is_tuple("000.01.1", "\x00\x01\x01", 3));
+  uint8_t bytes[12], count;
+  CHECK(!tree_sitter_red_tuple_decode("1.2", 3, bytes, &count));
+  CHECK(!tree_sitter_red_tuple_decode("1.2.256", 7, bytes, &count));
+  CHECK(!tree_sitter_red_tuple_decode("1.2.3.", 6, bytes, &count));
+  CHECK(!tree_sitter_red_tuple_decode("1..3", 4, bytes, &count));
+  CHECK(!tree_sitter_red_tuple_decode("1.2.3.4.5.6.7.8.9.10.11.12.13", 29,
+                                      bytes, &count));
+
+  static const char loopback[16] = {[15] = 1};
+  static const char link_local[16] = {(char)0xfe, (char)0x80, [15] = 1};
+  static const char mapped[16] = {[10] = (char)0xff, (char)0xff,
+                                  (char)192,  (char)168,
+                                  0,          1};
+  static const char full[16] = {0x20, 0x01, 0x0d, (char)0xb8, 0, 1, 0, 2,
+                                0,    3,    0,    4,          0, 5, 0, 6};
+  CHECK(is_ipv6("::1", loopback, TREE_SITTER_RED_NO_PREFIX, ""));
+  CHECK(is_ipv6("fe80::1%eth0/64", link_local, 64, "eth0"));
+  CHECK(is_ipv6("FE80:0:0:0:0:0:0:1%1", link_local, TREE_SITTER_RED_NO_PREFIX,
+                "1"));
+  CHECK(is_ipv6("::ffff:192.168.0.1/128", mapped, 128, ""));
+  CHECK(is_ipv6("0:0:0:0:0:ffff:192.168.0.1", mapped,
+                TREE_SITTER_RED_NO_PREFIX, ""));
+  CHECK(is_ipv6("2001:db8:1:2:3:4:5:6", full, TREE_SITTER_RED_NO_PREFIX, ""));
+  CHECK(is_ipv6("2001:db8:1:2:3:4:0.5.0.6", full, TREE_SITTER_RED_NO_PREFIX,
+                ""));
+  CHECK(is_ipv6("::", (const char[16]){0}, TREE_SITTER_RED_NO_PREFIX, ""));
+  CHECK(is_ipv6("::/0", (const char[16]){0}, 0, ""));
+  CHECK(rejects_ipv6("1:2:3:4:5:6:7"));
+  CHECK(rejects_ipv6("1:2:3:4:5:6:7:8:9"));
+  CHECK(rejects_ipv6("1::2::3"));
+  CHECK(rejects_ipv6("1:2:3:4:5:6:7:8::"));
+  CHECK(rejects_ipv6("12345::1"));
+  CHECK(rejects_ipv6(":1::2"));
+  CHECK(rejects_ipv6("1::2:"));
+  CHECK(rejects_ipv6("::1%"));
+  CHECK(rejects_ipv6("::1/129"));
+  CHECK(rejects_ipv6("::1/"));
+  CHECK(rejects_ipv6("::1/64x"));
+  CHECK(rejects_ipv6("1:2:3:4:5:6:7:1.2.3.4"));
+  CHECK(rejects_ipv6("::1.2.3"));
+  CHECK(rejects_ipv6("::1.2.3.256"));
+#ifndef _WIN32
+  test_random_addresses();
+#endif
+
+  // Rows go to the table of their type, with their file and offset.
+  TSRedLiteralColumns columns = {0};
+  CHECK(push(&columns, TSRedSymbolTuple, 0, 10, "192.168.0.1"));
+  CHECK(push(&columns, TSRedSymbolIpv6, 0, 30, "fe80::1%eth0/64"));
+  CHECK(push(&columns, TSRedSymbolIpv6, 1, 5, "::1"));
+  CHECK(push(&columns, TSRedSymbolUrl, 1, 40, "https://red-lang.org/x"));
+  CHECK(push(&columns, TSRedSymbolEmail, 2, 0, "team@red-lang.org"));
+  // Skipped.
+  CHECK(push(&columns, TSRedSymbolTuple, 2, 50, "1.2.999"));
+  CHECK(push(&columns, TSRedSymbolWord, 2, 60, "word"));
+  CHECK(columns.tuples.count == 1 && columns.ipv6.count == 2 &&
+        columns.urls.count == 1 && columns.emails.count == 1);
+  CHECK(columns.tuples.length[0] == 4 &&
+        memcmp(columns.tuples.bytes, "\xc0\xa8\x00\x01\0\0\0\0\0\0\0\0", 12) ==
+            0);
+  CHECK(columns.ipv6.file[1] == 1 && columns.ipv6.start_byte[1] == 5);
+  CHECK(memcmp(columns.ipv6.address + 16, loopback, 16) == 0);
+  CHECK(columns.ipv6.prefix[0] == 64 &&
+        columns.ipv6.prefix[1] == TREE_SITTER_RED_NO_PREFIX);
+  CHECK(text_is(&columns.ipv6.zone, 0, "eth0") &&
+        text_is(&columns.ipv6.zone, 1, ""));
+  CHECK(text_is(&columns.urls.text, 0, "https://red-lang.org/x") &&
+        columns.urls.head_length[0] == 5);
+  CHECK(text_is(&columns.emails.text, 0, "team@red-lang.org") &&
+        columns.emails.head_length[0] == 4 && columns.emails.file[0] == 2);
+
+  // Appending shifts the offsets of the string columns, and grows past the
+  // first capacity.
+  TSRedLiteralColumns merged = {0};
+  for (int i = 0; i < 100; i++) {
+    CHECK(tree_sitter_red_columns_append(&merged, &columns));
+  }
+  CHECK(merged.tuples.count == 100 && merged.ipv6.count == 200 &&
+        merged.urls.count == 100 && merged.emails.count == 100);
+  CHECK(text_is(&merged.ipv6.zone, 198, "eth0") &&
+        text_is(&merged.ipv6.zone, 199, ""));
+  CHECK(text_is(&merged.urls.text, 99, "https://red-lang.org/x") &&
+        merged.urls.text.offsets[100] == 100 * 22);
+  CHECK(merged.ipv6.start_byte[199] == 5 &&
+        memcmp(merged.ipv6.address + 16 * 199, loopback, 16) == 0);
+  TSRedLiteralColumns empty = {0};
+  CHECK(tree_sitter_red_columns_append(&merged, &empty));
+  CHECK(tree_sitter_red_columns_append(&empty, &(TSRedLiteralColumns){0}));
+  CHECK(empty.tuples.count == 0 && empty.tuples.file == NULL);
+
+  tree_sitter_red_columns_delete(&columns);
+  tree_sitter_red_columns_delete(&merged);
+  CHECK(merged.ipv6.count == 0 && merged.ipv6.address == NULL);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,66 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-red-columns.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tree_sitter/api.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static const char source[] =
+    "Red []\n"
+    "server: [host 192.168.0.1 ip fe80::1%eth0/64 color 255.128.0]\n"
+    "home: https://[2001:db8::1]:8080/ mail: team@red-lang.org\n";
+
+int main(void) {
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_red());
+  TSTree *tree =
+      ts_parser_parse_string(parser, NULL, source, sizeof(source) - 1);
+
+  TSRedLiteralColumns columns = {0};
+  CHECK(tree_sitter_red_columns_extract(tree, source, 7, &columns));
+  CHECK(columns.tuples.count == 2 && columns.tuples.length[0] == 4 &&
+        columns.tuples.length[1] == 3);
+  CHECK(columns.tuples.file[1] == 7 &&
+        strncmp(source + columns.tuples.start_byte[1], "255.128.0", 9) == 0);
+  // The address inside the url is part of the url.
+  CHECK(columns.ipv6.count == 1 && columns.ipv6.prefix[0] == 64);
+  CHECK(columns.urls.count == 1 && columns.urls.head_length[0] == 5);
+  CHECK(columns.emails.count == 1);
+  ts_tree_delete(tree);
+  ts_parser_delete(parser);
+
+  // Scanning keeps the order of the paths, whatever the threads do.
+  char path[] = "/tmp/test-columns-XXXXXX";
+  int fd = mkstemp(path);
+  FILE *file = fd >= 0 ? fdopen(fd, "w") : NULL;
+  CHECK(file && fwrite(source, 1, sizeof(source) - 1, file) ==
+                    sizeof(source) - 1);
+  if (file) {
+    fclose(file);
+  }
+  const char *paths[] = {path, "/nonexistent.red", path};
+  TSRedLiteralColumns scanned = {0};
+  CHECK(tree_sitter_red_columns_scan(paths, 3, 2, &scanned));
+  CHECK(scanned.tuples.count == 4 && scanned.tuples.file[0] == 0 &&
+        scanned.tuples.file[2] == 2);
+  CHECK(scanned.emails.count == 2 && scanned.emails.file[1] == 2);
+  remove(path);
+
+  tree_sitter_red_columns_delete(&columns);
+  tree_sitter_red_columns_delete(&scanned);
+  return failures ? 1 : 0;
+}
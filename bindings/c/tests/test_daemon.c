@@ -0,0 +1,151 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-red-daemon.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static void write_edit(TSRedMessage *message) {
+  tree_sitter_red_message_reset(message);
+  tree_sitter_red_message_put_u8(message, TSRedDaemonEdit);
+  tree_sitter_red_message_put_bytes(message, "a.red", 5);
+  tree_sitter_red_message_put_u32(message, 7);
+  tree_sitter_red_message_put_u32(message, 0x12345678);
+  tree_sitter_red_message_put_bytes(message, "", 0);
+  tree_sitter_red_message_put_u16(message, 0xbeef);
+}
+
+static void check_edit(const TSRedMessage *message) {
+  TSRedMessageReader reader = tree_sitter_red_message_reader(message);
+  uint32_t length;
+  CHECK(tree_sitter_red_message_get_u8(&reader) == TSRedDaemonEdit);
+  const uint8_t *name = tree_sitter_red_message_get_bytes(&reader, &length);
+  CHECK(length == 5 && memcmp(name, "a.red", 5) == 0);
+  CHECK(tree_sitter_red_message_get_u32(&reader) == 7);
+  CHECK(tree_sitter_red_message_get_u32(&reader) == 0x12345678);
+  tree_sitter_red_message_get_bytes(&reader, &length);
+  CHECK(length == 0);
+  CHECK(tree_sitter_red_message_get_u16(&reader) == 0xbeef);
+  CHECK(!reader.failed && reader.offset == reader.size);
+
+  // Reading past the end fails and yields zeros.
+  CHECK(tree_sitter_red_message_get_u32(&reader) == 0);
+  CHECK(reader.failed);
+}
+
+int main(void) {
+  TSRedMessage message;
+  tree_sitter_red_message_init(&message);
+  write_edit(&message);
+  check_edit(&message);
+
+  // A byte string whose length runs past the payload is rejected.
+  tree_sitter_red_message_reset(&message);
+  tree_sitter_red_message_put_u32(&message, 100);
+  tree_sitter_red_message_put_u8(&message, 'x');
+  TSRedMessageReader reader = tree_sitter_red_message_reader(&message);
+  uint32_t length;
+  CHECK(tree_sitter_red_message_get_bytes(&reader, &length) == NULL);
+  CHECK(length == 0 && reader.failed);
+
+#ifndef _WIN32
+  // Frames survive a socket, several to a connection.
+  int fds[2];
+  CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+  TSRedMessage received;
+  tree_sitter_red_message_init(&received);
+  write_edit(&message);
+  CHECK(tree_sitter_red_message_send(fds[0], &message));
+  CHECK(tree_sitter_red_message_send(fds[0], &message));
+  for (int i = 0; i < 2; i++) {
+    CHECK(tree_sitter_red_message_receive(fds[1], &received));
+    check_edit(&received);
+  }
+
+  // A call sends its request and reads the response into the same message.
+  tree_sitter_red_message_reset(&message);
+  tree_sitter_red_message_put_u8(&message, TSRedDaemonOk);
+  tree_sitter_red_message_put_u8(&message, 1);
+  CHECK(tree_sitter_red_message_send(fds[1], &message));
+  write_edit(&message);
+  CHECK(tree_sitter_red_daemon_call(fds[0], &message));
+  reader = tree_sitter_red_message_reader(&message);
+  CHECK(tree_sitter_red_message_get_u8(&reader) == TSRedDaemonOk);
+  CHECK(tree_sitter_red_message_get_u8(&reader) == 1);
+  CHECK(reader.offset == reader.size);
+  CHECK(tree_sitter_red_message_receive(fds[1], &received));
+  check_edit(&received);
+
+  // A frame read without blocking arrives in pieces, and memory follows the
+  // bytes that came rather than the length the frame claims.
+  CHECK(fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK) == 0);
+  size_t arrived = 0;
+  tree_sitter_red_message_reset(&received);
+  CHECK(tree_sitter_red_message_receive_some(fds[1], &received,
+                                             &arrived) == TSRedTransferPending);
+  static const uint8_t claim[] = {0, 0, 0, 1, 'x'};
+  CHECK(send(fds[0], claim, 2, 0) == 2);
+  CHECK(tree_sitter_red_message_receive_some(fds[1], &received,
+                                             &arrived) == TSRedTransferPending);
+  CHECK(arrived == 2);
+  CHECK(send(fds[0], claim + 2, 3, 0) == 3);
+  CHECK(tree_sitter_red_message_receive_some(fds[1], &received,
+                                             &arrived) == TSRedTransferPending);
+  CHECK(arrived == 5 && received.capacity < (1u << 20));
+  close(fds[0]);
+  CHECK(tree_sitter_red_message_receive_some(fds[1], &received,
+                                             &arrived) == TSRedTransferFailed);
+  close(fds[1]);
+
+  // A frame written without blocking reads back whole, and one over the
+  // limit fails as soon as its length is in.
+  CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+  CHECK(fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK) == 0);
+  write_edit(&message);
+  size_t sent = 0;
+  CHECK(tree_sitter_red_message_send_some(fds[0], &message, &sent) ==
+        TSRedTransferDone);
+  CHECK(sent == message.size);
+  arrived = 0;
+  tree_sitter_red_message_reset(&received);
+  CHECK(tree_sitter_red_message_receive_some(fds[1], &received,
+                                             &arrived) == TSRedTransferDone);
+  check_edit(&received);
+  static const uint8_t too_long[] = {0, 0, 0, 0x80};
+  CHECK(send(fds[0], too_long, 4, 0) == 4);
+  arrived = 0;
+  tree_sitter_red_message_reset(&received);
+  CHECK(tree_sitter_red_message_receive_some(fds[1], &received,
+                                             &arrived) == TSRedTransferFailed);
+  close(fds[0]);
+  close(fds[1]);
+  CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+  // A closed peer ends the connection.
+  close(fds[1]);
+  CHECK(!tree_sitter_red_message_receive(fds[0], &received));
+  close(fds[0]);
+  tree_sitter_red_message_delete(&received);
+
+  CHECK(tree_sitter_red_daemon_connect("/nonexistent/daemon.sock") < 0);
+#endif
+
+  tree_sitter_red_message_delete(&message);
+  return failures == 0 ? 0 : 1;
+}
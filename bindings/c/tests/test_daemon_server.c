@@ -0,0 +1,259 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-red-daemon.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static TSRedDaemon *server;
+static TSRedMessage request, response;
+
+static void begin(TSRedDaemonOp op, const char *name) {
+  tree_sitter_red_message_reset(&request);
+  tree_sitter_red_message_put_u8(&request, op);
+  if (name) {
+    tree_sitter_red_message_put_bytes(&request, name, (uint32_t)strlen(name));
+  }
+}
+
+static uint8_t handle(TSRedMessageReader *reader) {
+  TSRedMessageReader input = tree_sitter_red_message_reader(&request);
+  tree_sitter_red_daemon_handle(server, &input, &response);
+  *reader = tree_sitter_red_message_reader(&response);
+  return tree_sitter_red_message_get_u8(reader);
+}
+
+static void check_diagnostics(const char *name, bool expected) {
+  TSRedMessageReader reader;
+  begin(TSRedDaemonDiagnostics, name);
+  CHECK(handle(&reader) == TSRedDaemonOk);
+  uint32_t count = tree_sitter_red_message_get_u32(&reader);
+  CHECK((count > 0) == expected);
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t length;
+    tree_sitter_red_message_get_u8(&reader);
+    tree_sitter_red_message_get_bytes(&reader, &length);
+    for (int j = 0; j < 4; j++) {
+      tree_sitter_red_message_get_u32(&reader);
+    }
+  }
+  CHECK(!reader.failed && reader.offset == reader.size);
+}
+
+// The row of the first outline item of `name`.
+static uint32_t outline_row(const char *name) {
+  TSRedMessageReader reader;
+  begin(TSRedDaemonOutline, name);
+  CHECK(handle(&reader) == TSRedDaemonOk);
+  CHECK(tree_sitter_red_message_get_u32(&reader) > 0);
+  tree_sitter_red_message_get_u32(&reader);
+  tree_sitter_red_message_get_u32(&reader);
+  uint32_t row = tree_sitter_red_message_get_u32(&reader);
+  CHECK(!reader.failed);
+  return row;
+}
+
+// Serve from a child process, where a client that stalls part way through a
+// request must neither hold up another nor stay connected.
+static void check_serve(void) {
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/test-daemon-server-%ld.sock",
+           (long)getpid());
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strcpy(address.sun_path, path);
+  unlink(path);
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  CHECK(fd >= 0 && bind(fd, (struct sockaddr *)&address, sizeof(address)) == 0 &&
+        listen(fd, 16) == 0);
+  pid_t child = fork();
+  CHECK(child >= 0);
+  if (child == 0) {
+    TSRedDaemon *daemon = tree_sitter_red_daemon_new(NULL);
+    tree_sitter_red_daemon_set_idle_timeout(daemon, 200000);
+    _exit(daemon && tree_sitter_red_daemon_serve(daemon, fd) ? 0 : 1);
+  }
+  close(fd);
+
+  // A frame that claims 256 MiB and never comes.
+  int stalled = tree_sitter_red_daemon_connect(path);
+  static const uint8_t part[] = {0, 0, 0, 0x10, TSRedDaemonPing};
+  CHECK(send(stalled, part, sizeof(part), 0) == (ssize_t)sizeof(part));
+  int other = tree_sitter_red_daemon_connect(path);
+  TSRedMessage message;
+  tree_sitter_red_message_init(&message);
+  tree_sitter_red_message_put_u8(&message, TSRedDaemonPing);
+  CHECK(tree_sitter_red_daemon_call(other, &message));
+  TSRedMessageReader reader = tree_sitter_red_message_reader(&message);
+  CHECK(tree_sitter_red_message_get_u8(&reader) == TSRedDaemonOk);
+  char byte;
+  CHECK(recv(stalled, &byte, 1, 0) == 0);
+  close(stalled);
+
+  tree_sitter_red_message_reset(&message);
+  tree_sitter_red_message_put_u8(&message, TSRedDaemonShutdown);
+  CHECK(tree_sitter_red_daemon_call(other, &message));
+  close(other);
+  int status;
+  CHECK(waitpid(child, &status, 0) == child && WIFEXITED(status) &&
+        WEXITSTATUS(status) == 0);
+  tree_sitter_red_message_delete(&message);
+  unlink(path);
+}
+
+int main(void) {
+  signal(SIGPIPE, SIG_IGN);
+  check_serve();
+  server = tree_sitter_red_daemon_new(TREE_SITTER_RED_QUERIES_DIR);
+  CHECK(server != NULL);
+  if (!server) {
+    return 1;
+  }
+  tree_sitter_red_message_init(&request);
+  tree_sitter_red_message_init(&response);
+  TSRedMessageReader reader;
+
+  // A broken file, then an edit that fixes it.
+  static const char source[] = "Red []\nadd: func [a b] [a + b\n";
+  begin(TSRedDaemonParse, "add.red");
+  tree_sitter_red_message_put_bytes(&request, source, sizeof(source) - 1);
+  CHECK(handle(&reader) == TSRedDaemonOk);
+  CHECK(tree_sitter_red_message_get_u8(&reader) == 1);
+  check_diagnostics("add.red", true);
+
+  begin(TSRedDaemonEdit, "add.red");
+  tree_sitter_red_message_put_u32(&request, sizeof(source) - 2);
+  tree_sitter_red_message_put_u32(&request, sizeof(source) - 2);
+  tree_sitter_red_message_put_bytes(&request, "]", 1);
+  CHECK(handle(&reader) == TSRedDaemonOk);
+  CHECK(tree_sitter_red_message_get_u8(&reader) == 0);
+  check_diagnostics("add.red", false);
+
+  begin(TSRedDaemonOutline, "add.red");
+  CHECK(handle(&reader) == TSRedDaemonOk);
+  CHECK(tree_sitter_red_message_get_u32(&reader) == 1);
+  uint32_t start_byte = tree_sitter_red_message_get_u32(&reader);
+  tree_sitter_red_message_get_u32(&reader);
+  uint32_t row = tree_sitter_red_message_get_u32(&reader);
+  tree_sitter_red_message_get_u32(&reader);
+  uint32_t context_length, name_length;
+  const uint8_t *context =
+      tree_sitter_red_message_get_bytes(&reader, &context_length);
+  const uint8_t *name = tree_sitter_red_message_get_bytes(&reader, &name_length);
+  CHECK(start_byte == 7 && row == 1);
+  CHECK(context_length == 4 && memcmp(context, "func", 4) == 0);
+  CHECK(name_length == 4 && memcmp(name, "add:", 4) == 0);
+
+  // `func` is a keyword, and `a` only a variable.
+  begin(TSRedDaemonHighlights, "add.red");
+  tree_sitter_red_message_put_u32(&request, 0);
+  tree_sitter_red_message_put_u32(&request, UINT32_MAX);
+  CHECK(handle(&reader) == TSRedDaemonOk);
+  uint32_t name_count = tree_sitter_red_message_get_u32(&reader);
+  int keyword = -1;
+  for (uint32_t i = 0; i < name_count; i++) {
+    uint32_t length;
+    const uint8_t *capture = tree_sitter_red_message_get_bytes(&reader, &length);
+    if (length == 7 && memcmp(capture, "keyword", 7) == 0) {
+      keyword = (int)i;
+    }
+  }
+  CHECK(keyword >= 0);
+  uint32_t count = tree_sitter_red_message_get_u32(&reader);
+  bool func_is_keyword = false, a_is_keyword = false;
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t start = tree_sitter_red_message_get_u32(&reader);
+    tree_sitter_red_message_get_u32(&reader);
+    uint16_t capture = tree_sitter_red_message_get_u16(&reader);
+    if (capture == keyword) {
+      func_is_keyword |= start == 12;
+      a_is_keyword |= start == 18;
+    }
+  }
+  CHECK(func_is_keyword);
+  CHECK(!a_is_keyword);
+  CHECK(!reader.failed && reader.offset == reader.size);
+
+  // Edits that add and remove lines move what comes after them.
+  begin(TSRedDaemonEdit, "add.red");
+  tree_sitter_red_message_put_u32(&request, 7);
+  tree_sitter_red_message_put_u32(&request, 7);
+  tree_sitter_red_message_put_bytes(&request, "a: 1\nb: 2\n", 10);
+  CHECK(handle(&reader) == TSRedDaemonOk);
+  CHECK(tree_sitter_red_message_get_u8(&reader) == 0);
+  CHECK(outline_row("add.red") == 3);
+  begin(TSRedDaemonEdit, "add.red");
+  tree_sitter_red_message_put_u32(&request, 7);
+  tree_sitter_red_message_put_u32(&request, 12);
+  tree_sitter_red_message_put_bytes(&request, "", 0);
+  CHECK(handle(&reader) == TSRedDaemonOk);
+  CHECK(tree_sitter_red_message_get_u8(&reader) == 0);
+  CHECK(outline_row("add.red") == 2);
+
+  // Errors.
+  begin(TSRedDaemonDiagnostics, "other.red");
+  CHECK(handle(&reader) == TSRedDaemonUnknownFile);
+  begin(TSRedDaemonEdit, "add.red");
+  tree_sitter_red_message_put_u32(&request, 10);
+  tree_sitter_red_message_put_u32(&request, 5);
+  tree_sitter_red_message_put_bytes(&request, "", 0);
+  CHECK(handle(&reader) == TSRedDaemonBadRequest);
+  begin(TSRedDaemonParse, "add.red");
+  CHECK(handle(&reader) == TSRedDaemonBadRequest);
+  begin(99, NULL);
+  CHECK(handle(&reader) == TSRedDaemonBadRequest);
+
+  begin(TSRedDaemonClose, "add.red");
+  CHECK(handle(&reader) == TSRedDaemonOk);
+  begin(TSRedDaemonOutline, "add.red");
+  CHECK(handle(&reader) == TSRedDaemonUnknownFile);
+
+  // A parse past the timeout fails without keeping the file, and does not
+  // hold up the next one.
+  static const char line[] = "x: [1 2 3] print x\n";
+  uint32_t big_length = 20000 * (sizeof(line) - 1);
+  char *big = malloc(big_length);
+  CHECK(big != NULL);
+  if (big) {
+    for (uint32_t i = 0; i < 20000; i++) {
+      memcpy(big + i * (sizeof(line) - 1), line, sizeof(line) - 1);
+    }
+    tree_sitter_red_daemon_set_timeout(server, 1);
+    begin(TSRedDaemonParse, "big.red");
+    tree_sitter_red_message_put_bytes(&request, big, big_length);
+    CHECK(handle(&reader) == TSRedDaemonTimedOut);
+    begin(TSRedDaemonOutline, "big.red");
+    CHECK(handle(&reader) == TSRedDaemonUnknownFile);
+    free(big);
+  }
+  tree_sitter_red_daemon_set_timeout(server, 0);
+  begin(TSRedDaemonParse, "add.red");
+  tree_sitter_red_message_put_bytes(&request, source, sizeof(source) - 1);
+  CHECK(handle(&reader) == TSRedDaemonOk);
+
+  begin(TSRedDaemonShutdown, NULL);
+  TSRedMessageReader input = tree_sitter_red_message_reader(&request);
+  CHECK(!tree_sitter_red_daemon_handle(server, &input, &response));
+
+  tree_sitter_red_message_delete(&request);
+  tree_sitter_red_message_delete(&response);
+  tree_sitter_red_daemon_delete(server);
+  return failures == 0 ? 0 : 1;
+}
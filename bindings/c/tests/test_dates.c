@@ -0,0 +1,177 @@
+#include "tree_sitter/tree-sitter-red-dates.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static const char *const month_names[][3] = {
+    {"Jan", "January", "JAN"},   {"Feb", "February", "feb"},
+    {"Mar", "March", "MARCH"},   {"Apr", "April", "apr"},
+    {"May", "May", "MAY"},       {"Jun", "June", "jUNE"},
+    {"Jul", "July", "jul"},      {"Aug", "August", "AUG"},
+    {"Sep", "September", "Sept"}, {"Oct", "October", "oct"},
+    {"Nov", "November", "NOV"},  {"Dec", "December", "dec"},
+};
+
+static bool is_leap_year(int year) {
+  return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+}
+
+static int days_in_month(int year, int month) {
+  static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  return month == 2 && is_leap_year(year) ? 29 : days[month - 1];
+}
+
+// Expect `text` to decode to `epoch_seconds` and the given date.
+static void expect(const char *text, int64_t epoch_seconds, int year,
+                   int month, int day) {
+  TSRedDate date;
+  if (!tree_sitter_red_date_decode(text, (uint32_t)strlen(text), &date)) {
+    fprintf(stderr, "cannot decode %s\n", text);
+    failures++;
+  } else if (date.epoch_seconds != epoch_seconds || date.year != year ||
+             date.month != month || date.day != day) {
+    fprintf(stderr, "%s: %lld %d-%d-%d, not %lld %d-%d-%d\n", text,
+            (long long)date.epoch_seconds, date.year, date.month, date.day,
+            (long long)epoch_seconds, year, month, day);
+    failures++;
+  }
+}
+
+static bool rejects(const char *text) {
+  TSRedDate date;
+  TSRedTime time;
+  uint32_t length = (uint32_t)strlen(text);
+  return !tree_sitter_red_date_decode(text, length, &date) &&
+         !tree_sitter_red_time_decode(text, length, &time);
+}
+
+static bool is_time(const char *text, int64_t ns, uint8_t flags) {
+  TSRedTime time;
+  return tree_sitter_red_time_decode(text, (uint32_t)strlen(text), &time) &&
+         time.ns == ns && time.flags == flags;
+}
+
+// Every day from 0100-01-01 to 9999-12-31 in each form of the grammar's
+// `date` token, against a count of days that walks the calendar one day at
+// a time.
+static void test_every_day(void) {
+  // Days from 0100-01-01 to 1970-01-01.
+  int64_t offset = 0;
+  for (int year = 100; year < 1970; year++) {
+    offset += is_leap_year(year) ? 366 : 365;
+  }
+
+  int64_t days = -offset;
+  char text[64];
+  for (int year = 100; year <= 9999; year++) {
+    int ordinal = 0;
+    for (int month = 1; month <= 12; month++) {
+      for (int day = 1; day <= days_in_month(year, month); day++, days++) {
+        int64_t seconds = days * 86400;
+        ordinal++;
+        snprintf(text, sizeof(text), "%d-%d-%d", year, month, day);
+        expect(text, seconds, year, month, day);
+        if (year < 1900 || year > 2100) {
+          continue;
+        }
+        snprintf(text, sizeof(text), "%04d-%02d-%02d", year, month, day);
+        expect(text, seconds, year, month, day);
+        snprintf(text, sizeof(text), "%d/%d/%d", year, month, day);
+        expect(text, seconds, year, month, day);
+        snprintf(text, sizeof(text), "%d-%s-%d", day,
+                 month_names[month - 1][ordinal % 3], year);
+        expect(text, seconds, year, month, day);
+        snprintf(text, sizeof(text), "%02d/%02d/%d", day, month, year);
+        expect(text, seconds, year, month, day);
+        snprintf(text, sizeof(text), "%d-%03d", year, ordinal);
+        expect(text, seconds, year, month, day);
+        snprintf(text, sizeof(text), "%04d%02d%02dT000000Z", year, month, day);
+        expect(text, seconds, year, month, day);
+        if (year >= 1950 && year < 2050) {
+          snprintf(text, sizeof(text), "%d-%s-%02d", day,
+                   month_names[month - 1][0], year % 100);
+          expect(text, seconds, year, month, day);
+        }
+
+        // The ISO week, when it is in the same year.
+        int weekday = (int)(((days + 3) % 7 + 7) % 7) + 1;
+        int week = (ordinal - weekday + 10) / 7;
+        if (week >= 1 && week <= 52) {
+          snprintf(text, sizeof(text), "%d-W%02d-%d", year, week, weekday);
+          expect(text, seconds, year, month, day);
+        }
+      }
+    }
+  }
+}
+
+int main(void) {
+  test_every_day();
+
+  // Times, zones and their precision.
+  TSRedDate date;
+  static const char zoned[] = "2024-01-15T10:30:15.25+05:30";
+  CHECK(tree_sitter_red_date_decode(zoned, sizeof(zoned) - 1, &date));
+  CHECK(date.epoch_seconds == 1705314615 - 5 * 3600 - 30 * 60);
+  CHECK(date.nanoseconds == 250000000);
+  CHECK(date.zone_minutes == 330);
+  CHECK(date.flags == (TSRedDateHasTime | TSRedDateHasSeconds |
+                       TSRedDateHasFraction | TSRedDateHasZone));
+  expect("15-Jan-2024/10:30", 1705314600, 2024, 1, 15);
+  expect("15-Jan-2024/10:30-5", 1705314600 + 5 * 3600, 2024, 1, 15);
+  expect("15-Jan-2024/10:30-0500", 1705314600 + 5 * 3600, 2024, 1, 15);
+  expect("15-Jan-2024/10:30Z", 1705314600, 2024, 1, 15);
+  expect("20240115T1030Z", 1705314600, 2024, 1, 15);
+  expect("20240115T103000.5-08:00", 1705314600 + 8 * 3600, 2024, 1, 15);
+  expect("1/2/-300", -71631561600LL, -300, 2, 1);
+  expect("2024-W03", 1705276800, 2024, 1, 15);
+  expect("2020-W53-7", 1609632000, 2021, 1, 3);
+  expect("2024-W01-1", 1704067200, 2024, 1, 1);
+  expect("2019-W01-1", 1546214400, 2018, 12, 31);
+  expect("1-Sept-2024", 1725148800, 2024, 9, 1);
+
+  CHECK(rejects("2023-02-29"));
+  CHECK(rejects("31-Apr-2020"));
+  CHECK(rejects("2024-13-01"));
+  CHECK(rejects("2024-00-10"));
+  CHECK(rejects("2023-366"));
+  CHECK(rejects("2021-W53"));
+  CHECK(rejects("2024-W00"));
+  CHECK(rejects("2024-W10-8"));
+  CHECK(rejects("1-Ja-2020"));
+  CHECK(rejects("1-Janu-2020"));
+  CHECK(rejects("1-Septe-2020"));
+  CHECK(rejects("1-Jan/2020"));
+  CHECK(rejects("1/2/-30"));
+  CHECK(rejects("2024-01-15T10"));
+  CHECK(rejects("2024-01-15T10:30+16"));
+  CHECK(rejects("2024-01-15T10:30+123"));
+  CHECK(rejects("20240115T10Z"));
+  CHECK(rejects("20240115T1030"));
+  CHECK(rejects(""));
+
+  CHECK(is_time("10:30", 37800000000000LL, 0));
+  CHECK(is_time("-1:30", -5400000000000LL, 0));
+  CHECK(is_time("+0:0:1", 1000000000LL, TSRedDateHasSeconds));
+  CHECK(is_time("1:23.5", 83500000000LL,
+                TSRedDateHasSeconds | TSRedDateHasFraction));
+  CHECK(is_time("10:30:15.123456789", 37815123456789LL,
+                TSRedDateHasSeconds | TSRedDateHasFraction));
+  CHECK(is_time("100000:00", 360000000000000000LL, 0));
+  CHECK(rejects("10:"));
+  CHECK(rejects("10:30:"));
+  CHECK(rejects("10:30.1234567890"));
+  CHECK(rejects("999999999:00"));
+
+  return failures ? 1 : 0;
+}
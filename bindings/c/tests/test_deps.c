@@ -0,0 +1,134 @@
+#include "tree_sitter/tree-sitter-red-deps.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static bool resolves(const char *from, const char *target, const char *expected) {
+  char *path = tree_sitter_red_deps_resolve(from, target);
+  bool equal = path && strcmp(path, expected) == 0;
+  if (!equal) {
+    fprintf(stderr, "resolve(%s, %s) = %s\n", from, target, path);
+  }
+  free(path);
+  return equal;
+}
+
+static uint32_t position(const TSRedDependencyOrder *order, uint32_t count,
+                         uint32_t file) {
+  for (uint32_t i = 0; i < count; i++) {
+    if (order->order[i] == file) {
+      return i;
+    }
+  }
+  return UINT32_MAX;
+}
+
+static void count_edge(void *payload, uint32_t from, uint32_t to,
+                       TSRedDependencyKind kind) {
+  (void)from;
+  (void)to;
+  (void)kind;
+  (*(uint32_t *)payload)++;
+}
+
+int main(void) {
+  // Lists survive the cache encoding.
+  TSRedDependencyList list = {0}, decoded;
+  CHECK(tree_sitter_red_deps_list_push(&list, TSRedDependencyDo, "lib.red", 7, 3));
+  CHECK(tree_sitter_red_deps_list_push(&list, TSRedDependencyInclude,
+                                       "a b.reds", 8, 10));
+  uint8_t *data;
+  size_t size;
+  CHECK(tree_sitter_red_deps_encode(&list, &data, &size));
+  CHECK(tree_sitter_red_deps_decode(data, size, &decoded));
+  CHECK(decoded.count == 2);
+  CHECK(decoded.items[1].kind == TSRedDependencyInclude);
+  CHECK(decoded.items[1].row == 10);
+  CHECK(strcmp(decoded.items[1].path, "a b.reds") == 0);
+  tree_sitter_red_deps_list_delete(&decoded);
+  CHECK(!tree_sitter_red_deps_decode(data, size - 1, &decoded));
+  CHECK(decoded.count == 0 && decoded.items == NULL);
+  data[4] = 9;
+  CHECK(!tree_sitter_red_deps_decode(data, size, &decoded));
+  free(data);
+  tree_sitter_red_deps_list_delete(&list);
+
+  CHECK(resolves("src/main.red", "lib.red", "src/lib.red"));
+  CHECK(resolves("src/main.red", "./util/../lib.red", "src/lib.red"));
+  CHECK(resolves("src/main.red", "../../shared/x.red", "../shared/x.red"));
+  CHECK(resolves("main.red", "../x.red", "../x.red"));
+  CHECK(resolves("src/main.red", "/abs/../../x.red", "/x.red"));
+  CHECK(resolves("src/main.red", "modules/", "src/modules/"));
+
+  // main -> a -> b -> a, main -> c, and d on its own.
+  TSRedDependencyGraph *graph = tree_sitter_red_deps_graph_new();
+  uint32_t main_red = tree_sitter_red_deps_graph_add_file(graph, "main.red");
+  uint32_t a = tree_sitter_red_deps_graph_add_file(graph, "a.red");
+  uint32_t b = tree_sitter_red_deps_graph_add_file(graph, "b.red");
+  uint32_t c = tree_sitter_red_deps_graph_add_file(graph, "c.red");
+  uint32_t d = tree_sitter_red_deps_graph_add_file(graph, "d.red");
+  CHECK(tree_sitter_red_deps_graph_add_file(graph, "a.red") == a);
+  CHECK(tree_sitter_red_deps_graph_file_count(graph) == 5);
+  CHECK(strcmp(tree_sitter_red_deps_graph_path(graph, c), "c.red") == 0);
+  CHECK(!tree_sitter_red_deps_graph_exists(graph, c));
+  tree_sitter_red_deps_graph_set_exists(graph, c, true);
+  CHECK(tree_sitter_red_deps_graph_exists(graph, c));
+  CHECK(tree_sitter_red_deps_graph_add_edge(graph, main_red, a, TSRedDependencyDo));
+  CHECK(tree_sitter_red_deps_graph_add_edge(graph, a, b, TSRedDependencyInclude));
+  CHECK(tree_sitter_red_deps_graph_add_edge(graph, b, a, TSRedDependencyInclude));
+  CHECK(tree_sitter_red_deps_graph_add_edge(graph, main_red, c, TSRedDependencyLoad));
+  CHECK(!tree_sitter_red_deps_graph_add_edge(graph, main_red, 99, TSRedDependencyDo));
+  uint32_t edges = 0;
+  tree_sitter_red_deps_graph_edges(graph, count_edge, &edges);
+  CHECK(edges == 4);
+
+  TSRedDependencyOrder order;
+  CHECK(tree_sitter_red_deps_graph_sort(graph, &order));
+  CHECK(order.has_cycle);
+  CHECK(order.component_count == 4);
+  CHECK(order.component[a] == order.component[b]);
+  CHECK(order.component[a] != order.component[main_red]);
+  CHECK(position(&order, 5, a) < position(&order, 5, main_red));
+  CHECK(position(&order, 5, b) < position(&order, 5, main_red));
+  CHECK(position(&order, 5, c) < position(&order, 5, main_red));
+  CHECK(position(&order, 5, d) != UINT32_MAX);
+  tree_sitter_red_deps_order_delete(&order);
+  tree_sitter_red_deps_graph_delete(graph);
+
+  // A long chain, deeper than any C stack would allow recursing into.
+  graph = tree_sitter_red_deps_graph_new();
+  char name[32];
+  const uint32_t length = 200000;
+  for (uint32_t i = 0; i < length; i++) {
+    snprintf(name, sizeof(name), "%u.red", i);
+    CHECK(tree_sitter_red_deps_graph_add_file(graph, name) == i);
+    if (i > 0) {
+      tree_sitter_red_deps_graph_add_edge(graph, i - 1, i, TSRedDependencyDo);
+    }
+  }
+  CHECK(tree_sitter_red_deps_graph_sort(graph, &order));
+  CHECK(!order.has_cycle);
+  CHECK(order.component_count == length);
+  CHECK(order.order[0] == length - 1 && order.order[length - 1] == 0);
+  tree_sitter_red_deps_order_delete(&order);
+
+  // A file that includes itself is a cycle of one.
+  tree_sitter_red_deps_graph_add_edge(graph, 7, 7, TSRedDependencyInclude);
+  CHECK(tree_sitter_red_deps_graph_sort(graph, &order));
+  CHECK(order.has_cycle);
+  tree_sitter_red_deps_order_delete(&order);
+  tree_sitter_red_deps_graph_delete(graph);
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-red-deps.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <tree_sitter/api.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static bool has(const TSRedDependencyList *list, uint32_t i,
+                TSRedDependencyKind kind, const char *path, uint32_t row) {
+  return i < list->count && list->items[i].kind == kind &&
+         strcmp(list->items[i].path, path) == 0 && list->items[i].row == row;
+}
+
+// A link back up the tree is not walked into.
+static void check_scan_skips_linked_directories(void) {
+  char directory[] = "/tmp/test-deps-tree-XXXXXX";
+  CHECK(mkdtemp(directory) != NULL);
+  char script[64], link[64];
+  snprintf(script, sizeof(script), "%s/a.red", directory);
+  snprintf(link, sizeof(link), "%s/loop", directory);
+  FILE *file = fopen(script, "wb");
+  CHECK(file != NULL);
+  if (file) {
+    fputs("Red []\nprint 1\n", file);
+    fclose(file);
+  }
+  CHECK(symlink(".", link) == 0);
+
+  TSRedDependencyGraph *graph = tree_sitter_red_deps_scan(directory, 2, NULL);
+  CHECK(graph != NULL);
+  if (graph) {
+    CHECK(tree_sitter_red_deps_graph_file_count(graph) == 1);
+    CHECK(strcmp(tree_sitter_red_deps_graph_path(graph, 0), script) == 0);
+    tree_sitter_red_deps_graph_delete(graph);
+  }
+  remove(link);
+  remove(script);
+  rmdir(directory);
+}
+
+int main(void) {
+  check_scan_skips_linked_directories();
+  static const char source[] =
+      "Red []\n"
+      "do %lib.red\n"
+      "#include %runtime/common.reds\n"
+      "data: load/all %\"my data.red\"\n"
+      "if yes [DO ; the next line\n"
+      "  %nested%20file.red]\n"
+      "print %not-a-dependency.red\n"
+      "do-events %neither.red\n";
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_red());
+  TSTree *tree =
+      ts_parser_parse_string(parser, NULL, source, (uint32_t)strlen(source));
+
+  TSRedDependencyList list = {0};
+  CHECK(tree_sitter_red_deps_extract(tree, source, &list));
+  CHECK(list.count == 4);
+  CHECK(has(&list, 0, TSRedDependencyDo, "lib.red", 1));
+  CHECK(has(&list, 1, TSRedDependencyInclude, "runtime/common.reds", 2));
+  CHECK(has(&list, 2, TSRedDependencyLoad, "my data.red", 3));
+  CHECK(has(&list, 3, TSRedDependencyDo, "nested file.red", 5));
+  tree_sitter_red_deps_list_delete(&list);
+
+  ts_tree_delete(tree);
+  ts_parser_delete(parser);
+  return failures == 0 ? 0 : 1;
+}
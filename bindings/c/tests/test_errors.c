@@ -0,0 +1,69 @@
+#include "tree_sitter/tree-sitter-red-errors.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+int main(void) {
+  TSRedErrorList list = {0}, decoded;
+  static const uint16_t expected[] = {3, 5, 8};
+  TSRedError missing = {TSRedErrorMissing, 20, 20, 1, 13, 19, 20, 7, 0, 0};
+  TSRedError unexpected = {TSRedErrorUnexpected, 40, 44, 3, 0, 40, 41, 9, 0, 0};
+  CHECK(tree_sitter_red_errors_push(&list, &missing, expected, 3));
+  CHECK(tree_sitter_red_errors_push(&list, &unexpected, NULL, 0));
+  CHECK(tree_sitter_red_errors_push(&list, &unexpected, expected + 1, 2));
+  CHECK(list.count == 3 && list.expected_count == 5);
+  CHECK(list.items[2].expected_offset == 3);
+  CHECK(list.expected[list.items[2].expected_offset + 1] == 8);
+
+  // Lists survive the cache encoding.
+  uint8_t *data;
+  size_t size;
+  CHECK(tree_sitter_red_errors_encode(&list, &data, &size));
+  CHECK(tree_sitter_red_errors_decode(data, size, &decoded));
+  CHECK(decoded.count == 3 && decoded.expected_count == 5);
+  for (uint32_t i = 0; i < 3; i++) {
+    const TSRedError *a = &decoded.items[i], *b = &list.items[i];
+    CHECK(a->kind == b->kind && a->start_byte == b->start_byte &&
+          a->end_byte == b->end_byte && a->row == b->row &&
+          a->column == b->column && a->token_start == b->token_start &&
+          a->token_end == b->token_end && a->symbol == b->symbol &&
+          a->expected_offset == b->expected_offset &&
+          a->expected_count == b->expected_count);
+  }
+  CHECK(memcmp(decoded.expected, list.expected, 5 * sizeof(uint16_t)) == 0);
+  tree_sitter_red_errors_delete(&decoded);
+
+  // Truncated, padded and corrupt data is rejected.
+  CHECK(!tree_sitter_red_errors_decode(data, size - 1, &decoded));
+  CHECK(decoded.count == 0 && decoded.items == NULL);
+  uint8_t *padded = malloc(size + 1);
+  memcpy(padded, data, size);
+  padded[size] = 0;
+  CHECK(!tree_sitter_red_errors_decode(padded, size + 1, &decoded));
+  free(padded);
+  data[4] = 2;
+  CHECK(!tree_sitter_red_errors_decode(data, size, &decoded));
+  free(data);
+
+  TSRedErrorList empty = {0};
+  CHECK(tree_sitter_red_errors_encode(&empty, &data, &size));
+  CHECK(size == 4);
+  CHECK(tree_sitter_red_errors_decode(data, size, &decoded));
+  CHECK(decoded.count == 0);
+  tree_sitter_red_errors_delete(&decoded);
+  free(data);
+
+  tree_sitter_red_errors_delete(&list);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+#include "tree_sitter/tree-sitter-red-errors.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <tree_sitter/api.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static TSParser *parser;
+
+static bool collect(const char *source, TSRedErrorList *errors) {
+  TSTree *tree =
+      ts_parser_parse_string(parser, NULL, source, (uint32_t)strlen(source));
+  bool ok = tree_sitter_red_errors_collect(tree, errors);
+  ts_tree_delete(tree);
+  return ok;
+}
+
+static bool expects(const TSRedErrorList *errors, const TSRedError *error,
+                    const char *name) {
+  for (uint32_t i = 0; i < error->expected_count; i++) {
+    uint16_t symbol = errors->expected[error->expected_offset + i];
+    if (strcmp(ts_language_symbol_name(tree_sitter_red(), symbol), name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int main(void) {
+  parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_red());
+  TSRedErrorList errors = {0};
+
+  CHECK(collect("Red []\nprint [1 2 3]\n", &errors));
+  CHECK(errors.count == 0);
+
+  // An unclosed block is closed by a missing bracket.
+  static const char unclosed[] = "Red []\nadd: func [a b] [a + b\n";
+  CHECK(collect(unclosed, &errors));
+  CHECK(errors.count >= 1);
+  bool found = false;
+  for (uint32_t i = 0; i < errors.count; i++) {
+    const TSRedError *error = &errors.items[i];
+    CHECK(error->row >= 1);
+    CHECK(error->token_start <= error->token_end);
+    CHECK(error->token_end <= sizeof(unclosed) - 1);
+    found |= error->kind == TSRedErrorMissing &&
+             strcmp(ts_language_symbol_name(tree_sitter_red(), error->symbol),
+                    "]") == 0 &&
+             expects(&errors, error, "]");
+  }
+  CHECK(found || errors.items[0].kind == TSRedErrorUnexpected);
+  tree_sitter_red_errors_delete(&errors);
+
+  // A stray closing bracket is skipped.
+  static const char stray[] = "Red []\nprint 1 ]\nprint 2\n";
+  CHECK(collect(stray, &errors));
+  CHECK(errors.count == 1);
+  if (errors.count == 1) {
+    CHECK(errors.items[0].kind == TSRedErrorUnexpected);
+    CHECK(errors.items[0].row == 1);
+    CHECK(stray[errors.items[0].token_start] == ']');
+  }
+  tree_sitter_red_errors_delete(&errors);
+
+  ts_parser_delete(parser);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+#include "tree_sitter/tree-sitter-red-header.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static bool field_is(const TSRedHeader *header, const char *key,
+                     TSRedHeaderValueType type, const char *value) {
+  const TSRedHeaderField *field = tree_sitter_red_header_find(header, key);
+  if (!field || field->type != type) {
+    return false;
+  }
+  if (type == TSRedHeaderString || type == TSRedHeaderFile) {
+    return field->text_length == strlen(value) &&
+           memcmp(field->text, value, field->text_length) == 0;
+  }
+  return field->raw_length == strlen(value) &&
+         memcmp(field->raw, value, field->raw_length) == 0;
+}
+
+static bool parse(const char *source, TSRedHeader *header) {
+  return tree_sitter_red_header_parse(source, (uint32_t)strlen(source), header);
+}
+
+int main(void) {
+  TSRedHeader header;
+
+  static const char script[] =
+      "\xef\xbb\xbf#!/usr/local/bin/red\n"
+      "; A comment before the header.\n"
+      "Red [\n"
+      "    Title:   \"Tree-sitter ^\"parse^\" runner^/\"\n"
+      "    Version: 0.1.2  ; the version\n"
+      "    Needs:   [View \"]\" [nested]]\n"
+      "    Author:  {Red {team} ^(1F600)^(tab)}\n"
+      "    File:    %my%20script.red\n"
+      "    Quoted:  %\"a file.red\"\n"
+      "    Raw:     %%{no ^escapes}%%\n"
+      "    Date:    18-Oct-2026\n"
+      "    Level:   -3\n"
+      "    Icon:    default\n"
+      "    Home:    https://www.red-lang.org\n"
+      "]\n"
+      "print \"the rest is never read\" [";
+  CHECK(parse(script, &header));
+  CHECK(!header.is_red_system);
+  CHECK(memcmp(script + header.start_byte, "Red [", 5) == 0);
+  CHECK(script[header.end_byte - 1] == ']' && script[header.end_byte] == '\n');
+  CHECK(header.field_count == 11);
+  CHECK(field_is(&header, "title", TSRedHeaderString,
+                 "Tree-sitter \"parse\" runner\n"));
+  CHECK(field_is(&header, "Version", TSRedHeaderTuple, "0.1.2"));
+  CHECK(field_is(&header, "Needs", TSRedHeaderBlock, "[View \"]\" [nested]]"));
+  CHECK(field_is(&header, "Author", TSRedHeaderString,
+                 "Red {team} \xf0\x9f\x98\x80\t"));
+  CHECK(field_is(&header, "File", TSRedHeaderFile, "my script.red"));
+  CHECK(field_is(&header, "Quoted", TSRedHeaderFile, "a file.red"));
+  CHECK(field_is(&header, "Raw", TSRedHeaderString, "no ^escapes"));
+  CHECK(field_is(&header, "Date", TSRedHeaderOther, "18-Oct-2026"));
+  CHECK(field_is(&header, "Level", TSRedHeaderNumber, "-3"));
+  CHECK(field_is(&header, "Icon", TSRedHeaderWord, "default"));
+  CHECK(field_is(&header, "Home", TSRedHeaderOther, "https://www.red-lang.org"));
+  CHECK(tree_sitter_red_header_find(&header, "Missing") == NULL);
+  tree_sitter_red_header_delete(&header);
+
+  CHECK(parse("red/system[Title: \"x\"]", &header));
+  CHECK(header.is_red_system);
+  CHECK(field_is(&header, "Title", TSRedHeaderString, "x"));
+  tree_sitter_red_header_delete(&header);
+
+  // No header, or one that does not end.
+  CHECK(!parse("print 1", &header));
+  CHECK(!parse("Red print 1", &header));
+  CHECK(!parse("Red [Title: \"x\"", &header));
+  CHECK(!parse("Red [Title: {x]", &header));
+  CHECK(!parse("Red [Title: )]", &header));
+  CHECK(!parse("", &header));
+
+  // Nesting is followed to a limit, and no further.
+  char nested[4096];
+  strcpy(nested, "Red [Needs: ");
+  size_t length = strlen(nested);
+  for (int i = 0; i < 200; i++) {
+    nested[length++] = i % 2 ? '(' : '[';
+  }
+  for (int i = 199; i >= 0; i--) {
+    nested[length++] = i % 2 ? ')' : ']';
+  }
+  strcpy(nested + length, " Title: \"x\"]");
+  CHECK(parse(nested, &header));
+  CHECK(field_is(&header, "Title", TSRedHeaderString, "x"));
+  tree_sitter_red_header_delete(&header);
+  strcpy(nested, "Red [Needs: ");
+  length = strlen(nested);
+  memset(nested + length, '[', 3000);
+  nested[length + 3000] = '\0';
+  CHECK(!parse(nested, &header));
+
+  // A header longer than the first read.
+  char path[] = "test_header.red";
+  FILE *file = fopen(path, "wb");
+  CHECK(file != NULL);
+  if (file) {
+    fputs("Red [\n  Notes: {", file);
+    for (int i = 0; i < 1000; i++) {
+      fputs("0123456789", file);
+    }
+    fputs("}\n  Title: \"long\"\n]\n", file);
+    fclose(file);
+  }
+  CHECK(tree_sitter_red_header_read(path, &header));
+  CHECK(field_is(&header, "Title", TSRedHeaderString, "long"));
+  CHECK(tree_sitter_red_header_find(&header, "Notes")->text_length == 10000);
+  tree_sitter_red_header_delete(&header);
+  remove(path);
+  CHECK(!tree_sitter_red_header_read(path, &header));
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+#include "tree_sitter/tree-sitter-red-numbers.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static TSRedNumber number(const char *text) {
+  TSRedNumber decoded = {TSRedNumberInteger, -1, -1};
+  if (!tree_sitter_red_number_decode(text, (uint32_t)strlen(text), &decoded)) {
+    fprintf(stderr, "cannot decode %s\n", text);
+    failures++;
+  }
+  return decoded;
+}
+
+static bool is_integer(const char *text, int64_t value) {
+  TSRedNumber decoded = number(text);
+  return decoded.kind == TSRedNumberInteger && decoded.integer == value;
+}
+
+static bool is_float(const char *text, double value) {
+  TSRedNumber decoded = number(text);
+  return decoded.kind == TSRedNumberFloat &&
+         memcmp(&decoded.value, &value, sizeof(double)) == 0;
+}
+
+static bool is_percent(const char *text, double value) {
+  TSRedNumber decoded = number(text);
+  return decoded.kind == TSRedNumberPercent && decoded.value == value;
+}
+
+static bool is_money(const char *text, const char *currency, bool negative,
+                     uint64_t whole, uint32_t fraction) {
+  TSRedMoney money;
+  return tree_sitter_red_money_decode(text, (uint32_t)strlen(text), &money) &&
+         strcmp(money.currency, currency) == 0 && money.negative == negative &&
+         money.whole == whole && money.fraction == fraction;
+}
+
+static bool is_pair(const char *text, int32_t x, int32_t y) {
+  TSRedPair pair;
+  return tree_sitter_red_pair_decode(text, (uint32_t)strlen(text), &pair) &&
+         pair.x == x && pair.y == y;
+}
+
+static bool rejects(const char *text) {
+  TSRedNumber decoded;
+  TSRedMoney money;
+  TSRedPair pair;
+  uint32_t length = (uint32_t)strlen(text);
+  return !tree_sitter_red_number_decode(text, length, &decoded) &&
+         !tree_sitter_red_money_decode(text, length, &money) &&
+         !tree_sitter_red_pair_decode(text, length, &pair);
+}
+
+int main(void) {
+  CHECK(is_integer("0", 0));
+  CHECK(is_integer("-42", -42));
+  CHECK(is_integer("+7", 7));
+  CHECK(is_integer("1'000'000", 1000000));
+  CHECK(is_integer("007", 7));
+  CHECK(is_integer("2147483647", 2147483647));
+  CHECK(is_integer("-2147483648", -2147483648LL));
+  // Out of Red's 32-bit range, integers load as floats.
+  CHECK(is_float("2147483648", 2147483648.0));
+  CHECK(is_float("-99999999999999999999", -1e20));
+
+  CHECK(is_float("1.5", 1.5));
+  CHECK(is_float("-0.0", -0.0));
+  CHECK(is_float(".5", 0.5));
+  CHECK(is_float("1e3", 1000.0));
+  CHECK(is_float("1.5E-3", 0.0015));
+  CHECK(is_float("1'234.5'6", 1234.56));
+  CHECK(is_float("0.1", 0.1));
+  CHECK(is_float("3.141592653589793238462643383279", 3.141592653589793));
+  CHECK(is_float("1e400", INFINITY));
+  CHECK(is_float("1e-400", 0.0));
+  CHECK(is_float("4.9406564584124654e-324", 4.9406564584124654e-324));
+  CHECK(is_float("1.7976931348623157e308", 1.7976931348623157e308));
+  CHECK(is_float("1.#inf", INFINITY));
+  CHECK(is_float("-1.#INF", -INFINITY));
+  CHECK(isnan(number("1.#NaN").value));
+
+  CHECK(is_percent("50%", 0.5));
+  CHECK(is_percent("-12.5%", -0.125));
+  CHECK(is_percent("1e2%", 1.0));
+  CHECK(is_percent("1.#inf%", INFINITY));
+
+  // Long mantissas round as a whole: this is just above the halfway point
+  // between 1 and the next double, by a digit past the 780th.
+  char halfway[1024] = "1.00000000000000011102230246251565404236316680908203125";
+  size_t length = strlen(halfway);
+  memset(halfway + length, '0', 900);
+  strcpy(halfway + length + 900, "1");
+  CHECK(is_float(halfway, 1.0000000000000002));
+  halfway[length + 900] = '\0';
+  CHECK(is_float(halfway, 1.0));
+
+  // Agrees with strtod, which rounds correctly, on random doubles.
+  srand(1);
+  for (int i = 0; i < 20000; i++) {
+    uint64_t bits = 0;
+    for (int k = 0; k < 4; k++) {
+      bits = (bits << 16) | (uint64_t)(rand() & 0xffff);
+    }
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    if (!isfinite(value)) {
+      continue;
+    }
+    char text[64];
+    snprintf(text, sizeof(text), "%.*e", i % 20, fabs(value));
+    TSRedNumber decoded = number(text);
+    double expected = strtod(text, NULL);
+    if (memcmp(&decoded.value, &expected, sizeof(double)) != 0) {
+      fprintf(stderr, "%s: %.17g, not %.17g\n", text, decoded.value, expected);
+      failures++;
+    }
+  }
+
+  CHECK(is_money("$1", "", false, 1, 0));
+  CHECK(is_money("-$0.5", "", true, 0, 50000));
+  CHECK(is_money("USD$1'000.00", "USD", false, 1000, 0));
+  CHECK(is_money("+eur$12.34567", "EUR", false, 12, 34567));
+  CHECK(is_money("$1.123455", "", false, 1, 12346));
+  CHECK(is_money("$1.999995", "", false, 2, 0));
+  CHECK(is_money("$99999999999999999", "", false, 99999999999999999u, 0));
+  CHECK(rejects("$999999999999999999"));
+  CHECK(rejects("$99999999999999999.999995"));
+
+  CHECK(is_pair("10x20", 10, 20));
+  CHECK(is_pair("-1X+2", -1, 2));
+  CHECK(is_pair("1'024x768", 1024, 768));
+  CHECK(is_pair("-2147483648x2147483647", INT32_MIN, INT32_MAX));
+  CHECK(rejects("2147483648x1"));
+
+  CHECK(rejects(""));
+  CHECK(rejects("-"));
+  CHECK(rejects("%"));
+  CHECK(rejects("1."));
+  CHECK(rejects("1e"));
+  CHECK(rejects("1'"));
+  CHECK(rejects("'1"));
+  CHECK(rejects("1x"));
+  CHECK(rejects("$"));
+  CHECK(rejects("1.#foo"));
+  CHECK(rejects("12a"));
+
+  return failures ? 1 : 0;
+}
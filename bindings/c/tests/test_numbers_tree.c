@@ -0,0 +1,70 @@
+#include "tree_sitter/tree-sitter-red-numbers.h"
+#include "tree_sitter/tree-sitter-red-symbols.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <tree_sitter/api.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+// The first node of type `symbol` in `node`, depth first.
+static TSNode find(TSNode node, TSSymbol symbol) {
+  if (ts_node_symbol(node) == symbol) {
+    return node;
+  }
+  uint32_t count = ts_node_named_child_count(node);
+  for (uint32_t i = 0; i < count; i++) {
+    TSNode found = find(ts_node_named_child(node, i), symbol);
+    if (!ts_node_is_null(found)) {
+      return found;
+    }
+  }
+  return (TSNode){{0}, NULL, NULL};
+}
+
+int main(void) {
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_red());
+  static const char source[] =
+      "Red []\nsize: 1'024x768 price: EUR$12.50 ratio: 12.5% at: (1, 2.5)\n";
+  TSTree *tree =
+      ts_parser_parse_string(parser, NULL, source, sizeof(source) - 1);
+  TSNode root = ts_tree_root_node(tree);
+
+  TSRedPair pair;
+  CHECK(tree_sitter_red_pair_from_node(find(root, TSRedSymbolPair), source,
+                                       &pair));
+  CHECK(pair.x == 1024 && pair.y == 768);
+
+  TSRedMoney money;
+  CHECK(tree_sitter_red_money_from_node(find(root, TSRedSymbolMoney), source,
+                                        &money));
+  CHECK(strcmp(money.currency, "EUR") == 0 && money.whole == 12 &&
+        money.fraction == 50000);
+
+  TSRedNumber number;
+  CHECK(tree_sitter_red_number_from_node(find(root, TSRedSymbolNumber), source,
+                                         &number));
+  CHECK(number.kind == TSRedNumberPercent && number.value == 0.125);
+
+  TSRedPoint point;
+  TSNode node = find(root, TSRedSymbolPoint);
+  CHECK(tree_sitter_red_point_from_node(node, source, &point));
+  CHECK(point.dimensions == 2 && point.x == 1.0f && point.y == 2.5f);
+  // Nodes of another type are not decoded.
+  CHECK(!tree_sitter_red_pair_from_node(node, source, &pair));
+
+  ts_tree_delete(tree);
+  ts_parser_delete(parser);
+  return failures ? 1 : 0;
+}
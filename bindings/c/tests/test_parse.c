@@ -0,0 +1,130 @@
+#include "tree_sitter/tree-sitter-red-parse.h"
+#include "tree_sitter/tree-sitter-red-symbols.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+// `count` copies of `text`.
+static char *repeat(const char *text, uint32_t count, uint32_t *length) {
+  size_t size = strlen(text);
+  char *source = malloc(size * count + 1);
+  for (uint32_t i = 0; i < count; i++) {
+    memcpy(source + size * i, text, size);
+  }
+  source[size * count] = '\0';
+  *length = (uint32_t)(size * count);
+  return source;
+}
+
+typedef struct {
+  const char *source;
+  uint32_t length;
+  // Where the first string of the tree ends.
+  uint32_t string_end;
+} Job;
+
+// Parse on a thread of its own, without limits.
+static void *parse_job(void *payload) {
+  Job *job = payload;
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_red());
+  TSRedParseResult result;
+  if (tree_sitter_red_parse(parser, NULL, job->source, job->length, NULL,
+                            &result) == TSRedParseDone) {
+    TSNode root = ts_tree_root_node(result.tree);
+    job->string_end = ts_node_end_byte(ts_node_named_child(root, 0));
+    ts_tree_delete(result.tree);
+  }
+  ts_parser_delete(parser);
+  return NULL;
+}
+
+int main(void) {
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_red());
+  static const char script[] = "Red []\nprint [1 + 2]\n";
+  TSRedParseResult result;
+
+  // Without limits, the same as ts_parser_parse_string.
+  CHECK(tree_sitter_red_parse(parser, NULL, script, sizeof(script) - 1, NULL,
+                              &result) == TSRedParseDone);
+  CHECK(result.tree && !result.has_error);
+  CHECK(result.offset == sizeof(script) - 1);
+  ts_tree_delete(result.tree);
+
+  // A set flag stops the parse at its first check, and clearing it lets the
+  // next call resume.
+  uint32_t length;
+  char *source = repeat("a: [b c/d \"e\" 1.5 #{00}]\n", 20000, &length);
+  size_t flag = 1;
+  TSRedParseOptions options = {0, &flag, 0};
+  CHECK(tree_sitter_red_parse(parser, NULL, source, length, &options,
+                              &result) == TSRedParseCancelled);
+  CHECK(result.tree == NULL && result.offset < length);
+  flag = 0;
+  CHECK(tree_sitter_red_parse(parser, NULL, source, length, &options,
+                              &result) == TSRedParseDone);
+  CHECK(result.tree && !result.has_error && result.offset == length);
+  ts_tree_delete(result.tree);
+
+  // A timeout too short for the source, then a reset to start over.
+  options = (TSRedParseOptions){1, NULL, 0};
+  CHECK(tree_sitter_red_parse(parser, NULL, source, length, &options,
+                              &result) == TSRedParseTimedOut);
+  CHECK(result.tree == NULL);
+  ts_parser_reset(parser);
+  CHECK(tree_sitter_red_parse(parser, NULL, source, length, NULL, &result) ==
+        TSRedParseDone);
+  ts_tree_delete(result.tree);
+  free(source);
+
+  // With a token budget, an unclosed brace ends its string early instead of
+  // taking in the rest of the script.
+  source = repeat("x: 1\n", 1000, &length);
+  source[0] = '{';
+  options = (TSRedParseOptions){0, NULL, 100};
+  CHECK(tree_sitter_red_parse(parser, NULL, source, length, &options,
+                              &result) == TSRedParseDone);
+  TSNode string = ts_node_named_child(ts_tree_root_node(result.tree), 0);
+  CHECK(ts_node_symbol(string) == TSRedSymbolMultilineString);
+  CHECK(ts_node_end_byte(string) < 200);
+  CHECK(ts_node_has_error(ts_tree_root_node(result.tree)));
+  ts_tree_delete(result.tree);
+  // The budget was for that parse only.
+  CHECK(tree_sitter_red_parse(parser, NULL, source, length, NULL, &result) ==
+        TSRedParseDone);
+  string = ts_node_named_child(ts_tree_root_node(result.tree), 0);
+  CHECK(ts_node_end_byte(string) == length);
+  ts_tree_delete(result.tree);
+
+  // A budget set on one thread does not reach a parse on another.
+  CHECK(tree_sitter_red_external_scanner_set_budget(100) == 0);
+  Job job = {source, length, 0};
+  pthread_t thread;
+  CHECK(pthread_create(&thread, NULL, parse_job, &job) == 0 &&
+        pthread_join(thread, NULL) == 0);
+  CHECK(job.string_end == length);
+  CHECK(tree_sitter_red_parse(parser, NULL, source, length, NULL, &result) ==
+        TSRedParseDone);
+  string = ts_node_named_child(ts_tree_root_node(result.tree), 0);
+  CHECK(ts_node_end_byte(string) < 200);
+  ts_tree_delete(result.tree);
+  CHECK(tree_sitter_red_external_scanner_set_budget(0) == 100);
+  free(source);
+
+  ts_parser_delete(parser);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+#include "tree_sitter/parser.h"
+#include "tree_sitter/tree-sitter-red-stats.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// The external scanner, driven over a string by a lexer of our own, as the
+// runtime would drive it.
+
+uint32_t tree_sitter_red_external_scanner_set_budget(uint32_t characters);
+bool tree_sitter_red_external_scanner_scan(void *payload, TSLexer *lexer,
+                                           const bool *valid_symbols);
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+typedef struct {
+  TSLexer lexer;
+  const char *source;
+  uint32_t length;
+  uint32_t position;
+  uint32_t token_end;
+} Lexer;
+
+static void advance(TSLexer *lexer, bool skip) {
+  Lexer *self = (Lexer *)lexer;
+  (void)skip;
+  if (self->position < self->length) {
+    self->position++;
+  }
+  lexer->lookahead =
+      self->position < self->length ? (uint8_t)self->source[self->position] : 0;
+}
+
+static void mark_end(TSLexer *lexer) {
+  Lexer *self = (Lexer *)lexer;
+  self->token_end = self->position;
+}
+
+static uint32_t get_column(TSLexer *lexer) {
+  return ((Lexer *)lexer)->position;
+}
+
+static bool is_at_included_range_start(const TSLexer *lexer) {
+  (void)lexer;
+  return false;
+}
+
+static bool eof(const TSLexer *lexer) {
+  const Lexer *self = (const Lexer *)lexer;
+  return self->position >= self->length;
+}
+
+static void lex_log(const TSLexer *lexer, const char *format, ...) {
+  (void)lexer;
+  (void)format;
+}
+
+// Scan `source` for `token` alone and return where the token ends, or
+// UINT32_MAX if there is none or the scanner returned another than `result`.
+static uint32_t scan_as(const char *source, TSRedScannerToken token,
+                        TSRedScannerToken result) {
+  Lexer self = {{0}, source, (uint32_t)strlen(source), 0, 0};
+  self.lexer.lookahead = (uint8_t)source[0];
+  self.lexer.advance = advance;
+  self.lexer.mark_end = mark_end;
+  self.lexer.get_column = get_column;
+  self.lexer.is_at_included_range_start = is_at_included_range_start;
+  self.lexer.eof = eof;
+  self.lexer.log = lex_log;
+  bool valid_symbols[TSRedScannerTokenCount] = {false};
+  valid_symbols[token] = true;
+  if (!tree_sitter_red_external_scanner_scan(NULL, &self.lexer,
+                                             valid_symbols) ||
+      self.lexer.result_symbol != result) {
+    return UINT32_MAX;
+  }
+  return self.token_end;
+}
+
+static uint32_t scan(const char *source, TSRedScannerToken token) {
+  return scan_as(source, token, token);
+}
+
+int main(void) {
+  // The body of a multiline string ends before its closing brace; raw
+  // strings include their delimiters.
+  CHECK(scan("abc {x} ^} def} tail", TSRedScannerMultilineString) == 14);
+  CHECK(scan("%{ab}c}%x", TSRedScannerRawString) == 8);
+  CHECK(scan("%%{a}%b}%%", TSRedScannerRawString) == 10);
+  // Unclosed ones end with the input.
+  CHECK(scan("abc {x", TSRedScannerMultilineString) == 6);
+  CHECK(scan("%{abc", TSRedScannerRawString) == 5);
+
+  // With a budget, a body ends after that many characters, though never
+  // in front of a `}`, which would close the string. A raw string cut
+  // short is an error_sentinel, which the parser does not accept.
+  tree_sitter_red_external_scanner_set_budget(4);
+  CHECK(scan("abc {x} ^} def} tail", TSRedScannerMultilineString) == 4);
+  CHECK(scan("ab}", TSRedScannerMultilineString) == 2);
+  CHECK(scan("{{ab}} c}", TSRedScannerMultilineString) == 6);
+  CHECK(scan("{{ab}}}", TSRedScannerMultilineString) == 6);
+  CHECK(scan("%{ab}c}%x", TSRedScannerRawString) == UINT32_MAX);
+  CHECK(scan_as("%{ab}c}%x", TSRedScannerRawString,
+                TSRedScannerErrorSentinel) == 6);
+  CHECK(scan("%{ab}%x", TSRedScannerRawString) == 6);
+  CHECK(scan("%{a}%", TSRedScannerRawString) == 5);
+  tree_sitter_red_external_scanner_set_budget(0);
+  CHECK(scan("abc {x} ^} def} tail", TSRedScannerMultilineString) == 14);
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+#include "tree_sitter/tree-sitter-red-serialize.h"
+#include "tree_sitter/tree-sitter-red-symbols.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+// The shape of `add: func [a] [a]`, with made-up anonymous symbols.
+static void write_function(TSRedTreeWriter *writer) {
+  tree_sitter_red_tree_writer_init(writer, 20);
+  tree_sitter_red_tree_writer_enter(writer, TSRedSymbolSourceFile, 0,
+                                    TSRedTreeNodeNamed, 0, 20, 1);
+  tree_sitter_red_tree_writer_enter(writer, TSRedSymbolFunction, 0,
+                                    TSRedTreeNodeNamed, 0, 17, 4);
+  tree_sitter_red_tree_writer_enter(writer, TSRedSymbolSetWord,
+                                    TSRedFieldName, TSRedTreeNodeNamed, 0, 4,
+                                    0);
+  tree_sitter_red_tree_writer_leave(writer);
+  tree_sitter_red_tree_writer_enter(writer, 62, TSRedFieldKey, 0, 5, 9, 0);
+  tree_sitter_red_tree_writer_leave(writer);
+  tree_sitter_red_tree_writer_enter(writer, TSRedSymbolBlock, TSRedFieldSpec,
+                                    TSRedTreeNodeNamed, 10, 13, 1);
+  tree_sitter_red_tree_writer_enter(writer, TSRedSymbolWord, 0,
+                                    TSRedTreeNodeNamed, 11, 12, 0);
+  tree_sitter_red_tree_writer_leave(writer);
+  tree_sitter_red_tree_writer_leave(writer);
+  tree_sitter_red_tree_writer_enter(writer, TSRedSymbolBlock, TSRedFieldBody,
+                                    TSRedTreeNodeNamed, 14, 17, 0);
+  tree_sitter_red_tree_writer_leave(writer);
+  tree_sitter_red_tree_writer_leave(writer);
+  tree_sitter_red_tree_writer_leave(writer);
+}
+
+static void check_tree(const TSRedTreeFile *file) {
+  CHECK(file->node_count == 7);
+  CHECK(file->source_length == 20);
+
+  TSRedTreeNode root, function, child, word;
+  CHECK(tree_sitter_red_tree_file_root(file, &root));
+  CHECK(root.symbol == TSRedSymbolSourceFile);
+  CHECK(root.child_count == 1);
+
+  CHECK(tree_sitter_red_tree_node_first_child(&root, &function));
+  CHECK(function.symbol == TSRedSymbolFunction);
+  CHECK(function.end_byte == 17);
+  CHECK(!tree_sitter_red_tree_node_next_sibling(&root, &function));
+
+  static const struct {
+    uint16_t symbol, field_id;
+    uint32_t start_byte, end_byte;
+  } expected[] = {
+      {TSRedSymbolSetWord, TSRedFieldName, 0, 4},
+      {62, TSRedFieldKey, 5, 9},
+      {TSRedSymbolBlock, TSRedFieldSpec, 10, 13},
+      {TSRedSymbolBlock, TSRedFieldBody, 14, 17},
+  };
+  size_t count = 0;
+  bool more = tree_sitter_red_tree_node_first_child(&function, &child);
+  while (more && count < 4) {
+    CHECK(child.symbol == expected[count].symbol);
+    CHECK(child.field_id == expected[count].field_id);
+    CHECK(child.start_byte == expected[count].start_byte);
+    CHECK(child.end_byte == expected[count].end_byte);
+    CHECK(!!(child.flags & TSRedTreeNodeNamed) == (child.symbol != 62));
+    if (count == 2) {
+      CHECK(tree_sitter_red_tree_node_first_child(&child, &word));
+      CHECK(word.symbol == TSRedSymbolWord);
+      CHECK(word.start_byte == 11 && word.end_byte == 12);
+    }
+    count++;
+    more = tree_sitter_red_tree_node_next_sibling(&function, &child);
+  }
+  CHECK(!more);
+  CHECK(count == 4);
+}
+
+int main(void) {
+  TSRedTreeWriter writer;
+  uint8_t *data;
+  size_t size;
+
+  write_function(&writer);
+  CHECK(tree_sitter_red_tree_writer_finish(&writer, &data, &size));
+
+  TSRedTreeFile file;
+  CHECK(tree_sitter_red_tree_file_open(&file, data, size));
+  check_tree(&file);
+
+  // Truncated and mismatched buffers are rejected.
+  CHECK(!tree_sitter_red_tree_file_open(&file, data, size - 1));
+  data[6] ^= 1;
+  CHECK(!tree_sitter_red_tree_file_open(&file, data, size));
+  data[6] ^= 1;
+
+  // The same bytes read through a mapping.
+  char path[] = "test_serialize.rdts";
+  FILE *out = fopen(path, "wb");
+  CHECK(out && fwrite(data, 1, size, out) == size);
+  if (out) {
+    fclose(out);
+  }
+#ifndef _WIN32
+  CHECK(tree_sitter_red_tree_file_map(&file, path));
+  check_tree(&file);
+  tree_sitter_red_tree_file_unmap(&file);
+#endif
+  remove(path);
+  free(data);
+
+  // Unbalanced or overlapping nodes fail the whole encoding.
+  tree_sitter_red_tree_writer_init(&writer, 4);
+  tree_sitter_red_tree_writer_enter(&writer, TSRedSymbolBlock, 0, 0, 0, 4, 2);
+  tree_sitter_red_tree_writer_enter(&writer, TSRedSymbolWord, 0, 0, 1, 3, 0);
+  tree_sitter_red_tree_writer_leave(&writer);
+  tree_sitter_red_tree_writer_enter(&writer, TSRedSymbolWord, 0, 0, 2, 3, 0);
+  tree_sitter_red_tree_writer_leave(&writer);
+  tree_sitter_red_tree_writer_leave(&writer);
+  CHECK(!tree_sitter_red_tree_writer_finish(&writer, &data, &size));
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+#include "tree_sitter/tree-sitter-red-split.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+// Whether `source` is cut, a line at a time, after exactly the lines
+// numbered in `rows`, which ends with 0.
+static bool splits_after(const char *source, const uint32_t *rows) {
+  TSRedSplit splits[64];
+  uint32_t count =
+      tree_sitter_red_split(source, (uint32_t)strlen(source), 1, splits, 64);
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t byte = splits[i].byte, row = 0;
+    for (uint32_t j = 0; j < byte; j++) {
+      row += source[j] == '\n';
+    }
+    if (rows[i] != splits[i].row || row != splits[i].row ||
+        source[byte - 1] != '\n') {
+      return false;
+    }
+  }
+  return rows[count] == 0;
+}
+
+#define SPLITS_AFTER(source, ...)                                              \
+  splits_after(source, (const uint32_t[]){__VA_ARGS__})
+
+int main(void) {
+  // Only between top-level lines, and never at the very end.
+  CHECK(SPLITS_AFTER("a: 1\nb: 2\nc: 3\n", 1, 2, 0));
+  CHECK(SPLITS_AFTER("a [\nb\n] c (\nd\n) #[\ne\n]\nf", 7, 0));
+  CHECK(SPLITS_AFTER("a]\nb)\nc\n", 1, 2, 0));
+
+  // Not in strings, braces, raw strings, comments or tags.
+  CHECK(SPLITS_AFTER("a: \"[\"\nb: #\"(\" \"^\"[\"\nc\n", 1, 2, 0));
+  CHECK(SPLITS_AFTER("\"unclosed [\nb\n", 1, 0));
+  CHECK(SPLITS_AFTER("{a\n{b}\n^}\n}\nc\nd", 4, 5, 0));
+  CHECK(SPLITS_AFTER("#{\n00\n}\n64#{\nAA==\n}\nc", 3, 6, 0));
+  // Comments in binaries may hold braces.
+  CHECK(SPLITS_AFTER("#{00 ; }\n 01}\nc\n", 2, 0));
+  CHECK(SPLITS_AFTER("2#{00000000 ; {\n}\n16#{; }\n}\nc", 2, 4, 0));
+  CHECK(SPLITS_AFTER("a#{; }\n}\nb\n", 1, 2, 0));
+  CHECK(SPLITS_AFTER("%{a\n}b%\n}%\nc\n", 3, 0));
+  CHECK(SPLITS_AFTER("%%{a\n}%\n}%%\nc\n", 3, 0));
+  CHECK(SPLITS_AFTER("x: %file\ny: a%{\n}\nz\n", 1, 3, 0));
+  CHECK(SPLITS_AFTER("; [ { \" %{\nb\n", 1, 0));
+  CHECK(SPLITS_AFTER("<a b=\">\n\" c='>\n'>\nd: a < b\ne\n", 3, 4, 0));
+
+  // Every alignment of what ends a run of plain bytes.
+  char source[128];
+  for (uint32_t k = 0; k < 48; k++) {
+    memset(source, 'a', k);
+    strcpy(source + k, "[\nb]\nz\n");
+    CHECK(SPLITS_AFTER(source, 2, 0));
+    memset(source, 'a', k);
+    strcpy(source + k, "{[\n}\n");
+    CHECK(SPLITS_AFTER(source, 0));
+  }
+
+  // Chunks of at least the given size, and up to the capacity.
+  static const char line[] = "x: [1 2 3]\n";
+  uint32_t lines = 1000, length = lines * (sizeof(line) - 1);
+  char *script = malloc(length);
+  for (uint32_t i = 0; i < lines; i++) {
+    memcpy(script + i * (sizeof(line) - 1), line, sizeof(line) - 1);
+  }
+  TSRedSplit splits[200];
+  uint32_t count = tree_sitter_red_split(script, length, 100, splits, 200);
+  CHECK(count == 99 && count <= length / 100);
+  for (uint32_t i = 0; i < count; i++) {
+    CHECK(splits[i].byte == (i + 1) * 110 && splits[i].row == (i + 1) * 10);
+  }
+  CHECK(tree_sitter_red_split(script, length, 100, splits, 5) == 5);
+  CHECK(tree_sitter_red_split(script, length, length, splits, 200) == 0);
+  free(script);
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+#include "tree_sitter/tree-sitter-red-split.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tree_sitter/api.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static const char *const lines[] = {
+    "Red [title: \"data\"]\n",
+    "add: func [a b] [\n  a + b\n]\n",
+    "s: {multi\nline [ string}\n",
+    "r: %{raw\n]}% ; comment [\n",
+    "b: #{\n  DEADBEEF\n}\n",
+    "m: #[a: 1\n b: \"x\"]\n",
+    "t: <a href=\"x\">\n",
+    "p: 'a/(b + 1)/c\n",
+};
+
+static bool same_node(TSNode a, TSNode b) {
+  return ts_node_symbol(a) == ts_node_symbol(b) &&
+         ts_node_start_byte(a) == ts_node_start_byte(b) &&
+         ts_node_end_byte(a) == ts_node_end_byte(b) &&
+         ts_node_start_point(a).row == ts_node_start_point(b).row &&
+         ts_node_start_point(a).column == ts_node_start_point(b).column;
+}
+
+int main(void) {
+  // A script of the lines over and over.
+  size_t capacity = 1 << 16, size = 0;
+  char *source = malloc(capacity);
+  for (size_t i = 0; source; i++) {
+    const char *line = lines[i % (sizeof(lines) / sizeof(lines[0]))];
+    size_t length = strlen(line);
+    if (size + length > capacity) {
+      break;
+    }
+    memcpy(source + size, line, length);
+    size += length;
+  }
+  uint32_t length = (uint32_t)size;
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_red());
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+  TSNode root = ts_tree_root_node(tree);
+
+  TSRedChunks chunks;
+  CHECK(tree_sitter_red_parse_chunks(source, length, 4096, 4, &chunks));
+  CHECK(chunks.count > 8 && chunks.count <= length / 4096 + 1);
+  CHECK(tree_sitter_red_chunks_has_error(&chunks) == ts_node_has_error(root));
+
+  // The top-level nodes of the chunks are those of the whole script.
+  uint32_t child = 0, child_count = ts_node_child_count(root);
+  for (uint32_t i = 0; i < chunks.count; i++) {
+    TSNode chunk_root = ts_tree_root_node(chunks.trees[i]);
+    uint32_t end = i + 1 < chunks.count ? chunks.starts[i + 1].byte : length;
+    for (uint32_t j = 0; j < ts_node_child_count(chunk_root); j++) {
+      TSNode node = ts_node_child(chunk_root, j);
+      CHECK(child < child_count && same_node(node, ts_node_child(root, child)));
+      CHECK(ts_node_start_byte(node) >= chunks.starts[i].byte &&
+            ts_node_end_byte(node) <= end);
+      child++;
+    }
+  }
+  CHECK(child == child_count);
+
+  // Looking up a node finds it in its chunk.
+  for (uint32_t byte = 0; byte < length; byte += 997) {
+    uint32_t chunk = tree_sitter_red_chunks_find(&chunks, byte);
+    CHECK(chunks.starts[chunk].byte <= byte);
+    CHECK(chunk + 1 == chunks.count || byte < chunks.starts[chunk + 1].byte);
+    TSNode found =
+        tree_sitter_red_chunks_descendant_for_byte_range(&chunks, byte, byte);
+    CHECK(same_node(found, ts_node_descendant_for_byte_range(root, byte, byte)));
+  }
+  uint32_t boundary = chunks.starts[1].byte;
+  CHECK(ts_node_is_null(tree_sitter_red_chunks_descendant_for_byte_range(
+      &chunks, boundary - 2, boundary + 2)));
+
+  // One thread, and a single chunk, parse the same.
+  TSRedChunks single;
+  CHECK(tree_sitter_red_parse_chunks(source, length, 4096, 1, &single));
+  CHECK(single.count == chunks.count);
+  tree_sitter_red_chunks_delete(&single);
+  CHECK(tree_sitter_red_parse_chunks(source, length, length, 0, &single));
+  CHECK(single.count == 1 &&
+        same_node(ts_tree_root_node(single.trees[0]), root));
+  tree_sitter_red_chunks_delete(&single);
+
+  tree_sitter_red_chunks_delete(&chunks);
+  CHECK(chunks.count == 0 && chunks.trees == NULL);
+  ts_tree_delete(tree);
+  ts_parser_delete(parser);
+  free(source);
+  return failures == 0 ? 0 : 1;
+}
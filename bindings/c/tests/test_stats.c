@@ -0,0 +1,68 @@
+#include "tree_sitter/tree-sitter-red-stats.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+int main(void) {
+  // A parse that splits into three versions, re-lexes a `/` after the
+  // external scanner declined it, and recovers from an error.
+  static const char *const log[] = {
+      "new_parse",
+      "process version:0, version_count:1, state:1, row:0, col:0",
+      "lex_external state:2, row:0, column:0",
+      "lex_internal state:5, row:0, column:0",
+      "consume character:'a'",
+      "lexed_lookahead sym:word, size:1",
+      "process version:0, version_count:3, state:7, row:0, col:1",
+      "lex_internal state:5, row:0, column:1",
+      "skip character:' '",
+      "consume character:'/'",
+      "process version:2, version_count:2, state:9, row:0, col:3",
+      "detect_error lookahead:]",
+      "recover_to_previous state:1, depth:2",
+      "skip_token symbol:]",
+      "recover_with_missing symbol:], state:4",
+      "reuse_node symbol:block",
+      "lex_internal state:5, row:1, column:1",
+      "accept",
+      "done",
+  };
+  TSRedParseStats stats = {0};
+  for (size_t i = 0; i < sizeof(log) / sizeof(*log); i++) {
+    tree_sitter_red_stats_record(&stats, log[i]);
+  }
+  CHECK(stats.lexes == 4);
+  CHECK(stats.external_lexes == 1);
+  CHECK(stats.relexes == 1);
+  CHECK(stats.consumed == 2 && stats.skipped == 1);
+  CHECK(stats.max_versions == 3);
+  CHECK(stats.errors == 1);
+  CHECK(stats.recoveries == 2);
+  CHECK(stats.skipped_tokens == 1);
+  CHECK(stats.reused_nodes == 1);
+
+  CHECK(strcmp(tree_sitter_red_scanner_token_name(TSRedScannerIpv6Address),
+               "ipv6_address") == 0);
+  CHECK(tree_sitter_red_scanner_token_name(TSRedScannerTokenCount) == NULL);
+
+  // With or without TREE_SITTER_RED_STATS, counters read as zero after a
+  // reset.
+  TSRedScannerStats scanner;
+  memset(&scanner, 0xff, sizeof(scanner));
+  tree_sitter_red_external_scanner_stats_reset();
+  tree_sitter_red_external_scanner_stats(&scanner);
+  CHECK(scanner.tokens == 0 && scanner.advanced == 0 &&
+        scanner.discarded == 0 && scanner.calls[0] == 0);
+
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,248 @@
+#include "tree_sitter/tree-sitter-red-stream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+#define PATH "test-stream.red"
+
+typedef struct {
+  const char *data;
+  uint32_t length;
+  // Reads fail from here on.
+  uint64_t fail_at;
+  unsigned reads;
+} Source;
+
+// Returns a few bytes at a time, as a pipe may.
+static int64_t read_source(void *payload, uint64_t offset, char *buffer,
+                           uint32_t size) {
+  Source *source = payload;
+  source->reads++;
+  if (offset >= source->fail_at) {
+    return -1;
+  }
+  if (offset >= source->length) {
+    return 0;
+  }
+  uint64_t count = source->length - offset;
+  count = count < size ? count : size;
+  count = count < 7 ? count : 7;
+  memcpy(buffer, source->data + offset, (size_t)count);
+  return (int64_t)count;
+}
+
+static bool write_file(const char *data, size_t length) {
+  FILE *file = fopen(PATH, "wb");
+  bool written = file && fwrite(data, 1, length, file) == length;
+  return file && fclose(file) == 0 && written;
+}
+
+typedef TSRedStream *Open(const char *data, uint32_t length, uint32_t window,
+                          Source *source);
+
+static TSRedStream *open_file(const char *data, uint32_t length,
+                              uint32_t window, Source *source) {
+  (void)source;
+  return write_file(data, length) ? tree_sitter_red_stream_open(PATH, window)
+                                  : NULL;
+}
+
+static TSRedStream *open_reader(const char *data, uint32_t length,
+                                uint32_t window, Source *source) {
+  *source = (Source){data, length, UINT64_MAX, 0};
+  return tree_sitter_red_stream_new(read_source, source, window);
+}
+
+// Whether reading at each of `offsets` returns the text there, up to a
+// window of it, and nothing past its end.
+static bool reads_text(TSRedStream *stream, const char *text, uint32_t length,
+                       uint32_t window, const uint32_t *offsets,
+                       uint32_t count) {
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t offset = offsets[i], size;
+    const char *read = tree_sitter_red_stream_read(stream, offset, &size);
+    uint32_t left = offset < length ? length - offset : 0;
+    if (!read || size > window || size > left || (size < 4 && size < left) ||
+        (size && memcmp(read, text + offset, size) != 0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Read all of the text in order, as a parse does.
+static void read_all(TSRedStream *stream) {
+  uint32_t offset = 0, size;
+  while (tree_sitter_red_stream_read(stream, offset, &size), size > 0) {
+    offset += size;
+  }
+}
+
+static void test_reads(Open *open) {
+  // Long enough for the file's pages to be dropped behind the reads.
+  uint32_t length = 1 << 20;
+  char *text = malloc(length);
+  for (uint32_t i = 0; i < length; i++) {
+    text[i] = "a: [b \"c\"]\n"[i % 11];
+  }
+  Source source;
+  TSRedStream *stream = open(text, length, 4096, &source);
+  CHECK(stream && tree_sitter_red_stream_encoding(stream) == TSRedStreamUtf8 &&
+        tree_sitter_red_stream_bom_length(stream) == 0);
+  if (stream) {
+    uint32_t offsets[] = {0,      1,          4095,       4096,   100000,
+                          999999, length - 3, length - 1, length, length + 5,
+                          12,     0,          5000,       4097};
+    CHECK(reads_text(stream, text, length, 4096, offsets,
+                     sizeof(offsets) / sizeof(offsets[0])));
+    read_all(stream);
+    uint32_t again[] = {0, 7, length / 2};
+    CHECK(reads_text(stream, text, length, 4096, again, 3));
+    CHECK(tree_sitter_red_stream_invalid_offset(stream) == UINT32_MAX);
+    CHECK(!tree_sitter_red_stream_failed(stream));
+  }
+  tree_sitter_red_stream_delete(stream);
+
+  // Small windows are raised to the least.
+  stream = open(text, length, 1, &source);
+  uint32_t size;
+  CHECK(stream && tree_sitter_red_stream_read(stream, 0, &size) &&
+        size == TREE_SITTER_RED_STREAM_MIN_WINDOW);
+  tree_sitter_red_stream_delete(stream);
+
+  stream = open("", 0, 0, &source);
+  CHECK(stream && tree_sitter_red_stream_read(stream, 0, &size) && size == 0);
+  tree_sitter_red_stream_delete(stream);
+  free(text);
+}
+
+static void test_encodings(Open *open) {
+  static const struct {
+    const char *data;
+    uint32_t length;
+    TSRedStreamEncoding encoding;
+    uint32_t bom;
+  } cases[] = {
+      {"\xEF\xBB\xBFRed []", 9, TSRedStreamUtf8, 3},
+      {"\xFF\xFER\0e\0d\0", 8, TSRedStreamUtf16LE, 2},
+      {"\xFE\xFF\0R\0e\0d", 8, TSRedStreamUtf16BE, 2},
+      {"R\0e\0d\0", 6, TSRedStreamUtf16LE, 0},
+      {"\0R\0e\0d", 6, TSRedStreamUtf16BE, 0},
+      {"Red []", 6, TSRedStreamUtf8, 0},
+      {"\xC3\xA9t\xC3\xA9", 5, TSRedStreamUtf8, 0},
+  };
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    Source source;
+    TSRedStream *stream = open(cases[i].data, cases[i].length, 0, &source);
+    CHECK(stream &&
+          tree_sitter_red_stream_encoding(stream) == cases[i].encoding &&
+          tree_sitter_red_stream_bom_length(stream) == cases[i].bom);
+    if (!stream) {
+      continue;
+    }
+    // The mark is not part of the text.
+    uint32_t size;
+    const char *text = tree_sitter_red_stream_read(stream, 0, &size);
+    CHECK(size == cases[i].length - cases[i].bom &&
+          memcmp(text, cases[i].data + cases[i].bom, size) == 0);
+    CHECK(tree_sitter_red_stream_invalid_offset(stream) == UINT32_MAX);
+    tree_sitter_red_stream_delete(stream);
+  }
+}
+
+// The offset of the first invalid byte once all of `data` was read with a
+// window of 16, which cuts characters in two.
+static uint32_t invalid_offset(Open *open, const char *data, uint32_t length) {
+  Source source;
+  TSRedStream *stream = open(data, length, 16, &source);
+  if (!stream) {
+    return 0;
+  }
+  read_all(stream);
+  uint32_t offset = tree_sitter_red_stream_invalid_offset(stream);
+  tree_sitter_red_stream_delete(stream);
+  return offset;
+}
+
+#define INVALID_OFFSET(open, data) invalid_offset(open, data, sizeof(data) - 1)
+
+static void test_validation(Open *open) {
+  // Characters cut by the end of a window are whole in the next read.
+  CHECK(INVALID_OFFSET(open, "a: \"\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\" b: "
+                             "\"\xF0\x9F\x98\x80\xF0\x9F\x98\x80\"") ==
+        UINT32_MAX);
+  CHECK(INVALID_OFFSET(open, "0123456789abcd\xC3\xA9xyz") == UINT32_MAX);
+  CHECK(INVALID_OFFSET(open, "0123456789abcde\xE2\x82\xACxyz") == UINT32_MAX);
+
+  // Stray continuation bytes, overlong forms, surrogates, code points past
+  // U+10FFFF and characters cut by the end of the file.
+  CHECK(INVALID_OFFSET(open, "0123456789abcdefgh\x80") == 18);
+  CHECK(INVALID_OFFSET(open, "a \xC0\xAF") == 2);
+  CHECK(INVALID_OFFSET(open, "a \xE0\x80\xAF") == 2);
+  CHECK(INVALID_OFFSET(open, "abc \xED\xA0\x80") == 4);
+  CHECK(INVALID_OFFSET(open, "\xF4\x90\x80\x80") == 0);
+  CHECK(INVALID_OFFSET(open, "0123456789abcdefghij\xE2\x82") == 20);
+  CHECK(INVALID_OFFSET(open, "\xEF\xBB\xBF" "ab\xFF") == 2);
+
+  // Lone surrogates in UTF-16.
+  CHECK(INVALID_OFFSET(open, "\xFF\xFE" "a\0=\0\x3D\xD8\x00\xDE") ==
+        UINT32_MAX);
+  CHECK(INVALID_OFFSET(open, "\xFF\xFE" "a\0\x00\xDE") == 2);
+  CHECK(INVALID_OFFSET(open, "\xFE\xFF\0a\xD8\x3D\0b") == 2);
+  CHECK(INVALID_OFFSET(open, "\xFF\xFE" "a\0\x3D\xD8") == 2);
+  CHECK(INVALID_OFFSET(open, "a\0b\0c") == 4);
+
+  // Bytes the parser skips are checked too.
+  char text[4096];
+  memset(text, 'a', sizeof(text));
+  text[1000] = '\xFE';
+  Source source;
+  TSRedStream *stream = open(text, sizeof(text), 64, &source);
+  uint32_t size;
+  CHECK(stream && tree_sitter_red_stream_read(stream, 3000, &size) &&
+        size == 64);
+  CHECK(stream && tree_sitter_red_stream_invalid_offset(stream) == 1000);
+  tree_sitter_red_stream_delete(stream);
+}
+
+static void test_reader_failures(void) {
+  static const char text[] = "a: 1\nb: 2\nc: 3\nd: 4\ne: 5\nf: 6\ng: 7\n";
+  Source source = {text, sizeof(text) - 1, 20, 0};
+  TSRedStream *stream = tree_sitter_red_stream_new(read_source, &source, 16);
+  uint32_t size;
+  CHECK(stream && tree_sitter_red_stream_read(stream, 2, &size) && size == 14);
+  unsigned reads = source.reads;
+  CHECK(stream && tree_sitter_red_stream_read(stream, 9, &size) && size == 7 &&
+        source.reads == reads);
+  CHECK(stream && tree_sitter_red_stream_read(stream, 16, &size) && size == 0 &&
+        tree_sitter_red_stream_failed(stream));
+  CHECK(stream && tree_sitter_red_stream_read(stream, 0, &size) && size == 0);
+  tree_sitter_red_stream_delete(stream);
+
+  source.fail_at = 0;
+  CHECK(!tree_sitter_red_stream_new(read_source, &source, 16));
+}
+
+int main(void) {
+  Open *opens[] = {open_file, open_reader};
+  for (int i = 0; i < 2; i++) {
+    test_reads(opens[i]);
+    test_encodings(opens[i]);
+    test_validation(opens[i]);
+  }
+  test_reader_failures();
+  CHECK(!tree_sitter_red_stream_open(PATH ".missing", 0));
+  remove(PATH);
+  return failures == 0 ? 0 : 1;
+}
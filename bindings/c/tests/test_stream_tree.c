@@ -0,0 +1,171 @@
+#include "tree_sitter/tree-sitter-red-stream.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tree_sitter/api.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+#define PATH "test-stream-tree.red"
+
+static const char *const lines[] = {
+    "Red [title: \"donn\xC3\xA9" "es\"]\n",
+    "add: func [a b] [\n  a + b\n]\n",
+    "s: {multi\nline [ string}\n",
+    "r: %{raw\n]}% ; comment [\n",
+    "b: #{\n  DEADBEEF\n}\n",
+    "t: <a href=\"x\">\n",
+    "e: \"\xE2\x82\xAC \xF0\x9F\x98\x80\"\n",
+};
+
+static bool write_file(const char *bom, const char *data, size_t length) {
+  FILE *file = fopen(PATH, "wb");
+  bool written = file && fwrite(bom, 1, strlen(bom), file) == strlen(bom) &&
+                 fwrite(data, 1, length, file) == length;
+  return file && fclose(file) == 0 && written;
+}
+
+// Whether the trees have the same nodes at the same places.
+static bool same_tree(TSNode a, TSNode b) {
+  uint32_t count = ts_node_child_count(a);
+  if (ts_node_symbol(a) != ts_node_symbol(b) ||
+      ts_node_start_byte(a) != ts_node_start_byte(b) ||
+      ts_node_end_byte(a) != ts_node_end_byte(b) ||
+      ts_node_child_count(b) != count) {
+    return false;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    if (!same_tree(ts_node_child(a, i), ts_node_child(b, i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The script in UTF-16, as little-endian if `little` and big-endian if not.
+static char *utf16(const char *text, uint32_t length, bool little,
+                   uint32_t *size) {
+  char *out = malloc((size_t)length * 2);
+  uint32_t j = 0;
+  for (uint32_t i = 0; i < length;) {
+    uint8_t c = (uint8_t)text[i];
+    uint32_t n = c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+    uint32_t code = n == 1 ? c : c & (0x7F >> n);
+    for (uint32_t k = 1; k < n; k++) {
+      code = code << 6 | ((uint8_t)text[i + k] & 0x3F);
+    }
+    i += n;
+    uint16_t units[2] = {(uint16_t)code, 0};
+    uint32_t count = 1;
+    if (code > 0xFFFF) {
+      units[0] = (uint16_t)(0xD800 + ((code - 0x10000) >> 10));
+      units[1] = (uint16_t)(0xDC00 + ((code - 0x10000) & 0x3FF));
+      count = 2;
+    }
+    for (uint32_t k = 0; k < count; k++) {
+      out[j + !little] = (char)(units[k] & 0xFF);
+      out[j + little] = (char)(units[k] >> 8);
+      j += 2;
+    }
+  }
+  *size = j;
+  return out;
+}
+
+int main(void) {
+  size_t capacity = 1 << 18, length = 0;
+  char *source = malloc(capacity);
+  for (size_t i = 0; source; i++) {
+    const char *line = lines[i % (sizeof(lines) / sizeof(lines[0]))];
+    if (length + strlen(line) > capacity) {
+      break;
+    }
+    memcpy(source + length, line, strlen(line));
+    length += strlen(line);
+  }
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_red());
+  TSTree *expected =
+      ts_parser_parse_string(parser, NULL, source, (uint32_t)length);
+
+  // Mapped and read, with and without a mark, in small and default windows.
+  static const uint32_t windows[] = {16, 4096, 0};
+  for (size_t i = 0; i < 3; i++) {
+    for (int bom = 0; bom < 2; bom++) {
+      CHECK(write_file(bom ? "\xEF\xBB\xBF" : "", source, length));
+      TSRedStream *stream = tree_sitter_red_stream_open(PATH, windows[i]);
+      CHECK(stream && tree_sitter_red_stream_bom_length(stream) == 3u * bom);
+      if (!stream) {
+        continue;
+      }
+      TSTree *tree =
+          ts_parser_parse(parser, NULL, tree_sitter_red_stream_input(stream));
+      CHECK(tree && same_tree(ts_tree_root_node(tree),
+                              ts_tree_root_node(expected)));
+      CHECK(tree_sitter_red_stream_invalid_offset(stream) == UINT32_MAX);
+      ts_tree_delete(tree);
+      tree_sitter_red_stream_delete(stream);
+    }
+  }
+
+  // UTF-16 either way around parses to the same nodes, at the offsets of
+  // their text in UTF-16.
+  TSNode root = ts_tree_root_node(expected);
+  uint32_t second;
+  free(utf16(source, ts_node_start_byte(ts_node_child(root, 1)), true,
+             &second));
+  for (int little = 0; little < 2; little++) {
+    uint32_t size;
+    char *text = utf16(source, (uint32_t)length, little, &size);
+    CHECK(write_file(little ? "\xFF\xFE" : "\xFE\xFF", text, size));
+    TSRedStream *stream = tree_sitter_red_stream_open(PATH, 4096);
+    CHECK(stream && tree_sitter_red_stream_encoding(stream) ==
+                        (little ? TSRedStreamUtf16LE : TSRedStreamUtf16BE));
+    TSTree *tree =
+        stream ? ts_parser_parse(parser, NULL,
+                                 tree_sitter_red_stream_input(stream))
+               : NULL;
+    CHECK(tree && !ts_node_has_error(ts_tree_root_node(tree)) &&
+          ts_node_child_count(ts_tree_root_node(tree)) ==
+              ts_node_child_count(root) &&
+          ts_node_end_byte(ts_tree_root_node(tree)) == size);
+    CHECK(tree && ts_node_start_byte(ts_node_child(ts_tree_root_node(tree),
+                                                   1)) == second);
+    ts_tree_delete(tree);
+    tree_sitter_red_stream_delete(stream);
+    free(text);
+  }
+
+  // An invalid byte is found, and parsed as U+FFFD.
+  uint32_t invalid = 100;
+  while ((uint8_t)source[invalid] >= 0x80) {
+    invalid++;
+  }
+  source[invalid] = '\xFF';
+  CHECK(write_file("", source, length));
+  TSRedStream *stream = tree_sitter_red_stream_open(PATH, 64);
+  TSTree *tree =
+      ts_parser_parse(parser, NULL, tree_sitter_red_stream_input(stream));
+  CHECK(tree_sitter_red_stream_invalid_offset(stream) == invalid);
+  CHECK(ts_node_end_byte(ts_tree_root_node(tree)) == length);
+  ts_tree_delete(tree);
+  tree_sitter_red_stream_delete(stream);
+
+  remove(PATH);
+  ts_tree_delete(expected);
+  ts_parser_delete(parser);
+  free(source);
+  return failures == 0 ? 0 : 1;
+}
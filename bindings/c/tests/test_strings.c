@@ -0,0 +1,136 @@
+#include "tree_sitter/tree-sitter-red-strings.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static char buffer[64];
+
+// Decode `text` and compare its value, `length` bytes that may include NULs.
+static bool decodes_to(const char *text, const char *value, uint32_t length) {
+  TSRedString string;
+  return tree_sitter_red_string_decode(text, (uint32_t)strlen(text), buffer,
+                                       sizeof(buffer), &string) &&
+         string.length == length && memcmp(string.text, value, length) == 0;
+}
+
+#define DECODES_TO(text, value) decodes_to(text, value, sizeof(value) - 1)
+
+// Whether `text` decodes to a span of itself rather than into the buffer.
+static bool is_view(const char *text) {
+  TSRedString string;
+  uint32_t length = (uint32_t)strlen(text);
+  return tree_sitter_red_string_decode(text, length, buffer, sizeof(buffer),
+                                       &string) &&
+         string.text >= text && string.text + string.length <= text + length;
+}
+
+static bool rejects(const char *text) {
+  TSRedString string;
+  return !tree_sitter_red_string_decode(text, (uint32_t)strlen(text), buffer,
+                                        sizeof(buffer), &string);
+}
+
+int main(void) {
+  // Literals without escapes are spans of the source.
+  CHECK(DECODES_TO("\"\"", ""));
+  CHECK(DECODES_TO("\"plain text\"", "plain text"));
+  CHECK(DECODES_TO("{multi\nline {nested}}", "multi\nline {nested}"));
+  CHECK(DECODES_TO("#\"a\"", "a"));
+  CHECK(DECODES_TO("%\"\"", ""));
+  CHECK(DECODES_TO("%dir/file.red", "dir/file.red"));
+  CHECK(DECODES_TO("%{raw ^/ \"text\"}%", "raw ^/ \"text\""));
+  CHECK(DECODES_TO("%%{a}% b}%%", "a}% b"));
+  CHECK(is_view("\"plain text\""));
+  CHECK(is_view("%%{a ^ b}%%"));
+  CHECK(is_view("%file.red"));
+
+  // Carets.
+  CHECK(DECODES_TO("\"a^/b^-c^^d^\"e\"", "a\nb\tc^d\"e"));
+  CHECK(DECODES_TO("{^{^}}", "{}"));
+  CHECK(DECODES_TO("\"^(null)^(back)^(TAB)^(line)^(page)^(esc)^(del)\"",
+                   "\0\b\t\n\f\x1b\x7f"));
+  CHECK(DECODES_TO("\"^(41)^(e9)^(20AC)^(1F3F4)^(10FFFF)\"",
+                   "A\xc3\xa9\xe2\x82\xac\xf0\x9f\x8f\xb4\xf4\x8f\xbf\xbf"));
+  CHECK(DECODES_TO("\"^M^j^[^@^~\"", "\r\n\x1b\0\x7f"));
+  CHECK(DECODES_TO("#\"^(tab)\"", "\t"));
+  CHECK(DECODES_TO("#\"^\"\"", "\""));
+  CHECK(DECODES_TO("%\"my ^(tab) file\"", "my \t file"));
+  CHECK(!is_view("\"a^/b\""));
+  // Not escapes the grammar lexes, decoded as leniently as Red's load.
+  CHECK(DECODES_TO("\"^(110000)\"", "(110000)"));
+  CHECK(DECODES_TO("\"^(0000041)\"", "(0000041)"));
+  CHECK(DECODES_TO("\"^(tab\"", "(tab"));
+  CHECK(DECODES_TO("{a^}", "a^"));
+
+  // Percent signs in unquoted files.
+  CHECK(DECODES_TO("%my%20file%2Ered", "my file.red"));
+  CHECK(DECODES_TO("%100%", "100%"));
+  CHECK(DECODES_TO("%a%2", "a%2"));
+  CHECK(DECODES_TO("%a%zz", "a%zz"));
+
+  // Every code point through ^(...).
+  for (uint32_t code_point = 0; code_point <= 0x10ffff; code_point++) {
+    char text[16], expected[4];
+    TSRedString string;
+    int length = snprintf(text, sizeof(text), "\"^(%X)\"", code_point);
+    uint32_t size = 0;
+    if (code_point < 0x80) {
+      expected[size++] = (char)code_point;
+    } else if (code_point < 0x800) {
+      expected[size++] = (char)(0xc0 | (code_point >> 6));
+      expected[size++] = (char)(0x80 | (code_point & 0x3f));
+    } else if (code_point < 0x10000) {
+      expected[size++] = (char)(0xe0 | (code_point >> 12));
+      expected[size++] = (char)(0x80 | ((code_point >> 6) & 0x3f));
+      expected[size++] = (char)(0x80 | (code_point & 0x3f));
+    } else {
+      expected[size++] = (char)(0xf0 | (code_point >> 18));
+      expected[size++] = (char)(0x80 | ((code_point >> 12) & 0x3f));
+      expected[size++] = (char)(0x80 | ((code_point >> 6) & 0x3f));
+      expected[size++] = (char)(0x80 | (code_point & 0x3f));
+    }
+    if (!tree_sitter_red_string_decode(text, (uint32_t)length, buffer,
+                                       sizeof(buffer), &string) ||
+        string.length != size || memcmp(string.text, expected, size) != 0) {
+      fprintf(stderr, "cannot decode %s\n", text);
+      failures++;
+      break;
+    }
+  }
+
+  // The buffer is only needed, and only checked, when there are escapes.
+  static const char escaped[] = "\"abc^/def\"";
+  TSRedString string;
+  CHECK(tree_sitter_red_string_decode(escaped, sizeof(escaped) - 1, buffer, 7,
+                                      &string));
+  CHECK(string.text == buffer && string.length == 7);
+  CHECK(!tree_sitter_red_string_decode(escaped, sizeof(escaped) - 1, buffer, 6,
+                                       &string));
+  CHECK(tree_sitter_red_string_decode("\"abc\"", 5, NULL, 0, &string));
+
+  CHECK(rejects(""));
+  CHECK(rejects("\""));
+  CHECK(rejects("\"abc"));
+  CHECK(rejects("{abc"));
+  CHECK(rejects("#\""));
+  CHECK(rejects("#abc"));
+  CHECK(rejects("%"));
+  CHECK(rejects("%\""));
+  CHECK(rejects("%{abc}"));
+  CHECK(rejects("%%{abc}%"));
+  CHECK(rejects("%{abc}%%"));
+  CHECK(rejects("%%"));
+  CHECK(rejects("word"));
+
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,47 @@
+#include "tree_sitter/parser.h"
+#include "tree_sitter/tree-sitter-red-symbols.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static int failures = 0;
+
+static void check_symbol(const TSLanguage *language, TSSymbol id,
+                         const char *name) {
+  if (id >= language->symbol_count ||
+      strcmp(language->symbol_names[id], name) != 0 ||
+      language->public_symbol_map[id] != id ||
+      !language->symbol_metadata[id].visible ||
+      !language->symbol_metadata[id].named) {
+    fprintf(stderr, "symbol %s is not %u\n", name, id);
+    failures++;
+  }
+}
+
+static void check_field(const TSLanguage *language, TSFieldId id,
+                        const char *name) {
+  if (id == 0 || id > language->field_count ||
+      strcmp(language->field_names[id], name) != 0) {
+    fprintf(stderr, "field %s is not %u\n", name, id);
+    failures++;
+  }
+}
+
+int main(void) {
+  const TSLanguage *language = tree_sitter_red();
+
+  if (language->abi_version != TREE_SITTER_RED_LANGUAGE_VERSION ||
+      language->symbol_count != TREE_SITTER_RED_SYMBOL_COUNT ||
+      language->field_count != TREE_SITTER_RED_FIELD_COUNT) {
+    fprintf(stderr, "tree-sitter-red-symbols.h is out of date\n");
+    return 1;
+  }
+
+#define CHECK_SYMBOL(id, name) check_symbol(language, id, name);
+#define CHECK_FIELD(id, name) check_field(language, id, name);
+  TREE_SITTER_RED_SYMBOLS(CHECK_SYMBOL)
+  TREE_SITTER_RED_FIELDS(CHECK_FIELD)
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+#include "tree_sitter/parser.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <stdio.h>
+
+// The parse table must stay deterministic: with one token of lookahead,
+// every state has one action per token. The only entries with more are the
+// ones tree-sitter generates for repetitions, a reduce of the repetition
+// next to a shift marked `repetition`, which the runtime resolves without
+// splitting the stack. Precedences between `word`, `path`, `set_path`,
+// `url` and `email` are decided by the generator; a grammar change that
+// leaves a real conflict for the runtime to fork on fails here.
+
+static int failures = 0;
+
+static void check_entry(const TSLanguage *language, uint32_t state,
+                        TSSymbol symbol, uint16_t index) {
+  const TSParseActionEntry *entry = &language->parse_actions[index];
+  if (entry->entry.count < 2) {
+    return;
+  }
+  unsigned shifts = 0, reduces = 0;
+  for (unsigned i = 1; i <= entry->entry.count; i++) {
+    const TSParseAction *action = &entry[i].action;
+    if (action->type == TSParseActionTypeShift && action->shift.repetition) {
+      shifts++;
+    } else if (action->type == TSParseActionTypeReduce) {
+      reduces++;
+    }
+  }
+  if (entry->entry.count != 2 || shifts != 1 || reduces != 1) {
+    fprintf(stderr, "state %u forks on %s: %u actions\n", state,
+            language->symbol_names[symbol], entry->entry.count);
+    failures++;
+  }
+}
+
+int main(void) {
+  const TSLanguage *language = tree_sitter_red();
+  for (uint32_t state = 0; state < language->large_state_count; state++) {
+    for (TSSymbol symbol = 0; symbol < language->token_count; symbol++) {
+      uint16_t index =
+          language->parse_table[state * language->symbol_count + symbol];
+      if (index) {
+        check_entry(language, state, symbol, index);
+      }
+    }
+  }
+
+  // Small states list their entries as groups of symbols sharing a value.
+  for (uint32_t state = language->large_state_count;
+       state < language->state_count; state++) {
+    const uint16_t *data =
+        language->small_parse_table +
+        language->small_parse_table_map[state - language->large_state_count];
+    uint16_t group_count = *data++;
+    for (uint16_t group = 0; group < group_count; group++) {
+      uint16_t index = *data++;
+      uint16_t symbol_count = *data++;
+      for (uint16_t i = 0; i < symbol_count; i++) {
+        TSSymbol symbol = *data++;
+        if (symbol < language->token_count) {
+          check_entry(language, state, symbol, index);
+        }
+      }
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}
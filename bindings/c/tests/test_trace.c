@@ -0,0 +1,185 @@
+#include "tree_sitter/tree-sitter-red-deps.h"
+#include "tree_sitter/tree-sitter-red-trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static bool points_equal(TSRedTracePoint a, uint32_t row, uint32_t column) {
+  return a.row == row && a.column == column;
+}
+
+static bool edits_equal(const TSRedTraceEdit *a, const TSRedTraceEdit *b) {
+  return a->start_byte == b->start_byte && a->old_end_byte == b->old_end_byte &&
+         a->new_end_byte == b->new_end_byte &&
+         memcmp(&a->start_point, &b->start_point,
+                3 * sizeof(TSRedTracePoint)) == 0 &&
+         a->text_offset == b->text_offset && a->joined == b->joined;
+}
+
+static bool decodes(const char *text) {
+  TSRedTrace trace;
+  uint32_t line;
+  bool ok = tree_sitter_red_trace_decode(text, strlen(text), &trace, &line);
+  tree_sitter_red_trace_delete(&trace);
+  return ok;
+}
+
+static char *read_file(const char *path, uint32_t *length) {
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    return NULL;
+  }
+  char *data = NULL;
+  long size;
+  if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) >= 0 &&
+      fseek(file, 0, SEEK_SET) == 0 && (data = malloc((size_t)size + 1)) &&
+      fread(data, 1, (size_t)size, file) == (size_t)size) {
+    *length = (uint32_t)size;
+  } else {
+    free(data);
+    data = NULL;
+  }
+  fclose(file);
+  return data;
+}
+
+// Every edit of a recorded trace has the points that recording it again
+// from the document would give, and fits the document.
+static void check_trace_file(const char *path) {
+  uint32_t size, line, length;
+  char *data = read_file(path, &size);
+  TSRedTrace trace, again = {0};
+  CHECK(data && tree_sitter_red_trace_decode(data, size, &trace, &line));
+  if (!data) {
+    return;
+  }
+  free(data);
+  CHECK(trace.source != NULL && trace.count > 0);
+  char *source = trace.source ? tree_sitter_red_deps_resolve(path, trace.source)
+                              : NULL;
+  char *document = source ? read_file(source, &length) : NULL;
+  uint32_t capacity = length;
+  CHECK(document != NULL);
+  for (uint32_t i = 0; document && i < trace.count; i++) {
+    const TSRedTraceEdit *edit = &trace.edits[i];
+    CHECK(tree_sitter_red_trace_record(
+        &again, document, length, edit->start_byte, edit->old_end_byte,
+        trace.text + edit->text_offset, edit->new_end_byte - edit->start_byte,
+        edit->joined));
+    const TSRedTraceEdit *recorded = &again.edits[again.count - 1];
+    if (memcmp(&recorded->start_point, &edit->start_point,
+               3 * sizeof(TSRedTracePoint)) != 0) {
+      fprintf(stderr, "%s: edit %u has wrong points\n", path, i + 1);
+      failures++;
+      break;
+    }
+    CHECK(tree_sitter_red_trace_apply(&trace, edit, &document, &length,
+                                      &capacity));
+  }
+  free(document);
+  free(source);
+  tree_sitter_red_trace_delete(&again);
+  tree_sitter_red_trace_delete(&trace);
+}
+
+int main(void) {
+  // Points count rows and byte columns from the document before the edit.
+  const char *text = "Red []\nprint \"h\xc3\xa9\"\n";
+  uint32_t length = (uint32_t)strlen(text), capacity = length;
+  char *document = malloc(length);
+  memcpy(document, text, length);
+  TSRedTrace trace = {0};
+  CHECK(tree_sitter_red_trace_set_source(&trace, "a b.red"));
+  CHECK(tree_sitter_red_trace_record(&trace, document, length, 17, 17,
+                                     "!\n\t\"x\"", 6, false));
+  CHECK(trace.count == 1);
+  CHECK(points_equal(trace.edits[0].start_point, 1, 10));
+  CHECK(points_equal(trace.edits[0].old_end_point, 1, 10));
+  CHECK(points_equal(trace.edits[0].new_end_point, 2, 4));
+  CHECK(tree_sitter_red_trace_apply(&trace, &trace.edits[0], &document, &length,
+                                    &capacity));
+  CHECK(length == 25 && memcmp(document, "Red []\nprint \"h\xc3\xa9!\n\t\"x\"\"\n",
+                               25) == 0);
+
+  // Replacing across lines, and a joined edit.
+  CHECK(tree_sitter_red_trace_record(&trace, document, length, 4, 13, "\x01", 1,
+                                     false));
+  CHECK(points_equal(trace.edits[1].start_point, 0, 4));
+  CHECK(points_equal(trace.edits[1].old_end_point, 1, 6));
+  CHECK(points_equal(trace.edits[1].new_end_point, 0, 5));
+  CHECK(tree_sitter_red_trace_apply(&trace, &trace.edits[1], &document, &length,
+                                    &capacity));
+  CHECK(length == 17 && memcmp(document, "Red \x01\"h\xc3\xa9!\n\t\"x\"\"\n",
+                               17) == 0);
+  CHECK(tree_sitter_red_trace_record(&trace, document, length, 0, 3, "", 0,
+                                     true));
+  CHECK(trace.edits[2].joined && trace.edits[2].new_end_byte == 0);
+  CHECK(!tree_sitter_red_trace_record(&trace, document, length, 3, 18, "", 0,
+                                      false));
+  CHECK(!tree_sitter_red_trace_record(&trace, document, length, 3, 2, "", 0,
+                                      false));
+
+  // The text form survives a round trip, escapes included.
+  char *data;
+  size_t size;
+  CHECK(tree_sitter_red_trace_encode(&trace, &data, &size));
+  const char *expected = "source a b.red\n"
+                         "edit 17 17 23 1:10 1:10 2:4 \"!\\n\\t\\\"x\\\"\"\n"
+                         "edit 4 13 5 0:4 1:6 0:5 \"\\x01\"\n"
+                         "also 0 3 0 0:0 0:3 0:0 \"\"\n";
+  CHECK(size == strlen(expected) && memcmp(data, expected, size) == 0);
+  TSRedTrace decoded;
+  uint32_t line;
+  CHECK(tree_sitter_red_trace_decode(data, size, &decoded, &line));
+  CHECK(strcmp(decoded.source, "a b.red") == 0);
+  CHECK(decoded.count == 3 && decoded.text_size == trace.text_size);
+  for (uint32_t i = 0; i < 3; i++) {
+    CHECK(edits_equal(&decoded.edits[i], &trace.edits[i]));
+  }
+  CHECK(memcmp(decoded.text, trace.text, trace.text_size) == 0);
+  tree_sitter_red_trace_delete(&decoded);
+  free(data);
+  tree_sitter_red_trace_delete(&trace);
+  CHECK(trace.count == 0 && trace.source == NULL);
+  free(document);
+
+  // Comments, blank lines and a missing final newline are fine; malformed
+  // lines are reported by number.
+  CHECK(decodes("# comment\n\nedit 0 0 1 0:0 0:0 0:1 \"\\\\\""));
+  CHECK(decodes(""));
+  CHECK(!decodes("also 0 0 1 0:0 0:0 0:1 \"x\"\n"));
+  CHECK(!decodes("edit 0 0 2 0:0 0:0 0:1 \"x\"\n"));
+  CHECK(!decodes("edit 0 0 1 0:0 0:0 0:1 \"\\q\"\n"));
+  CHECK(!decodes("edit 0 0 1 0:0 0:0 0:1 \"\\x4\"\n"));
+  CHECK(!decodes("edit 0 0 1 0:0 0:0 0:1 \"x\" \n"));
+  CHECK(!decodes("edit 0 0 1 0:0 0:0 \"x\"\n"));
+  CHECK(!decodes("edit 0 0 1 0:0 0:0 0:1 \"x\nedit\"\n"));
+  CHECK(!decodes("edit 0 0 1 0:0 0:0 0:1 \"x\"\nsource a.red\n"));
+  CHECK(!decodes("edit 99999999999 0 1 0:0 0:0 0:1 \"x\"\n"));
+  CHECK(!tree_sitter_red_trace_decode("\n# x\nedt\n", 9, &decoded, &line));
+  CHECK(line == 3);
+
+#ifdef TREE_SITTER_RED_TRACES_DIR
+  static const char *const traces[] = {"comment-block", "open-brace",
+                                       "paste-binary", "type-function"};
+  for (size_t i = 0; i < sizeof(traces) / sizeof(traces[0]); i++) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s.trace", TREE_SITTER_RED_TRACES_DIR,
+             traces[i]);
+    check_trace_file(path);
+  }
+#endif
+
+  return failures == 0 ? 0 : 1;
+}
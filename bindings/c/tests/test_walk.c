@@ -0,0 +1,139 @@
+#include "tree_sitter/tree-sitter-red-errors.h"
+#include "tree_sitter/tree-sitter-red-symbols.h"
+#include "tree_sitter/tree-sitter-red-walk.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tree_sitter/api.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+// Deeper than any recursive walk over `ts_node_child` would survive with
+// a small stack, and deep enough that a walk using `ts_node_parent` would
+// take minutes.
+#define DEPTH 100000
+
+typedef struct {
+  uint64_t entered;
+  uint64_t left;
+  uint32_t depth;
+  uint32_t max_depth;
+  uint32_t blocks;
+  bool balanced;
+  // Stop after this many blocks, or 0.
+  uint32_t stop_after;
+  bool skip_blocks;
+} Visits;
+
+static TSRedWalkAction enter(void *payload, TSNode node, uint32_t depth) {
+  Visits *visits = payload;
+  visits->entered++;
+  visits->balanced &= depth == visits->depth;
+  visits->depth = depth + 1;
+  visits->max_depth = depth > visits->max_depth ? depth : visits->max_depth;
+  if (ts_node_symbol(node) == TSRedSymbolBlock) {
+    visits->blocks++;
+    if (visits->stop_after && visits->blocks == visits->stop_after) {
+      return TSRedWalkStop;
+    }
+    if (visits->skip_blocks) {
+      visits->depth = depth;
+      return TSRedWalkOver;
+    }
+  }
+  return TSRedWalkInto;
+}
+
+static void leave(void *payload, TSNode node, uint32_t depth) {
+  Visits *visits = payload;
+  (void)node;
+  visits->left++;
+  visits->balanced &= depth + 1 == visits->depth;
+  visits->depth = depth;
+}
+
+static char *nested(const char *open, const char *close, uint32_t depth,
+                    uint32_t *length) {
+  size_t open_length = strlen(open), close_length = strlen(close);
+  char *source = malloc(depth * (open_length + close_length) + 1);
+  char *end = source;
+  for (uint32_t i = 0; source && i < depth; i++) {
+    memcpy(end, open, open_length);
+    end += open_length;
+  }
+  for (uint32_t i = 0; source && i < depth; i++) {
+    memcpy(end, close, close_length);
+    end += close_length;
+  }
+  *length = (uint32_t)(end - source);
+  return source;
+}
+
+int main(void) {
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_red());
+
+  uint32_t length;
+  char *source = nested("[", "]", DEPTH, &length);
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, length);
+  TSNode root = ts_tree_root_node(tree);
+  CHECK(!ts_node_has_error(root));
+
+  // A block is itself and its two brackets, under the source file.
+  TSRedTreeShape shape = tree_sitter_red_tree_shape(root);
+  CHECK(shape.nodes == 1 + 3 * (uint64_t)DEPTH);
+  CHECK(shape.named_nodes == 1 + (uint64_t)DEPTH);
+  CHECK(shape.depth == DEPTH + 1);
+  CHECK(shape.max_children == 3);
+
+  Visits visits = {0, 0, 0, 0, 0, true, 0, false};
+  TSRedWalker walker = {enter, leave, &visits};
+  CHECK(tree_sitter_red_walk(root, &walker));
+  CHECK(visits.entered == shape.nodes && visits.left == shape.nodes);
+  CHECK(visits.max_depth == DEPTH + 1 && visits.depth == 0);
+  CHECK(visits.balanced);
+
+  // Skipping the outermost block skips them all; stopping ends the walk.
+  visits = (Visits){0, 0, 0, 0, 0, true, 0, true};
+  CHECK(tree_sitter_red_walk(root, &walker));
+  CHECK(visits.blocks == 1 && visits.entered == 2 && visits.left == 1);
+  CHECK(visits.balanced);
+  visits = (Visits){0, 0, 0, 0, 0, true, 1000, false};
+  CHECK(!tree_sitter_red_walk(root, &walker));
+  CHECK(visits.blocks == 1000);
+
+  // A walk from a node stays under it.
+  TSNode block = ts_node_named_child(root, 0);
+  visits = (Visits){0, 0, 0, 0, 0, true, 0, false};
+  CHECK(tree_sitter_red_walk(block, &walker));
+  CHECK(visits.entered == shape.nodes - 1 && visits.max_depth == DEPTH);
+  ts_tree_delete(tree);
+  free(source);
+
+  // Every unclosed block is reported, in time linear in their number.
+  source = nested("(", "", DEPTH, &length);
+  tree = ts_parser_parse_string(parser, NULL, source, length);
+  TSRedErrorList errors = {0};
+  CHECK(tree_sitter_red_errors_collect(tree, &errors));
+  CHECK(errors.count >= 1);
+  for (uint32_t i = 0; i < errors.count; i++) {
+    CHECK(errors.items[i].token_end <= length);
+  }
+  tree_sitter_red_errors_delete(&errors);
+  ts_tree_delete(tree);
+  free(source);
+
+  ts_parser_delete(parser);
+  return failures == 0 ? 0 : 1;
+}
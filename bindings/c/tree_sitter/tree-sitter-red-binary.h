@@ -0,0 +1,44 @@
+#ifndef TREE_SITTER_RED_BINARY_H_
+#define TREE_SITTER_RED_BINARY_H_
+
+// The bytes of binary! literals: `#{...}` and `16#{...}` in base 16,
+// `2#{...}` in base 2 and `64#{...}` in base 64, with the whitespace,
+// newlines and `;` comments between the digits skipped.
+//
+// On x86 CPUs with SSE2 and SSSE3, checked at run time, runs of base-16 and
+// base-64 digits are decoded 32 and 16 digits at a time; the rest of the
+// body, and every body on other CPUs, is decoded a digit at a time. Decoding
+// nodes needs the tree-sitter runtime; decoding text does not.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TSNode TSNode;
+
+// Decode a literal as written, from its base to its closing brace, into
+// `buffer`, and store the number of bytes in `size`. There are never more
+// bytes than three quarters of `length`. Returns false if `text` is not a
+// binary literal, if its digits do not make whole bytes, or if `capacity`
+// is too small.
+bool tree_sitter_red_binary_decode(const char *text, uint32_t length,
+                                   uint8_t *buffer, uint32_t capacity,
+                                   uint32_t *size);
+
+// Decode a binary node of a tree parsed from `source`. Requires the runtime.
+bool tree_sitter_red_binary_from_node(TSNode node, const char *source,
+                                      uint8_t *buffer, uint32_t capacity,
+                                      uint32_t *size);
+
+// The decoder this CPU uses for runs of digits: "ssse3", "sse2" or
+// "scalar". "sse2" decodes only base 16 in blocks.
+const char *tree_sitter_red_binary_implementation(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_BINARY_H_
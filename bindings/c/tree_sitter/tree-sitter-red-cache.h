@@ -0,0 +1,73 @@
+#ifndef TREE_SITTER_RED_CACHE_H_
+#define TREE_SITTER_RED_CACHE_H_
+
+// A persistent cache of results derived from Red sources, so that repeated
+// runs over unchanged files can skip parsing them.
+//
+// An entry is keyed by a hash of the source contents and a kind (an error
+// list, an outline, an encoded tree, ...) and holds opaque bytes. Entries are
+// also tagged with TREE_SITTER_RED_GRAMMAR_FINGERPRINT, and entries written
+// by a different grammar are never returned.
+//
+// The store is a single append-only file in the cache directory. Every record
+// is appended with one write to an O_APPEND descriptor, so any number of
+// processes can share a cache without locking; values are checksummed, and a
+// torn record reads as a miss without hiding the records appended after it.
+// Hits append a small touch record, so recency survives across runs. Once the
+// file outgrows its size limit, on a put or a hit, it is rewritten with the
+// most recently used entries of the current grammar and renamed over the old
+// one. Records that race with a compaction are dropped, which only costs a
+// later miss.
+//
+// The cache is not available on Windows, where `tree_sitter_red_cache_open`
+// always fails.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  TSRedCacheErrors = 1,
+  TSRedCacheOutline = 2,
+  TSRedCacheSymbols = 3,
+  // A tree in the encoding of tree-sitter-red-serialize.h.
+  TSRedCacheTree = 4,
+  // A list in the encoding of tree-sitter-red-deps.h.
+  TSRedCacheDependencies = 5,
+  // Kinds from here on are free for applications.
+  TSRedCacheUser = 0x100,
+} TSRedCacheKind;
+
+typedef struct TSRedCache TSRedCache;
+
+// A fast, non-cryptographic 64-bit hash.
+uint64_t tree_sitter_red_hash(const void *data, size_t length, uint64_t seed);
+
+// Open or create the cache in `directory`. A `size_limit` of zero selects
+// TREE_SITTER_RED_CACHE_DEFAULT_LIMIT.
+#define TREE_SITTER_RED_CACHE_DEFAULT_LIMIT (64u << 20)
+TSRedCache *tree_sitter_red_cache_open(const char *directory,
+                                       uint64_t size_limit);
+void tree_sitter_red_cache_close(TSRedCache *cache);
+
+// Look up the entry of `kind` for the source whose `tree_sitter_red_hash` with
+// a zero seed is `hash`. On a hit, `value` receives a copy that the caller
+// releases with `free`.
+bool tree_sitter_red_cache_get(TSRedCache *cache, uint64_t hash, uint32_t kind,
+                               uint8_t **value, size_t *length);
+bool tree_sitter_red_cache_put(TSRedCache *cache, uint64_t hash, uint32_t kind,
+                               const void *value, size_t length);
+
+// Rewrite the store now, keeping the most recently used entries that fit in
+// half of the size limit.
+bool tree_sitter_red_cache_compact(TSRedCache *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_CACHE_H_
@@ -0,0 +1,132 @@
+#ifndef TREE_SITTER_RED_COLUMNS_H_
+#define TREE_SITTER_RED_COLUMNS_H_
+
+// Tuple, IPv6, url and email literals of many scripts, decoded into
+// columns: one array per field, in the layout of Arrow's struct of arrays,
+// so that they can be handed to a columnar engine and joined without
+// converting each row.
+//
+// Every table has the file and the byte offset of each literal. Tuples,
+// which include IPv4 addresses, colors and versions, are up to 12 bytes;
+// IPv6 addresses are 16 bytes in network order with their prefix length
+// and zone; urls and emails are their text as written. Extracting literals
+// from trees and files needs the tree-sitter runtime; decoding literals and
+// building columns do not.
+
+#include "tree-sitter-red-symbols.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TSTree TSTree;
+
+// Variable-length values: value `i` is `data[offsets[i]..offsets[i + 1])`,
+// with `count + 1` offsets, as in Arrow's utf8 arrays.
+typedef struct {
+  uint32_t *offsets;
+  char *data;
+  uint32_t size;
+  uint32_t capacity;
+} TSRedStringColumn;
+
+typedef struct {
+  uint32_t count;
+  uint32_t capacity;
+  // The file each literal came from, as an index into the paths given to
+  // `tree_sitter_red_columns_scan`, and its offset in that file.
+  uint32_t *file;
+  uint32_t *start_byte;
+  // 12 bytes per tuple, of which the first `length` are set and the rest 0.
+  uint8_t *bytes;
+  uint8_t *length;
+} TSRedTupleColumns;
+
+// A prefix length of an IPv6 address without one.
+#define TREE_SITTER_RED_NO_PREFIX 255
+
+typedef struct {
+  uint32_t count;
+  uint32_t capacity;
+  uint32_t *file;
+  uint32_t *start_byte;
+  // 16 bytes per address.
+  uint8_t *address;
+  // 0..128, or TREE_SITTER_RED_NO_PREFIX.
+  uint8_t *prefix;
+  // Without its `%`; empty without a zone.
+  TSRedStringColumn zone;
+} TSRedIpv6Columns;
+
+typedef struct {
+  uint32_t count;
+  uint32_t capacity;
+  uint32_t *file;
+  uint32_t *start_byte;
+  TSRedStringColumn text;
+  // For urls, the length of the scheme before the `:`; for emails, of the
+  // user before the `@`.
+  uint32_t *head_length;
+} TSRedTextColumns;
+
+// Zero-initialized columns are empty, and their arrays are NULL until they
+// have a row.
+typedef struct {
+  TSRedTupleColumns tuples;
+  TSRedIpv6Columns ipv6;
+  TSRedTextColumns urls;
+  TSRedTextColumns emails;
+} TSRedLiteralColumns;
+
+typedef struct {
+  uint8_t address[16];
+  uint8_t prefix;
+  const char *zone;
+  uint32_t zone_length;
+} TSRedIpv6;
+
+// Return false if `text` is not a literal of that type. A tuple has 3 to 12
+// bytes; an IPv6 literal may have a zone and a prefix, as in
+// `fe80::1%eth0/64`, and an IPv4 address as its last 32 bits.
+bool tree_sitter_red_tuple_decode(const char *text, uint32_t length,
+                                  uint8_t bytes[12], uint8_t *count);
+bool tree_sitter_red_ipv6_decode(const char *text, uint32_t length,
+                                 TSRedIpv6 *ipv6);
+
+// Decode the text of a tuple, ipv6, url or email node and append it to the
+// columns for its symbol. Other symbols and literals that do not decode,
+// such as `1.2.3.256` in an error, are skipped. Returns false when out of
+// memory, leaving the columns as they were.
+bool tree_sitter_red_columns_push(TSRedLiteralColumns *columns,
+                                  TSRedSymbol symbol, uint32_t file,
+                                  uint32_t start_byte, const char *text,
+                                  uint32_t length);
+
+// Append every row of `from` to `to`. Returns false when out of memory.
+bool tree_sitter_red_columns_append(TSRedLiteralColumns *to,
+                                    const TSRedLiteralColumns *from);
+
+// Free the columns and reset them to empty.
+void tree_sitter_red_columns_delete(TSRedLiteralColumns *columns);
+
+// Append the literals of a parsed script, in source order, as rows of
+// `file`. Requires the runtime.
+bool tree_sitter_red_columns_extract(const TSTree *tree, const char *source,
+                                     uint32_t file,
+                                     TSRedLiteralColumns *columns);
+
+// Parse `paths` on `threads` threads, or one per CPU if 0, and append their
+// literals, file by file in the order of `paths`. Files that cannot be read
+// have no rows. Requires the runtime and POSIX threads.
+bool tree_sitter_red_columns_scan(const char *const *paths, uint32_t count,
+                                  unsigned threads,
+                                  TSRedLiteralColumns *columns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_COLUMNS_H_
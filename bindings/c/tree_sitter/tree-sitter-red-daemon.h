@@ -0,0 +1,181 @@
+#ifndef TREE_SITTER_RED_DAEMON_H_
+#define TREE_SITTER_RED_DAEMON_H_
+
+// A resident parse daemon and its client.
+//
+// The daemon keeps a warm parser, the compiled highlights and outline
+// queries, and the source and last tree of every open file, and serves
+// requests over a local Unix socket, so that short-lived tools do not pay for
+// process startup, library loading and query compilation.
+//
+// Every message is a frame: a 4-byte little-endian payload length, then the
+// payload. Integers in payloads are little-endian, and `bytes` is a u32
+// length followed by that many bytes. A request payload starts with a u8
+// TSRedDaemonOp, a response payload with a u8 TSRedDaemonStatus; only
+// successful responses carry the fields below.
+//
+//   op            request fields              response fields
+//   Ping          -                           -
+//   Parse         name: bytes, source: bytes  has_error: u8
+//   Edit          name: bytes, start: u32,    has_error: u8
+//                 old_end: u32, text: bytes
+//   Diagnostics   name: bytes                 count: u32, then per problem
+//                                               missing: u8, symbol: bytes,
+//                                               start_byte: u32, end_byte: u32,
+//                                               row: u32, column: u32
+//   Outline       name: bytes                 count: u32, then per item
+//                                               start_byte: u32, end_byte: u32,
+//                                               row: u32, column: u32,
+//                                               context: bytes, name: bytes
+//   Highlights    name: bytes, start: u32,    names: u32 count of bytes,
+//                 end: u32                    count: u32, then per capture
+//                                               start_byte: u32, end_byte: u32,
+//                                               name index: u16
+//   Close         name: bytes                 -
+//   Shutdown      -                           -
+//
+// Files are identified by the name they were parsed under. `Edit` replaces
+// the bytes from `start` to `old_end` of the file's source with `text` and
+// reparses it incrementally. Rows and columns are zero-based; columns count
+// bytes. A `Parse` or `Edit` that runs past the daemon's timeout fails with
+// TimedOut and closes the file.
+//
+// Messages and the client only need a POSIX system; the daemon itself also
+// needs the tree-sitter runtime.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  TSRedDaemonPing = 0,
+  TSRedDaemonParse = 1,
+  TSRedDaemonEdit = 2,
+  TSRedDaemonDiagnostics = 3,
+  TSRedDaemonOutline = 4,
+  TSRedDaemonHighlights = 5,
+  TSRedDaemonClose = 6,
+  TSRedDaemonShutdown = 7,
+} TSRedDaemonOp;
+
+typedef enum {
+  TSRedDaemonOk = 0,
+  TSRedDaemonBadRequest = 1,
+  TSRedDaemonUnknownFile = 2,
+  TSRedDaemonParseFailed = 3,
+  TSRedDaemonNoQuery = 4,
+  TSRedDaemonOutOfMemory = 5,
+  TSRedDaemonTimedOut = 6,
+} TSRedDaemonStatus;
+
+// The largest payload either side accepts.
+#define TREE_SITTER_RED_DAEMON_MAX_PAYLOAD (256u << 20)
+
+// A frame being built, with room for its length prefix.
+typedef struct {
+  uint8_t *data;
+  size_t size;
+  size_t capacity;
+  bool failed;
+} TSRedMessage;
+
+void tree_sitter_red_message_init(TSRedMessage *message);
+void tree_sitter_red_message_reset(TSRedMessage *message);
+void tree_sitter_red_message_delete(TSRedMessage *message);
+void tree_sitter_red_message_put_u8(TSRedMessage *message, uint8_t value);
+void tree_sitter_red_message_put_u16(TSRedMessage *message, uint16_t value);
+void tree_sitter_red_message_put_u32(TSRedMessage *message, uint32_t value);
+void tree_sitter_red_message_put_bytes(TSRedMessage *message, const void *data,
+                                       uint32_t length);
+
+// Reads the payload of a message. Reading past its end sets `failed` and
+// yields zeros.
+typedef struct {
+  const uint8_t *data;
+  size_t size;
+  size_t offset;
+  bool failed;
+} TSRedMessageReader;
+
+TSRedMessageReader tree_sitter_red_message_reader(const TSRedMessage *message);
+uint8_t tree_sitter_red_message_get_u8(TSRedMessageReader *reader);
+uint16_t tree_sitter_red_message_get_u16(TSRedMessageReader *reader);
+uint32_t tree_sitter_red_message_get_u32(TSRedMessageReader *reader);
+// Points into the message, which must outlive the result.
+const uint8_t *tree_sitter_red_message_get_bytes(TSRedMessageReader *reader,
+                                                 uint32_t *length);
+
+// Write `message` as one frame, blocking until it is written. Returns false
+// if it failed to build.
+bool tree_sitter_red_message_send(int fd, TSRedMessage *message);
+// Replace `message` with the next frame read from `fd`, blocking until it is
+// read.
+bool tree_sitter_red_message_receive(int fd, TSRedMessage *message);
+
+typedef enum {
+  TSRedTransferPending,
+  TSRedTransferDone,
+  TSRedTransferFailed,
+} TSRedTransferStatus;
+
+// Write what `fd` takes now of `message`, of which `*sent` bytes, 0 at first,
+// were written by earlier calls. On a non-blocking `fd`, returns Pending once
+// it takes no more.
+TSRedTransferStatus tree_sitter_red_message_send_some(int fd,
+                                                      TSRedMessage *message,
+                                                      size_t *sent);
+// Read what `fd` has now of the next frame into `message`, of which `*received`
+// bytes, 0 at first, were read by earlier calls. The message only grows with
+// the bytes that arrive, whatever length the frame claims. On a non-blocking
+// `fd`, returns Pending once nothing more is there; Failed when the peer
+// closed, on an error, or for a frame over the largest payload.
+TSRedTransferStatus tree_sitter_red_message_receive_some(int fd,
+                                                         TSRedMessage *message,
+                                                         size_t *received);
+
+// Connect to the daemon listening on `socket_path`. Returns a descriptor for
+// any number of calls, or -1.
+int tree_sitter_red_daemon_connect(const char *socket_path);
+// Send `request` and replace it with the response.
+bool tree_sitter_red_daemon_call(int fd, TSRedMessage *message);
+
+typedef struct TSRedDaemon TSRedDaemon;
+
+// Create a daemon. `queries_directory` holds highlights.scm and outline.scm;
+// when it is NULL or a query is missing, the requests that need it fail with
+// TSRedDaemonNoQuery.
+TSRedDaemon *tree_sitter_red_daemon_new(const char *queries_directory);
+void tree_sitter_red_daemon_delete(TSRedDaemon *daemon);
+
+// Limit the time one `Parse` or `Edit` may take, so that a single script
+// cannot hold the daemon from its other clients. 0, the default, is no
+// limit.
+void tree_sitter_red_daemon_set_timeout(TSRedDaemon *daemon,
+                                        uint64_t timeout_micros);
+
+// Answer one request payload. Returns false once a Shutdown was handled.
+bool tree_sitter_red_daemon_handle(TSRedDaemon *daemon,
+                                   TSRedMessageReader *request,
+                                   TSRedMessage *response);
+
+// Drop a client that sends part of a request, or leaves part of a response
+// unread, and then makes no progress for this long, 10 seconds by default.
+// Clients between requests may idle for as long as they like.
+void tree_sitter_red_daemon_set_idle_timeout(TSRedDaemon *daemon,
+                                             uint64_t timeout_micros);
+
+// Accept connections on the listening socket `fd` and answer their requests
+// one at a time until a Shutdown request. Clients are read and written
+// without blocking, so one that stalls part way through a frame holds up no
+// other.
+bool tree_sitter_red_daemon_serve(TSRedDaemon *daemon, int fd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_DAEMON_H_
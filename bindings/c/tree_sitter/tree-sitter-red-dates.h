@@ -0,0 +1,71 @@
+#ifndef TREE_SITTER_RED_DATES_H_
+#define TREE_SITTER_RED_DATES_H_
+
+// The values of date and time literals, without allocating.
+//
+// Dates are decoded in every form the grammar lexes: 2024-01-15,
+// 2024/1/15, 15-Jan-2024, 15/1/24, 1/2/-300, the ISO 20240115T103000Z,
+// week dates 2024-W03-1 and ordinal dates 2024-015, each optionally with
+// a `/` or `T` and a time, then a zone `Z`, `+0530`, `-5` or `+5:30`. As in
+// Red, a two-digit year is in 1950..2049, `h:m.s` is minutes and seconds,
+// and a date without a zone is in UTC. Decoding nodes needs the tree-sitter
+// runtime; decoding text does not.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TSNode TSNode;
+
+typedef enum {
+  TSRedDateHasTime = 1,
+  TSRedDateHasSeconds = 2,
+  TSRedDateHasFraction = 4,
+  TSRedDateHasZone = 8,
+} TSRedDateFlags;
+
+typedef struct {
+  // Seconds since 1970-01-01T00:00:00Z, with the zone applied, and the
+  // nanoseconds after them. Years up to 9999 do not fit in 64 bits of
+  // nanoseconds.
+  int64_t epoch_seconds;
+  uint32_t nanoseconds;
+  // The calendar date as written, in its own zone.
+  int32_t year;
+  uint8_t month;
+  uint8_t day;
+  // Minutes east of UTC.
+  int16_t zone_minutes;
+  // TSRedDateFlags: what the literal specified.
+  uint8_t flags;
+} TSRedDate;
+
+typedef struct {
+  // Signed, and not limited to a day, but within 64 bits.
+  int64_t ns;
+  // TSRedDateHasSeconds and TSRedDateHasFraction.
+  uint8_t flags;
+} TSRedTime;
+
+// Return false if `text` is not a literal of that type, or is not a valid
+// calendar date.
+bool tree_sitter_red_date_decode(const char *text, uint32_t length,
+                                 TSRedDate *date);
+bool tree_sitter_red_time_decode(const char *text, uint32_t length,
+                                 TSRedTime *time);
+
+// Decode a date or time node of a tree parsed from `source`. Requires the
+// runtime.
+bool tree_sitter_red_date_from_node(TSNode node, const char *source,
+                                    TSRedDate *date);
+bool tree_sitter_red_time_from_node(TSNode node, const char *source,
+                                    TSRedTime *time);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_DATES_H_
@@ -0,0 +1,123 @@
+#ifndef TREE_SITTER_RED_DEPS_H_
+#define TREE_SITTER_RED_DEPS_H_
+
+// The files a Red script loads, and the dependency graph of a directory.
+//
+// A dependency is a `file!` literal right after `do`, `load` (or a path
+// starting with one of them, like `do/args`) or the `#include` directive:
+//
+//   do %lib.red
+//   #include %runtime/common.reds
+//   data: load/all %data.red
+//
+// Extracting dependencies and scanning directories need the tree-sitter
+// runtime; lists and graphs do not.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TSTree TSTree;
+typedef struct TSRedCache TSRedCache;
+
+typedef enum {
+  TSRedDependencyDo,
+  TSRedDependencyInclude,
+  TSRedDependencyLoad,
+} TSRedDependencyKind;
+
+typedef struct {
+  TSRedDependencyKind kind;
+  // The decoded file name as written, e.g. "runtime/common.reds".
+  char *path;
+  uint32_t row;
+} TSRedDependency;
+
+typedef struct {
+  TSRedDependency *items;
+  uint32_t count;
+  uint32_t capacity;
+} TSRedDependencyList;
+
+bool tree_sitter_red_deps_list_push(TSRedDependencyList *list,
+                                    TSRedDependencyKind kind, const char *path,
+                                    uint32_t path_length, uint32_t row);
+void tree_sitter_red_deps_list_delete(TSRedDependencyList *list);
+
+// A compact encoding of a list, e.g. for TSRedCacheDependencies entries.
+bool tree_sitter_red_deps_encode(const TSRedDependencyList *list,
+                                 uint8_t **data, size_t *size);
+bool tree_sitter_red_deps_decode(const uint8_t *data, size_t size,
+                                 TSRedDependencyList *list);
+
+// Collect the dependencies of a parsed script. Requires the runtime.
+bool tree_sitter_red_deps_extract(const TSTree *tree, const char *source,
+                                  TSRedDependencyList *list);
+
+// The path of `target` as seen from the file at `from`, with `.` and `..`
+// segments removed. The caller releases it with `free`.
+char *tree_sitter_red_deps_resolve(const char *from, const char *target);
+
+typedef struct TSRedDependencyGraph TSRedDependencyGraph;
+
+TSRedDependencyGraph *tree_sitter_red_deps_graph_new(void);
+void tree_sitter_red_deps_graph_delete(TSRedDependencyGraph *graph);
+
+// Add a file, or find the one with the same path. Returns its index, or
+// UINT32_MAX when out of memory.
+uint32_t tree_sitter_red_deps_graph_add_file(TSRedDependencyGraph *graph,
+                                             const char *path);
+// Record that file `from` depends on file `to`.
+bool tree_sitter_red_deps_graph_add_edge(TSRedDependencyGraph *graph,
+                                         uint32_t from, uint32_t to,
+                                         TSRedDependencyKind kind);
+
+uint32_t tree_sitter_red_deps_graph_file_count(const TSRedDependencyGraph *graph);
+const char *tree_sitter_red_deps_graph_path(const TSRedDependencyGraph *graph,
+                                            uint32_t file);
+// Whether the file was found while scanning, rather than only referenced.
+bool tree_sitter_red_deps_graph_exists(const TSRedDependencyGraph *graph,
+                                       uint32_t file);
+void tree_sitter_red_deps_graph_set_exists(TSRedDependencyGraph *graph,
+                                           uint32_t file, bool exists);
+
+// Call `visit` for every edge, in the order they were added.
+void tree_sitter_red_deps_graph_edges(
+    const TSRedDependencyGraph *graph,
+    void (*visit)(void *payload, uint32_t from, uint32_t to,
+                  TSRedDependencyKind kind),
+    void *payload);
+
+typedef struct {
+  // Every file, each after the files it depends on, except where they form
+  // a cycle.
+  uint32_t *order;
+  // The strongly connected component of each file. The files of one
+  // component are adjacent in `order`.
+  uint32_t *component;
+  uint32_t component_count;
+  // Whether any component is a cycle: more than one file, or a file that
+  // depends on itself.
+  bool has_cycle;
+} TSRedDependencyOrder;
+
+bool tree_sitter_red_deps_graph_sort(const TSRedDependencyGraph *graph,
+                                     TSRedDependencyOrder *order);
+void tree_sitter_red_deps_order_delete(TSRedDependencyOrder *order);
+
+// Parse every .red and .reds file under `directory` on `threads` threads and
+// build their graph. Symbolic links to directories are not followed. Files whose contents are in `cache`, which may be NULL,
+// are not parsed again. Requires the runtime and POSIX threads.
+TSRedDependencyGraph *tree_sitter_red_deps_scan(const char *directory,
+                                                unsigned threads,
+                                                TSRedCache *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_DEPS_H_
@@ -0,0 +1,76 @@
+#ifndef TREE_SITTER_RED_ERRORS_H_
+#define TREE_SITTER_RED_ERRORS_H_
+
+// The syntax errors of a parsed script, found without printing the tree.
+//
+// Collecting visits only the subtrees that `ts_node_has_error` marks, so a
+// file without errors costs one check of the root. Each ERROR and MISSING
+// node is reported with its position, the token it is about and the symbols
+// the parser would have accepted there. Collecting needs the tree-sitter
+// runtime; lists and their encoding do not.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TSTree TSTree;
+
+typedef enum {
+  // Tokens the parser skipped: an ERROR node.
+  TSRedErrorUnexpected,
+  // A token the parser assumed: a MISSING node, which is empty.
+  TSRedErrorMissing,
+} TSRedErrorKind;
+
+typedef struct {
+  TSRedErrorKind kind;
+  uint32_t start_byte;
+  uint32_t end_byte;
+  // Zero-based, with the column in bytes.
+  uint32_t row;
+  uint32_t column;
+  // The first skipped token, or for a missing one the token before it.
+  uint32_t token_start;
+  uint32_t token_end;
+  // The symbol of that skipped token, or the missing symbol.
+  uint16_t symbol;
+  // The visible symbols that were valid here:
+  // `list->expected[expected_offset..expected_offset + expected_count]`.
+  uint32_t expected_offset;
+  uint32_t expected_count;
+} TSRedError;
+
+typedef struct {
+  TSRedError *items;
+  uint32_t count;
+  uint32_t capacity;
+  uint16_t *expected;
+  uint32_t expected_count;
+  uint32_t expected_capacity;
+} TSRedErrorList;
+
+// Append `error`, copying `expected` and setting its offset and count.
+bool tree_sitter_red_errors_push(TSRedErrorList *list, const TSRedError *error,
+                                 const uint16_t *expected,
+                                 uint32_t expected_count);
+void tree_sitter_red_errors_delete(TSRedErrorList *list);
+
+// A compact encoding of a list, e.g. for TSRedCacheErrors entries.
+bool tree_sitter_red_errors_encode(const TSRedErrorList *list, uint8_t **data,
+                                   size_t *size);
+bool tree_sitter_red_errors_decode(const uint8_t *data, size_t size,
+                                   TSRedErrorList *list);
+
+// Append the errors of `tree` in source order. Errors inside an ERROR node
+// are part of it and not reported separately. Requires the runtime.
+bool tree_sitter_red_errors_collect(const TSTree *tree, TSRedErrorList *list);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_ERRORS_H_
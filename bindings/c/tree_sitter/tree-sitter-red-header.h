@@ -0,0 +1,76 @@
+#ifndef TREE_SITTER_RED_HEADER_H_
+#define TREE_SITTER_RED_HEADER_H_
+
+// Read only the header of a Red script, `Red [Title: "..." Version: 1.0]`,
+// without parsing the rest of the file.
+//
+// The header must be the first thing in the source after an optional UTF-8
+// byte order mark, a `#!` line, whitespace and comments. It starts with the
+// word `Red` or `Red/System`, in any case, followed by a block of `key: value`
+// pairs. Values are lexed like Red does but not evaluated; strings and files
+// are decoded. Does not depend on the tree-sitter runtime.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  TSRedHeaderWord,
+  TSRedHeaderString,
+  TSRedHeaderFile,
+  TSRedHeaderNumber,
+  TSRedHeaderTuple,
+  TSRedHeaderBlock,
+  // Anything else, such as dates, urls, emails and issues.
+  TSRedHeaderOther,
+} TSRedHeaderValueType;
+
+typedef struct {
+  // The key without its colon, and the value as written.
+  const char *key;
+  uint32_t key_length;
+  const char *raw;
+  uint32_t raw_length;
+  TSRedHeaderValueType type;
+  // The decoded contents of strings and files, NUL-terminated; NULL for
+  // other types.
+  char *text;
+  uint32_t text_length;
+} TSRedHeaderField;
+
+typedef struct {
+  bool is_red_system;
+  // The span from the `Red` word to the end of the block.
+  uint32_t start_byte;
+  uint32_t end_byte;
+  TSRedHeaderField *fields;
+  uint32_t field_count;
+  // The file contents read by `tree_sitter_red_header_read`, which `key` and
+  // `raw` point into.
+  char *buffer;
+} TSRedHeader;
+
+// Lex the header at the start of `source`. `key` and `raw` point into
+// `source`, which must outlive the header. Returns false if there is no
+// complete, well-formed header.
+bool tree_sitter_red_header_parse(const char *source, uint32_t length,
+                                  TSRedHeader *header);
+
+// Read the header of the file at `path`, reading no more of the file than
+// it takes to find the end of the header.
+bool tree_sitter_red_header_read(const char *path, TSRedHeader *header);
+
+void tree_sitter_red_header_delete(TSRedHeader *header);
+
+// Find a field by key, ignoring case like Red does. Returns NULL if absent.
+const TSRedHeaderField *tree_sitter_red_header_find(const TSRedHeader *header,
+                                                    const char *key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_HEADER_H_
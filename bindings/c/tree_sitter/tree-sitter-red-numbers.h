@@ -0,0 +1,84 @@
+#ifndef TREE_SITTER_RED_NUMBERS_H_
+#define TREE_SITTER_RED_NUMBERS_H_
+
+// The values of number, money, pair and point literals, decoded the way
+// Red's `load` does, without allocating.
+//
+// Text decoding takes the text of one token, as the grammar lexes it:
+// `'` digit separators, exponents, `1.#inf` and `1.#nan`, a trailing `%`,
+// an optional currency code before the `$` of money, the `x` of a pair.
+// Floats are correctly rounded. Decoding nodes needs the tree-sitter
+// runtime; decoding text does not.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TSNode TSNode;
+
+typedef enum {
+  TSRedNumberInteger,
+  TSRedNumberFloat,
+  TSRedNumberPercent,
+} TSRedNumberKind;
+
+typedef struct {
+  TSRedNumberKind kind;
+  // Set for integers, which Red keeps in 32 bits: an integer literal
+  // outside that range loads as a float, as in Red.
+  int64_t integer;
+  // The value of any kind; for a percent, the fraction, e.g. 0.5 for 50%.
+  double value;
+} TSRedNumber;
+
+typedef struct {
+  // The currency code in upper case, or empty.
+  char currency[4];
+  bool negative;
+  // Up to 17 digits before the point and 5 after it, in hundred
+  // thousandths, rounded half up.
+  uint64_t whole;
+  uint32_t fraction;
+} TSRedMoney;
+
+typedef struct {
+  int32_t x;
+  int32_t y;
+} TSRedPair;
+
+typedef struct {
+  // 2 for point2D!, 3 for point3D!.
+  uint8_t dimensions;
+  float x;
+  float y;
+  float z;
+} TSRedPoint;
+
+// Return false if `text` is not a literal of that type, or if it is out of
+// Red's range for it.
+bool tree_sitter_red_number_decode(const char *text, uint32_t length,
+                                   TSRedNumber *number);
+bool tree_sitter_red_money_decode(const char *text, uint32_t length,
+                                  TSRedMoney *money);
+bool tree_sitter_red_pair_decode(const char *text, uint32_t length,
+                                 TSRedPair *pair);
+
+// Decode a number, money, pair or point node of a tree parsed from
+// `source`. Requires the runtime.
+bool tree_sitter_red_number_from_node(TSNode node, const char *source,
+                                      TSRedNumber *number);
+bool tree_sitter_red_money_from_node(TSNode node, const char *source,
+                                     TSRedMoney *money);
+bool tree_sitter_red_pair_from_node(TSNode node, const char *source,
+                                    TSRedPair *pair);
+bool tree_sitter_red_point_from_node(TSNode node, const char *source,
+                                     TSRedPoint *point);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_NUMBERS_H_
@@ -0,0 +1,71 @@
+#ifndef TREE_SITTER_RED_PARSE_H_
+#define TREE_SITTER_RED_PARSE_H_
+
+// Parsing with a timeout and a cancellation flag, for services that parse
+// scripts they do not trust.
+//
+// Both are checked by the parser's progress callback, which the runtime
+// calls every few hundred operations, so a parse stops soon after its time
+// runs out or its flag is set, with the status saying which. The parser
+// keeps the work done so far: parsing the same source again resumes it,
+// under a new timeout, and `ts_parser_reset` discards it. A single token is
+// lexed without checks, which the scanner's token budget bounds. Requires
+// the tree-sitter runtime.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  TSRedParseDone,
+  TSRedParseTimedOut,
+  TSRedParseCancelled,
+} TSRedParseStatus;
+
+typedef struct {
+  // The time the parse may take, or 0 for no limit.
+  uint64_t timeout_micros;
+  // When not NULL, the parse stops once this is non-zero. It may be set
+  // from another thread.
+  const size_t *cancellation_flag;
+  // The scanner budget for this parse only, as set by
+  // tree_sitter_red_external_scanner_set_budget, or 0 to keep the calling
+  // thread's.
+  uint32_t scanner_budget;
+} TSRedParseOptions;
+
+typedef struct {
+  // The tree, or NULL if the parse stopped.
+  TSTree *tree;
+  // How far the parse got: the length of the source when done.
+  uint32_t offset;
+  // Whether the tree, or the part parsed so far, has errors.
+  bool has_error;
+} TSRedParseResult;
+
+// Parse `source` with `parser`, reusing `old_tree` if not NULL, under the
+// limits of `options`, which may be NULL for none.
+TSRedParseStatus tree_sitter_red_parse(TSParser *parser,
+                                       const TSTree *old_tree,
+                                       const char *source, uint32_t length,
+                                       const TSRedParseOptions *options,
+                                       TSRedParseResult *result);
+
+// Limit the characters the body of a multiline or raw string may span in
+// parses on the calling thread: past it, the string is cut short and the
+// tree has an error there, a missing `}` for a multiline string. 0, the
+// default, is no limit. Parsers on other threads keep their own budget.
+// Returns the previous budget. Defined by the external scanner.
+uint32_t tree_sitter_red_external_scanner_set_budget(uint32_t characters);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_PARSE_H_
@@ -0,0 +1,53 @@
+#ifndef TREE_SITTER_RED_QUERY_H_
+#define TREE_SITTER_RED_QUERY_H_
+
+// Queries with their text predicates applied.
+//
+// The tree-sitter runtime leaves predicates such as `#match?` to the caller.
+// A TSRedQuery compiles the ones used by queries/*.scm once, when the query
+// is created, and checks them against each match:
+//
+//   (#eq? @capture "text")        (#not-eq? @capture "text")
+//   (#eq? @capture @other)        (#not-eq? @capture @other)
+//   (#match? @capture "regex")    (#not-match? @capture "regex")
+//   (#any-of? @capture "a" "b" ...)
+//
+// Regexes are POSIX extended regexes; a leading `(?i)` makes them case
+// insensitive. Other predicates, like `#set!`, are ignored. Requires the
+// tree-sitter runtime.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TSRedQuery TSRedQuery;
+
+// Compile `source` for the Red language. On failure, returns NULL and sets
+// `error_offset` and `error_type` like `ts_query_new`; a predicate that
+// cannot be compiled is reported as TSQueryErrorSyntax at offset zero.
+TSRedQuery *tree_sitter_red_query_new(const char *source, uint32_t length,
+                                      uint32_t *error_offset,
+                                      TSQueryError *error_type);
+
+// Read and compile a query file, such as queries/highlights.scm.
+TSRedQuery *tree_sitter_red_query_load(const char *path);
+void tree_sitter_red_query_delete(TSRedQuery *query);
+
+const TSQuery *tree_sitter_red_query_raw(const TSRedQuery *query);
+
+// Whether the predicates of the pattern of `match` hold, where `source` is
+// the text the tree was parsed from.
+bool tree_sitter_red_query_satisfies(const TSRedQuery *query,
+                                     const TSQueryMatch *match,
+                                     const char *source);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_QUERY_H_
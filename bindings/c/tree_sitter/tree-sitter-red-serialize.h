@@ -0,0 +1,133 @@
+#ifndef TREE_SITTER_RED_SERIALIZE_H_
+#define TREE_SITTER_RED_SERIALIZE_H_
+
+// A compact binary encoding of Red syntax trees.
+//
+// A file starts with a fixed little-endian header:
+//
+//   offset  size  field
+//        0     4  magic, "RDTS"
+//        4     2  format version (TREE_SITTER_RED_TREE_FORMAT_VERSION)
+//        6     2  ABI version of the parser that produced the tree
+//        8     2  symbol count of that parser
+//       10     2  field count of that parser
+//       12     4  node count
+//       16     4  source length in bytes
+//       20     4  size of the node records that follow
+//
+// followed by one record per node in document order. A record is a sequence
+// of unsigned LEB128 varints:
+//
+//   (symbol << 5) | flags
+//   field id                 only if flags has TSRedTreeNodeHasField
+//   start delta              from the end of the previous sibling, or from
+//                            the start of the parent for a first child
+//   length                   end byte - start byte
+//   child count
+//
+// and, when the child count is not zero, a 4-byte little-endian size of the
+// records of all descendants, so a reader can skip a whole subtree.
+//
+// The reader works in place on the encoded bytes, e.g. an mmap'd file shared
+// between processes, and does not depend on the tree-sitter runtime.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TSTree TSTree;
+
+#define TREE_SITTER_RED_TREE_FORMAT_VERSION 1
+#define TREE_SITTER_RED_TREE_HEADER_SIZE 24
+
+typedef enum {
+  TSRedTreeNodeNamed = 1 << 0,
+  TSRedTreeNodeMissing = 1 << 1,
+  TSRedTreeNodeExtra = 1 << 2,
+  TSRedTreeNodeError = 1 << 3,
+  TSRedTreeNodeHasField = 1 << 4,
+} TSRedTreeNodeFlags;
+
+// A growable buffer receiving an encoded tree. Nodes are added in document
+// order: `enter` a node, add its children, then `leave` it.
+typedef struct {
+  uint8_t *data;
+  size_t size;
+  size_t capacity;
+  uint32_t node_count;
+  uint32_t source_length;
+  // Open nodes, innermost last.
+  struct TSRedTreeWriterFrame *frames;
+  uint32_t depth;
+  uint32_t frame_capacity;
+  bool failed;
+} TSRedTreeWriter;
+
+void tree_sitter_red_tree_writer_init(TSRedTreeWriter *writer,
+                                      uint32_t source_length);
+void tree_sitter_red_tree_writer_enter(TSRedTreeWriter *writer,
+                                       uint16_t symbol, uint16_t field_id,
+                                       uint16_t flags, uint32_t start_byte,
+                                       uint32_t end_byte,
+                                       uint32_t child_count);
+void tree_sitter_red_tree_writer_leave(TSRedTreeWriter *writer);
+
+// Finish the encoding and hand over the buffer, which the caller releases
+// with `free`. Returns false if a node was left open or memory ran out.
+bool tree_sitter_red_tree_writer_finish(TSRedTreeWriter *writer,
+                                        uint8_t **data, size_t *size);
+void tree_sitter_red_tree_writer_delete(TSRedTreeWriter *writer);
+
+// Encode a whole syntax tree. Requires the tree-sitter runtime.
+bool tree_sitter_red_tree_serialize(const TSTree *tree, uint8_t **data,
+                                    size_t *size);
+
+typedef struct {
+  const uint8_t *data;
+  size_t size;
+  uint32_t node_count;
+  uint32_t source_length;
+  // Set when the buffer was mapped by `tree_sitter_red_tree_file_map`.
+  void *mapping;
+  size_t mapping_size;
+} TSRedTreeFile;
+
+typedef struct {
+  uint16_t symbol;
+  uint16_t field_id;
+  uint16_t flags;
+  uint32_t start_byte;
+  uint32_t end_byte;
+  uint32_t child_count;
+  // Where the node's first child record starts and where its subtree ends.
+  const uint8_t *children;
+  const uint8_t *subtree_end;
+} TSRedTreeNode;
+
+// Check the header of an encoded tree, which must have been produced for the
+// same grammar tables as this library.
+bool tree_sitter_red_tree_file_open(TSRedTreeFile *file, const void *data,
+                                    size_t size);
+
+// Map an encoded tree read-only from disk and open it.
+bool tree_sitter_red_tree_file_map(TSRedTreeFile *file, const char *path);
+void tree_sitter_red_tree_file_unmap(TSRedTreeFile *file);
+
+bool tree_sitter_red_tree_file_root(const TSRedTreeFile *file,
+                                    TSRedTreeNode *root);
+bool tree_sitter_red_tree_node_first_child(const TSRedTreeNode *parent,
+                                           TSRedTreeNode *child);
+
+// Move `node`, a child of `parent`, to its next sibling.
+bool tree_sitter_red_tree_node_next_sibling(const TSRedTreeNode *parent,
+                                            TSRedTreeNode *node);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_SERIALIZE_H_
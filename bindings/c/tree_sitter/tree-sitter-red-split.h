@@ -0,0 +1,84 @@
+#ifndef TREE_SITTER_RED_SPLIT_H_
+#define TREE_SITTER_RED_SPLIT_H_
+
+// Parsing one large script on several cores, as chunks of its top-level
+// lines.
+//
+// Newlines are tokens of their own, and none of the nodes at the top level
+// of a script spans one, so a script can be cut after any newline that is
+// not inside a block, paren or map, a string, a multiline or raw string, a
+// binary, a tag or a comment. The chunks then parse to the same top-level
+// nodes as the whole script. Finding such newlines takes one pass over the
+// bytes with a small state machine; on x86 CPUs with SSE2, checked at run
+// time, the bytes that cannot change its state are skipped 16 at a time.
+//
+// Each chunk is parsed by a parser of its own, restricted to the chunk with
+// `ts_parser_set_included_ranges`, so the nodes of every chunk have their
+// positions in the whole script. Splitting does not need the tree-sitter
+// runtime; parsing does, and POSIX threads.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TSNode TSNode;
+typedef struct TSTree TSTree;
+
+// Where a chunk starts: just after a newline, so at column 0.
+typedef struct {
+  uint32_t byte;
+  uint32_t row;
+} TSRedSplit;
+
+// Find where to cut `source` into chunks of at least `chunk_size` bytes:
+// the first top-level newline at or past `chunk_size` bytes from the start
+// of each chunk. Stores up to `capacity` starts of chunks after the first,
+// in order, and returns how many it stored. There are never more than
+// `length / chunk_size`.
+uint32_t tree_sitter_red_split(const char *source, uint32_t length,
+                               uint32_t chunk_size, TSRedSplit *splits,
+                               uint32_t capacity);
+
+// How the split skips bytes on this CPU: "sse2" or "scalar".
+const char *tree_sitter_red_split_implementation(void);
+
+typedef struct {
+  // The tree of each chunk, in order. Together, the children of their root
+  // nodes are the top-level nodes of the script.
+  TSTree **trees;
+  // Where each chunk starts; the first at {0, 0}. A chunk ends where the
+  // next starts, and the last at `length`.
+  TSRedSplit *starts;
+  uint32_t count;
+  uint32_t length;
+} TSRedChunks;
+
+// Parse `source` in chunks of at least `chunk_size` bytes on up to
+// `threads` threads, or as many as there are processors if 0. Returns
+// false when out of memory or if a chunk could not be parsed. Requires the
+// runtime.
+bool tree_sitter_red_parse_chunks(const char *source, uint32_t length,
+                                  uint32_t chunk_size, unsigned threads,
+                                  TSRedChunks *chunks);
+void tree_sitter_red_chunks_delete(TSRedChunks *chunks);
+
+// The chunk that `byte` is in.
+uint32_t tree_sitter_red_chunks_find(const TSRedChunks *chunks, uint32_t byte);
+
+// The smallest node that spans `start_byte..end_byte`, as
+// `ts_node_descendant_for_byte_range` finds it in a single tree, or a null
+// node if the range is not within one chunk.
+TSNode tree_sitter_red_chunks_descendant_for_byte_range(
+    const TSRedChunks *chunks, uint32_t start_byte, uint32_t end_byte);
+
+// Whether any chunk has a syntax error.
+bool tree_sitter_red_chunks_has_error(const TSRedChunks *chunks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_SPLIT_H_
@@ -0,0 +1,86 @@
+#ifndef TREE_SITTER_RED_STATS_H_
+#define TREE_SITTER_RED_STATS_H_
+
+// Counters for one parse, to tell GLR stack splitting, error recovery and
+// scanner backtracking apart when a file is slow to parse.
+//
+// The parser counters come from the parser's log: attach a collector before
+// parsing, which needs the tree-sitter runtime. The scanner counters are kept
+// by the external scanner itself, per thread, and only in a language library
+// built with TREE_SITTER_RED_STATS; otherwise they stay zero.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TSParser TSParser;
+
+// The external tokens, in the order of `valid_symbols`.
+typedef enum {
+  TSRedScannerInfixOp,
+  TSRedScannerHexa,
+  TSRedScannerRawString,
+  TSRedScannerMultilineString,
+  TSRedScannerIpv6Address,
+  TSRedScannerErrorSentinel,
+  TSRedScannerTokenCount,
+} TSRedScannerToken;
+
+typedef struct TSRedScannerStats {
+  // Calls by `valid_symbols` combination: bit i of the index is set when
+  // token i was valid.
+  uint32_t calls[1 << TSRedScannerTokenCount];
+  // Calls that returned a token.
+  uint32_t tokens;
+  // Characters the scanner advanced over, skipped ones included, and those
+  // of them that were not part of a returned token.
+  uint64_t advanced;
+  uint64_t discarded;
+} TSRedScannerStats;
+
+typedef struct {
+  // Lexer calls, those that tried the external scanner, and those at a
+  // position the previous call had already lexed.
+  uint32_t lexes;
+  uint32_t external_lexes;
+  uint32_t relexes;
+  // Characters the lexer consumed into tokens and skipped.
+  uint64_t consumed;
+  uint64_t skipped;
+  // The most stack versions the parser processed at once.
+  uint32_t max_versions;
+  // Times the parser found an error, recovered, and skipped a token.
+  uint32_t errors;
+  uint32_t recoveries;
+  uint32_t skipped_tokens;
+  // Subtrees reused from the old tree of an incremental parse.
+  uint32_t reused_nodes;
+  // Internal: the position of the previous lexer call.
+  uint32_t last_row;
+  uint32_t last_column;
+} TSRedParseStats;
+
+// Count one message of the parser's log in `stats`.
+void tree_sitter_red_stats_record(TSRedParseStats *stats, const char *message);
+
+// Set a logger on `parser` that records into `stats` until detached. Logging
+// slows parsing down, so measure time without it. Requires the runtime.
+void tree_sitter_red_stats_attach(TSParser *parser, TSRedParseStats *stats);
+void tree_sitter_red_stats_detach(TSParser *parser);
+
+// The name of an external token, as in the grammar.
+const char *tree_sitter_red_scanner_token_name(TSRedScannerToken token);
+
+// Copy the scanner counters of this thread, and return whether the library
+// was built with TREE_SITTER_RED_STATS. Defined by the external scanner.
+bool tree_sitter_red_external_scanner_stats(TSRedScannerStats *stats);
+void tree_sitter_red_external_scanner_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_STATS_H_
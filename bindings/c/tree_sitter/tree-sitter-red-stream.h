@@ -0,0 +1,89 @@
+#ifndef TREE_SITTER_RED_STREAM_H_
+#define TREE_SITTER_RED_STREAM_H_
+
+// Parsing a file without loading it: a stream of its text that the parser
+// pulls a window at a time, from a memory-mapped file or from a reader.
+//
+// A mapped file is advised as read sequentially, and pages more than a
+// window behind the furthest read are dropped as the parser moves on, so a
+// parse keeps about one window of the file resident besides its tree. A
+// reader fills a buffer of one window. Either way, every read starts where
+// the parser asks and spans up to a window.
+//
+// The encoding comes from the byte order mark: UTF-8, UTF-16LE or UTF-16BE,
+// and without one, UTF-16 if one of the first two bytes is zero and UTF-8
+// otherwise. The mark is not part of the text: offsets in the tree, and
+// those given to the stream, count from just after it. Bytes are checked as
+// they are first read, and the stream keeps where the first one that is not
+// valid in the encoding is; the parser reads such bytes as U+FFFD.
+//
+// Streams need neither the tree-sitter runtime nor a parser; the TSInput
+// for one does, and comes from `tree_sitter_red_stream_input`. A stream is
+// read by one parse at a time.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TSInput TSInput;
+
+typedef enum {
+  TSRedStreamUtf8,
+  TSRedStreamUtf16LE,
+  TSRedStreamUtf16BE,
+} TSRedStreamEncoding;
+
+// Read up to `size` bytes at `offset` of the file into `buffer`. Returns
+// how many, which is 0 only at the end of the file, or -1 on an error.
+typedef int64_t (*TSRedStreamRead)(void *payload, uint64_t offset,
+                                   char *buffer, uint32_t size);
+
+typedef struct TSRedStream TSRedStream;
+
+// A `window` of zero selects TREE_SITTER_RED_STREAM_DEFAULT_WINDOW; smaller
+// ones than TREE_SITTER_RED_STREAM_MIN_WINDOW are raised to it.
+#define TREE_SITTER_RED_STREAM_DEFAULT_WINDOW (64u << 10)
+#define TREE_SITTER_RED_STREAM_MIN_WINDOW 16u
+
+// Map the regular file at `path`. Returns NULL with `errno` set if it cannot
+// be, or if its text is over 4 GiB. On Windows, the file is read instead.
+TSRedStream *tree_sitter_red_stream_open(const char *path, uint32_t window);
+
+// A stream of what `read` returns, which it reads at once for the mark.
+// Returns NULL if out of memory or if that read fails.
+TSRedStream *tree_sitter_red_stream_new(TSRedStreamRead read, void *payload,
+                                        uint32_t window);
+
+void tree_sitter_red_stream_delete(TSRedStream *stream);
+
+// The text from `byte`, up to a window of it. Sets `size` to its length,
+// which is zero at the end of the text or after a failed read. It stays
+// valid until the next read of the stream.
+const char *tree_sitter_red_stream_read(TSRedStream *stream, uint32_t byte,
+                                        uint32_t *size);
+
+TSRedStreamEncoding tree_sitter_red_stream_encoding(const TSRedStream *stream);
+
+// The length of the byte order mark: 0, 2 or 3.
+uint32_t tree_sitter_red_stream_bom_length(const TSRedStream *stream);
+
+// The offset in the text of the first byte not valid in the encoding among
+// those read so far, or UINT32_MAX if there is none. A parse reads all of
+// the text, so after one this covers the whole file.
+uint32_t tree_sitter_red_stream_invalid_offset(const TSRedStream *stream);
+
+// Whether a read failed, so that the text seemed to end early.
+bool tree_sitter_red_stream_failed(const TSRedStream *stream);
+
+// An input for `ts_parser_parse` that reads `stream`, in its encoding.
+// Requires the runtime.
+TSInput tree_sitter_red_stream_input(TSRedStream *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_STREAM_H_
@@ -0,0 +1,48 @@
+#ifndef TREE_SITTER_RED_STRINGS_H_
+#define TREE_SITTER_RED_STRINGS_H_
+
+// The values of string, char, file, multiline string and raw string
+// literals, without walking their `string_content` and `escaped_char`
+// children and without allocating.
+//
+// Carets are decoded as Red does: `^/`, `^-`, `^(tab)`, `^(1F3F4)`, `^^`,
+// `^"` and control characters such as `^M`. Unquoted files decode `%20`
+// escapes instead, and raw strings decode nothing. A literal without escapes
+// decodes to a span of the source, so only literals with escapes are copied.
+// Decoding nodes needs the tree-sitter runtime; decoding text does not.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TSNode TSNode;
+
+typedef struct {
+  // The decoded UTF-8 value, not NUL-terminated: a span of the source when
+  // the literal has no escapes, and the caller's buffer when it does.
+  const char *text;
+  uint32_t length;
+} TSRedString;
+
+// Decode a literal as written, delimiters included. The value is never
+// longer than the literal, so a buffer of `length` bytes is always enough.
+// Returns false if `text` is not one of those literals, or if its value
+// needs more than `capacity` bytes of `buffer`.
+bool tree_sitter_red_string_decode(const char *text, uint32_t length,
+                                   char *buffer, uint32_t capacity,
+                                   TSRedString *string);
+
+// Decode a string, char, file, multiline_string or raw_string node of a tree
+// parsed from `source`. Requires the runtime.
+bool tree_sitter_red_string_from_node(TSNode node, const char *source,
+                                      char *buffer, uint32_t capacity,
+                                      TSRedString *string);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_STRINGS_H_
@@ -0,0 +1,161 @@
+#ifndef TREE_SITTER_RED_SYMBOLS_H_
+#define TREE_SITTER_RED_SYMBOLS_H_
+
+// Automatically @generated by scripts/generate-bindings.js
+//
+// The ids of the named node kinds and fields of the Red grammar, as returned
+// by `ts_node_symbol` and `ts_tree_cursor_current_field_id`. They are only
+// valid for the parser generated with the ABI and table sizes below.
+
+#define TREE_SITTER_RED_LANGUAGE_VERSION 15
+#define TREE_SITTER_RED_SYMBOL_COUNT 133
+#define TREE_SITTER_RED_FIELD_COUNT 4
+
+// Identifies the grammar: the first 64 bits of the SHA-256 of src/grammar.json.
+#define TREE_SITTER_RED_GRAMMAR_FINGERPRINT 0xfad28625fae92bd4ULL
+
+typedef enum {
+  TSRedSymbolComment = 2,
+  TSRedSymbolNumber = 10,
+  TSRedSymbolPair = 11,
+  TSRedSymbolMoney = 15,
+  TSRedSymbolTuple = 16,
+  TSRedSymbolZoneIndex = 17,
+  TSRedSymbolCidr = 18,
+  TSRedSymbolRef = 26,
+  TSRedSymbolIssue = 27,
+  TSRedSymbolEmail = 30,
+  TSRedSymbolStringContent = 34,
+  TSRedSymbolEscapedChar = 38,
+  TSRedSymbolTag = 60,
+  TSRedSymbolInfixOp = 87,
+  TSRedSymbolHexa = 88,
+  TSRedSymbolRawString = 89,
+  TSRedSymbolIpv6Address = 91,
+  TSRedSymbolSourceFile = 93,
+  TSRedSymbolBoolean = 94,
+  TSRedSymbolPoint = 95,
+  TSRedSymbolIpv6 = 96,
+  TSRedSymbolTime = 97,
+  TSRedSymbolDate = 98,
+  TSRedSymbolChar = 99,
+  TSRedSymbolRefinement = 100,
+  TSRedSymbolFile = 101,
+  TSRedSymbolString = 103,
+  TSRedSymbolMultilineString = 104,
+  TSRedSymbolConstruction = 105,
+  TSRedSymbolWord = 106,
+  TSRedSymbolLitWord = 107,
+  TSRedSymbolGetWord = 108,
+  TSRedSymbolSetWord = 109,
+  TSRedSymbolUrl = 110,
+  TSRedSymbolPathStart = 112,
+  TSRedSymbolPath = 113,
+  TSRedSymbolLitPath = 114,
+  TSRedSymbolGetPath = 115,
+  TSRedSymbolSetPath = 116,
+  TSRedSymbolBinary = 117,
+  TSRedSymbolMap = 118,
+  TSRedSymbolBlock = 119,
+  TSRedSymbolParen = 120,
+  TSRedSymbolFunction = 121,
+  TSRedSymbolDoes = 122,
+  TSRedSymbolContext = 123,
+  TSRedSymbolMake = 124,
+  TSRedSymbolInvalidToken = 125,
+} TSRedSymbol;
+
+typedef enum {
+  TSRedFieldBody = 1,
+  TSRedFieldKey = 2,
+  TSRedFieldName = 3,
+  TSRedFieldSpec = 4,
+} TSRedField;
+
+// X-macros over every symbol and field: `X(enumerator, "node name")`.
+#define TREE_SITTER_RED_SYMBOLS(X) \
+  X(TSRedSymbolComment, "comment") \
+  X(TSRedSymbolNumber, "number") \
+  X(TSRedSymbolPair, "pair") \
+  X(TSRedSymbolMoney, "money") \
+  X(TSRedSymbolTuple, "tuple") \
+  X(TSRedSymbolZoneIndex, "zone_index") \
+  X(TSRedSymbolCidr, "cidr") \
+  X(TSRedSymbolRef, "ref") \
+  X(TSRedSymbolIssue, "issue") \
+  X(TSRedSymbolEmail, "email") \
+  X(TSRedSymbolStringContent, "string_content") \
+  X(TSRedSymbolEscapedChar, "escaped_char") \
+  X(TSRedSymbolTag, "tag") \
+  X(TSRedSymbolInfixOp, "infix_op") \
+  X(TSRedSymbolHexa, "hexa") \
+  X(TSRedSymbolRawString, "raw_string") \
+  X(TSRedSymbolIpv6Address, "ipv6_address") \
+  X(TSRedSymbolSourceFile, "source_file") \
+  X(TSRedSymbolBoolean, "boolean") \
+  X(TSRedSymbolPoint, "point") \
+  X(TSRedSymbolIpv6, "ipv6") \
+  X(TSRedSymbolTime, "time") \
+  X(TSRedSymbolDate, "date") \
+  X(TSRedSymbolChar, "char") \
+  X(TSRedSymbolRefinement, "refinement") \
+  X(TSRedSymbolFile, "file") \
+  X(TSRedSymbolString, "string") \
+  X(TSRedSymbolMultilineString, "multiline_string") \
+  X(TSRedSymbolConstruction, "construction") \
+  X(TSRedSymbolWord, "word") \
+  X(TSRedSymbolLitWord, "lit_word") \
+  X(TSRedSymbolGetWord, "get_word") \
+  X(TSRedSymbolSetWord, "set_word") \
+  X(TSRedSymbolUrl, "url") \
+  X(TSRedSymbolPathStart, "path_start") \
+  X(TSRedSymbolPath, "path") \
+  X(TSRedSymbolLitPath, "lit_path") \
+  X(TSRedSymbolGetPath, "get_path") \
+  X(TSRedSymbolSetPath, "set_path") \
+  X(TSRedSymbolBinary, "binary") \
+  X(TSRedSymbolMap, "map") \
+  X(TSRedSymbolBlock, "block") \
+  X(TSRedSymbolParen, "paren") \
+  X(TSRedSymbolFunction, "function") \
+  X(TSRedSymbolDoes, "does") \
+  X(TSRedSymbolContext, "context") \
+  X(TSRedSymbolMake, "make") \
+  X(TSRedSymbolInvalidToken, "invalid_token")
+
+#define TREE_SITTER_RED_FIELDS(X) \
+  X(TSRedFieldBody, "body") \
+  X(TSRedFieldKey, "key") \
+  X(TSRedFieldName, "name") \
+  X(TSRedFieldSpec, "spec")
+
+#ifdef TREE_SITTER_API_H_
+
+#include <stdbool.h>
+
+// Check that the ids above agree with the loaded language. Call it once at
+// startup: a mismatch means this header and the parser come from different
+// `tree-sitter generate` runs.
+static inline bool tree_sitter_red_symbols_match(const TSLanguage *language) {
+  if (ts_language_abi_version(language) != TREE_SITTER_RED_LANGUAGE_VERSION ||
+      ts_language_symbol_count(language) != TREE_SITTER_RED_SYMBOL_COUNT ||
+      ts_language_field_count(language) != TREE_SITTER_RED_FIELD_COUNT) {
+    return false;
+  }
+  bool match = true;
+#define TREE_SITTER_RED_CHECK_SYMBOL(id, name)                                 \
+  match = match && ts_language_symbol_for_name(language, name,                 \
+                                               sizeof(name) - 1, true) == (id);
+#define TREE_SITTER_RED_CHECK_FIELD(id, name)                                  \
+  match = match &&                                                             \
+          ts_language_field_id_for_name(language, name, sizeof(name) - 1) == (id);
+  TREE_SITTER_RED_SYMBOLS(TREE_SITTER_RED_CHECK_SYMBOL)
+  TREE_SITTER_RED_FIELDS(TREE_SITTER_RED_CHECK_FIELD)
+#undef TREE_SITTER_RED_CHECK_SYMBOL
+#undef TREE_SITTER_RED_CHECK_FIELD
+  return match;
+}
+
+#endif // TREE_SITTER_API_H_
+
+#endif // TREE_SITTER_RED_SYMBOLS_H_
@@ -0,0 +1,92 @@
+#ifndef TREE_SITTER_RED_TRACE_H_
+#define TREE_SITTER_RED_TRACE_H_
+
+// Recorded editor sessions, to replay through `ts_tree_edit` and
+// `ts_parser_parse` and measure reparse latency keystroke by keystroke.
+//
+// A trace is a text file of one edit per line, the fields of a TSInputEdit
+// followed by the inserted text:
+//
+//   # typing `f: func`
+//   source ../../example.red
+//   edit 120 120 121 4:0 4:0 4:1 "f"
+//   edit 121 121 122 4:1 4:1 4:2 ":"
+//   also 300 300 301 9:0 9:0 9:1 ";"
+//
+// Columns are in bytes. `source` names the document the edits start from,
+// relative to the trace; without it the document starts empty. An `also`
+// edit is applied together with the edit before it and parsed once, like a
+// multi-cursor edit. The text is quoted with `\"`, `\\`, `\n`, `\t`, `\r` and
+// `\xHH` escapes. Recording and reading traces do not need the runtime.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  uint32_t row;
+  uint32_t column;
+} TSRedTracePoint;
+
+typedef struct {
+  uint32_t start_byte;
+  uint32_t old_end_byte;
+  uint32_t new_end_byte;
+  TSRedTracePoint start_point;
+  TSRedTracePoint old_end_point;
+  TSRedTracePoint new_end_point;
+  // The inserted text: `new_end_byte - start_byte` bytes from
+  // `trace->text + text_offset`.
+  uint32_t text_offset;
+  // Parsed together with the edit before it.
+  bool joined;
+} TSRedTraceEdit;
+
+// A zero-initialized trace is empty.
+typedef struct {
+  char *source;
+  TSRedTraceEdit *edits;
+  uint32_t count;
+  uint32_t capacity;
+  char *text;
+  uint32_t text_size;
+  uint32_t text_capacity;
+} TSRedTrace;
+
+bool tree_sitter_red_trace_set_source(TSRedTrace *trace, const char *path);
+
+// Append the edit that replaces `document[start_byte..old_end_byte)` with
+// `text`, computing its points from `document`, which is the document as
+// it is before this edit. Returns false if the range is not in the
+// document, or when out of memory.
+bool tree_sitter_red_trace_record(TSRedTrace *trace, const char *document,
+                                  uint32_t length, uint32_t start_byte,
+                                  uint32_t old_end_byte, const char *text,
+                                  uint32_t text_length, bool joined);
+
+// Apply `edit` of `trace` to a document in a `malloc`ed buffer, growing it
+// when needed. Returns false if the edit does not fit the document, or when
+// out of memory.
+bool tree_sitter_red_trace_apply(const TSRedTrace *trace,
+                                 const TSRedTraceEdit *edit, char **document,
+                                 uint32_t *length, uint32_t *capacity);
+
+// The text of a trace. The caller releases `data` with `free`.
+bool tree_sitter_red_trace_encode(const TSRedTrace *trace, char **data,
+                                  size_t *size);
+// Read a trace. On failure, `line` is the one-based line that could not be
+// read.
+bool tree_sitter_red_trace_decode(const char *data, size_t size,
+                                  TSRedTrace *trace, uint32_t *line);
+
+void tree_sitter_red_trace_delete(TSRedTrace *trace);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_TRACE_H_
@@ -0,0 +1,62 @@
+#ifndef TREE_SITTER_RED_WALK_H_
+#define TREE_SITTER_RED_WALK_H_
+
+// Walks over a tree that work at any depth.
+//
+// Red data nests blocks, parens and maps thousands of levels deep, as the
+// files `save` writes from `load-json` do. These walks keep their place in
+// a TSTreeCursor, whose stack is on the heap, so they use the same C stack
+// at every depth and move between nodes in constant time. Use them instead
+// of recursing over `ts_node_child`, and instead of `ts_node_parent` and
+// `ts_node_prev_sibling`, which search down from the root on every call.
+// Requires the tree-sitter runtime.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  // Visit the children of the node next.
+  TSRedWalkInto,
+  // Skip its children and go on with its next sibling.
+  TSRedWalkOver,
+  // End the walk.
+  TSRedWalkStop,
+} TSRedWalkAction;
+
+typedef struct {
+  // Called on each node before its children. `depth` is 0 for the node the
+  // walk starts from.
+  TSRedWalkAction (*enter)(void *payload, TSNode node, uint32_t depth);
+  // Called after the children of each node entered with TSRedWalkInto, or
+  // right after entering it if it has none. May be NULL.
+  void (*leave)(void *payload, TSNode node, uint32_t depth);
+  void *payload;
+} TSRedWalker;
+
+// Walk `node` and its descendants in document order. Returns false if
+// `enter` stopped the walk.
+bool tree_sitter_red_walk(TSNode node, const TSRedWalker *walker);
+
+typedef struct {
+  uint64_t nodes;
+  uint64_t named_nodes;
+  // How many levels below the node its deepest descendant is.
+  uint32_t depth;
+  // The most children of one node.
+  uint32_t max_children;
+} TSRedTreeShape;
+
+// Count the nodes under `node`, itself included, and measure its depth.
+TSRedTreeShape tree_sitter_red_tree_shape(TSNode node);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_RED_WALK_H_
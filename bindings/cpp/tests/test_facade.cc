@@ -0,0 +1,59 @@
+#include <tree_sitter/tree-sitter-red.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+namespace red = tree_sitter::red;
+
+static int failures = 0;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);     \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+int main() {
+  constexpr std::string_view source = "add: func [a b] [a + b]\n"
+                                      "obj: context [x: 1]\n";
+
+  TSParser *parser = ts_parser_new();
+  CHECK(ts_parser_set_language(parser, red::language()));
+  CHECK(tree_sitter_red_symbols_match(red::language()));
+  TSTree *tree = ts_parser_parse_string(parser, nullptr, source.data(),
+                                        static_cast<uint32_t>(source.size()));
+  red::Node root(ts_tree_root_node(tree));
+  CHECK(root.is<red::SourceFile>());
+
+  int functions = 0;
+  int contexts = 0;
+  red::walk(root, [&](auto node) {
+    using View = decltype(node);
+    if constexpr (std::is_same_v<View, red::Function>) {
+      functions++;
+      CHECK(node.name().text(source) == "add:");
+      CHECK(node.key().text(source) == "func");
+      CHECK(node.spec().template is<red::Block>());
+      CHECK(node.body().text(source) == "[a + b]");
+    } else if constexpr (std::is_same_v<View, red::Context>) {
+      contexts++;
+      CHECK(node.name().template is<red::SetWord>());
+      CHECK(!node.body().is_null());
+    }
+  });
+  CHECK(functions == 1);
+  CHECK(contexts == 1);
+
+  int children = 0;
+  for (red::Node child : root.children()) {
+    if (child.is_named()) children++;
+  }
+  CHECK(children == 2);
+
+  ts_tree_delete(tree);
+  ts_parser_delete(parser);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,944 @@
+#ifndef TREE_SITTER_RED_HPP_
+#define TREE_SITTER_RED_HPP_
+
+// Automatically @generated by scripts/generate-bindings.js
+//
+// A header-only C++20 view of Red syntax trees. Every named node kind gets
+// a view type that wraps a TSNode and exposes its fields; all of them are
+// thin inline wrappers over the C API.
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-red-symbols.h>
+#include <tree_sitter/tree-sitter-red.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace tree_sitter::red {
+
+inline const TSLanguage *language() noexcept { return tree_sitter_red(); }
+
+enum class Symbol : TSSymbol {
+  Comment = TSRedSymbolComment,
+  Number = TSRedSymbolNumber,
+  Pair = TSRedSymbolPair,
+  Money = TSRedSymbolMoney,
+  Tuple = TSRedSymbolTuple,
+  ZoneIndex = TSRedSymbolZoneIndex,
+  Cidr = TSRedSymbolCidr,
+  Ref = TSRedSymbolRef,
+  Issue = TSRedSymbolIssue,
+  Email = TSRedSymbolEmail,
+  StringContent = TSRedSymbolStringContent,
+  EscapedChar = TSRedSymbolEscapedChar,
+  Tag = TSRedSymbolTag,
+  InfixOp = TSRedSymbolInfixOp,
+  Hexa = TSRedSymbolHexa,
+  RawString = TSRedSymbolRawString,
+  Ipv6Address = TSRedSymbolIpv6Address,
+  SourceFile = TSRedSymbolSourceFile,
+  Boolean = TSRedSymbolBoolean,
+  Point = TSRedSymbolPoint,
+  Ipv6 = TSRedSymbolIpv6,
+  Time = TSRedSymbolTime,
+  Date = TSRedSymbolDate,
+  Char = TSRedSymbolChar,
+  Refinement = TSRedSymbolRefinement,
+  File = TSRedSymbolFile,
+  String = TSRedSymbolString,
+  MultilineString = TSRedSymbolMultilineString,
+  Construction = TSRedSymbolConstruction,
+  Word = TSRedSymbolWord,
+  LitWord = TSRedSymbolLitWord,
+  GetWord = TSRedSymbolGetWord,
+  SetWord = TSRedSymbolSetWord,
+  Url = TSRedSymbolUrl,
+  PathStart = TSRedSymbolPathStart,
+  Path = TSRedSymbolPath,
+  LitPath = TSRedSymbolLitPath,
+  GetPath = TSRedSymbolGetPath,
+  SetPath = TSRedSymbolSetPath,
+  Binary = TSRedSymbolBinary,
+  Map = TSRedSymbolMap,
+  Block = TSRedSymbolBlock,
+  Paren = TSRedSymbolParen,
+  Function = TSRedSymbolFunction,
+  Does = TSRedSymbolDoes,
+  Context = TSRedSymbolContext,
+  Make = TSRedSymbolMake,
+  InvalidToken = TSRedSymbolInvalidToken,
+};
+
+class Children;
+
+// An untyped node. Views of specific kinds derive from it.
+class Node {
+ public:
+  constexpr Node() noexcept = default;
+  constexpr explicit Node(TSNode node) noexcept : node_(node) {}
+
+  [[nodiscard]] constexpr TSNode raw() const noexcept { return node_; }
+  [[nodiscard]] bool is_null() const noexcept { return ts_node_is_null(node_); }
+  [[nodiscard]] Symbol symbol() const noexcept {
+    return static_cast<Symbol>(ts_node_symbol(node_));
+  }
+  [[nodiscard]] bool is_named() const noexcept { return ts_node_is_named(node_); }
+  [[nodiscard]] bool has_error() const noexcept { return ts_node_has_error(node_); }
+  [[nodiscard]] uint32_t start_byte() const noexcept {
+    return ts_node_start_byte(node_);
+  }
+  [[nodiscard]] uint32_t end_byte() const noexcept { return ts_node_end_byte(node_); }
+  [[nodiscard]] TSPoint start_point() const noexcept {
+    return ts_node_start_point(node_);
+  }
+  [[nodiscard]] TSPoint end_point() const noexcept {
+    return ts_node_end_point(node_);
+  }
+
+  // The source text covered by the node, or the part of it in `source` if
+  // that is shorter than the text that was parsed.
+  [[nodiscard]] std::string_view text(std::string_view source) const noexcept {
+    std::size_t start = std::min<std::size_t>(start_byte(), source.size());
+    return source.substr(start, end_byte() - start_byte());
+  }
+
+  // The node's children, iterated with a single tree cursor.
+  [[nodiscard]] Children children() const noexcept;
+
+  // Whether the node is of the kind viewed by `View`.
+  template <class View> [[nodiscard]] bool is() const noexcept {
+    return !is_null() && symbol() == View::kind;
+  }
+
+  // The node as a `View`, or a null view if it is of another kind.
+  template <class View> [[nodiscard]] View as() const noexcept {
+    return is<View>() ? View(node_) : View();
+  }
+
+ protected:
+  [[nodiscard]] TSNode field(TSRedField id) const noexcept {
+    return ts_node_child_by_field_id(node_, static_cast<TSFieldId>(id));
+  }
+
+ private:
+  TSNode node_{};
+};
+
+class Comment : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Comment;
+
+  using Node::Node;
+};
+
+class Number : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Number;
+
+  using Node::Node;
+};
+
+class Pair : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Pair;
+
+  using Node::Node;
+};
+
+class Money : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Money;
+
+  using Node::Node;
+};
+
+class Tuple : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Tuple;
+
+  using Node::Node;
+};
+
+class ZoneIndex : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::ZoneIndex;
+
+  using Node::Node;
+};
+
+class Cidr : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Cidr;
+
+  using Node::Node;
+};
+
+class Ref : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Ref;
+
+  using Node::Node;
+};
+
+class Issue : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Issue;
+
+  using Node::Node;
+};
+
+class Email : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Email;
+
+  using Node::Node;
+};
+
+class StringContent : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::StringContent;
+
+  using Node::Node;
+};
+
+class EscapedChar : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::EscapedChar;
+
+  using Node::Node;
+};
+
+class Tag : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Tag;
+
+  using Node::Node;
+};
+
+class InfixOp : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::InfixOp;
+
+  using Node::Node;
+};
+
+class Hexa : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Hexa;
+
+  using Node::Node;
+};
+
+class RawString : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::RawString;
+
+  using Node::Node;
+};
+
+class Ipv6Address : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Ipv6Address;
+
+  using Node::Node;
+};
+
+class SourceFile : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::SourceFile;
+
+  using Node::Node;
+};
+
+class Boolean : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Boolean;
+
+  using Node::Node;
+};
+
+class Point : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Point;
+
+  using Node::Node;
+};
+
+class Ipv6 : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Ipv6;
+
+  using Node::Node;
+};
+
+class Time : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Time;
+
+  using Node::Node;
+};
+
+class Date : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Date;
+
+  using Node::Node;
+};
+
+class Char : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Char;
+
+  using Node::Node;
+};
+
+class Refinement : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Refinement;
+
+  using Node::Node;
+};
+
+class File : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::File;
+
+  using Node::Node;
+};
+
+class String : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::String;
+
+  using Node::Node;
+};
+
+class MultilineString : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::MultilineString;
+
+  using Node::Node;
+};
+
+class Construction : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Construction;
+
+  using Node::Node;
+};
+
+class Word : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Word;
+
+  using Node::Node;
+};
+
+class LitWord : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::LitWord;
+
+  using Node::Node;
+};
+
+class GetWord : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::GetWord;
+
+  using Node::Node;
+};
+
+class SetWord : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::SetWord;
+
+  using Node::Node;
+};
+
+class Url : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Url;
+
+  using Node::Node;
+};
+
+class PathStart : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::PathStart;
+
+  using Node::Node;
+};
+
+class Path : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Path;
+
+  using Node::Node;
+};
+
+class LitPath : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::LitPath;
+
+  using Node::Node;
+};
+
+class GetPath : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::GetPath;
+
+  using Node::Node;
+};
+
+class SetPath : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::SetPath;
+
+  using Node::Node;
+};
+
+class Binary : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Binary;
+
+  using Node::Node;
+};
+
+class Map : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Map;
+
+  using Node::Node;
+};
+
+class Block : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Block;
+
+  using Node::Node;
+};
+
+class Paren : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Paren;
+
+  using Node::Node;
+};
+
+class InvalidToken : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::InvalidToken;
+
+  using Node::Node;
+};
+
+class Function : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Function;
+
+  using Node::Node;
+
+  // The `body` field, or a null view if absent.
+  [[nodiscard]] Block body() const noexcept {
+    return Block(field(TSRedFieldBody));
+  }
+
+  // The `key` field.
+  [[nodiscard]] Node key() const noexcept {
+    return Node(field(TSRedFieldKey));
+  }
+
+  // The `name` field.
+  [[nodiscard]] Node name() const noexcept {
+    return Node(field(TSRedFieldName));
+  }
+
+  // The `spec` field, or a null view if absent.
+  [[nodiscard]] Node spec() const noexcept {
+    return Node(field(TSRedFieldSpec));
+  }
+};
+
+class Does : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Does;
+
+  using Node::Node;
+
+  // The `body` field, or a null view if absent.
+  [[nodiscard]] Block body() const noexcept {
+    return Block(field(TSRedFieldBody));
+  }
+
+  // The `key` field.
+  [[nodiscard]] Node key() const noexcept {
+    return Node(field(TSRedFieldKey));
+  }
+
+  // The `name` field.
+  [[nodiscard]] Node name() const noexcept {
+    return Node(field(TSRedFieldName));
+  }
+};
+
+class Context : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Context;
+
+  using Node::Node;
+
+  // The `body` field, or a null view if absent.
+  [[nodiscard]] Block body() const noexcept {
+    return Block(field(TSRedFieldBody));
+  }
+
+  // The `key` field.
+  [[nodiscard]] Node key() const noexcept {
+    return Node(field(TSRedFieldKey));
+  }
+
+  // The `name` field.
+  [[nodiscard]] Node name() const noexcept {
+    return Node(field(TSRedFieldName));
+  }
+};
+
+class Make : public Node {
+ public:
+  static constexpr Symbol kind = Symbol::Make;
+
+  using Node::Node;
+
+  // The `key` field.
+  [[nodiscard]] Node key() const noexcept {
+    return Node(field(TSRedFieldKey));
+  }
+
+  // The `name` field.
+  [[nodiscard]] Node name() const noexcept {
+    return Node(field(TSRedFieldName));
+  }
+};
+
+// Maps a symbol to its view type, e.g. `view_for<Symbol::Function>::type`.
+template <Symbol S> struct view_for;
+template <> struct view_for<Symbol::Comment> { using type = Comment; };
+template <> struct view_for<Symbol::Number> { using type = Number; };
+template <> struct view_for<Symbol::Pair> { using type = Pair; };
+template <> struct view_for<Symbol::Money> { using type = Money; };
+template <> struct view_for<Symbol::Tuple> { using type = Tuple; };
+template <> struct view_for<Symbol::ZoneIndex> { using type = ZoneIndex; };
+template <> struct view_for<Symbol::Cidr> { using type = Cidr; };
+template <> struct view_for<Symbol::Ref> { using type = Ref; };
+template <> struct view_for<Symbol::Issue> { using type = Issue; };
+template <> struct view_for<Symbol::Email> { using type = Email; };
+template <> struct view_for<Symbol::StringContent> { using type = StringContent; };
+template <> struct view_for<Symbol::EscapedChar> { using type = EscapedChar; };
+template <> struct view_for<Symbol::Tag> { using type = Tag; };
+template <> struct view_for<Symbol::InfixOp> { using type = InfixOp; };
+template <> struct view_for<Symbol::Hexa> { using type = Hexa; };
+template <> struct view_for<Symbol::RawString> { using type = RawString; };
+template <> struct view_for<Symbol::Ipv6Address> { using type = Ipv6Address; };
+template <> struct view_for<Symbol::SourceFile> { using type = SourceFile; };
+template <> struct view_for<Symbol::Boolean> { using type = Boolean; };
+template <> struct view_for<Symbol::Point> { using type = Point; };
+template <> struct view_for<Symbol::Ipv6> { using type = Ipv6; };
+template <> struct view_for<Symbol::Time> { using type = Time; };
+template <> struct view_for<Symbol::Date> { using type = Date; };
+template <> struct view_for<Symbol::Char> { using type = Char; };
+template <> struct view_for<Symbol::Refinement> { using type = Refinement; };
+template <> struct view_for<Symbol::File> { using type = File; };
+template <> struct view_for<Symbol::String> { using type = String; };
+template <> struct view_for<Symbol::MultilineString> { using type = MultilineString; };
+template <> struct view_for<Symbol::Construction> { using type = Construction; };
+template <> struct view_for<Symbol::Word> { using type = Word; };
+template <> struct view_for<Symbol::LitWord> { using type = LitWord; };
+template <> struct view_for<Symbol::GetWord> { using type = GetWord; };
+template <> struct view_for<Symbol::SetWord> { using type = SetWord; };
+template <> struct view_for<Symbol::Url> { using type = Url; };
+template <> struct view_for<Symbol::PathStart> { using type = PathStart; };
+template <> struct view_for<Symbol::Path> { using type = Path; };
+template <> struct view_for<Symbol::LitPath> { using type = LitPath; };
+template <> struct view_for<Symbol::GetPath> { using type = GetPath; };
+template <> struct view_for<Symbol::SetPath> { using type = SetPath; };
+template <> struct view_for<Symbol::Binary> { using type = Binary; };
+template <> struct view_for<Symbol::Map> { using type = Map; };
+template <> struct view_for<Symbol::Block> { using type = Block; };
+template <> struct view_for<Symbol::Paren> { using type = Paren; };
+template <> struct view_for<Symbol::Function> { using type = Function; };
+template <> struct view_for<Symbol::Does> { using type = Does; };
+template <> struct view_for<Symbol::Context> { using type = Context; };
+template <> struct view_for<Symbol::Make> { using type = Make; };
+template <> struct view_for<Symbol::InvalidToken> { using type = InvalidToken; };
+template <Symbol S> using view_for_t = typename view_for<S>::type;
+
+// A forward range over the children of a node. It owns one tree cursor,
+// so iterating allocates nothing per child.
+class Children {
+ public:
+  class iterator {
+   public:
+    using value_type = Node;
+    using difference_type = std::ptrdiff_t;
+
+    [[nodiscard]] Node operator*() const noexcept {
+      return Node(ts_tree_cursor_current_node(cursor_));
+    }
+    iterator &operator++() noexcept {
+      if (!ts_tree_cursor_goto_next_sibling(cursor_)) cursor_ = nullptr;
+      return *this;
+    }
+    void operator++(int) noexcept { ++*this; }
+    [[nodiscard]] bool operator==(std::default_sentinel_t) const noexcept {
+      return cursor_ == nullptr;
+    }
+
+   private:
+    friend class Children;
+    constexpr explicit iterator(TSTreeCursor *cursor) noexcept : cursor_(cursor) {}
+    TSTreeCursor *cursor_;
+  };
+
+  explicit Children(TSNode parent) noexcept
+      : cursor_(ts_tree_cursor_new(parent)),
+        empty_(!ts_tree_cursor_goto_first_child(&cursor_)) {}
+  Children(const Children &) = delete;
+  Children &operator=(const Children &) = delete;
+  ~Children() { ts_tree_cursor_delete(&cursor_); }
+
+  [[nodiscard]] iterator begin() noexcept {
+    return iterator(empty_ ? nullptr : &cursor_);
+  }
+  [[nodiscard]] std::default_sentinel_t end() const noexcept { return {}; }
+
+ private:
+  TSTreeCursor cursor_;
+  bool empty_;
+};
+
+inline Children Node::children() const noexcept { return Children(node_); }
+
+// Call `visitor` with the typed view of `node` if it accepts that view, and
+// with the untyped node otherwise (when it accepts one). The overload is
+// chosen at compile time; at run time this is a single switch on the id.
+template <class Visitor> void visit(Node node, Visitor &&visitor) {
+  switch (node.symbol()) {
+  case Symbol::Comment:
+    if constexpr (std::is_invocable_v<Visitor, Comment>) {
+      std::forward<Visitor>(visitor)(Comment(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Number:
+    if constexpr (std::is_invocable_v<Visitor, Number>) {
+      std::forward<Visitor>(visitor)(Number(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Pair:
+    if constexpr (std::is_invocable_v<Visitor, Pair>) {
+      std::forward<Visitor>(visitor)(Pair(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Money:
+    if constexpr (std::is_invocable_v<Visitor, Money>) {
+      std::forward<Visitor>(visitor)(Money(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Tuple:
+    if constexpr (std::is_invocable_v<Visitor, Tuple>) {
+      std::forward<Visitor>(visitor)(Tuple(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::ZoneIndex:
+    if constexpr (std::is_invocable_v<Visitor, ZoneIndex>) {
+      std::forward<Visitor>(visitor)(ZoneIndex(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Cidr:
+    if constexpr (std::is_invocable_v<Visitor, Cidr>) {
+      std::forward<Visitor>(visitor)(Cidr(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Ref:
+    if constexpr (std::is_invocable_v<Visitor, Ref>) {
+      std::forward<Visitor>(visitor)(Ref(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Issue:
+    if constexpr (std::is_invocable_v<Visitor, Issue>) {
+      std::forward<Visitor>(visitor)(Issue(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Email:
+    if constexpr (std::is_invocable_v<Visitor, Email>) {
+      std::forward<Visitor>(visitor)(Email(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::StringContent:
+    if constexpr (std::is_invocable_v<Visitor, StringContent>) {
+      std::forward<Visitor>(visitor)(StringContent(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::EscapedChar:
+    if constexpr (std::is_invocable_v<Visitor, EscapedChar>) {
+      std::forward<Visitor>(visitor)(EscapedChar(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Tag:
+    if constexpr (std::is_invocable_v<Visitor, Tag>) {
+      std::forward<Visitor>(visitor)(Tag(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::InfixOp:
+    if constexpr (std::is_invocable_v<Visitor, InfixOp>) {
+      std::forward<Visitor>(visitor)(InfixOp(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Hexa:
+    if constexpr (std::is_invocable_v<Visitor, Hexa>) {
+      std::forward<Visitor>(visitor)(Hexa(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::RawString:
+    if constexpr (std::is_invocable_v<Visitor, RawString>) {
+      std::forward<Visitor>(visitor)(RawString(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Ipv6Address:
+    if constexpr (std::is_invocable_v<Visitor, Ipv6Address>) {
+      std::forward<Visitor>(visitor)(Ipv6Address(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::SourceFile:
+    if constexpr (std::is_invocable_v<Visitor, SourceFile>) {
+      std::forward<Visitor>(visitor)(SourceFile(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Boolean:
+    if constexpr (std::is_invocable_v<Visitor, Boolean>) {
+      std::forward<Visitor>(visitor)(Boolean(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Point:
+    if constexpr (std::is_invocable_v<Visitor, Point>) {
+      std::forward<Visitor>(visitor)(Point(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Ipv6:
+    if constexpr (std::is_invocable_v<Visitor, Ipv6>) {
+      std::forward<Visitor>(visitor)(Ipv6(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Time:
+    if constexpr (std::is_invocable_v<Visitor, Time>) {
+      std::forward<Visitor>(visitor)(Time(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Date:
+    if constexpr (std::is_invocable_v<Visitor, Date>) {
+      std::forward<Visitor>(visitor)(Date(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Char:
+    if constexpr (std::is_invocable_v<Visitor, Char>) {
+      std::forward<Visitor>(visitor)(Char(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Refinement:
+    if constexpr (std::is_invocable_v<Visitor, Refinement>) {
+      std::forward<Visitor>(visitor)(Refinement(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::File:
+    if constexpr (std::is_invocable_v<Visitor, File>) {
+      std::forward<Visitor>(visitor)(File(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::String:
+    if constexpr (std::is_invocable_v<Visitor, String>) {
+      std::forward<Visitor>(visitor)(String(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::MultilineString:
+    if constexpr (std::is_invocable_v<Visitor, MultilineString>) {
+      std::forward<Visitor>(visitor)(MultilineString(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Construction:
+    if constexpr (std::is_invocable_v<Visitor, Construction>) {
+      std::forward<Visitor>(visitor)(Construction(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Word:
+    if constexpr (std::is_invocable_v<Visitor, Word>) {
+      std::forward<Visitor>(visitor)(Word(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::LitWord:
+    if constexpr (std::is_invocable_v<Visitor, LitWord>) {
+      std::forward<Visitor>(visitor)(LitWord(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::GetWord:
+    if constexpr (std::is_invocable_v<Visitor, GetWord>) {
+      std::forward<Visitor>(visitor)(GetWord(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::SetWord:
+    if constexpr (std::is_invocable_v<Visitor, SetWord>) {
+      std::forward<Visitor>(visitor)(SetWord(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Url:
+    if constexpr (std::is_invocable_v<Visitor, Url>) {
+      std::forward<Visitor>(visitor)(Url(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::PathStart:
+    if constexpr (std::is_invocable_v<Visitor, PathStart>) {
+      std::forward<Visitor>(visitor)(PathStart(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Path:
+    if constexpr (std::is_invocable_v<Visitor, Path>) {
+      std::forward<Visitor>(visitor)(Path(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::LitPath:
+    if constexpr (std::is_invocable_v<Visitor, LitPath>) {
+      std::forward<Visitor>(visitor)(LitPath(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::GetPath:
+    if constexpr (std::is_invocable_v<Visitor, GetPath>) {
+      std::forward<Visitor>(visitor)(GetPath(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::SetPath:
+    if constexpr (std::is_invocable_v<Visitor, SetPath>) {
+      std::forward<Visitor>(visitor)(SetPath(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Binary:
+    if constexpr (std::is_invocable_v<Visitor, Binary>) {
+      std::forward<Visitor>(visitor)(Binary(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Map:
+    if constexpr (std::is_invocable_v<Visitor, Map>) {
+      std::forward<Visitor>(visitor)(Map(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Block:
+    if constexpr (std::is_invocable_v<Visitor, Block>) {
+      std::forward<Visitor>(visitor)(Block(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Paren:
+    if constexpr (std::is_invocable_v<Visitor, Paren>) {
+      std::forward<Visitor>(visitor)(Paren(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Function:
+    if constexpr (std::is_invocable_v<Visitor, Function>) {
+      std::forward<Visitor>(visitor)(Function(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Does:
+    if constexpr (std::is_invocable_v<Visitor, Does>) {
+      std::forward<Visitor>(visitor)(Does(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Context:
+    if constexpr (std::is_invocable_v<Visitor, Context>) {
+      std::forward<Visitor>(visitor)(Context(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::Make:
+    if constexpr (std::is_invocable_v<Visitor, Make>) {
+      std::forward<Visitor>(visitor)(Make(node.raw()));
+      return;
+    }
+    break;
+  case Symbol::InvalidToken:
+    if constexpr (std::is_invocable_v<Visitor, InvalidToken>) {
+      std::forward<Visitor>(visitor)(InvalidToken(node.raw()));
+      return;
+    }
+    break;
+  }
+  if constexpr (std::is_invocable_v<Visitor, Node>) {
+    std::forward<Visitor>(visitor)(node);
+  }
+}
+
+// Walk `node` and its descendants in document order with one tree cursor,
+// passing every named node to `visit`.
+template <class Visitor> void walk(Node node, Visitor &&visitor) {
+  TSTreeCursor cursor = ts_tree_cursor_new(node.raw());
+  for (;;) {
+    Node current(ts_tree_cursor_current_node(&cursor));
+    if (current.is_named()) visit(current, visitor);
+    if (ts_tree_cursor_goto_first_child(&cursor)) continue;
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        ts_tree_cursor_delete(&cursor);
+        return;
+      }
+    }
+  }
+}
+
+}  // namespace tree_sitter::red
+
+#endif  // TREE_SITTER_RED_HPP_
@@ -1,7 +1,13 @@
 package tree_sitter_red_test
 
 import (
+	"bytes"
+	"context"
+	"os"
+	"path/filepath"
+	"strings"
 	"testing"
+	"time"
 
 	tree_sitter "github.com/tree-sitter/go-tree-sitter"
 	tree_sitter_red "github.com/red/tree-sitter-red/bindings/go"
@@ -13,3 +19,193 @@ func TestCanLoadGrammar(t *testing.T) {
 		t.Errorf("Error loading Red grammar")
 	}
 }
+
+func TestSymbolIds(t *testing.T) {
+	language := tree_sitter.NewLanguage(tree_sitter_red.Language())
+	if id := language.IdForNodeKind("set_word", true); id != tree_sitter_red.SymbolSetWord {
+		t.Errorf("set_word has id %d, want %d", id, tree_sitter_red.SymbolSetWord)
+	}
+	if id := language.FieldIdForName("body"); id != tree_sitter_red.FieldBody {
+		t.Errorf("body has id %d, want %d", id, tree_sitter_red.FieldBody)
+	}
+}
+
+func TestCanceledParseReturnsNoTree(t *testing.T) {
+	parser := tree_sitter.NewParser()
+	defer parser.Close()
+	parser.SetLanguage(tree_sitter.NewLanguage(tree_sitter_red.Language()))
+	source := bytes.Repeat([]byte("a: [b c/d \"e\" 1.5 #{00}]\n"), 20000)
+
+	ctx, cancel := context.WithCancel(context.Background())
+	cancel()
+	if result := tree_sitter_red.Parse(ctx, parser, source, nil); result.Status != tree_sitter_red.ParseCanceled || result.Tree != nil {
+		t.Errorf("canceled parse returned %v", result.Status)
+	} else if result.Offset >= uint32(len(source)) {
+		t.Errorf("canceled parse got to %d", result.Offset)
+	}
+
+	// The next parse resumes where the canceled one stopped.
+	result := tree_sitter_red.Parse(context.Background(), parser, source, nil)
+	if result.Status != tree_sitter_red.ParseDone || result.Tree == nil || result.HasError {
+		t.Fatalf("resumed parse returned %v", result.Status)
+	}
+	result.Tree.Close()
+}
+
+func TestParseStopsWhenOutOfTime(t *testing.T) {
+	parser := tree_sitter.NewParser()
+	defer parser.Close()
+	parser.SetLanguage(tree_sitter.NewLanguage(tree_sitter_red.Language()))
+	source := bytes.Repeat([]byte("a: [b c/d \"e\" 1.5 #{00}]\n"), 20000)
+
+	ctx, cancel := context.WithTimeout(context.Background(), time.Microsecond)
+	defer cancel()
+	time.Sleep(time.Millisecond)
+	if result := tree_sitter_red.Parse(ctx, parser, source, nil); result.Status != tree_sitter_red.ParseTimedOut || result.Tree != nil {
+		t.Errorf("timed out parse returned %v", result.Status)
+	}
+	parser.Reset()
+}
+
+func TestScannerBudgetEndsUnclosedStrings(t *testing.T) {
+	parser := tree_sitter.NewParser()
+	defer parser.Close()
+	parser.SetLanguage(tree_sitter.NewLanguage(tree_sitter_red.Language()))
+	source := append([]byte("{"), bytes.Repeat([]byte("x: 1\n"), 1000)...)
+
+	result := tree_sitter_red.ParseWithBudget(context.Background(), parser, source, nil, 100)
+	if result.Tree == nil {
+		t.Fatalf("parse returned %v", result.Status)
+	}
+	defer result.Tree.Close()
+	node := result.Tree.RootNode().NamedChild(0)
+	if node.KindId() != tree_sitter_red.SymbolMultilineString || node.EndByte() >= 200 {
+		t.Errorf("unclosed string is %s, ending at %d", node.Kind(), node.EndByte())
+	}
+	if !result.Tree.RootNode().HasError() {
+		t.Errorf("cut string is not an error")
+	}
+
+	// The budget was for that parse only.
+	tree := parser.Parse(source, nil)
+	defer tree.Close()
+	if end := tree.RootNode().NamedChild(0).EndByte(); end != uint(len(source)) {
+		t.Errorf("string after the budgeted parse ends at %d", end)
+	}
+}
+
+func TestStreamParsesAsString(t *testing.T) {
+	parser := tree_sitter.NewParser()
+	defer parser.Close()
+	parser.SetLanguage(tree_sitter.NewLanguage(tree_sitter_red.Language()))
+	source := bytes.Repeat([]byte("a: [b c/d \"é\" 1.5 #{00}]\n"), 2000)
+	expected := parser.Parse(source, nil)
+	defer expected.Close()
+
+	path := filepath.Join(t.TempDir(), "stream.red")
+	if err := os.WriteFile(path, append([]byte("\xEF\xBB\xBF"), source...), 0o644); err != nil {
+		t.Fatal(err)
+	}
+	stream, err := tree_sitter_red.OpenStream(path, 64)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer stream.Close()
+	tree := stream.Parse(parser, nil)
+	defer tree.Close()
+	if tree.RootNode().ToSexp() != expected.RootNode().ToSexp() ||
+		tree.RootNode().EndByte() != uint(len(source)) {
+		t.Errorf("stream parsed to %d bytes", tree.RootNode().EndByte())
+	}
+	if offset, ok := stream.InvalidOffset(); ok {
+		t.Errorf("invalid byte at %d", offset)
+	}
+	if _, err := tree_sitter_red.OpenStream(path+".missing", 0); err == nil {
+		t.Errorf("opened a missing file")
+	}
+}
+
+// utf16 encodes text, which is ASCII but for é, as UTF-16 with a byte order
+// mark.
+func utf16(text string, bigEndian bool) []byte {
+	var encoded []byte
+	for _, r := range "\uFEFF" + text {
+		if bigEndian {
+			encoded = append(encoded, byte(r>>8), byte(r))
+		} else {
+			encoded = append(encoded, byte(r), byte(r>>8))
+		}
+	}
+	return encoded
+}
+
+func TestStreamParsesUTF16(t *testing.T) {
+	parser := tree_sitter.NewParser()
+	defer parser.Close()
+	parser.SetLanguage(tree_sitter.NewLanguage(tree_sitter_red.Language()))
+	text := strings.Repeat("a: [b c/d \"é\" 1.5 #{00}]\n", 200)
+	expected := parser.Parse([]byte(text), nil)
+	defer expected.Close()
+
+	for _, test := range []struct {
+		bigEndian bool
+		encoding  tree_sitter_red.StreamEncoding
+	}{
+		{false, tree_sitter_red.StreamUTF16LE},
+		{true, tree_sitter_red.StreamUTF16BE},
+	} {
+		path := filepath.Join(t.TempDir(), "stream.red")
+		if err := os.WriteFile(path, utf16(text, test.bigEndian), 0o644); err != nil {
+			t.Fatal(err)
+		}
+		stream, err := tree_sitter_red.OpenStream(path, 64)
+		if err != nil {
+			t.Fatal(err)
+		}
+		if stream.Encoding() != test.encoding || stream.BOMLength() != 2 {
+			t.Errorf("encoding %d with a %d-byte mark", stream.Encoding(), stream.BOMLength())
+		}
+		tree := stream.Parse(parser, nil)
+		root := tree.RootNode()
+		if root.HasError() || root.ToSexp() != expected.RootNode().ToSexp() ||
+			root.EndByte() != uint(2*len([]rune(text))) {
+			t.Errorf("big endian %v: parsed to %d bytes: %s", test.bigEndian, root.EndByte(), root.ToSexp())
+		}
+		tree.Close()
+		stream.Close()
+	}
+}
+
+func TestCacheKeepsValuesAcrossOpens(t *testing.T) {
+	directory := t.TempDir()
+	hash := tree_sitter_red.CacheHash([]byte("Red [] print 1"))
+	if hash == tree_sitter_red.CacheHash([]byte("Red [] print 2")) {
+		t.Errorf("sources hash alike")
+	}
+	cache, err := tree_sitter_red.OpenCache(directory, 0)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if _, ok := cache.Get(hash, tree_sitter_red.CacheErrors); ok {
+		t.Errorf("empty cache has a value")
+	}
+	if !cache.Put(hash, tree_sitter_red.CacheErrors, []byte("[]")) {
+		t.Errorf("put failed")
+	}
+	cache.Close()
+
+	cache, err = tree_sitter_red.OpenCache(directory, 0)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer cache.Close()
+	if value, ok := cache.Get(hash, tree_sitter_red.CacheErrors); !ok || string(value) != "[]" {
+		t.Errorf("got %q, %v", value, ok)
+	}
+	if _, ok := cache.Get(hash, tree_sitter_red.CacheOutline); ok {
+		t.Errorf("got a value of another kind")
+	}
+	if !cache.Compact() {
+		t.Errorf("compact failed")
+	}
+}
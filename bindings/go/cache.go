@@ -0,0 +1,78 @@
+package tree_sitter_red
+
+// #cgo CFLAGS: -std=c11 -fPIC -I${SRCDIR}/../c
+// #include "../c/src/cache.c"
+// #include <stdlib.h>
+import "C"
+
+import (
+	"unsafe"
+)
+
+// The kinds of value a Cache holds.
+const (
+	CacheErrors       uint32 = 1
+	CacheOutline      uint32 = 2
+	CacheSymbols      uint32 = 3
+	CacheTree         uint32 = 4
+	CacheDependencies uint32 = 5
+	// Kinds from CacheUser on are free for applications.
+	CacheUser uint32 = 0x100
+)
+
+// CacheHash is the hash a Cache keys a source by.
+func CacheHash(source []byte) uint64 {
+	return uint64(C.tree_sitter_red_hash(unsafe.Pointer(unsafe.SliceData(source)), C.size_t(len(source)), 0))
+}
+
+// Cache is a persistent store of results derived from Red sources, shared
+// by any number of processes. Entries are keyed by the CacheHash of a source
+// and a kind, and entries written by another version of the grammar are
+// never returned. Once the store outgrows its size limit, the least recently
+// used entries are dropped. A Cache is not safe for concurrent use.
+type Cache struct {
+	raw *C.TSRedCache
+}
+
+// OpenCache opens or creates the cache in directory, keeping it under
+// sizeLimit bytes, or 64 MiB if 0. It fails on Windows. Close releases it.
+func OpenCache(directory string, sizeLimit uint64) (*Cache, error) {
+	cdirectory := C.CString(directory)
+	defer C.free(unsafe.Pointer(cdirectory))
+	raw, err := C.tree_sitter_red_cache_open(cdirectory, C.uint64_t(sizeLimit))
+	if raw == nil {
+		return nil, err
+	}
+	return &Cache{raw}, nil
+}
+
+// Close releases the cache; the store stays on disk.
+func (c *Cache) Close() {
+	if c.raw != nil {
+		C.tree_sitter_red_cache_close(c.raw)
+		c.raw = nil
+	}
+}
+
+// Get returns the value of kind for the source whose CacheHash is hash.
+func (c *Cache) Get(hash uint64, kind uint32) ([]byte, bool) {
+	var value *C.uint8_t
+	var length C.size_t
+	if !C.tree_sitter_red_cache_get(c.raw, C.uint64_t(hash), C.uint32_t(kind), &value, &length) {
+		return nil, false
+	}
+	defer C.free(unsafe.Pointer(value))
+	return C.GoBytes(unsafe.Pointer(value), C.int(length)), true
+}
+
+// Put stores value as the value of kind for the source whose CacheHash is
+// hash. Values over half the size limit are not stored.
+func (c *Cache) Put(hash uint64, kind uint32, value []byte) bool {
+	return bool(C.tree_sitter_red_cache_put(c.raw, C.uint64_t(hash), C.uint32_t(kind), unsafe.Pointer(unsafe.SliceData(value)), C.size_t(len(value))))
+}
+
+// Compact rewrites the store now, keeping the most recently used entries that
+// fit in half of the size limit.
+func (c *Cache) Compact() bool {
+	return bool(C.tree_sitter_red_cache_compact(c.raw))
+}
@@ -0,0 +1,84 @@
+package tree_sitter_red
+
+// #include <stdint.h>
+// uint32_t tree_sitter_red_external_scanner_set_budget(uint32_t characters);
+import "C"
+
+import (
+	"context"
+	"errors"
+	"runtime"
+
+	tree_sitter "github.com/tree-sitter/go-tree-sitter"
+)
+
+// ParseStatus tells why Parse returned.
+type ParseStatus int
+
+const (
+	ParseDone ParseStatus = iota
+	ParseTimedOut
+	ParseCanceled
+)
+
+// ParseResult is the tree of a parse, or how far it got before it stopped.
+type ParseResult struct {
+	// Tree is nil if the parse stopped.
+	Tree   *tree_sitter.Tree
+	Status ParseStatus
+	// Offset is the length of the source when done.
+	Offset   uint32
+	HasError bool
+}
+
+// Parse parses source with parser, reusing oldTree if not nil, until ctx is
+// done. The parser checks ctx every few hundred operations. A parse that
+// stopped has no tree; the parser keeps its work, so parsing the same source
+// again resumes it, and parser.Reset discards it.
+func Parse(ctx context.Context, parser *tree_sitter.Parser, source []byte, oldTree *tree_sitter.Tree) ParseResult {
+	var result ParseResult
+	options := tree_sitter.ParseOptions{
+		ProgressCallback: func(state tree_sitter.ParseState) bool {
+			result.Offset = state.CurrentByteOffset
+			result.HasError = state.HasError
+			switch err := ctx.Err(); {
+			case err == nil:
+				return false
+			case errors.Is(err, context.DeadlineExceeded):
+				result.Status = ParseTimedOut
+			default:
+				result.Status = ParseCanceled
+			}
+			return true
+		},
+	}
+	read := func(offset int, _ tree_sitter.Point) []byte {
+		if offset < len(source) {
+			return source[offset:]
+		}
+		return nil
+	}
+	if tree := parser.ParseWithOptions(read, oldTree, &options); tree != nil {
+		return ParseResult{
+			Tree:     tree,
+			Status:   ParseDone,
+			Offset:   uint32(len(source)),
+			HasError: tree.RootNode().HasError(),
+		}
+	}
+	return result
+}
+
+// ParseWithBudget is Parse with a scanner budget for this parse only: the
+// body of a multiline or raw string may span at most budget characters, or
+// any number if 0. Past it, the string is cut short and the tree has an
+// error there. Parses in other goroutines are not affected.
+func ParseWithBudget(ctx context.Context, parser *tree_sitter.Parser, source []byte, oldTree *tree_sitter.Tree, budget uint32) ParseResult {
+	// The scanner keeps its budget per OS thread, so the goroutine stays on
+	// this one until the budget is restored.
+	runtime.LockOSThread()
+	defer runtime.UnlockOSThread()
+	previous := C.tree_sitter_red_external_scanner_set_budget(C.uint32_t(budget))
+	defer C.tree_sitter_red_external_scanner_set_budget(previous)
+	return Parse(ctx, parser, source, oldTree)
+}
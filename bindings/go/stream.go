@@ -0,0 +1,118 @@
+package tree_sitter_red
+
+// #cgo CFLAGS: -std=c11 -fPIC -I${SRCDIR}/../c
+// #include "../c/src/stream.c"
+// #include <stdlib.h>
+import "C"
+
+import (
+	"runtime"
+	"unsafe"
+
+	tree_sitter "github.com/tree-sitter/go-tree-sitter"
+)
+
+// StreamEncoding is the encoding of a Stream, from its byte order mark.
+type StreamEncoding int
+
+const (
+	StreamUTF8 StreamEncoding = iota
+	StreamUTF16LE
+	StreamUTF16BE
+)
+
+// Stream is a file that a parser reads a window at a time, from a memory
+// map. The map is advised as read sequentially, and pages more than a window
+// behind the parser are dropped, so a parse keeps about one window of the
+// file resident besides its tree. The byte order mark is not part of the
+// text: offsets in the tree count from just after it.
+type Stream struct {
+	raw *C.TSRedStream
+}
+
+// OpenStream maps the file at path, to be read window bytes at a time, or
+// 64 KiB if 0. Close releases it.
+func OpenStream(path string, window uint32) (*Stream, error) {
+	cpath := C.CString(path)
+	defer C.free(unsafe.Pointer(cpath))
+	raw, err := C.tree_sitter_red_stream_open(cpath, C.uint32_t(window))
+	if raw == nil {
+		return nil, err
+	}
+	return &Stream{raw}, nil
+}
+
+// Close unmaps the file.
+func (s *Stream) Close() {
+	if s.raw != nil {
+		C.tree_sitter_red_stream_delete(s.raw)
+		s.raw = nil
+	}
+}
+
+func (s *Stream) Encoding() StreamEncoding {
+	return StreamEncoding(C.tree_sitter_red_stream_encoding(s.raw))
+}
+
+// BOMLength is the length of the byte order mark: 0, 2 or 3.
+func (s *Stream) BOMLength() uint32 {
+	return uint32(C.tree_sitter_red_stream_bom_length(s.raw))
+}
+
+// InvalidOffset is the offset in the text of the first byte not valid in the
+// encoding, among those read so far. After a parse, it covers the whole file.
+func (s *Stream) InvalidOffset() (uint32, bool) {
+	offset := uint32(C.tree_sitter_red_stream_invalid_offset(s.raw))
+	return offset, offset != ^uint32(0)
+}
+
+// Failed tells whether reading the file failed, so that it seemed to end
+// early.
+func (s *Stream) Failed() bool {
+	return bool(C.tree_sitter_red_stream_failed(s.raw))
+}
+
+// Read returns the text from byte, up to a window of it, and nil at the end.
+// The slice points into the stream's map or buffer without copying, and is
+// only valid until the next Read or Close.
+func (s *Stream) Read(byte uint32) []byte {
+	var size C.uint32_t
+	text := C.tree_sitter_red_stream_read(s.raw, C.uint32_t(byte), &size)
+	runtime.KeepAlive(s)
+	if size == 0 {
+		return nil
+	}
+	return unsafe.Slice((*uint8)(unsafe.Pointer(text)), int(size))
+}
+
+// Parse parses the file with parser, reusing oldTree if not nil, in its
+// encoding.
+func (s *Stream) Parse(parser *tree_sitter.Parser, oldTree *tree_sitter.Tree) *tree_sitter.Tree {
+	// The parser takes UTF-16 of either byte order as the bytes in memory of
+	// the units it is given, so the file's bytes are passed on as they are,
+	// two to a unit, for big-endian files too. A window that does not start
+	// on an even address is copied, as units must be aligned.
+	units := func(unit int, _ tree_sitter.Point) []uint16 {
+		text := s.Read(uint32(unit * 2))
+		if len(text) < 2 {
+			return nil
+		}
+		if uintptr(unsafe.Pointer(&text[0]))%unsafe.Alignof(uint16(0)) != 0 {
+			aligned := make([]uint16, len(text)/2)
+			copy(unsafe.Slice((*uint8)(unsafe.Pointer(&aligned[0])), len(aligned)*2), text)
+			return aligned
+		}
+		return unsafe.Slice((*uint16)(unsafe.Pointer(&text[0])), len(text)/2)
+	}
+	switch s.Encoding() {
+	case StreamUTF16LE:
+		return parser.ParseUTF16LEWithOptions(units, oldTree, nil)
+	case StreamUTF16BE:
+		return parser.ParseUTF16BEWithOptions(units, oldTree, nil)
+	default:
+		read := func(offset int, _ tree_sitter.Point) []byte {
+			return s.Read(uint32(offset))
+		}
+		return parser.ParseWithOptions(read, oldTree, nil)
+	}
+}
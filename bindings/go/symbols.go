@@ -0,0 +1,63 @@
+// Code generated by scripts/generate-bindings.js. DO NOT EDIT.
+
+package tree_sitter_red
+
+// Ids of the named node kinds, as returned by Node.KindId.
+const (
+	SymbolComment         uint16 = 2
+	SymbolNumber          uint16 = 10
+	SymbolPair            uint16 = 11
+	SymbolMoney           uint16 = 15
+	SymbolTuple           uint16 = 16
+	SymbolZoneIndex       uint16 = 17
+	SymbolCidr            uint16 = 18
+	SymbolRef             uint16 = 26
+	SymbolIssue           uint16 = 27
+	SymbolEmail           uint16 = 30
+	SymbolStringContent   uint16 = 34
+	SymbolEscapedChar     uint16 = 38
+	SymbolTag             uint16 = 60
+	SymbolInfixOp         uint16 = 87
+	SymbolHexa            uint16 = 88
+	SymbolRawString       uint16 = 89
+	SymbolIpv6Address     uint16 = 91
+	SymbolSourceFile      uint16 = 93
+	SymbolBoolean         uint16 = 94
+	SymbolPoint           uint16 = 95
+	SymbolIpv6            uint16 = 96
+	SymbolTime            uint16 = 97
+	SymbolDate            uint16 = 98
+	SymbolChar            uint16 = 99
+	SymbolRefinement      uint16 = 100
+	SymbolFile            uint16 = 101
+	SymbolString          uint16 = 103
+	SymbolMultilineString uint16 = 104
+	SymbolConstruction    uint16 = 105
+	SymbolWord            uint16 = 106
+	SymbolLitWord         uint16 = 107
+	SymbolGetWord         uint16 = 108
+	SymbolSetWord         uint16 = 109
+	SymbolUrl             uint16 = 110
+	SymbolPathStart       uint16 = 112
+	SymbolPath            uint16 = 113
+	SymbolLitPath         uint16 = 114
+	SymbolGetPath         uint16 = 115
+	SymbolSetPath         uint16 = 116
+	SymbolBinary          uint16 = 117
+	SymbolMap             uint16 = 118
+	SymbolBlock           uint16 = 119
+	SymbolParen           uint16 = 120
+	SymbolFunction        uint16 = 121
+	SymbolDoes            uint16 = 122
+	SymbolContext         uint16 = 123
+	SymbolMake            uint16 = 124
+	SymbolInvalidToken    uint16 = 125
+)
+
+// Ids of the fields, for Node.ChildByFieldId.
+const (
+	FieldBody uint16 = 1
+	FieldKey  uint16 = 2
+	FieldName uint16 = 3
+	FieldSpec uint16 = 4
+)
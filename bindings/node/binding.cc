@@ -1,18 +1,362 @@
 #include <napi.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tree_sitter/tree-sitter-red-cache.h"
+#include "tree_sitter/tree-sitter-red-stream.h"
+
 typedef struct TSLanguage TSLanguage;
 
 extern "C" TSLanguage *tree_sitter_red();
+extern "C" uint32_t tree_sitter_red_external_scanner_set_budget(uint32_t characters);
 
 // "tree-sitter", "language" hashed with BLAKE2
 const napi_type_tag LANGUAGE_TYPE_TAG = {
     0x8AF2E5212AD58ABF, 0xD5006CAD83ABBA16
 };
 
+Napi::Value SetScannerBudget(const Napi::CallbackInfo &info) {
+    auto env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "budget must be a number").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    uint32_t previous =
+        tree_sitter_red_external_scanner_set_budget(info[0].As<Napi::Number>().Uint32Value());
+    return Napi::Number::New(env, previous);
+}
+
+// A stream read as JavaScript strings, which count UTF-16 units rather than
+// bytes.
+struct Stream {
+    TSRedStream *stream;
+    // The byte offset of the text at each unit offset where a read ended,
+    // sorted, to resume decoding from.
+    std::vector<std::pair<uint32_t, uint32_t>> checkpoints;
+};
+
+// Tells the externals OpenStream makes from any other.
+const napi_type_tag STREAM_TYPE_TAG = {
+    0x5C1E0B7A93D4F268, 0xA7E3C05D1B8F4926
+};
+
+static Stream *GetStream(const Napi::CallbackInfo &info) {
+    if (info.Length() < 1 || !info[0].IsExternal() ||
+        !info[0].As<Napi::External<Stream>>().CheckTypeTag(&STREAM_TYPE_TAG)) {
+        Napi::TypeError::New(info.Env(), "not a stream").ThrowAsJavaScriptException();
+        return nullptr;
+    }
+    Stream *stream = info[0].As<Napi::External<Stream>>().Data();
+    if (!stream->stream) {
+        Napi::Error::New(info.Env(), "stream is closed").ThrowAsJavaScriptException();
+        return nullptr;
+    }
+    return stream;
+}
+
+Napi::Value OpenStream(const Napi::CallbackInfo &info) {
+    auto env = info.Env();
+    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsNumber()) {
+        Napi::TypeError::New(env, "expected a path and a window").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    std::string path = info[0].As<Napi::String>().Utf8Value();
+    TSRedStream *raw = tree_sitter_red_stream_open(
+        path.c_str(), info[1].As<Napi::Number>().Uint32Value());
+    if (!raw) {
+        Napi::Error::New(env, path + ": " + std::strerror(errno)).ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    auto stream = Napi::External<Stream>::New(
+        env, new Stream{raw, {{0, 0}}}, [](Napi::Env, Stream *stream) {
+            tree_sitter_red_stream_delete(stream->stream);
+            delete stream;
+        });
+    stream.TypeTag(&STREAM_TYPE_TAG);
+    return stream;
+}
+
+// Appends the UTF-16 of the whole characters of `text`, from the one at or
+// before unit `skip`, and returns the bytes and units they took. A character
+// cut by the end of `text` is left for the next read, unless `at_end`;
+// invalid bytes read as U+FFFD, as the parser reads them.
+static std::pair<uint32_t, uint32_t> Decode(
+    TSRedStreamEncoding encoding, const uint8_t *text, uint32_t size, bool at_end,
+    uint32_t skip, std::u16string &out) {
+    uint32_t i = 0, units = 0;
+    while (i < size) {
+        uint32_t code, length;
+        if (encoding == TSRedStreamUtf8) {
+            uint8_t c = text[i];
+            length = c < 0x80 ? 1 : c < 0xC2 ? 0 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : c < 0xF5 ? 4 : 0;
+            if (length == 0) {
+                code = 0xFFFD, length = 1;
+            } else if (i + length > size && !at_end) {
+                break;
+            } else {
+                code = length == 1 ? c : c & (0x7F >> length);
+                uint32_t k = 1;
+                for (; k < length && i + k < size && (text[i + k] & 0xC0) == 0x80; k++) {
+                    code = code << 6 | (text[i + k] & 0x3F);
+                }
+                static const uint32_t least[] = {0, 0, 0x80, 0x800, 0x10000};
+                if (k < length || code < least[length] || code > 0x10FFFF ||
+                    (code >= 0xD800 && code < 0xE000)) {
+                    code = 0xFFFD, length = k;
+                }
+            }
+        } else {
+            if (i + 2 > size) {
+                break;
+            }
+            bool little = encoding == TSRedStreamUtf16LE;
+            code = little ? text[i] | text[i + 1] << 8 : text[i] << 8 | text[i + 1];
+            length = 2;
+            if (code >= 0xD800 && code < 0xDC00) {
+                if (i + 4 > size && !at_end) {
+                    break;
+                }
+                uint32_t low = i + 4 > size ? 0
+                    : little ? text[i + 2] | text[i + 3] << 8 : text[i + 2] << 8 | text[i + 3];
+                if (low >= 0xDC00 && low < 0xE000) {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    length = 4;
+                } else {
+                    code = 0xFFFD;
+                }
+            } else if (code >= 0xDC00 && code < 0xE000) {
+                code = 0xFFFD;
+            }
+        }
+        uint32_t count = code > 0xFFFF ? 2 : 1;
+        if (units + count > skip) {
+            if (count == 2) {
+                out.push_back(static_cast<char16_t>(0xD800 + ((code - 0x10000) >> 10)));
+                out.push_back(static_cast<char16_t>(0xDC00 + ((code - 0x10000) & 0x3FF)));
+            } else {
+                out.push_back(static_cast<char16_t>(code));
+            }
+        }
+        units += count;
+        i += length;
+    }
+    return {i, units};
+}
+
+// The text from UTF-16 unit `index`, up to about a window of it, and null at
+// the end.
+Napi::Value ReadStream(const Napi::CallbackInfo &info) {
+    auto env = info.Env();
+    Stream *stream = GetStream(info);
+    if (!stream) {
+        return env.Undefined();
+    }
+    if (info.Length() < 2 || !info[1].IsNumber()) {
+        Napi::TypeError::New(env, "index must be a number").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    uint32_t index = info[1].As<Napi::Number>().Uint32Value();
+    auto &checkpoints = stream->checkpoints;
+    auto checkpoint = std::upper_bound(
+        checkpoints.begin(), checkpoints.end(), std::make_pair(index, UINT32_MAX)) - 1;
+    uint32_t unit = checkpoint->first, byte = checkpoint->second;
+    TSRedStreamEncoding encoding = tree_sitter_red_stream_encoding(stream->stream);
+    std::u16string out;
+    while (out.empty()) {
+        uint32_t size;
+        auto text = reinterpret_cast<const uint8_t *>(
+            tree_sitter_red_stream_read(stream->stream, byte, &size));
+        if (size == 0) {
+            return env.Null();
+        }
+        // The stream returns at least four bytes, so a whole character,
+        // unless these are the last.
+        auto read = Decode(encoding, text, size, false, index - unit, out);
+        if (read.first == 0) {
+            read = Decode(encoding, text, size, true, index - unit, out);
+        }
+        if (read.first == 0) {
+            return env.Null();
+        }
+        byte += read.first;
+        unit += read.second;
+        auto at = std::lower_bound(checkpoints.begin(), checkpoints.end(),
+                                   std::make_pair(unit, 0u));
+        if (at == checkpoints.end() || at->first != unit) {
+            checkpoints.insert(at, {unit, byte});
+        }
+    }
+    return Napi::String::New(env, out.data(), out.size());
+}
+
+Napi::Value StreamInfo(const Napi::CallbackInfo &info) {
+    auto env = info.Env();
+    Stream *stream = GetStream(info);
+    if (!stream) {
+        return env.Undefined();
+    }
+    static const char *const encodings[] = {"utf8", "utf16le", "utf16be"};
+    uint32_t invalid = tree_sitter_red_stream_invalid_offset(stream->stream);
+    auto result = Napi::Object::New(env);
+    result["encoding"] = encodings[tree_sitter_red_stream_encoding(stream->stream)];
+    result["bomLength"] = tree_sitter_red_stream_bom_length(stream->stream);
+    result["invalidOffset"] = invalid == UINT32_MAX ? env.Null() : Napi::Number::New(env, invalid);
+    result["failed"] = tree_sitter_red_stream_failed(stream->stream);
+    return result;
+}
+
+Napi::Value CloseStream(const Napi::CallbackInfo &info) {
+    Stream *stream = GetStream(info);
+    if (stream) {
+        tree_sitter_red_stream_delete(stream->stream);
+        stream->stream = nullptr;
+    }
+    return info.Env().Undefined();
+}
+
+Napi::Value CacheHash(const Napi::CallbackInfo &info) {
+    auto env = info.Env();
+    if (info.Length() < 1 || !info[0].IsBuffer()) {
+        Napi::TypeError::New(env, "source must be a buffer").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    auto source = info[0].As<Napi::Buffer<uint8_t>>();
+    return Napi::BigInt::New(env, tree_sitter_red_hash(source.Data(), source.Length(), 0));
+}
+
+// Tells the externals OpenCache makes from any other.
+const napi_type_tag CACHE_TYPE_TAG = {
+    0x3B9F61D2C8A4E057, 0xE1046A9D7C2B583F
+};
+
+// The cache in a cell that CloseCache empties.
+struct Cache {
+    TSRedCache *cache;
+};
+
+static TSRedCache *GetCache(const Napi::CallbackInfo &info) {
+    if (info.Length() < 1 || !info[0].IsExternal() ||
+        !info[0].As<Napi::External<Cache>>().CheckTypeTag(&CACHE_TYPE_TAG)) {
+        Napi::TypeError::New(info.Env(), "not a cache").ThrowAsJavaScriptException();
+        return nullptr;
+    }
+    TSRedCache *cache = info[0].As<Napi::External<Cache>>().Data()->cache;
+    if (!cache) {
+        Napi::Error::New(info.Env(), "cache is closed").ThrowAsJavaScriptException();
+    }
+    return cache;
+}
+
+// Reads the hash and kind that follow the cache in the arguments.
+static bool GetKey(const Napi::CallbackInfo &info, uint64_t *hash, uint32_t *kind) {
+    bool lossless = false;
+    if (info.Length() >= 3 && info[1].IsBigInt() && info[2].IsNumber()) {
+        *hash = info[1].As<Napi::BigInt>().Uint64Value(&lossless);
+        *kind = info[2].As<Napi::Number>().Uint32Value();
+    }
+    if (!lossless) {
+        Napi::TypeError::New(info.Env(), "expected a hash and a kind").ThrowAsJavaScriptException();
+    }
+    return lossless;
+}
+
+Napi::Value OpenCache(const Napi::CallbackInfo &info) {
+    auto env = info.Env();
+    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsNumber()) {
+        Napi::TypeError::New(env, "expected a directory and a size limit").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    std::string directory = info[0].As<Napi::String>().Utf8Value();
+    TSRedCache *raw = tree_sitter_red_cache_open(
+        directory.c_str(), static_cast<uint64_t>(info[1].As<Napi::Number>().Int64Value()));
+    if (!raw) {
+        Napi::Error::New(env, directory + ": " + std::strerror(errno)).ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    auto cache = Napi::External<Cache>::New(
+        env, new Cache{raw}, [](Napi::Env, Cache *cache) {
+            tree_sitter_red_cache_close(cache->cache);
+            delete cache;
+        });
+    cache.TypeTag(&CACHE_TYPE_TAG);
+    return cache;
+}
+
+Napi::Value CacheGet(const Napi::CallbackInfo &info) {
+    auto env = info.Env();
+    TSRedCache *cache = GetCache(info);
+    uint64_t hash;
+    uint32_t kind;
+    if (!cache || !GetKey(info, &hash, &kind)) {
+        return env.Undefined();
+    }
+    uint8_t *value;
+    size_t length;
+    if (!tree_sitter_red_cache_get(cache, hash, kind, &value, &length)) {
+        return env.Null();
+    }
+    auto buffer = Napi::Buffer<uint8_t>::Copy(env, value, length);
+    std::free(value);
+    return buffer;
+}
+
+Napi::Value CachePut(const Napi::CallbackInfo &info) {
+    auto env = info.Env();
+    TSRedCache *cache = GetCache(info);
+    uint64_t hash;
+    uint32_t kind;
+    if (!cache || !GetKey(info, &hash, &kind)) {
+        return env.Undefined();
+    }
+    if (info.Length() < 4 || !info[3].IsBuffer()) {
+        Napi::TypeError::New(env, "value must be a buffer").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    auto value = info[3].As<Napi::Buffer<uint8_t>>();
+    return Napi::Boolean::New(
+        env, tree_sitter_red_cache_put(cache, hash, kind, value.Data(), value.Length()));
+}
+
+Napi::Value CacheCompact(const Napi::CallbackInfo &info) {
+    auto env = info.Env();
+    TSRedCache *cache = GetCache(info);
+    if (!cache) {
+        return env.Undefined();
+    }
+    return Napi::Boolean::New(env, tree_sitter_red_cache_compact(cache));
+}
+
+Napi::Value CloseCache(const Napi::CallbackInfo &info) {
+    TSRedCache *cache = GetCache(info);
+    if (cache) {
+        tree_sitter_red_cache_close(cache);
+        info[0].As<Napi::External<Cache>>().Data()->cache = nullptr;
+    }
+    return info.Env().Undefined();
+}
+
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
     auto language = Napi::External<TSLanguage>::New(env, tree_sitter_red());
     language.TypeTag(&LANGUAGE_TYPE_TAG);
     exports["language"] = language;
+    exports["setScannerBudget"] = Napi::Function::New(env, SetScannerBudget);
+    exports["openStream"] = Napi::Function::New(env, OpenStream);
+    exports["readStream"] = Napi::Function::New(env, ReadStream);
+    exports["streamInfo"] = Napi::Function::New(env, StreamInfo);
+    exports["closeStream"] = Napi::Function::New(env, CloseStream);
+    exports["cacheHash"] = Napi::Function::New(env, CacheHash);
+    exports["openCache"] = Napi::Function::New(env, OpenCache);
+    exports["cacheGet"] = Napi::Function::New(env, CacheGet);
+    exports["cachePut"] = Napi::Function::New(env, CachePut);
+    exports["cacheCompact"] = Napi::Function::New(env, CacheCompact);
+    exports["closeCache"] = Napi::Function::New(env, CloseCache);
     return exports;
 }
 
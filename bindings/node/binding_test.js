@@ -1,4 +1,7 @@
 import assert from "node:assert";
+import { mkdtempSync, rmSync, writeFileSync } from "node:fs";
+import { tmpdir } from "node:os";
+import { join } from "node:path";
 import { test } from "node:test";
 import Parser from "tree-sitter";
 
@@ -9,3 +12,97 @@ test("can load grammar", () => {
     parser.setLanguage(language);
   });
 });
+
+test("cancelled parse returns no tree", async () => {
+  const { default: language } = await import("./index.js");
+  const parser = new Parser();
+  parser.setLanguage(language);
+  const input = 'a: [b c/d "e" 1.5 #{00}]\n'.repeat(20000);
+  const cancel = new Int32Array(new SharedArrayBuffer(4));
+  Atomics.store(cancel, 0, 1);
+  let result = language.parse(parser, input, null, { cancel });
+  assert.strictEqual(result.status, language.ParseStatus.CANCELLED);
+  assert.strictEqual(result.tree, null);
+  assert.ok(result.offset < Buffer.byteLength(input));
+
+  // The next parse resumes where the cancelled one stopped.
+  Atomics.store(cancel, 0, 0);
+  result = language.parse(parser, input, null, { cancel });
+  assert.strictEqual(result.status, language.ParseStatus.DONE);
+  assert.ok(result.tree !== null && !result.hasError);
+});
+
+test("parse stops when out of time", async () => {
+  const { default: language } = await import("./index.js");
+  const parser = new Parser();
+  parser.setLanguage(language);
+  const input = 'a: [b c/d "e" 1.5 #{00}]\n'.repeat(20000);
+  const result = language.parse(parser, input, null, { timeout: 0 });
+  assert.strictEqual(result.status, language.ParseStatus.TIMED_OUT);
+  assert.strictEqual(result.tree, null);
+  parser.reset();
+});
+
+test("scanner budget ends unclosed strings", async () => {
+  const { default: language } = await import("./index.js");
+  const parser = new Parser();
+  parser.setLanguage(language);
+  const input = "{" + "x: 1\n".repeat(1000);
+  const root = language.parse(parser, input, null, { scannerBudget: 100 }).tree.rootNode;
+  const string = root.namedChildren[0];
+  assert.strictEqual(string.typeId, language.symbols.multiline_string);
+  assert.ok(string.endIndex < 200);
+  assert.ok(root.hasError);
+
+  // The budget was for that parse only.
+  assert.strictEqual(parser.parse(input).rootNode.namedChildren[0].endIndex, input.length);
+});
+
+test("parse file reads as a string", async () => {
+  const { default: language } = await import("./index.js");
+  const parser = new Parser();
+  parser.setLanguage(language);
+  const input = 'a: [b c/d "é😀" 1.5 #{00}]\n'.repeat(2000);
+  const expected = parser.parse(input);
+  const dir = mkdtempSync(join(tmpdir(), "tree-sitter-red-"));
+  const path = join(dir, "stream.red");
+  try {
+    writeFileSync(path, "\uFEFF" + input);
+    let result = language.parseFile(parser, path, null, { window: 64 });
+    assert.strictEqual(result.bomLength, 3);
+    assert.strictEqual(result.invalidOffset, null);
+    assert.strictEqual(result.tree.rootNode.toString(), expected.rootNode.toString());
+    assert.strictEqual(result.tree.rootNode.endIndex, input.length);
+
+    writeFileSync(path, Buffer.from("\uFEFF" + input, "utf16le"));
+    result = language.parseFile(parser, path);
+    assert.strictEqual(result.encoding, "utf16le");
+    assert.strictEqual(result.tree.rootNode.toString(), expected.rootNode.toString());
+  } finally {
+    rmSync(dir, { recursive: true });
+  }
+  assert.throws(() => language.parseFile(parser, path));
+});
+
+test("cache keeps values across opens", async () => {
+  const { default: language } = await import("./index.js");
+  const { Cache, CacheKind, cacheHash } = language;
+  const dir = mkdtempSync(join(tmpdir(), "tree-sitter-red-"));
+  const hash = cacheHash(Buffer.from("Red [] print 1"));
+  assert.notStrictEqual(hash, cacheHash(Buffer.from("Red [] print 2")));
+  try {
+    let cache = new Cache(dir);
+    assert.strictEqual(cache.get(hash, CacheKind.ERRORS), null);
+    assert.ok(cache.put(hash, CacheKind.ERRORS, Buffer.from("[]")));
+    cache.close();
+
+    cache = new Cache(dir);
+    assert.deepStrictEqual(cache.get(hash, CacheKind.ERRORS), Buffer.from("[]"));
+    assert.strictEqual(cache.get(hash, CacheKind.OUTLINE), null);
+    assert.ok(cache.compact());
+    cache.close();
+    assert.throws(() => cache.get(hash, CacheKind.ERRORS));
+  } finally {
+    rmSync(dir, { recursive: true });
+  }
+});
@@ -18,6 +18,75 @@ type NodeInfo =
       children: ChildNode[];
     });
 
+type ParseStatus = "done" | "timedOut" | "cancelled";
+
+type ParseResult<Tree> = {
+  /** The tree, or `null` if the parse stopped. */
+  tree: Tree | null;
+  status: ParseStatus;
+  /** How far the parse got: the end of the input when done. */
+  offset: number;
+  hasError: boolean;
+};
+
+type ParseLimits = {
+  /** The time the parse may take, in milliseconds. */
+  timeout?: number;
+  /**
+   * The parse stops once element 0 is non-zero. Backed by a
+   * `SharedArrayBuffer`, it can be set with `Atomics.store` from another
+   * worker while this one parses.
+   */
+  cancel?: Int32Array;
+  /** The scanner budget for this parse only, as `setScannerBudget` sets it. */
+  scannerBudget?: number;
+};
+
+type StreamResult<Tree> = {
+  tree: Tree | null;
+  /** The encoding of the file, from its byte order mark. */
+  encoding: "utf8" | "utf16le" | "utf16be";
+  /** The length of the byte order mark: 0, 2 or 3. */
+  bomLength: number;
+  /**
+   * The byte offset, in the file after its byte order mark, of the first
+   * byte not valid in the encoding, which was parsed as U+FFFD.
+   */
+  invalidOffset: number | null;
+  /** Whether reading the file failed, so that it seemed to end early. */
+  failed: boolean;
+};
+
+/**
+ * A persistent store of results derived from Red sources, shared by any
+ * number of processes. Entries are keyed by the `cacheHash` of a source and
+ * a kind, and entries written by another version of the grammar are never
+ * returned. Once the store outgrows its size limit, the least recently used
+ * entries are dropped. Not available on Windows, where the constructor
+ * throws.
+ */
+declare class Cache {
+  /**
+   * Open or create the cache in `directory`, keeping it under `sizeLimit`
+   * bytes, or 64 MiB if 0.
+   */
+  constructor(directory: string, sizeLimit?: number);
+  /** The value of `kind` for the source whose hash is `hash`, or `null`. */
+  get(hash: bigint, kind: number): Buffer | null;
+  /**
+   * Store `value` as the value of `kind` for the source whose hash is
+   * `hash`. Values over half the size limit are not stored.
+   */
+  put(hash: bigint, kind: number, value: Buffer): boolean;
+  /**
+   * Rewrite the store now, keeping the most recently used entries that fit
+   * in half of the size limit.
+   */
+  compact(): boolean;
+  /** Release the cache; the store stays on disk. */
+  close(): void;
+}
+
 /**
  * The tree-sitter language object for this grammar.
  *
@@ -44,6 +113,97 @@ declare const binding: {
    */
   nodeTypeInfo: NodeInfo[];
 
+  /** The id of every named node kind, as returned by `SyntaxNode.typeId`. */
+  symbols: Readonly<Record<string, number>>;
+
+  /** The id of every field, for `SyntaxNode.childForFieldId`. */
+  fields: Readonly<Record<string, number>>;
+
+  /** The values of `ParseResult.status`. */
+  ParseStatus: Readonly<{
+    DONE: "done";
+    TIMED_OUT: "timedOut";
+    CANCELLED: "cancelled";
+  }>;
+
+  /**
+   * Parse with a timeout and a cancellation flag, which the parser checks
+   * every few hundred operations, and a scanner budget for this parse only.
+   * A parse that stopped has no tree; the parser keeps its work, so parsing
+   * the same input again resumes it, and `parser.reset()` discards it.
+   */
+  parse<Tree>(
+    parser: { parse(input: string, oldTree?: Tree | null, options?: object): Tree | null },
+    input: string,
+    oldTree?: Tree | null,
+    limits?: ParseLimits,
+  ): ParseResult<Tree>;
+
+  /**
+   * Parse the file at `path` a window of `window` bytes at a time, 64 KiB by
+   * default, from a memory map. Pages more than a window behind the parser
+   * are dropped, so a parse keeps about one window of the file resident
+   * besides its tree. Like any input to the parser, the text is read as
+   * UTF-16: indices in the tree count its units, from after the byte order
+   * mark.
+   */
+  parseFile<Tree>(
+    parser: { parse(input: (index: number) => string | null, oldTree?: Tree | null): Tree | null },
+    path: string,
+    oldTree?: Tree | null,
+    options?: { window?: number },
+  ): StreamResult<Tree>;
+
+  /** @private */
+  openStream(path: string, window: number): unknown;
+
+  /** @private */
+  readStream(stream: unknown, index: number): string | null;
+
+  /** @private */
+  streamInfo(stream: unknown): Omit<StreamResult<never>, "tree">;
+
+  /** @private */
+  closeStream(stream: unknown): void;
+
+  /** The hash a `Cache` keys `source` by. */
+  cacheHash(source: Buffer): bigint;
+
+  Cache: typeof Cache;
+
+  /** The kinds of value a `Cache` holds; kinds from `USER` on are free. */
+  CacheKind: {
+    readonly ERRORS: 1;
+    readonly OUTLINE: 2;
+    readonly SYMBOLS: 3;
+    readonly TREE: 4;
+    readonly DEPENDENCIES: 5;
+    readonly USER: 0x100;
+  };
+
+  /** @private */
+  openCache(directory: string, sizeLimit: number): unknown;
+
+  /** @private */
+  cacheGet(cache: unknown, hash: bigint, kind: number): Buffer | null;
+
+  /** @private */
+  cachePut(cache: unknown, hash: bigint, kind: number, value: Buffer): boolean;
+
+  /** @private */
+  cacheCompact(cache: unknown): boolean;
+
+  /** @private */
+  closeCache(cache: unknown): void;
+
+  /**
+   * Limit the characters the body of a multiline or raw string may span in
+   * parses on this thread: past it, the string is cut short and the tree has
+   * an error there. 0, the default, is no limit. Workers keep their own
+   * budget. Returns the previous budget.
+   */
+  setScannerBudget(characters: number): number;
+
   /** The syntax highlighting query for this grammar. */
   HIGHLIGHTS_QUERY?: string;
 
@@ -1,5 +1,6 @@
 import { readFileSync } from "node:fs";
 import { fileURLToPath } from "node:url";
+import { fields, symbols } from "./symbols.js";
 
 const root = fileURLToPath(new URL("../..", import.meta.url));
 
@@ -13,6 +14,96 @@ try {
   binding.nodeTypeInfo = nodeTypes.default;
 } catch { }
 
+binding.symbols = symbols;
+binding.fields = fields;
+
+binding.ParseStatus = Object.freeze({
+  DONE: "done",
+  TIMED_OUT: "timedOut",
+  CANCELLED: "cancelled",
+});
+
+binding.parse = (parser, input, oldTree, { timeout, cancel, scannerBudget } = {}) => {
+  const { ParseStatus } = binding;
+  const deadline = timeout === undefined ? undefined : performance.now() + timeout;
+  let status = ParseStatus.DONE;
+  let offset = 0;
+  let hasError = false;
+  const progressCallback = (state) => {
+    offset = state.currentOffset;
+    hasError = state.hasError;
+    if (cancel !== undefined && Atomics.load(cancel, 0) !== 0) {
+      status = ParseStatus.CANCELLED;
+    } else if (deadline !== undefined && performance.now() >= deadline) {
+      status = ParseStatus.TIMED_OUT;
+    }
+    return status !== ParseStatus.DONE;
+  };
+  // The scanner reads its budget on this thread, which the parse runs on.
+  const previous =
+    scannerBudget === undefined ? undefined : binding.setScannerBudget(scannerBudget);
+  let tree;
+  try {
+    tree = parser.parse(input, oldTree, { progressCallback });
+  } finally {
+    if (previous !== undefined) {
+      binding.setScannerBudget(previous);
+    }
+  }
+  if (tree) {
+    return {
+      tree,
+      status: ParseStatus.DONE,
+      offset: tree.rootNode.endIndex,
+      hasError: tree.rootNode.hasError,
+    };
+  }
+  return { tree: null, status, offset, hasError };
+};
+
+binding.parseFile = (parser, path, oldTree, { window = 0 } = {}) => {
+  const stream = binding.openStream(path, window);
+  try {
+    const tree = parser.parse((index) => binding.readStream(stream, index), oldTree);
+    return { tree, ...binding.streamInfo(stream) };
+  } finally {
+    binding.closeStream(stream);
+  }
+};
+
+binding.CacheKind = Object.freeze({
+  ERRORS: 1,
+  OUTLINE: 2,
+  SYMBOLS: 3,
+  TREE: 4,
+  DEPENDENCIES: 5,
+  USER: 0x100,
+});
+
+binding.Cache = class Cache {
+  #cache;
+
+  constructor(directory, sizeLimit = 0) {
+    this.#cache = binding.openCache(directory, sizeLimit);
+  }
+
+  get(hash, kind) {
+    return binding.cacheGet(this.#cache, hash, kind);
+  }
+
+  put(hash, kind, value) {
+    return binding.cachePut(this.#cache, hash, kind, value);
+  }
+
+  compact() {
+    return binding.cacheCompact(this.#cache);
+  }
+
+  close() {
+    binding.closeCache(this.#cache);
+  }
+};
+
 const queries = [
   ["HIGHLIGHTS_QUERY", `${root}/queries/highlights.scm`],
   ["INJECTIONS_QUERY", `${root}/queries/injections.scm`],
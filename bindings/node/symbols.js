@@ -0,0 +1,61 @@
+// Automatically @generated by scripts/generate-bindings.js
+
+/** Ids of the named node kinds, as returned by `SyntaxNode.typeId`. */
+export const symbols = Object.freeze({
+  comment: 2,
+  number: 10,
+  pair: 11,
+  money: 15,
+  tuple: 16,
+  zone_index: 17,
+  cidr: 18,
+  ref: 26,
+  issue: 27,
+  email: 30,
+  string_content: 34,
+  escaped_char: 38,
+  tag: 60,
+  infix_op: 87,
+  hexa: 88,
+  raw_string: 89,
+  ipv6_address: 91,
+  source_file: 93,
+  boolean: 94,
+  point: 95,
+  ipv6: 96,
+  time: 97,
+  date: 98,
+  char: 99,
+  refinement: 100,
+  file: 101,
+  string: 103,
+  multiline_string: 104,
+  construction: 105,
+  word: 106,
+  lit_word: 107,
+  get_word: 108,
+  set_word: 109,
+  url: 110,
+  path_start: 112,
+  path: 113,
+  lit_path: 114,
+  get_path: 115,
+  set_path: 116,
+  binary: 117,
+  map: 118,
+  block: 119,
+  paren: 120,
+  function: 121,
+  does: 122,
+  context: 123,
+  make: 124,
+  invalid_token: 125,
+});
+
+/** Ids of the fields, for `SyntaxNode.childForFieldId`. */
+export const fields = Object.freeze({
+  body: 1,
+  key: 2,
+  name: 3,
+  spec: 4,
+});
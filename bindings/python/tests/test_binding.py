@@ -1,3 +1,7 @@
+from os import path, remove
+from shutil import rmtree
+from tempfile import mkdtemp
+from threading import Event
 from unittest import TestCase
 
 from tree_sitter import Language, Parser
@@ -10,3 +14,86 @@ class TestLanguage(TestCase):
             Parser(Language(tree_sitter_red.language()))
         except Exception:
             self.fail("Error loading Red grammar")
+
+    def test_symbol_ids_match_grammar(self):
+        language = Language(tree_sitter_red.language())
+        for symbol in tree_sitter_red.Symbol:
+            kind = symbol.name.lower()
+            self.assertEqual(language.id_for_node_kind(kind, True), symbol, kind)
+        for field in tree_sitter_red.Field:
+            name = field.name.lower()
+            self.assertEqual(language.field_id_for_name(name), field, name)
+
+    def test_cancelled_parse_returns_no_tree(self):
+        parser = Parser(Language(tree_sitter_red.language()))
+        source = b'a: [b c/d "e" 1.5 #{00}]\n' * 20000
+        cancel = Event()
+        cancel.set()
+        result = tree_sitter_red.parse(parser, source, cancel=cancel)
+        self.assertEqual(result.status, tree_sitter_red.ParseStatus.CANCELLED)
+        self.assertIsNone(result.tree)
+        self.assertLess(result.offset, len(source))
+
+        # The next parse resumes where the cancelled one stopped.
+        result = tree_sitter_red.parse(parser, source)
+        self.assertEqual(result.status, tree_sitter_red.ParseStatus.DONE)
+        self.assertIsNotNone(result.tree)
+        self.assertFalse(result.has_error)
+
+    def test_parse_stops_when_out_of_time(self):
+        parser = Parser(Language(tree_sitter_red.language()))
+        source = b'a: [b c/d "e" 1.5 #{00}]\n' * 20000
+        result = tree_sitter_red.parse(parser, source, timeout=1e-6)
+        self.assertEqual(result.status, tree_sitter_red.ParseStatus.TIMED_OUT)
+        self.assertIsNone(result.tree)
+        parser.reset()
+
+    def test_scanner_budget_ends_unclosed_strings(self):
+        parser = Parser(Language(tree_sitter_red.language()))
+        source = b"{" + b"x: 1\n" * 1000
+        result = tree_sitter_red.parse(parser, source, scanner_budget=100)
+        root = result.tree.root_node
+        string = root.named_children[0]
+        self.assertEqual(string.kind_id, tree_sitter_red.Symbol.MULTILINE_STRING)
+        self.assertLess(string.end_byte, 200)
+        self.assertTrue(root.has_error)
+
+        # The budget was for that parse only.
+        string = parser.parse(source).root_node.named_children[0]
+        self.assertEqual(string.end_byte, len(source))
+
+    def test_stream_parses_as_bytes(self):
+        parser = Parser(Language(tree_sitter_red.language()))
+        source = 'a: [b c/d "é" 1.5 #{00}]\n'.encode() * 2000
+        expected = parser.parse(source)
+        name = path.join(mkdtemp(), "stream.red")
+        with open(name, "wb") as file:
+            file.write(b"\xEF\xBB\xBF" + source)
+        with tree_sitter_red.Stream(name, 64) as stream:
+            self.assertEqual(stream.bom_length, 3)
+            tree = stream.parse(parser)
+            self.assertEqual(str(tree.root_node), str(expected.root_node))
+            self.assertEqual(tree.root_node.end_byte, len(source))
+            self.assertIsNone(stream.invalid_offset)
+
+        with open(name, "wb") as file:
+            file.write(b"\xFF\xFE" + 'a: "é"\n'.encode("utf-16-le"))
+        with tree_sitter_red.Stream(name) as stream:
+            self.assertEqual(stream.encoding, tree_sitter_red.StreamEncoding.UTF16LE)
+            self.assertFalse(stream.parse(parser).root_node.has_error)
+        remove(name)
+        with self.assertRaises(FileNotFoundError):
+            tree_sitter_red.Stream(name)
+
+    def test_cache_keeps_values_across_opens(self):
+        directory = mkdtemp()
+        hash = tree_sitter_red.cache_hash(b"Red [] print 1")
+        self.assertNotEqual(hash, tree_sitter_red.cache_hash(b"Red [] print 2"))
+        with tree_sitter_red.Cache(directory) as cache:
+            self.assertIsNone(cache.get(hash, tree_sitter_red.CacheKind.ERRORS))
+            self.assertTrue(cache.put(hash, tree_sitter_red.CacheKind.ERRORS, b"[]"))
+        with tree_sitter_red.Cache(directory) as cache:
+            self.assertEqual(cache.get(hash, tree_sitter_red.CacheKind.ERRORS), b"[]")
+            self.assertIsNone(cache.get(hash, tree_sitter_red.CacheKind.OUTLINE))
+            self.assertTrue(cache.compact())
+        rmtree(directory)
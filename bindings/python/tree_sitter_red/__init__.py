@@ -2,7 +2,11 @@
 
 from importlib.resources import files as _files
 
-from ._binding import language
+from ._binding import language, set_scanner_budget
+from .cache import Cache, CacheKind, cache_hash
+from .parsing import ParseResult, ParseStatus, parse
+from .stream import Stream, StreamEncoding
+from .symbols import Field, Symbol
 
 
 def _get_query(name, file):
@@ -28,7 +32,18 @@ def __getattr__(name):
 
 
 __all__ = [
+    "cache_hash",
     "language",
+    "parse",
+    "set_scanner_budget",
+    "Cache",
+    "CacheKind",
+    "Field",
+    "ParseResult",
+    "ParseStatus",
+    "Stream",
+    "StreamEncoding",
+    "Symbol",
     "HIGHLIGHTS_QUERY",
     "INJECTIONS_QUERY",
     "LOCALS_QUERY",
@@ -1,6 +1,14 @@
+from enum import IntEnum
+from os import PathLike
+from threading import Event
 from typing import Final
 from typing_extensions import CapsuleType
 
+from tree_sitter import Parser, Tree
+
+from .parsing import ParseResult as ParseResult, ParseStatus as ParseStatus
+from .symbols import Field as Field, Symbol as Symbol
+
 HIGHLIGHTS_QUERY: Final[str] | None
 """The syntax highlighting query for this grammar."""
 
@@ -15,3 +23,91 @@ TAGS_QUERY: Final[str] | None
 
 def language() -> CapsuleType:
     """The tree-sitter language function for this grammar."""
+
+def set_scanner_budget(characters: int, /) -> int:
+    """Limit the characters the body of a multiline or raw string may span in
+    parses on the calling thread: past it, the string is cut short and the
+    tree has an error there. 0, the default, is no limit. Parsers on other
+    threads keep their own budget. Returns the previous budget."""
+
+def parse(
+    parser: Parser,
+    source: bytes,
+    old_tree: Tree | None = None,
+    *,
+    timeout: float | None = None,
+    cancel: Event | None = None,
+    scanner_budget: int | None = None,
+) -> ParseResult:
+    """Parse with a timeout in seconds, a cancellation flag and a scanner
+    budget for this parse only."""
+
+class StreamEncoding(IntEnum):
+    """The encoding of a stream, from its byte order mark."""
+
+    UTF8 = 0
+    UTF16LE = 1
+    UTF16BE = 2
+
+class Stream:
+    """A file that a parser reads a window at a time, from a memory map.
+    Pages more than a window behind the parser are dropped."""
+
+    def __init__(self, path: str | bytes | PathLike[str], window: int = 0) -> None:
+        """Map the file at ``path``, to be read ``window`` bytes at a time,
+        or 64 KiB if 0."""
+    def close(self) -> None:
+        """Unmap the file."""
+    def __enter__(self) -> Stream: ...
+    def __exit__(self, *exc_info: object) -> None: ...
+    @property
+    def encoding(self) -> StreamEncoding: ...
+    @property
+    def bom_length(self) -> int:
+        """The length of the byte order mark: 0, 2 or 3."""
+    @property
+    def invalid_offset(self) -> int | None:
+        """The offset in the text of the first byte not valid in the
+        encoding, among those read so far."""
+    @property
+    def failed(self) -> bool:
+        """Whether reading the file failed, so that it seemed to end early."""
+    def read(self, byte: int) -> bytes:
+        """The text from ``byte``, up to a window of it."""
+    def parse(self, parser: Parser, old_tree: Tree | None = None) -> Tree | None:
+        """Parse the file with ``parser``, reusing ``old_tree``, in its
+        encoding."""
+
+class CacheKind(IntEnum):
+    """The kinds of value a cache holds. Kinds from ``USER`` on are free for
+    applications."""
+
+    ERRORS = 1
+    OUTLINE = 2
+    SYMBOLS = 3
+    TREE = 4
+    DEPENDENCIES = 5
+    USER = 0x100
+
+def cache_hash(source: bytes, /) -> int:
+    """The hash a cache keys ``source`` by."""
+
+class Cache:
+    """A persistent store of results derived from Red sources, keyed by the
+    hash of a source and a kind. The least recently used entries are dropped
+    once it outgrows its size limit."""
+
+    def __init__(self, directory: str | bytes | PathLike[str], size_limit: int = 0) -> None:
+        """Open or create the cache in ``directory``, keeping it under
+        ``size_limit`` bytes, or 64 MiB if 0."""
+    def close(self) -> None:
+        """Release the cache; the store stays on disk."""
+    def __enter__(self) -> Cache: ...
+    def __exit__(self, *exc_info: object) -> None: ...
+    def get(self, hash: int, kind: int) -> bytes | None:
+        """The value of ``kind`` for the source whose hash is ``hash``."""
+    def put(self, hash: int, kind: int, value: bytes) -> bool:
+        """Store ``value`` as the value of ``kind`` for the source whose hash
+        is ``hash``."""
+    def compact(self) -> bool:
+        """Rewrite the store now, keeping the most recently used entries."""
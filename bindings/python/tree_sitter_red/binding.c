@@ -1,4 +1,5 @@
 #include <Python.h>
+#include <stdint.h>
 
 typedef struct TSLanguage TSLanguage;
 
@@ -8,6 +9,193 @@ static PyObject* _binding_language(PyObject *Py_UNUSED(self), PyObject *Py_UNUSE
     return PyCapsule_New(tree_sitter_red(), "tree_sitter.Language", NULL);
 }
 
+uint32_t tree_sitter_red_external_scanner_set_budget(uint32_t characters);
+
+static PyObject* _binding_set_scanner_budget(PyObject *Py_UNUSED(self), PyObject *arg) {
+    unsigned long characters = PyLong_AsUnsignedLong(arg);
+    if (characters == (unsigned long)-1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    if (characters > UINT32_MAX) {
+        PyErr_SetString(PyExc_OverflowError, "budget is over 4294967295 characters");
+        return NULL;
+    }
+    return PyLong_FromUnsignedLong(
+        tree_sitter_red_external_scanner_set_budget((uint32_t)characters));
+}
+
+#include "tree_sitter/tree-sitter-red-stream.h"
+
+static void stream_delete(PyObject *capsule) {
+    tree_sitter_red_stream_delete(PyCapsule_GetPointer(capsule, "tree_sitter_red.Stream"));
+}
+
+static TSRedStream *stream_get(PyObject *capsule) {
+    return PyCapsule_GetPointer(capsule, "tree_sitter_red.Stream");
+}
+
+static PyObject* _binding_open_stream(PyObject *Py_UNUSED(self), PyObject *args) {
+    PyObject *path;
+    unsigned long window;
+    if (!PyArg_ParseTuple(args, "O&k", PyUnicode_FSConverter, &path, &window)) {
+        return NULL;
+    }
+    if (window > UINT32_MAX) {
+        Py_DECREF(path);
+        PyErr_SetString(PyExc_OverflowError, "window is over 4294967295 bytes");
+        return NULL;
+    }
+    const char *name = PyBytes_AsString(path);
+    TSRedStream *stream;
+    Py_BEGIN_ALLOW_THREADS
+    stream = tree_sitter_red_stream_open(name, (uint32_t)window);
+    Py_END_ALLOW_THREADS
+    if (!stream) {
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, name);
+        Py_DECREF(path);
+        return NULL;
+    }
+    Py_DECREF(path);
+    PyObject *capsule = PyCapsule_New(stream, "tree_sitter_red.Stream", stream_delete);
+    if (!capsule) {
+        tree_sitter_red_stream_delete(stream);
+    }
+    return capsule;
+}
+
+static PyObject* _binding_stream_read(PyObject *Py_UNUSED(self), PyObject *args) {
+    PyObject *capsule;
+    unsigned long long byte;
+    if (!PyArg_ParseTuple(args, "OK", &capsule, &byte)) {
+        return NULL;
+    }
+    TSRedStream *stream = stream_get(capsule);
+    if (!stream) {
+        return NULL;
+    }
+    uint32_t size;
+    const char *text = tree_sitter_red_stream_read(
+        stream, byte > UINT32_MAX ? UINT32_MAX : (uint32_t)byte, &size);
+    return PyBytes_FromStringAndSize(text, size);
+}
+
+static PyObject* _binding_stream_info(PyObject *Py_UNUSED(self), PyObject *capsule) {
+    TSRedStream *stream = stream_get(capsule);
+    if (!stream) {
+        return NULL;
+    }
+    uint32_t invalid = tree_sitter_red_stream_invalid_offset(stream);
+    PyObject *offset = invalid == UINT32_MAX ? Py_NewRef(Py_None) : PyLong_FromUnsignedLong(invalid);
+    if (!offset) {
+        return NULL;
+    }
+    return Py_BuildValue("(iINO)", (int)tree_sitter_red_stream_encoding(stream),
+                         (unsigned int)tree_sitter_red_stream_bom_length(stream), offset,
+                         tree_sitter_red_stream_failed(stream) ? Py_True : Py_False);
+}
+
+#include "tree_sitter/tree-sitter-red-cache.h"
+
+#include <stdlib.h>
+
+static void cache_close(PyObject *capsule) {
+    tree_sitter_red_cache_close(PyCapsule_GetPointer(capsule, "tree_sitter_red.Cache"));
+}
+
+static TSRedCache *cache_get(PyObject *capsule) {
+    return PyCapsule_GetPointer(capsule, "tree_sitter_red.Cache");
+}
+
+static PyObject* _binding_cache_hash(PyObject *Py_UNUSED(self), PyObject *arg) {
+    char *source;
+    Py_ssize_t length;
+    if (PyBytes_AsStringAndSize(arg, &source, &length) < 0) {
+        return NULL;
+    }
+    return PyLong_FromUnsignedLongLong(tree_sitter_red_hash(source, (size_t)length, 0));
+}
+
+static PyObject* _binding_open_cache(PyObject *Py_UNUSED(self), PyObject *args) {
+    PyObject *path;
+    unsigned long long size_limit;
+    if (!PyArg_ParseTuple(args, "O&K", PyUnicode_FSConverter, &path, &size_limit)) {
+        return NULL;
+    }
+    const char *name = PyBytes_AsString(path);
+    TSRedCache *cache;
+    Py_BEGIN_ALLOW_THREADS
+    cache = tree_sitter_red_cache_open(name, size_limit);
+    Py_END_ALLOW_THREADS
+    if (!cache) {
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, name);
+        Py_DECREF(path);
+        return NULL;
+    }
+    Py_DECREF(path);
+    PyObject *capsule = PyCapsule_New(cache, "tree_sitter_red.Cache", cache_close);
+    if (!capsule) {
+        tree_sitter_red_cache_close(cache);
+    }
+    return capsule;
+}
+
+static PyObject* _binding_cache_get(PyObject *Py_UNUSED(self), PyObject *args) {
+    PyObject *capsule;
+    unsigned long long hash;
+    unsigned int kind;
+    if (!PyArg_ParseTuple(args, "OKI", &capsule, &hash, &kind)) {
+        return NULL;
+    }
+    TSRedCache *cache = cache_get(capsule);
+    if (!cache) {
+        return NULL;
+    }
+    uint8_t *value;
+    size_t length;
+    bool found;
+    Py_BEGIN_ALLOW_THREADS
+    found = tree_sitter_red_cache_get(cache, hash, kind, &value, &length);
+    Py_END_ALLOW_THREADS
+    if (!found) {
+        Py_RETURN_NONE;
+    }
+    PyObject *bytes = PyBytes_FromStringAndSize((const char *)value, (Py_ssize_t)length);
+    free(value);
+    return bytes;
+}
+
+static PyObject* _binding_cache_put(PyObject *Py_UNUSED(self), PyObject *args) {
+    PyObject *capsule;
+    unsigned long long hash;
+    unsigned int kind;
+    const char *value;
+    Py_ssize_t length;
+    if (!PyArg_ParseTuple(args, "OKIy#", &capsule, &hash, &kind, &value, &length)) {
+        return NULL;
+    }
+    TSRedCache *cache = cache_get(capsule);
+    if (!cache) {
+        return NULL;
+    }
+    bool stored;
+    Py_BEGIN_ALLOW_THREADS
+    stored = tree_sitter_red_cache_put(cache, hash, kind, value, (size_t)length);
+    Py_END_ALLOW_THREADS
+    return PyBool_FromLong(stored);
+}
+
+static PyObject* _binding_cache_compact(PyObject *Py_UNUSED(self), PyObject *capsule) {
+    TSRedCache *cache = cache_get(capsule);
+    if (!cache) {
+        return NULL;
+    }
+    bool compacted;
+    Py_BEGIN_ALLOW_THREADS
+    compacted = tree_sitter_red_cache_compact(cache);
+    Py_END_ALLOW_THREADS
+    return PyBool_FromLong(compacted);
+}
+
 static struct PyModuleDef_Slot slots[] = {
 #ifdef Py_GIL_DISABLED
     {Py_mod_gil, Py_MOD_GIL_NOT_USED},
@@ -18,6 +206,24 @@ static struct PyModuleDef_Slot slots[] = {
 static PyMethodDef methods[] = {
     {"language", _binding_language, METH_NOARGS,
      "Get the tree-sitter language for this grammar."},
+    {"set_scanner_budget", _binding_set_scanner_budget, METH_O,
+     "Limit the characters a multiline or raw string may span on this thread."},
+    {"open_stream", _binding_open_stream, METH_VARARGS,
+     "Map a file to be read a window at a time."},
+    {"stream_read", _binding_stream_read, METH_VARARGS,
+     "Read a window of a stream from a byte offset."},
+    {"stream_info", _binding_stream_info, METH_O,
+     "Get the encoding, mark length, invalid offset and failure of a stream."},
+    {"cache_hash", _binding_cache_hash, METH_O,
+     "Hash a source as a cache keys it."},
+    {"open_cache", _binding_open_cache, METH_VARARGS,
+     "Open or create a cache in a directory."},
+    {"cache_get", _binding_cache_get, METH_VARARGS,
+     "Get a value of a kind for a source hash, or None."},
+    {"cache_put", _binding_cache_put, METH_VARARGS,
+     "Store a value of a kind for a source hash."},
+    {"cache_compact", _binding_cache_compact, METH_O,
+     "Rewrite a cache, keeping the most recently used entries."},
     {NULL, NULL, 0, NULL}
 };
 
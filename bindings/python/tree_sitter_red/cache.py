@@ -0,0 +1,63 @@
+"""A persistent cache of results derived from Red sources."""
+
+from enum import IntEnum
+
+from . import _binding
+
+
+class CacheKind(IntEnum):
+    """The kinds of value a cache holds. Kinds from ``USER`` on are free for
+    applications."""
+
+    ERRORS = 1
+    OUTLINE = 2
+    SYMBOLS = 3
+    TREE = 4
+    DEPENDENCIES = 5
+    USER = 0x100
+
+
+def cache_hash(source):
+    """The hash a cache keys ``source`` by."""
+    return _binding.cache_hash(source)
+
+
+class Cache:
+    """A persistent store of results derived from Red sources, shared by any
+    number of processes.
+
+    Entries are keyed by the :func:`cache_hash` of a source and a kind, and
+    entries written by another version of the grammar are never returned.
+    Once the store outgrows its size limit, the least recently used entries
+    are dropped. Not available on Windows, where opening one fails.
+    """
+
+    def __init__(self, directory, size_limit=0):
+        """Open or create the cache in ``directory``, keeping it under
+        ``size_limit`` bytes, or 64 MiB if 0."""
+        self._cache = _binding.open_cache(directory, size_limit)
+
+    def close(self):
+        """Release the cache; the store stays on disk."""
+        self._cache = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc_info):
+        self.close()
+
+    def get(self, hash, kind):
+        """The value of ``kind`` for the source whose hash is ``hash``, or
+        ``None``."""
+        return _binding.cache_get(self._cache, hash, kind)
+
+    def put(self, hash, kind, value):
+        """Store ``value`` as the value of ``kind`` for the source whose hash
+        is ``hash``. Values over half the size limit are not stored."""
+        return _binding.cache_put(self._cache, hash, kind, value)
+
+    def compact(self):
+        """Rewrite the store now, keeping the most recently used entries that
+        fit in half of the size limit."""
+        return _binding.cache_compact(self._cache)
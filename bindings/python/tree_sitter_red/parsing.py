@@ -0,0 +1,61 @@
+"""Parsing with a timeout and a cancellation flag."""
+
+from enum import IntEnum
+from time import monotonic
+from typing import NamedTuple
+
+from ._binding import set_scanner_budget
+
+
+class ParseStatus(IntEnum):
+    """Why a parse returned."""
+
+    DONE = 0
+    TIMED_OUT = 1
+    CANCELLED = 2
+
+
+class ParseResult(NamedTuple):
+    """The tree, or how far the parse got before it stopped."""
+
+    tree: object
+    status: ParseStatus
+    offset: int
+    has_error: bool
+
+
+def parse(parser, source, old_tree=None, *, timeout=None, cancel=None,
+          scanner_budget=None):
+    """Parse ``source`` with ``parser``, stopping after ``timeout`` seconds or
+    once ``cancel``, a ``threading.Event``, is set. A ``scanner_budget``
+    applies to this parse only, as ``set_scanner_budget`` would set it.
+
+    The parser checks both limits every few hundred operations. A parse that
+    stopped has no tree; the parser keeps its work, so parsing the same
+    source again resumes it, and ``parser.reset()`` discards it.
+    """
+    deadline = None if timeout is None else monotonic() + timeout
+    progress = [ParseStatus.DONE, 0, False]
+
+    def progress_callback(offset, has_error):
+        progress[1:] = offset, has_error
+        if cancel is not None and cancel.is_set():
+            progress[0] = ParseStatus.CANCELLED
+        elif deadline is not None and monotonic() >= deadline:
+            progress[0] = ParseStatus.TIMED_OUT
+        return progress[0] != ParseStatus.DONE
+
+    # The scanner reads its budget on this thread, which the parse runs on.
+    previous = None
+    if scanner_budget is not None:
+        previous = set_scanner_budget(scanner_budget)
+    try:
+        tree = parser.parse(source, old_tree,
+                            progress_callback=progress_callback)
+    finally:
+        if previous is not None:
+            set_scanner_budget(previous)
+    if tree is not None:
+        return ParseResult(tree, ParseStatus.DONE, len(source),
+                           tree.root_node.has_error)
+    return ParseResult(None, *progress)
@@ -0,0 +1,75 @@
+"""Parsing a file a window at a time, from a memory map."""
+
+from enum import IntEnum
+
+from . import _binding
+
+
+class StreamEncoding(IntEnum):
+    """The encoding of a stream, from its byte order mark."""
+
+    UTF8 = 0
+    UTF16LE = 1
+    UTF16BE = 2
+
+
+class Stream:
+    """A file that a parser reads a window at a time, from a memory map.
+
+    The map is advised as read sequentially, and pages more than a window
+    behind the parser are dropped, so a parse keeps about one window of the
+    file resident besides its tree. The byte order mark is not part of the
+    text: offsets in the tree count from just after it.
+    """
+
+    def __init__(self, path, window=0):
+        """Map the file at ``path``, to be read ``window`` bytes at a time,
+        or 64 KiB if 0."""
+        self._stream = _binding.open_stream(path, window)
+
+    def close(self):
+        """Unmap the file."""
+        self._stream = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc_info):
+        self.close()
+
+    @property
+    def encoding(self):
+        return StreamEncoding(_binding.stream_info(self._stream)[0])
+
+    @property
+    def bom_length(self):
+        """The length of the byte order mark: 0, 2 or 3."""
+        return _binding.stream_info(self._stream)[1]
+
+    @property
+    def invalid_offset(self):
+        """The offset in the text of the first byte not valid in the
+        encoding, among those read so far, or ``None``. After a parse, this
+        covers the whole file."""
+        return _binding.stream_info(self._stream)[2]
+
+    @property
+    def failed(self):
+        """Whether reading the file failed, so that it seemed to end early."""
+        return _binding.stream_info(self._stream)[3]
+
+    def read(self, byte):
+        """The text from ``byte``, up to a window of it, and empty at the
+        end."""
+        return _binding.stream_read(self._stream, byte)
+
+    def parse(self, parser, old_tree=None):
+        """Parse the file with ``parser``, reusing ``old_tree``, in its
+        encoding."""
+        encoding = ("utf8", "utf16le", "utf16be")[self.encoding]
+        stream = self._stream
+
+        def read(byte, point):
+            return _binding.stream_read(stream, byte)
+
+        return parser.parse(read, old_tree, encoding=encoding)
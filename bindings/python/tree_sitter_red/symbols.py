@@ -0,0 +1,67 @@
+# Automatically @generated by scripts/generate-bindings.js
+
+"""Ids of the named node kinds and fields of the Red grammar."""
+
+from enum import IntEnum
+
+
+class Symbol(IntEnum):
+    """Node kind ids, as returned by ``Node.kind_id``."""
+
+    COMMENT = 2
+    NUMBER = 10
+    PAIR = 11
+    MONEY = 15
+    TUPLE = 16
+    ZONE_INDEX = 17
+    CIDR = 18
+    REF = 26
+    ISSUE = 27
+    EMAIL = 30
+    STRING_CONTENT = 34
+    ESCAPED_CHAR = 38
+    TAG = 60
+    INFIX_OP = 87
+    HEXA = 88
+    RAW_STRING = 89
+    IPV6_ADDRESS = 91
+    SOURCE_FILE = 93
+    BOOLEAN = 94
+    POINT = 95
+    IPV6 = 96
+    TIME = 97
+    DATE = 98
+    CHAR = 99
+    REFINEMENT = 100
+    FILE = 101
+    STRING = 103
+    MULTILINE_STRING = 104
+    CONSTRUCTION = 105
+    WORD = 106
+    LIT_WORD = 107
+    GET_WORD = 108
+    SET_WORD = 109
+    URL = 110
+    PATH_START = 112
+    PATH = 113
+    LIT_PATH = 114
+    GET_PATH = 115
+    SET_PATH = 116
+    BINARY = 117
+    MAP = 118
+    BLOCK = 119
+    PAREN = 120
+    FUNCTION = 121
+    DOES = 122
+    CONTEXT = 123
+    MAKE = 124
+    INVALID_TOKEN = 125
+
+
+class Field(IntEnum):
+    """Field ids, for ``Node.child_by_field_id``."""
+
+    BODY = 1
+    KEY = 2
+    NAME = 3
+    SPEC = 4
@@ -35,6 +35,24 @@ fn main() {
         println!("cargo:rerun-if-changed={}", scanner_path.to_str().unwrap());
     }
 
+    // The stream of the `stream` feature maps files, which wasm cannot.
+    if std::env::var_os("CARGO_FEATURE_STREAM").is_some()
+        && std::env::var("TARGET").unwrap() != "wasm32-unknown-unknown"
+    {
+        let stream_path = std::path::Path::new("bindings/c/src/stream.c");
+        c_config.include("bindings/c").file(stream_path);
+        println!("cargo:rerun-if-changed={}", stream_path.to_str().unwrap());
+    }
+
+    // The cache of the `cache` feature writes files, which wasm cannot.
+    if std::env::var_os("CARGO_FEATURE_CACHE").is_some()
+        && std::env::var("TARGET").unwrap() != "wasm32-unknown-unknown"
+    {
+        let cache_path = std::path::Path::new("bindings/c/src/cache.c");
+        c_config.include("bindings/c").file(cache_path);
+        println!("cargo:rerun-if-changed={}", cache_path.to_str().unwrap());
+    }
+
     c_config.compile("tree-sitter-red");
 
     println!("cargo:rustc-check-cfg=cfg(with_highlights_query)");
@@ -0,0 +1,149 @@
+use std::ffi::{c_char, c_void, CString};
+use std::io;
+use std::path::Path;
+use std::ptr::NonNull;
+
+#[repr(C)]
+struct TSRedCache {
+    _private: [u8; 0],
+}
+
+extern "C" {
+    fn tree_sitter_red_hash(data: *const c_void, length: usize, seed: u64) -> u64;
+    fn tree_sitter_red_cache_open(directory: *const c_char, size_limit: u64) -> *mut TSRedCache;
+    fn tree_sitter_red_cache_close(cache: *mut TSRedCache);
+    fn tree_sitter_red_cache_get(
+        cache: *mut TSRedCache,
+        hash: u64,
+        kind: u32,
+        value: *mut *mut u8,
+        length: *mut usize,
+    ) -> bool;
+    fn tree_sitter_red_cache_put(
+        cache: *mut TSRedCache,
+        hash: u64,
+        kind: u32,
+        value: *const c_void,
+        length: usize,
+    ) -> bool;
+    fn tree_sitter_red_cache_compact(cache: *mut TSRedCache) -> bool;
+    fn free(pointer: *mut c_void);
+}
+
+/// The kinds of value a [`Cache`] holds, as in `TSRedCacheKind`.
+pub mod cache_kind {
+    pub const ERRORS: u32 = 1;
+    pub const OUTLINE: u32 = 2;
+    pub const SYMBOLS: u32 = 3;
+    /// A tree in the encoding of `tree-sitter-red-serialize.h`.
+    pub const TREE: u32 = 4;
+    /// A list in the encoding of `tree-sitter-red-deps.h`.
+    pub const DEPENDENCIES: u32 = 5;
+    /// Kinds from here on are free for applications.
+    pub const USER: u32 = 0x100;
+}
+
+/// The hash a [`Cache`] keys a source by.
+pub fn cache_hash(source: &[u8]) -> u64 {
+    unsafe { tree_sitter_red_hash(source.as_ptr().cast(), source.len(), 0) }
+}
+
+/// A persistent cache of results derived from Red sources, shared by any
+/// number of processes.
+///
+/// Entries are keyed by the [`cache_hash`] of a source and a kind, and
+/// entries written by another version of the grammar are never returned.
+/// Once the store outgrows its size limit, the least recently used entries
+/// are dropped. Not available on Windows, where [`Cache::open`] fails.
+#[derive(Debug)]
+pub struct Cache {
+    raw: NonNull<TSRedCache>,
+}
+
+// The cache is only used through `&mut self`.
+unsafe impl Send for Cache {}
+
+impl Cache {
+    /// Open or create the cache in `directory`, keeping it under
+    /// `size_limit` bytes, or 64 MiB if 0.
+    pub fn open(directory: impl AsRef<Path>, size_limit: u64) -> io::Result<Self> {
+        let directory = directory
+            .as_ref()
+            .to_str()
+            .ok_or_else(|| io::Error::new(io::ErrorKind::InvalidInput, "path is not UTF-8"))?;
+        let directory = CString::new(directory)
+            .map_err(|_| io::Error::new(io::ErrorKind::InvalidInput, "path has a NUL byte"))?;
+        let raw = unsafe { tree_sitter_red_cache_open(directory.as_ptr(), size_limit) };
+        NonNull::new(raw)
+            .map(|raw| Self { raw })
+            .ok_or_else(io::Error::last_os_error)
+    }
+
+    /// The value of `kind` for the source whose [`cache_hash`] is `hash`.
+    pub fn get(&mut self, hash: u64, kind: u32) -> Option<Vec<u8>> {
+        let mut value = std::ptr::null_mut();
+        let mut length = 0;
+        unsafe {
+            if !tree_sitter_red_cache_get(self.raw.as_ptr(), hash, kind, &mut value, &mut length) {
+                return None;
+            }
+            let copy = std::slice::from_raw_parts(value, length).to_vec();
+            free(value.cast());
+            Some(copy)
+        }
+    }
+
+    /// Store `value` as the value of `kind` for the source whose
+    /// [`cache_hash`] is `hash`. Values over half the size limit are not
+    /// stored.
+    pub fn put(&mut self, hash: u64, kind: u32, value: &[u8]) -> bool {
+        unsafe {
+            tree_sitter_red_cache_put(
+                self.raw.as_ptr(),
+                hash,
+                kind,
+                value.as_ptr().cast(),
+                value.len(),
+            )
+        }
+    }
+
+    /// Rewrite the store now, keeping the most recently used entries that fit
+    /// in half of the size limit.
+    pub fn compact(&mut self) -> bool {
+        unsafe { tree_sitter_red_cache_compact(self.raw.as_ptr()) }
+    }
+}
+
+impl Drop for Cache {
+    fn drop(&mut self) {
+        unsafe { tree_sitter_red_cache_close(self.raw.as_ptr()) }
+    }
+}
+
+#[cfg(all(test, unix))]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_cache_keeps_values_across_opens() {
+        let directory = std::env::temp_dir().join(format!("{}-cache", std::process::id()));
+        let hash = cache_hash(b"Red [] print 1");
+        assert_ne!(hash, cache_hash(b"Red [] print 2"));
+
+        let mut cache = Cache::open(&directory, 0).unwrap();
+        assert_eq!(cache.get(hash, cache_kind::ERRORS), None);
+        assert!(cache.put(hash, cache_kind::ERRORS, b"[]"));
+        drop(cache);
+
+        let mut cache = Cache::open(&directory, 0).unwrap();
+        assert_eq!(
+            cache.get(hash, cache_kind::ERRORS).as_deref(),
+            Some(&b"[]"[..])
+        );
+        assert_eq!(cache.get(hash, cache_kind::OUTLINE), None);
+        assert!(cache.compact());
+        drop(cache);
+        std::fs::remove_dir_all(directory).unwrap();
+    }
+}
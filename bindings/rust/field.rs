@@ -0,0 +1,34 @@
+// Automatically @generated by scripts/generate-bindings.js
+
+//! Field ids of the Red grammar, for `Node::child_by_field_id`.
+
+/// The id of the `body` field.
+pub const BODY: u16 = 1;
+/// The id of the `key` field.
+pub const KEY: u16 = 2;
+/// The id of the `name` field.
+pub const NAME: u16 = 3;
+/// The id of the `spec` field.
+pub const SPEC: u16 = 4;
+
+#[cfg(test)]
+mod tests {
+    const FIELDS: &[(&str, u16)] = &[
+        ("body", super::BODY),
+        ("key", super::KEY),
+        ("name", super::NAME),
+        ("spec", super::SPEC),
+    ];
+
+    #[test]
+    fn test_field_ids_match_language() {
+        let language: tree_sitter::Language = crate::LANGUAGE.into();
+        for &(name, id) in FIELDS {
+            assert_eq!(
+                language.field_id_for_name(name).map(u16::from),
+                Some(id),
+                "{name}"
+            );
+        }
+    }
+}
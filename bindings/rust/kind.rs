@@ -0,0 +1,162 @@
+// Automatically @generated by scripts/generate-bindings.js
+
+//! Node kind ids of the Red grammar, as returned by `Node::kind_id`.
+
+/// The id of `comment` nodes.
+pub const COMMENT: u16 = 2;
+/// The id of `number` nodes.
+pub const NUMBER: u16 = 10;
+/// The id of `pair` nodes.
+pub const PAIR: u16 = 11;
+/// The id of `money` nodes.
+pub const MONEY: u16 = 15;
+/// The id of `tuple` nodes.
+pub const TUPLE: u16 = 16;
+/// The id of `zone_index` nodes.
+pub const ZONE_INDEX: u16 = 17;
+/// The id of `cidr` nodes.
+pub const CIDR: u16 = 18;
+/// The id of `ref` nodes.
+pub const REF: u16 = 26;
+/// The id of `issue` nodes.
+pub const ISSUE: u16 = 27;
+/// The id of `email` nodes.
+pub const EMAIL: u16 = 30;
+/// The id of `string_content` nodes.
+pub const STRING_CONTENT: u16 = 34;
+/// The id of `escaped_char` nodes.
+pub const ESCAPED_CHAR: u16 = 38;
+/// The id of `tag` nodes.
+pub const TAG: u16 = 60;
+/// The id of `infix_op` nodes.
+pub const INFIX_OP: u16 = 87;
+/// The id of `hexa` nodes.
+pub const HEXA: u16 = 88;
+/// The id of `raw_string` nodes.
+pub const RAW_STRING: u16 = 89;
+/// The id of `ipv6_address` nodes.
+pub const IPV6_ADDRESS: u16 = 91;
+/// The id of `source_file` nodes.
+pub const SOURCE_FILE: u16 = 93;
+/// The id of `boolean` nodes.
+pub const BOOLEAN: u16 = 94;
+/// The id of `point` nodes.
+pub const POINT: u16 = 95;
+/// The id of `ipv6` nodes.
+pub const IPV6: u16 = 96;
+/// The id of `time` nodes.
+pub const TIME: u16 = 97;
+/// The id of `date` nodes.
+pub const DATE: u16 = 98;
+/// The id of `char` nodes.
+pub const CHAR: u16 = 99;
+/// The id of `refinement` nodes.
+pub const REFINEMENT: u16 = 100;
+/// The id of `file` nodes.
+pub const FILE: u16 = 101;
+/// The id of `string` nodes.
+pub const STRING: u16 = 103;
+/// The id of `multiline_string` nodes.
+pub const MULTILINE_STRING: u16 = 104;
+/// The id of `construction` nodes.
+pub const CONSTRUCTION: u16 = 105;
+/// The id of `word` nodes.
+pub const WORD: u16 = 106;
+/// The id of `lit_word` nodes.
+pub const LIT_WORD: u16 = 107;
+/// The id of `get_word` nodes.
+pub const GET_WORD: u16 = 108;
+/// The id of `set_word` nodes.
+pub const SET_WORD: u16 = 109;
+/// The id of `url` nodes.
+pub const URL: u16 = 110;
+/// The id of `path_start` nodes.
+pub const PATH_START: u16 = 112;
+/// The id of `path` nodes.
+pub const PATH: u16 = 113;
+/// The id of `lit_path` nodes.
+pub const LIT_PATH: u16 = 114;
+/// The id of `get_path` nodes.
+pub const GET_PATH: u16 = 115;
+/// The id of `set_path` nodes.
+pub const SET_PATH: u16 = 116;
+/// The id of `binary` nodes.
+pub const BINARY: u16 = 117;
+/// The id of `map` nodes.
+pub const MAP: u16 = 118;
+/// The id of `block` nodes.
+pub const BLOCK: u16 = 119;
+/// The id of `paren` nodes.
+pub const PAREN: u16 = 120;
+/// The id of `function` nodes.
+pub const FUNCTION: u16 = 121;
+/// The id of `does` nodes.
+pub const DOES: u16 = 122;
+/// The id of `context` nodes.
+pub const CONTEXT: u16 = 123;
+/// The id of `make` nodes.
+pub const MAKE: u16 = 124;
+/// The id of `invalid_token` nodes.
+pub const INVALID_TOKEN: u16 = 125;
+
+#[cfg(test)]
+mod tests {
+    const KINDS: &[(&str, u16)] = &[
+        ("comment", super::COMMENT),
+        ("number", super::NUMBER),
+        ("pair", super::PAIR),
+        ("money", super::MONEY),
+        ("tuple", super::TUPLE),
+        ("zone_index", super::ZONE_INDEX),
+        ("cidr", super::CIDR),
+        ("ref", super::REF),
+        ("issue", super::ISSUE),
+        ("email", super::EMAIL),
+        ("string_content", super::STRING_CONTENT),
+        ("escaped_char", super::ESCAPED_CHAR),
+        ("tag", super::TAG),
+        ("infix_op", super::INFIX_OP),
+        ("hexa", super::HEXA),
+        ("raw_string", super::RAW_STRING),
+        ("ipv6_address", super::IPV6_ADDRESS),
+        ("source_file", super::SOURCE_FILE),
+        ("boolean", super::BOOLEAN),
+        ("point", super::POINT),
+        ("ipv6", super::IPV6),
+        ("time", super::TIME),
+        ("date", super::DATE),
+        ("char", super::CHAR),
+        ("refinement", super::REFINEMENT),
+        ("file", super::FILE),
+        ("string", super::STRING),
+        ("multiline_string", super::MULTILINE_STRING),
+        ("construction", super::CONSTRUCTION),
+        ("word", super::WORD),
+        ("lit_word", super::LIT_WORD),
+        ("get_word", super::GET_WORD),
+        ("set_word", super::SET_WORD),
+        ("url", super::URL),
+        ("path_start", super::PATH_START),
+        ("path", super::PATH),
+        ("lit_path", super::LIT_PATH),
+        ("get_path", super::GET_PATH),
+        ("set_path", super::SET_PATH),
+        ("binary", super::BINARY),
+        ("map", super::MAP),
+        ("block", super::BLOCK),
+        ("paren", super::PAREN),
+        ("function", super::FUNCTION),
+        ("does", super::DOES),
+        ("context", super::CONTEXT),
+        ("make", super::MAKE),
+        ("invalid_token", super::INVALID_TOKEN),
+    ];
+
+    #[test]
+    fn test_kind_ids_match_language() {
+        let language: tree_sitter::Language = crate::LANGUAGE.into();
+        for &(name, id) in KINDS {
+            assert_eq!(language.id_for_node_kind(name, true), id, "{name}");
+        }
+    }
+}
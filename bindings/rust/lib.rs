@@ -15,13 +15,73 @@
 //! assert!(!tree.root_node().has_error());
 //! ```
 //!
+//! The [`kind`] and [`field`] modules list the id of every named node kind and
+//! field, so nodes can be told apart by [`kind_id`] instead of comparing kind
+//! strings. With the
+//! `visitor` feature, [`visitor::walk`] dispatches on those ids to a typed
+//! [`visitor::Visitor`], and the `parallel` feature adds [`par_parse_paths`]
+//! to parse many files on all cores.
+//!
+//! For input that cannot be trusted, the `parse` feature adds
+//! [`parse_with_limits`], which stops a parse after a timeout or once a
+//! cancellation flag is set, and bounds the length of a single string token
+//! by a scanner budget, which [`set_scanner_budget`] sets for a thread.
+//!
+//! For large files, the `stream` feature adds [`Stream`], which parses a
+//! memory-mapped file a window at a time, in UTF-8 or UTF-16 by its byte
+//! order mark, without reading it all into memory.
+//!
+//! For tools that check the same sources again and again, the `cache`
+//! feature adds [`Cache`], a persistent store of results derived from them,
+//! keyed by a hash of their contents and the version of the grammar.
+//!
 //! [`Parser`]: https://docs.rs/tree-sitter/0.26.6/tree_sitter/struct.Parser.html
+//! [`kind_id`]: https://docs.rs/tree-sitter/0.26.6/tree_sitter/struct.Node.html#method.kind_id
 //! [tree-sitter]: https://tree-sitter.github.io/
 
 use tree_sitter_language::LanguageFn;
 
+pub mod field;
+pub mod kind;
+
+#[cfg(feature = "visitor")]
+pub mod visitor;
+
+#[cfg(feature = "parallel")]
+mod parallel;
+
+#[cfg(feature = "parallel")]
+pub use parallel::{par_parse_paths, ParsedFile};
+
+#[cfg(feature = "parse")]
+mod parse;
+
+#[cfg(feature = "parse")]
+pub use parse::{parse_with_limits, ParseLimits, ParseResult, ParseStatus};
+
+#[cfg(feature = "stream")]
+mod stream;
+
+#[cfg(feature = "stream")]
+pub use stream::{Encoding, Stream};
+
+#[cfg(feature = "cache")]
+mod cache;
+
+#[cfg(feature = "cache")]
+pub use cache::{cache_hash, cache_kind, Cache};
+
 extern "C" {
     fn tree_sitter_red() -> *const ();
+    fn tree_sitter_red_external_scanner_set_budget(characters: u32) -> u32;
+}
+
+/// Limit the characters the body of a multiline or raw string may span in
+/// parses on the calling thread: past it, the string is cut short and the
+/// tree has an error there. 0, the default, is no limit. Parsers on other
+/// threads keep their own budget. Returns the previous budget.
+pub fn set_scanner_budget(characters: u32) -> u32 {
+    unsafe { tree_sitter_red_external_scanner_set_budget(characters) }
 }
 
 /// The tree-sitter [`LanguageFn`] for this grammar.
@@ -0,0 +1,50 @@
+use std::cell::RefCell;
+use std::io;
+use std::path::PathBuf;
+
+use rayon::iter::{IntoParallelIterator, ParallelIterator};
+use tree_sitter::{Parser, Tree};
+
+/// A Red source file parsed by [`par_parse_paths`].
+pub struct ParsedFile {
+    /// The path the file was read from.
+    pub path: PathBuf,
+    /// The file contents the tree refers to.
+    pub source: Vec<u8>,
+    /// The syntax tree of `source`.
+    pub tree: Tree,
+}
+
+thread_local! {
+    static PARSER: RefCell<Option<Parser>> = const { RefCell::new(None) };
+}
+
+fn parse_path(path: PathBuf) -> io::Result<ParsedFile> {
+    let source = std::fs::read(&path)?;
+    let tree = PARSER.with(|cell| {
+        let mut cell = cell.borrow_mut();
+        let parser = cell.get_or_insert_with(|| {
+            let mut parser = Parser::new();
+            parser
+                .set_language(&crate::LANGUAGE.into())
+                .expect("Error loading Red parser");
+            parser
+        });
+        parser.parse(&source, None)
+    });
+    let tree = tree.ok_or_else(|| io::Error::other("parsing was cancelled"))?;
+    Ok(ParsedFile { path, source, tree })
+}
+
+/// Read and parse every path on the rayon thread pool.
+///
+/// Each worker thread keeps one parser for its whole lifetime, so the cost of
+/// creating parsers does not grow with the number of files. Results come back
+/// in no particular order; a file that cannot be read yields its I/O error.
+pub fn par_parse_paths<I>(paths: I) -> impl ParallelIterator<Item = io::Result<ParsedFile>>
+where
+    I: IntoParallelIterator,
+    I::Item: Into<PathBuf>,
+{
+    paths.into_par_iter().map(|path| parse_path(path.into()))
+}
@@ -0,0 +1,166 @@
+use std::ops::ControlFlow;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::time::{Duration, Instant};
+
+use tree_sitter::{ParseOptions, ParseState, Parser, Tree};
+
+/// Why [`parse_with_limits`] returned.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum ParseStatus {
+    Done,
+    TimedOut,
+    Cancelled,
+}
+
+/// The limits of [`parse_with_limits`]. The default has none.
+#[derive(Clone, Copy, Debug, Default)]
+pub struct ParseLimits<'a> {
+    /// The time the parse may take.
+    pub timeout: Option<Duration>,
+    /// The parse stops once this is set, which may be from another thread.
+    pub cancellation_flag: Option<&'a AtomicBool>,
+    /// The scanner budget for this parse only, as [`crate::set_scanner_budget`]
+    /// sets it; `None` keeps the thread's.
+    pub scanner_budget: Option<u32>,
+}
+
+/// The tree of a parse, or how far it got before it stopped.
+#[derive(Debug)]
+pub struct ParseResult {
+    /// `None` if the parse stopped.
+    pub tree: Option<Tree>,
+    pub status: ParseStatus,
+    /// How far the parse got: the length of the source when done.
+    pub offset: usize,
+    pub has_error: bool,
+}
+
+/// Parse `source`, reusing `old_tree`, until the limits are reached.
+///
+/// The parser checks them every few hundred operations. A parse that stopped
+/// has no tree; the parser keeps its work, so parsing the same source again
+/// resumes it, and [`Parser::reset`] discards it.
+pub fn parse_with_limits(
+    parser: &mut Parser,
+    source: &[u8],
+    old_tree: Option<&Tree>,
+    limits: &ParseLimits,
+) -> ParseResult {
+    let deadline = limits.timeout.map(|timeout| Instant::now() + timeout);
+    let mut status = ParseStatus::Done;
+    let mut offset = 0;
+    let mut has_error = false;
+    let mut progress = |state: &ParseState| {
+        offset = state.current_byte_offset();
+        has_error = state.has_error();
+        if limits
+            .cancellation_flag
+            .is_some_and(|flag| flag.load(Ordering::Relaxed))
+        {
+            status = ParseStatus::Cancelled;
+        } else if deadline.is_some_and(|deadline| Instant::now() >= deadline) {
+            status = ParseStatus::TimedOut;
+        }
+        if status == ParseStatus::Done {
+            ControlFlow::Continue(())
+        } else {
+            ControlFlow::Break(())
+        }
+    };
+    let options = ParseOptions::new().progress_callback(&mut progress);
+    // The scanner reads its budget on this thread, which the parse runs on.
+    let previous = limits.scanner_budget.map(crate::set_scanner_budget);
+    let tree = parser.parse_with_options(
+        &mut |i, _| source.get(i..).unwrap_or_default(),
+        old_tree,
+        Some(options),
+    );
+    if let Some(previous) = previous {
+        crate::set_scanner_budget(previous);
+    }
+    match tree {
+        Some(tree) => {
+            let has_error = tree.root_node().has_error();
+            ParseResult {
+                tree: Some(tree),
+                status: ParseStatus::Done,
+                offset: source.len(),
+                has_error,
+            }
+        }
+        None => ParseResult {
+            tree: None,
+            status,
+            offset,
+            has_error,
+        },
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn parser() -> Parser {
+        let mut parser = Parser::new();
+        parser
+            .set_language(&crate::LANGUAGE.into())
+            .expect("Error loading Red parser");
+        parser
+    }
+
+    #[test]
+    fn test_cancelled_parse_returns_no_tree() {
+        let mut parser = parser();
+        let source = "a: [b c/d \"e\" 1.5 #{00}]\n".repeat(20000);
+        let flag = AtomicBool::new(true);
+        let limits = ParseLimits {
+            cancellation_flag: Some(&flag),
+            ..Default::default()
+        };
+        let result = parse_with_limits(&mut parser, source.as_bytes(), None, &limits);
+        assert_eq!(result.status, ParseStatus::Cancelled);
+        assert!(result.tree.is_none() && result.offset < source.len());
+
+        // The next parse resumes where the cancelled one stopped.
+        flag.store(false, Ordering::Relaxed);
+        let result = parse_with_limits(&mut parser, source.as_bytes(), None, &limits);
+        assert_eq!(result.status, ParseStatus::Done);
+        assert!(result.tree.is_some() && !result.has_error);
+    }
+
+    #[test]
+    fn test_parse_stops_when_out_of_time() {
+        let mut parser = parser();
+        let source = "a: [b c/d \"e\" 1.5 #{00}]\n".repeat(20000);
+        let limits = ParseLimits {
+            timeout: Some(Duration::ZERO),
+            ..Default::default()
+        };
+        let result = parse_with_limits(&mut parser, source.as_bytes(), None, &limits);
+        assert_eq!(result.status, ParseStatus::TimedOut);
+        assert!(result.tree.is_none());
+        parser.reset();
+    }
+
+    #[test]
+    fn test_scanner_budget_ends_unclosed_strings() {
+        let mut parser = parser();
+        let source = format!("{{{}", "x: 1\n".repeat(1000));
+        let limits = ParseLimits {
+            scanner_budget: Some(100),
+            ..Default::default()
+        };
+        let result = parse_with_limits(&mut parser, source.as_bytes(), None, &limits);
+        let tree = result.tree.unwrap();
+        let string = tree.root_node().named_child(0).unwrap();
+        assert_eq!(string.kind_id(), crate::kind::MULTILINE_STRING);
+        assert!(string.end_byte() < 200);
+        assert!(tree.root_node().has_error());
+
+        // The budget was for that parse only.
+        let tree = parser.parse(&source, None).unwrap();
+        let string = tree.root_node().named_child(0).unwrap();
+        assert_eq!(string.end_byte(), source.len());
+    }
+}
@@ -0,0 +1,218 @@
+use std::ffi::{c_char, c_int, CString};
+use std::io;
+use std::path::Path;
+use std::ptr::NonNull;
+
+use tree_sitter::{Parser, Tree};
+
+#[repr(C)]
+struct TSRedStream {
+    _private: [u8; 0],
+}
+
+extern "C" {
+    fn tree_sitter_red_stream_open(path: *const c_char, window: u32) -> *mut TSRedStream;
+    fn tree_sitter_red_stream_delete(stream: *mut TSRedStream);
+    fn tree_sitter_red_stream_read(
+        stream: *mut TSRedStream,
+        byte: u32,
+        size: *mut u32,
+    ) -> *const c_char;
+    fn tree_sitter_red_stream_encoding(stream: *const TSRedStream) -> c_int;
+    fn tree_sitter_red_stream_bom_length(stream: *const TSRedStream) -> u32;
+    fn tree_sitter_red_stream_invalid_offset(stream: *const TSRedStream) -> u32;
+    fn tree_sitter_red_stream_failed(stream: *const TSRedStream) -> bool;
+}
+
+/// The encoding of a [`Stream`], from its byte order mark.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum Encoding {
+    Utf8,
+    Utf16LE,
+    Utf16BE,
+}
+
+/// A file that a parser reads a window at a time, from a memory map.
+///
+/// The map is advised as read sequentially, and pages more than a window
+/// behind the parser are dropped, so a parse keeps about one window of the
+/// file resident besides its tree. The byte order mark is not part of the
+/// text: offsets in the tree count from just after it.
+#[derive(Debug)]
+pub struct Stream {
+    raw: NonNull<TSRedStream>,
+}
+
+// The stream is only read through `&mut self`.
+unsafe impl Send for Stream {}
+
+impl Stream {
+    /// Map the file at `path`, to be read `window` bytes at a time, or 64 KiB
+    /// if 0.
+    pub fn open(path: impl AsRef<Path>, window: u32) -> io::Result<Self> {
+        let path = path.as_ref();
+        #[cfg(unix)]
+        let bytes = std::os::unix::ffi::OsStrExt::as_bytes(path.as_os_str()).to_vec();
+        #[cfg(not(unix))]
+        let bytes = path
+            .to_str()
+            .ok_or_else(|| io::Error::new(io::ErrorKind::InvalidInput, "path is not UTF-8"))?
+            .as_bytes()
+            .to_vec();
+        let path = CString::new(bytes)
+            .map_err(|_| io::Error::new(io::ErrorKind::InvalidInput, "path has a NUL byte"))?;
+        let raw = unsafe { tree_sitter_red_stream_open(path.as_ptr(), window) };
+        NonNull::new(raw)
+            .map(|raw| Self { raw })
+            .ok_or_else(io::Error::last_os_error)
+    }
+
+    pub fn encoding(&self) -> Encoding {
+        match unsafe { tree_sitter_red_stream_encoding(self.raw.as_ptr()) } {
+            1 => Encoding::Utf16LE,
+            2 => Encoding::Utf16BE,
+            _ => Encoding::Utf8,
+        }
+    }
+
+    /// The length of the byte order mark: 0, 2 or 3.
+    pub fn bom_length(&self) -> u32 {
+        unsafe { tree_sitter_red_stream_bom_length(self.raw.as_ptr()) }
+    }
+
+    /// The offset in the text of the first byte not valid in the encoding,
+    /// among those read so far. After a parse, this covers the whole file.
+    pub fn invalid_offset(&self) -> Option<u32> {
+        match unsafe { tree_sitter_red_stream_invalid_offset(self.raw.as_ptr()) } {
+            u32::MAX => None,
+            offset => Some(offset),
+        }
+    }
+
+    /// Whether reading the file failed, so that it seemed to end early.
+    pub fn failed(&self) -> bool {
+        unsafe { tree_sitter_red_stream_failed(self.raw.as_ptr()) }
+    }
+
+    /// The text from `byte`, up to a window of it, and empty at the end.
+    pub fn read(&mut self, byte: u32) -> &[u8] {
+        unsafe { window(self.raw.as_ptr(), byte) }
+    }
+
+    /// Parse the file with `parser`, reusing `old_tree`, in its encoding.
+    pub fn parse(&mut self, parser: &mut Parser, old_tree: Option<&Tree>) -> Option<Tree> {
+        let raw = self.raw.as_ptr();
+        // The runtime is done with each window before it reads the next.
+        match self.encoding() {
+            Encoding::Utf8 => parser.parse_with_options(
+                &mut |byte, _| unsafe { window(raw, offset(byte)) },
+                old_tree,
+                None,
+            ),
+            Encoding::Utf16LE => parser.parse_utf16_le_with_options(
+                &mut |unit, _| unsafe { units(raw, offset(unit * 2)) },
+                old_tree,
+                None,
+            ),
+            Encoding::Utf16BE => parser.parse_utf16_be_with_options(
+                &mut |unit, _| unsafe { units(raw, offset(unit * 2)) },
+                old_tree,
+                None,
+            ),
+        }
+    }
+}
+
+impl Drop for Stream {
+    fn drop(&mut self) {
+        unsafe { tree_sitter_red_stream_delete(self.raw.as_ptr()) }
+    }
+}
+
+// Offsets past the text, which a stream does not have, read as its end.
+fn offset(byte: usize) -> u32 {
+    u32::try_from(byte).unwrap_or(u32::MAX)
+}
+
+// A window, valid until the next read of the stream.
+unsafe fn window<'a>(raw: *mut TSRedStream, byte: u32) -> &'a [u8] {
+    let mut size = 0;
+    let text = tree_sitter_red_stream_read(raw, byte, &mut size);
+    if size == 0 {
+        return &[];
+    }
+    std::slice::from_raw_parts(text.cast(), size as usize)
+}
+
+// A window of UTF-16, which starts at an even offset of a map or buffer, so
+// it is aligned.
+unsafe fn units<'a>(raw: *mut TSRedStream, byte: u32) -> &'a [u16] {
+    let bytes = window(raw, byte);
+    if bytes.len() < 2 {
+        return &[];
+    }
+    debug_assert_eq!(bytes.as_ptr() as usize % 2, 0);
+    std::slice::from_raw_parts(bytes.as_ptr().cast(), bytes.len() / 2)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn parser() -> Parser {
+        let mut parser = Parser::new();
+        parser
+            .set_language(&crate::LANGUAGE.into())
+            .expect("Error loading Red parser");
+        parser
+    }
+
+    fn write(name: &str, bytes: &[u8]) -> std::path::PathBuf {
+        let path = std::env::temp_dir().join(format!("{}-{name}", std::process::id()));
+        std::fs::write(&path, bytes).unwrap();
+        path
+    }
+
+    #[test]
+    fn test_stream_parses_as_string() {
+        let mut parser = parser();
+        let source = "a: [b c/d \"é\" 1.5 #{00}]\n".repeat(2000);
+        let expected = parser.parse(&source, None).unwrap();
+        let mut bytes = b"\xEF\xBB\xBF".to_vec();
+        bytes.extend_from_slice(source.as_bytes());
+        let path = write("utf8.red", &bytes);
+        let mut stream = Stream::open(&path, 64).unwrap();
+        assert_eq!(stream.bom_length(), 3);
+        let tree = stream.parse(&mut parser, None).unwrap();
+        assert_eq!(tree.root_node().to_sexp(), expected.root_node().to_sexp());
+        assert_eq!(tree.root_node().end_byte(), source.len());
+        assert_eq!(stream.invalid_offset(), None);
+        std::fs::remove_file(path).unwrap();
+    }
+
+    #[test]
+    fn test_stream_reads_utf16() {
+        let mut parser = parser();
+        let source = "a: [b \"é😀\"]\n".repeat(100);
+        let expected = parser.parse(&source, None).unwrap();
+        let mut bytes = vec![0xFF, 0xFE];
+        bytes.extend(source.encode_utf16().flat_map(u16::to_le_bytes));
+        let path = write("utf16.red", &bytes);
+        let mut stream = Stream::open(&path, 0).unwrap();
+        assert_eq!(stream.encoding(), Encoding::Utf16LE);
+        let tree = stream.parse(&mut parser, None).unwrap();
+        assert_eq!(tree.root_node().to_sexp(), expected.root_node().to_sexp());
+        assert_eq!(tree.root_node().end_byte(), bytes.len() - 2);
+        std::fs::remove_file(path).unwrap();
+    }
+
+    #[test]
+    fn test_stream_finds_invalid_bytes() {
+        let path = write("invalid.red", b"a: \"\xFF\"\n");
+        let mut stream = Stream::open(&path, 0).unwrap();
+        assert!(stream.parse(&mut parser(), None).is_some());
+        assert_eq!(stream.invalid_offset(), Some(4));
+        std::fs::remove_file(path).unwrap();
+        assert!(Stream::open(&path, 0).is_err());
+    }
+}
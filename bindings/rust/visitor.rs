@@ -0,0 +1,248 @@
+// Automatically @generated by scripts/generate-bindings.js
+
+use tree_sitter::Node;
+
+use crate::kind;
+
+/// What [`walk`] should do after visiting a node.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum Visit {
+    /// Descend into the node's children.
+    Continue,
+    /// Skip the node's children and move on to its next sibling.
+    SkipChildren,
+    /// End the walk.
+    Stop,
+}
+
+/// A visitor with one method per named node kind of the Red grammar.
+///
+/// Every method defaults to [`Visit::Continue`]; anonymous nodes are never
+/// reported.
+#[allow(unused_variables)]
+pub trait Visitor<'tree> {
+    fn visit_comment(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_number(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_pair(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_money(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_tuple(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_zone_index(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_cidr(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_ref(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_issue(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_email(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_string_content(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_escaped_char(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_tag(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_infix_op(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_hexa(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_raw_string(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_ipv6_address(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_source_file(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_boolean(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_point(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_ipv6(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_time(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_date(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_char(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_refinement(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_file(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_string(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_multiline_string(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_construction(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_word(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_lit_word(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_get_word(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_set_word(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_url(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_path_start(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_path(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_lit_path(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_get_path(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_set_path(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_binary(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_map(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_block(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_paren(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_function(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_does(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_context(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_make(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+    fn visit_invalid_token(&mut self, node: Node<'tree>) -> Visit {
+        Visit::Continue
+    }
+}
+
+/// Call the matching [`Visitor`] method for a single node.
+pub fn dispatch<'tree, V: Visitor<'tree> + ?Sized>(visitor: &mut V, node: Node<'tree>) -> Visit {
+    match node.kind_id() {
+        kind::COMMENT => visitor.visit_comment(node),
+        kind::NUMBER => visitor.visit_number(node),
+        kind::PAIR => visitor.visit_pair(node),
+        kind::MONEY => visitor.visit_money(node),
+        kind::TUPLE => visitor.visit_tuple(node),
+        kind::ZONE_INDEX => visitor.visit_zone_index(node),
+        kind::CIDR => visitor.visit_cidr(node),
+        kind::REF => visitor.visit_ref(node),
+        kind::ISSUE => visitor.visit_issue(node),
+        kind::EMAIL => visitor.visit_email(node),
+        kind::STRING_CONTENT => visitor.visit_string_content(node),
+        kind::ESCAPED_CHAR => visitor.visit_escaped_char(node),
+        kind::TAG => visitor.visit_tag(node),
+        kind::INFIX_OP => visitor.visit_infix_op(node),
+        kind::HEXA => visitor.visit_hexa(node),
+        kind::RAW_STRING => visitor.visit_raw_string(node),
+        kind::IPV6_ADDRESS => visitor.visit_ipv6_address(node),
+        kind::SOURCE_FILE => visitor.visit_source_file(node),
+        kind::BOOLEAN => visitor.visit_boolean(node),
+        kind::POINT => visitor.visit_point(node),
+        kind::IPV6 => visitor.visit_ipv6(node),
+        kind::TIME => visitor.visit_time(node),
+        kind::DATE => visitor.visit_date(node),
+        kind::CHAR => visitor.visit_char(node),
+        kind::REFINEMENT => visitor.visit_refinement(node),
+        kind::FILE => visitor.visit_file(node),
+        kind::STRING => visitor.visit_string(node),
+        kind::MULTILINE_STRING => visitor.visit_multiline_string(node),
+        kind::CONSTRUCTION => visitor.visit_construction(node),
+        kind::WORD => visitor.visit_word(node),
+        kind::LIT_WORD => visitor.visit_lit_word(node),
+        kind::GET_WORD => visitor.visit_get_word(node),
+        kind::SET_WORD => visitor.visit_set_word(node),
+        kind::URL => visitor.visit_url(node),
+        kind::PATH_START => visitor.visit_path_start(node),
+        kind::PATH => visitor.visit_path(node),
+        kind::LIT_PATH => visitor.visit_lit_path(node),
+        kind::GET_PATH => visitor.visit_get_path(node),
+        kind::SET_PATH => visitor.visit_set_path(node),
+        kind::BINARY => visitor.visit_binary(node),
+        kind::MAP => visitor.visit_map(node),
+        kind::BLOCK => visitor.visit_block(node),
+        kind::PAREN => visitor.visit_paren(node),
+        kind::FUNCTION => visitor.visit_function(node),
+        kind::DOES => visitor.visit_does(node),
+        kind::CONTEXT => visitor.visit_context(node),
+        kind::MAKE => visitor.visit_make(node),
+        kind::INVALID_TOKEN => visitor.visit_invalid_token(node),
+        _ => Visit::Continue,
+    }
+}
+
+/// Walk `node` and its descendants in document order with a single tree
+/// cursor, dispatching every named node to `visitor`.
+pub fn walk<'tree, V: Visitor<'tree> + ?Sized>(visitor: &mut V, node: Node<'tree>) {
+    let mut cursor = node.walk();
+    loop {
+        let descend = match dispatch(visitor, cursor.node()) {
+            Visit::Continue => true,
+            Visit::SkipChildren => false,
+            Visit::Stop => return,
+        };
+        if descend && cursor.goto_first_child() {
+            continue;
+        }
+        loop {
+            if cursor.depth() == 0 {
+                return;
+            }
+            if cursor.goto_next_sibling() {
+                break;
+            }
+            cursor.goto_parent();
+        }
+    }
+}
@@ -2,4 +2,4 @@ module github.com/red/tree-sitter-red
 
 go 1.22
 
-require github.com/tree-sitter/go-tree-sitter v0.24.0
+require github.com/tree-sitter/go-tree-sitter v0.25.0
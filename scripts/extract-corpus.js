@@ -0,0 +1,109 @@
+#!/usr/bin/env node
+/**
+ * @file Writes the sources of the test corpus as separate files
+ *
+ * Every example in `test/corpus/*.txt`, plus `example.red` and the fuzzing
+ * regressions, becomes one file in the output directory, ready to seed the
+ * fuzzer or to feed the benchmark:
+ *
+ *   node scripts/extract-corpus.js seeds
+ *
+ * With `--synthetic BYTES`, it also writes `synthetic.red`: the corpus
+ * examples and `example.red` repeated up to the given size, a steady
+ * workload for throughput measurements and PGO training.
+ */
+
+// @ts-check
+
+const fs = require("fs");
+const path = require("path");
+
+const root = path.resolve(__dirname, "..");
+
+/**
+ * Split a corpus file into the sources of its examples. An example is a
+ * `===` header line, its name, another `===` line, then the source up to a
+ * line of `---`.
+ *
+ * @param {string} text
+ * @returns {{ name: string, source: string }[]}
+ */
+function readExamples(text) {
+  const examples = [];
+  const lines = text.split("\n");
+  for (let i = 0; i + 2 < lines.length; i++) {
+    if (!/^={3,}$/.test(lines[i]) || !/^={3,}$/.test(lines[i + 2])) {
+      continue;
+    }
+    const name = lines[i + 1].trim();
+    let end = i + 3;
+    while (end < lines.length && !/^-{3,}$/.test(lines[end])) {
+      end++;
+    }
+    const source = lines.slice(i + 3, end).join("\n").trim() + "\n";
+    examples.push({ name, source });
+    i = end;
+  }
+  return examples;
+}
+
+/**
+ * @param {string} name
+ * @returns {string}
+ */
+function fileName(name) {
+  return name.toLowerCase().replace(/[^a-z0-9]+/g, "-").replace(/^-|-$/g, "");
+}
+
+function main() {
+  const args = process.argv.slice(2);
+  let synthetic = 0;
+  if (args[0] === "--synthetic") {
+    synthetic = Number(args[1]);
+    args.splice(0, 2);
+  }
+  const output = args[0];
+  if (!output || !(synthetic >= 0)) {
+    console.error("usage: node scripts/extract-corpus.js [--synthetic BYTES] DIRECTORY");
+    process.exit(2);
+  }
+  fs.mkdirSync(output, { recursive: true });
+
+  let count = 0;
+  /** @type {string[]} */
+  const sources = [];
+  const corpus = path.join(root, "test", "corpus");
+  for (const file of fs.readdirSync(corpus).filter((f) => f.endsWith(".txt"))) {
+    const prefix = path.basename(file, ".txt");
+    for (const { name, source } of readExamples(
+      fs.readFileSync(path.join(corpus, file), "utf8"),
+    )) {
+      fs.writeFileSync(path.join(output, `${prefix}-${fileName(name)}.red`), source);
+      sources.push(source);
+      count++;
+    }
+  }
+
+  const regressions = path.join(root, "test", "fuzz", "regressions");
+  const extra = [path.join(root, "example.red")].concat(
+    fs.existsSync(regressions)
+      ? fs.readdirSync(regressions).map((f) => path.join(regressions, f))
+      : [],
+  );
+  for (const file of extra) {
+    fs.copyFileSync(file, path.join(output, path.basename(file)));
+    count++;
+  }
+
+  // The regressions are left out: they are worst cases, not typical code.
+  if (synthetic > 0) {
+    sources.push(fs.readFileSync(path.join(root, "example.red"), "utf8"));
+    const chunk = sources.join("\n");
+    const text = chunk.repeat(Math.ceil(synthetic / Buffer.byteLength(chunk)));
+    fs.writeFileSync(path.join(output, "synthetic.red"), text);
+    count++;
+  }
+  console.log(`Wrote ${count} files to ${output}`);
+}
+
+main();
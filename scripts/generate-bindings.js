@@ -0,0 +1,729 @@
+#!/usr/bin/env node
+/**
+ * @file Generates the node-kind tables shipped with the language bindings
+ *
+ * The symbol ids are read from `src/parser.c` and the node shapes from
+ * `src/node-types.json`, so this has to be re-run after every
+ * `tree-sitter generate`.
+ */
+
+// @ts-check
+
+const crypto = require("crypto");
+const fs = require("fs");
+const path = require("path");
+
+const root = path.resolve(__dirname, "..");
+
+const HEADER = "Automatically @generated by scripts/generate-bindings.js";
+
+/**
+ * @typedef {{ id: number, name: string }} Kind
+ */
+
+/**
+ * Extract every visible, named symbol from the generated parser, keyed by the
+ * public symbol id that `ts_node_symbol` reports for it.
+ *
+ * @param {string} source
+ * @returns {Kind[]}
+ */
+function readKinds(source) {
+  const ids = new Map();
+  const enumBody = section(source, "enum ts_symbol_identifiers {", "};");
+  for (const [, sym, id] of enumBody.matchAll(/(\w+) = (\d+),/g)) {
+    ids.set(sym, Number(id));
+  }
+  ids.set("ts_builtin_sym_end", 0);
+
+  const names = new Map();
+  const namesBody = section(source, "ts_symbol_names[] = {", "};");
+  for (const [, sym, name] of namesBody.matchAll(/\[(\w+)\] = "((?:[^"\\]|\\.)*)",/g)) {
+    names.set(sym, name);
+  }
+
+  const publicSymbols = new Map();
+  const mapBody = section(source, "ts_symbol_map[] = {", "};");
+  for (const [, sym, target] of mapBody.matchAll(/\[(\w+)\] = (\w+),/g)) {
+    publicSymbols.set(sym, target);
+  }
+
+  const kinds = new Map();
+  const metadataBody = section(source, "ts_symbol_metadata[] = {", "};");
+  const entry = /\[(\w+)\] = \{\s*\.visible = (true|false),\s*\.named = (true|false),/g;
+  for (const [, sym, visible, named] of metadataBody.matchAll(entry)) {
+    if (visible !== "true" || named !== "true") continue;
+    const name = names.get(sym);
+    const id = ids.get(publicSymbols.get(sym) ?? sym);
+    if (name === undefined || id === undefined) {
+      throw new Error(`incomplete symbol tables for ${sym}`);
+    }
+    if (!kinds.has(name)) kinds.set(name, { id, name });
+  }
+  return [...kinds.values()].sort((a, b) => a.id - b.id);
+}
+
+/**
+ * Extract the field ids from the generated parser.
+ *
+ * @param {string} source
+ * @returns {Kind[]}
+ */
+function readFields(source) {
+  const body = section(source, "enum ts_field_identifiers {", "};");
+  return [...body.matchAll(/field_(\w+) = (\d+),/g)].map(([, name, id]) => ({
+    id: Number(id),
+    name,
+  }));
+}
+
+/**
+ * @param {string} source
+ * @param {string} name
+ */
+function readDefine(source, name) {
+  const match = source.match(new RegExp(`^#define ${name} (\\d+)$`, "m"));
+  if (!match) throw new Error(`missing ${name} in src/parser.c`);
+  return Number(match[1]);
+}
+
+/**
+ * @param {string} source
+ * @param {string} start
+ * @param {string} end
+ */
+function section(source, start, end) {
+  const from = source.indexOf(start);
+  if (from < 0) throw new Error(`missing \`${start}\` in src/parser.c`);
+  return source.slice(from + start.length, source.indexOf(end, from));
+}
+
+/** @param {string} name */
+function upperSnake(name) {
+  return name.replace(/^_+/, "").toUpperCase();
+}
+
+/** @param {string} name */
+function camel(name) {
+  return name
+    .replace(/^_+/, "")
+    .split("_")
+    .map((part) => part.charAt(0).toUpperCase() + part.slice(1))
+    .join("");
+}
+
+/**
+ * @typedef {{
+ *   languageVersion: number,
+ *   symbolCount: number,
+ *   fieldCount: number,
+ *   fingerprint: string,
+ * }} Version
+ */
+
+/**
+ * @param {Kind[]} kinds
+ * @param {Kind[]} fields
+ * @param {Version} version
+ */
+function cSymbols(kinds, fields, version) {
+  const lines = [
+    "#ifndef TREE_SITTER_RED_SYMBOLS_H_",
+    "#define TREE_SITTER_RED_SYMBOLS_H_",
+    "",
+    `// ${HEADER}`,
+    "//",
+    "// The ids of the named node kinds and fields of the Red grammar, as returned",
+    "// by `ts_node_symbol` and `ts_tree_cursor_current_field_id`. They are only",
+    "// valid for the parser generated with the ABI and table sizes below.",
+    "",
+    `#define TREE_SITTER_RED_LANGUAGE_VERSION ${version.languageVersion}`,
+    `#define TREE_SITTER_RED_SYMBOL_COUNT ${version.symbolCount}`,
+    `#define TREE_SITTER_RED_FIELD_COUNT ${version.fieldCount}`,
+    "",
+    "// Identifies the grammar: the first 64 bits of the SHA-256 of src/grammar.json.",
+    `#define TREE_SITTER_RED_GRAMMAR_FINGERPRINT 0x${version.fingerprint}ULL`,
+    "",
+    "typedef enum {",
+  ];
+  for (const { id, name } of kinds) {
+    lines.push(`  TSRedSymbol${camel(name)} = ${id},`);
+  }
+  lines.push("} TSRedSymbol;", "", "typedef enum {");
+  for (const { id, name } of fields) {
+    lines.push(`  TSRedField${camel(name)} = ${id},`);
+  }
+  lines.push(
+    "} TSRedField;",
+    "",
+    "// X-macros over every symbol and field: `X(enumerator, \"node name\")`.",
+    "#define TREE_SITTER_RED_SYMBOLS(X) \\",
+  );
+  kinds.forEach(({ name }, i) => {
+    const tail = i + 1 < kinds.length ? " \\" : "";
+    lines.push(`  X(TSRedSymbol${camel(name)}, ${JSON.stringify(name)})${tail}`);
+  });
+  lines.push("", "#define TREE_SITTER_RED_FIELDS(X) \\");
+  fields.forEach(({ name }, i) => {
+    const tail = i + 1 < fields.length ? " \\" : "";
+    lines.push(`  X(TSRedField${camel(name)}, ${JSON.stringify(name)})${tail}`);
+  });
+  lines.push(
+    "",
+    "#ifdef TREE_SITTER_API_H_",
+    "",
+    "#include <stdbool.h>",
+    "",
+    "// Check that the ids above agree with the loaded language. Call it once at",
+    "// startup: a mismatch means this header and the parser come from different",
+    "// `tree-sitter generate` runs.",
+    "static inline bool tree_sitter_red_symbols_match(const TSLanguage *language) {",
+    "  if (ts_language_abi_version(language) != TREE_SITTER_RED_LANGUAGE_VERSION ||",
+    "      ts_language_symbol_count(language) != TREE_SITTER_RED_SYMBOL_COUNT ||",
+    "      ts_language_field_count(language) != TREE_SITTER_RED_FIELD_COUNT) {",
+    "    return false;",
+    "  }",
+    "  bool match = true;",
+    "#define TREE_SITTER_RED_CHECK_SYMBOL(id, name)                                 \\",
+    "  match = match && ts_language_symbol_for_name(language, name,                 \\",
+    "                                               sizeof(name) - 1, true) == (id);",
+    "#define TREE_SITTER_RED_CHECK_FIELD(id, name)                                  \\",
+    "  match = match &&                                                             \\",
+    "          ts_language_field_id_for_name(language, name, sizeof(name) - 1) == (id);",
+    "  TREE_SITTER_RED_SYMBOLS(TREE_SITTER_RED_CHECK_SYMBOL)",
+    "  TREE_SITTER_RED_FIELDS(TREE_SITTER_RED_CHECK_FIELD)",
+    "#undef TREE_SITTER_RED_CHECK_SYMBOL",
+    "#undef TREE_SITTER_RED_CHECK_FIELD",
+    "  return match;",
+    "}",
+    "",
+    "#endif // TREE_SITTER_API_H_",
+    "",
+    "#endif // TREE_SITTER_RED_SYMBOLS_H_",
+    "",
+  );
+  return lines.join("\n");
+}
+
+/** @param {Kind[]} kinds */
+function rustKinds(kinds) {
+  const lines = [
+    `// ${HEADER}`,
+    "",
+    "//! Node kind ids of the Red grammar, as returned by `Node::kind_id`.",
+    "",
+  ];
+  for (const { id, name } of kinds) {
+    lines.push(`/// The id of \`${name}\` nodes.`);
+    lines.push(`pub const ${upperSnake(name)}: u16 = ${id};`);
+  }
+  lines.push(
+    "",
+    "#[cfg(test)]",
+    "mod tests {",
+    "    const KINDS: &[(&str, u16)] = &[",
+  );
+  for (const { name } of kinds) {
+    lines.push(`        (${JSON.stringify(name)}, super::${upperSnake(name)}),`);
+  }
+  lines.push(
+    "    ];",
+    "",
+    "    #[test]",
+    "    fn test_kind_ids_match_language() {",
+    "        let language: tree_sitter::Language = crate::LANGUAGE.into();",
+    "        for &(name, id) in KINDS {",
+    "            assert_eq!(language.id_for_node_kind(name, true), id, \"{name}\");",
+    "        }",
+  );
+  lines.push("    }", "}", "");
+  return lines.join("\n");
+}
+
+/** @param {Kind[]} fields */
+function rustFields(fields) {
+  const lines = [
+    `// ${HEADER}`,
+    "",
+    "//! Field ids of the Red grammar, for `Node::child_by_field_id`.",
+    "",
+  ];
+  for (const { id, name } of fields) {
+    lines.push(`/// The id of the \`${name}\` field.`);
+    lines.push(`pub const ${upperSnake(name)}: u16 = ${id};`);
+  }
+  lines.push(
+    "",
+    "#[cfg(test)]",
+    "mod tests {",
+    "    const FIELDS: &[(&str, u16)] = &[",
+  );
+  for (const { name } of fields) {
+    lines.push(`        (${JSON.stringify(name)}, super::${upperSnake(name)}),`);
+  }
+  lines.push(
+    "    ];",
+    "",
+    "    #[test]",
+    "    fn test_field_ids_match_language() {",
+    "        let language: tree_sitter::Language = crate::LANGUAGE.into();",
+    "        for &(name, id) in FIELDS {",
+    "            assert_eq!(",
+    "                language.field_id_for_name(name).map(u16::from),",
+    "                Some(id),",
+    "                \"{name}\"",
+    "            );",
+    "        }",
+    "    }",
+    "}",
+    "",
+  );
+  return lines.join("\n");
+}
+
+/**
+ * @param {Kind[]} kinds
+ * @param {Kind[]} fields
+ */
+function goSymbols(kinds, fields) {
+  const width = (/** @type {string[]} */ names) => Math.max(...names.map((n) => n.length));
+  const symbolWidth = width(kinds.map(({ name }) => `Symbol${camel(name)}`));
+  const fieldWidth = width(fields.map(({ name }) => `Field${camel(name)}`));
+  const lines = [
+    `// Code generated by scripts/generate-bindings.js. DO NOT EDIT.`,
+    "",
+    "package tree_sitter_red",
+    "",
+    "// Ids of the named node kinds, as returned by Node.KindId.",
+    "const (",
+  ];
+  for (const { id, name } of kinds) {
+    lines.push(`\t${`Symbol${camel(name)}`.padEnd(symbolWidth)} uint16 = ${id}`);
+  }
+  lines.push(")", "", "// Ids of the fields, for Node.ChildByFieldId.", "const (");
+  for (const { id, name } of fields) {
+    lines.push(`\t${`Field${camel(name)}`.padEnd(fieldWidth)} uint16 = ${id}`);
+  }
+  lines.push(")", "");
+  return lines.join("\n");
+}
+
+/**
+ * @param {Kind[]} kinds
+ * @param {Kind[]} fields
+ */
+function pythonSymbols(kinds, fields) {
+  const lines = [
+    `# ${HEADER}`,
+    "",
+    '"""Ids of the named node kinds and fields of the Red grammar."""',
+    "",
+    "from enum import IntEnum",
+    "",
+    "",
+    "class Symbol(IntEnum):",
+    '    """Node kind ids, as returned by ``Node.kind_id``."""',
+    "",
+  ];
+  for (const { id, name } of kinds) {
+    lines.push(`    ${upperSnake(name)} = ${id}`);
+  }
+  lines.push(
+    "",
+    "",
+    "class Field(IntEnum):",
+    '    """Field ids, for ``Node.child_by_field_id``."""',
+    "",
+  );
+  for (const { id, name } of fields) {
+    lines.push(`    ${upperSnake(name)} = ${id}`);
+  }
+  lines.push("");
+  return lines.join("\n");
+}
+
+/**
+ * @param {Kind[]} kinds
+ * @param {Kind[]} fields
+ */
+function nodeSymbols(kinds, fields) {
+  const lines = [
+    `// ${HEADER}`,
+    "",
+    "/** Ids of the named node kinds, as returned by `SyntaxNode.typeId`. */",
+    "export const symbols = Object.freeze({",
+  ];
+  for (const { id, name } of kinds) {
+    lines.push(`  ${name}: ${id},`);
+  }
+  lines.push(
+    "});",
+    "",
+    "/** Ids of the fields, for `SyntaxNode.childForFieldId`. */",
+    "export const fields = Object.freeze({",
+  );
+  for (const { id, name } of fields) {
+    lines.push(`  ${name}: ${id},`);
+  }
+  lines.push("});", "");
+  return lines.join("\n");
+}
+
+/**
+ * @param {Kind[]} kinds
+ * @param {any[]} nodeTypes
+ */
+function cppFacade(kinds, nodeTypes) {
+  const shapes = new Map(
+    nodeTypes.filter((t) => t.named).map((t) => [t.type, t.fields ?? {}]),
+  );
+  const lines = [
+    "#ifndef TREE_SITTER_RED_HPP_",
+    "#define TREE_SITTER_RED_HPP_",
+    "",
+    `// ${HEADER}`,
+    "//",
+    "// A header-only C++20 view of Red syntax trees. Every named node kind gets",
+    "// a view type that wraps a TSNode and exposes its fields; all of them are",
+    "// thin inline wrappers over the C API.",
+    "",
+    "#include <tree_sitter/api.h>",
+    "#include <tree_sitter/tree-sitter-red-symbols.h>",
+    "#include <tree_sitter/tree-sitter-red.h>",
+    "",
+    "#include <algorithm>",
+    "#include <cstddef>",
+    "#include <cstdint>",
+    "#include <iterator>",
+    "#include <string_view>",
+    "#include <type_traits>",
+    "#include <utility>",
+    "",
+    "namespace tree_sitter::red {",
+    "",
+    "inline const TSLanguage *language() noexcept { return tree_sitter_red(); }",
+    "",
+    "enum class Symbol : TSSymbol {",
+  ];
+  for (const { name } of kinds) {
+    lines.push(`  ${camel(name)} = TSRedSymbol${camel(name)},`);
+  }
+  lines.push(
+    "};",
+    "",
+    "class Children;",
+    "",
+    "// An untyped node. Views of specific kinds derive from it.",
+    "class Node {",
+    " public:",
+    "  constexpr Node() noexcept = default;",
+    "  constexpr explicit Node(TSNode node) noexcept : node_(node) {}",
+    "",
+    "  [[nodiscard]] constexpr TSNode raw() const noexcept { return node_; }",
+    "  [[nodiscard]] bool is_null() const noexcept { return ts_node_is_null(node_); }",
+    "  [[nodiscard]] Symbol symbol() const noexcept {",
+    "    return static_cast<Symbol>(ts_node_symbol(node_));",
+    "  }",
+    "  [[nodiscard]] bool is_named() const noexcept { return ts_node_is_named(node_); }",
+    "  [[nodiscard]] bool has_error() const noexcept { return ts_node_has_error(node_); }",
+    "  [[nodiscard]] uint32_t start_byte() const noexcept {",
+    "    return ts_node_start_byte(node_);",
+    "  }",
+    "  [[nodiscard]] uint32_t end_byte() const noexcept { return ts_node_end_byte(node_); }",
+    "  [[nodiscard]] TSPoint start_point() const noexcept {",
+    "    return ts_node_start_point(node_);",
+    "  }",
+    "  [[nodiscard]] TSPoint end_point() const noexcept {",
+    "    return ts_node_end_point(node_);",
+    "  }",
+    "",
+    "  // The source text covered by the node, or the part of it in `source` if",
+    "  // that is shorter than the text that was parsed.",
+    "  [[nodiscard]] std::string_view text(std::string_view source) const noexcept {",
+    "    std::size_t start = std::min<std::size_t>(start_byte(), source.size());",
+    "    return source.substr(start, end_byte() - start_byte());",
+    "  }",
+    "",
+    "  // The node's children, iterated with a single tree cursor.",
+    "  [[nodiscard]] Children children() const noexcept;",
+    "",
+    "  // Whether the node is of the kind viewed by `View`.",
+    "  template <class View> [[nodiscard]] bool is() const noexcept {",
+    "    return !is_null() && symbol() == View::kind;",
+    "  }",
+    "",
+    "  // The node as a `View`, or a null view if it is of another kind.",
+    "  template <class View> [[nodiscard]] View as() const noexcept {",
+    "    return is<View>() ? View(node_) : View();",
+    "  }",
+    "",
+    " protected:",
+    "  [[nodiscard]] TSNode field(TSRedField id) const noexcept {",
+    "    return ts_node_child_by_field_id(node_, static_cast<TSFieldId>(id));",
+    "  }",
+    "",
+    " private:",
+    "  TSNode node_{};",
+    "};",
+    "",
+  );
+
+  // Views with fields return other views, so those have to come last.
+  const hasFields = (/** @type {string} */ name) =>
+    Object.keys(shapes.get(name) ?? {}).length > 0;
+  const ordered = [
+    ...kinds.filter(({ name }) => !hasFields(name)),
+    ...kinds.filter(({ name }) => hasFields(name)),
+  ];
+  for (const { name } of ordered) {
+    lines.push(
+      `class ${camel(name)} : public Node {`,
+      " public:",
+      `  static constexpr Symbol kind = Symbol::${camel(name)};`,
+      "",
+      "  using Node::Node;",
+    );
+    const fields = Object.entries(shapes.get(name) ?? {});
+    for (const [field, info] of fields) {
+      const named = info.types.filter((/** @type {any} */ t) => t.named);
+      const type =
+        named.length === 1 && info.types.length === 1 ? camel(named[0].type) : "Node";
+      if (type !== "Node" && hasFields(named[0].type)) {
+        throw new Error(`field ${name}.${field} refers to a view with fields`);
+      }
+      lines.push(
+        "",
+        `  // The \`${field}\` field${info.required ? "" : ", or a null view if absent"}.`,
+        `  [[nodiscard]] ${type} ${field}() const noexcept {`,
+        `    return ${type}(field(TSRedField${camel(field)}));`,
+        "  }",
+      );
+    }
+    lines.push("};", "");
+  }
+
+  lines.push(
+    "// Maps a symbol to its view type, e.g. `view_for<Symbol::Function>::type`.",
+    "template <Symbol S> struct view_for;",
+  );
+  for (const { name } of kinds) {
+    lines.push(
+      `template <> struct view_for<Symbol::${camel(name)}> { using type = ${camel(name)}; };`,
+    );
+  }
+  lines.push(
+    "template <Symbol S> using view_for_t = typename view_for<S>::type;",
+    "",
+    "// A forward range over the children of a node. It owns one tree cursor,",
+    "// so iterating allocates nothing per child.",
+    "class Children {",
+    " public:",
+    "  class iterator {",
+    "   public:",
+    "    using value_type = Node;",
+    "    using difference_type = std::ptrdiff_t;",
+    "",
+    "    [[nodiscard]] Node operator*() const noexcept {",
+    "      return Node(ts_tree_cursor_current_node(cursor_));",
+    "    }",
+    "    iterator &operator++() noexcept {",
+    "      if (!ts_tree_cursor_goto_next_sibling(cursor_)) cursor_ = nullptr;",
+    "      return *this;",
+    "    }",
+    "    void operator++(int) noexcept { ++*this; }",
+    "    [[nodiscard]] bool operator==(std::default_sentinel_t) const noexcept {",
+    "      return cursor_ == nullptr;",
+    "    }",
+    "",
+    "   private:",
+    "    friend class Children;",
+    "    constexpr explicit iterator(TSTreeCursor *cursor) noexcept : cursor_(cursor) {}",
+    "    TSTreeCursor *cursor_;",
+    "  };",
+    "",
+    "  explicit Children(TSNode parent) noexcept",
+    "      : cursor_(ts_tree_cursor_new(parent)),",
+    "        empty_(!ts_tree_cursor_goto_first_child(&cursor_)) {}",
+    "  Children(const Children &) = delete;",
+    "  Children &operator=(const Children &) = delete;",
+    "  ~Children() { ts_tree_cursor_delete(&cursor_); }",
+    "",
+    "  [[nodiscard]] iterator begin() noexcept {",
+    "    return iterator(empty_ ? nullptr : &cursor_);",
+    "  }",
+    "  [[nodiscard]] std::default_sentinel_t end() const noexcept { return {}; }",
+    "",
+    " private:",
+    "  TSTreeCursor cursor_;",
+    "  bool empty_;",
+    "};",
+    "",
+    "inline Children Node::children() const noexcept { return Children(node_); }",
+    "",
+    "// Call `visitor` with the typed view of `node` if it accepts that view, and",
+    "// with the untyped node otherwise (when it accepts one). The overload is",
+    "// chosen at compile time; at run time this is a single switch on the id.",
+    "template <class Visitor> void visit(Node node, Visitor &&visitor) {",
+    "  switch (node.symbol()) {",
+  );
+  for (const { name } of kinds) {
+    lines.push(
+      `  case Symbol::${camel(name)}:`,
+      `    if constexpr (std::is_invocable_v<Visitor, ${camel(name)}>) {`,
+      `      std::forward<Visitor>(visitor)(${camel(name)}(node.raw()));`,
+      "      return;",
+      "    }",
+      "    break;",
+    );
+  }
+  lines.push(
+    "  }",
+    "  if constexpr (std::is_invocable_v<Visitor, Node>) {",
+    "    std::forward<Visitor>(visitor)(node);",
+    "  }",
+    "}",
+    "",
+    "// Walk `node` and its descendants in document order with one tree cursor,",
+    "// passing every named node to `visit`.",
+    "template <class Visitor> void walk(Node node, Visitor &&visitor) {",
+    "  TSTreeCursor cursor = ts_tree_cursor_new(node.raw());",
+    "  for (;;) {",
+    "    Node current(ts_tree_cursor_current_node(&cursor));",
+    "    if (current.is_named()) visit(current, visitor);",
+    "    if (ts_tree_cursor_goto_first_child(&cursor)) continue;",
+    "    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {",
+    "      if (!ts_tree_cursor_goto_parent(&cursor)) {",
+    "        ts_tree_cursor_delete(&cursor);",
+    "        return;",
+    "      }",
+    "    }",
+    "  }",
+    "}",
+    "",
+    "}  // namespace tree_sitter::red",
+    "",
+    "#endif  // TREE_SITTER_RED_HPP_",
+    "",
+  );
+  return lines.join("\n");
+}
+
+/** @param {Kind[]} kinds */
+function rustVisitor(kinds) {
+  const lines = [
+    `// ${HEADER}`,
+    "",
+    "use tree_sitter::Node;",
+    "",
+    "use crate::kind;",
+    "",
+    "/// What [`walk`] should do after visiting a node.",
+    "#[derive(Clone, Copy, Debug, PartialEq, Eq)]",
+    "pub enum Visit {",
+    "    /// Descend into the node's children.",
+    "    Continue,",
+    "    /// Skip the node's children and move on to its next sibling.",
+    "    SkipChildren,",
+    "    /// End the walk.",
+    "    Stop,",
+    "}",
+    "",
+    "/// A visitor with one method per named node kind of the Red grammar.",
+    "///",
+    "/// Every method defaults to [`Visit::Continue`]; anonymous nodes are never",
+    "/// reported.",
+    "#[allow(unused_variables)]",
+    "pub trait Visitor<'tree> {",
+  ];
+  for (const { name } of kinds) {
+    lines.push(
+      `    fn visit_${name.replace(/^_+/, "")}(&mut self, node: Node<'tree>) -> Visit {`,
+      "        Visit::Continue",
+      "    }",
+    );
+  }
+  lines.push(
+    "}",
+    "",
+    "/// Call the matching [`Visitor`] method for a single node.",
+    "pub fn dispatch<'tree, V: Visitor<'tree> + ?Sized>(visitor: &mut V, node: Node<'tree>) -> Visit {",
+    "    match node.kind_id() {",
+  );
+  for (const { name } of kinds) {
+    lines.push(
+      `        kind::${upperSnake(name)} => visitor.visit_${name.replace(/^_+/, "")}(node),`,
+    );
+  }
+  lines.push(
+    "        _ => Visit::Continue,",
+    "    }",
+    "}",
+    "",
+    "/// Walk `node` and its descendants in document order with a single tree",
+    "/// cursor, dispatching every named node to `visitor`.",
+    "pub fn walk<'tree, V: Visitor<'tree> + ?Sized>(visitor: &mut V, node: Node<'tree>) {",
+    "    let mut cursor = node.walk();",
+    "    loop {",
+    "        let descend = match dispatch(visitor, cursor.node()) {",
+    "            Visit::Continue => true,",
+    "            Visit::SkipChildren => false,",
+    "            Visit::Stop => return,",
+    "        };",
+    "        if descend && cursor.goto_first_child() {",
+    "            continue;",
+    "        }",
+    "        loop {",
+    "            if cursor.depth() == 0 {",
+    "                return;",
+    "            }",
+    "            if cursor.goto_next_sibling() {",
+    "                break;",
+    "            }",
+    "            cursor.goto_parent();",
+    "        }",
+    "    }",
+    "}",
+    "",
+  );
+  return lines.join("\n");
+}
+
+function main() {
+  const parser = fs.readFileSync(path.join(root, "src", "parser.c"), "utf8");
+  const nodeTypes = JSON.parse(
+    fs.readFileSync(path.join(root, "src", "node-types.json"), "utf8"),
+  );
+  // Symbols that never appear in a tree, such as `error_sentinel`, are left out.
+  const produced = new Set(
+    nodeTypes.filter((/** @type {any} */ t) => t.named).map((/** @type {any} */ t) => t.type),
+  );
+  const kinds = readKinds(parser).filter(({ name }) => produced.has(name));
+  const fields = readFields(parser);
+  const version = {
+    languageVersion: readDefine(parser, "LANGUAGE_VERSION"),
+    symbolCount: readDefine(parser, "SYMBOL_COUNT"),
+    fieldCount: readDefine(parser, "FIELD_COUNT"),
+    fingerprint: crypto
+      .createHash("sha256")
+      .update(fs.readFileSync(path.join(root, "src", "grammar.json")))
+      .digest("hex")
+      .slice(0, 16),
+  };
+
+  /** @type {[string, string][]} */
+  const outputs = [
+    ["bindings/c/tree_sitter/tree-sitter-red-symbols.h", cSymbols(kinds, fields, version)],
+    ["bindings/cpp/tree_sitter/tree-sitter-red.hpp", cppFacade(kinds, nodeTypes)],
+    ["bindings/go/symbols.go", goSymbols(kinds, fields)],
+    ["bindings/node/symbols.js", nodeSymbols(kinds, fields)],
+    ["bindings/python/tree_sitter_red/symbols.py", pythonSymbols(kinds, fields)],
+    ["bindings/rust/field.rs", rustFields(fields)],
+    ["bindings/rust/kind.rs", rustKinds(kinds)],
+    ["bindings/rust/visitor.rs", rustVisitor(kinds)],
+  ];
+  for (const [file, contents] of outputs) {
+    fs.writeFileSync(path.join(root, file), contents);
+  }
+}
+
+main();
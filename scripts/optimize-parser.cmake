@@ -0,0 +1,16 @@
+# Copy the generated parser without the pragmas that turn optimization off.
+#
+#   cmake -DINPUT=src/parser.c -DOUTPUT=parser-optimized.c -P scripts/optimize-parser.cmake
+#
+# `tree-sitter generate` compiles the lexer at -O0 because optimizing its
+# very large functions is slow. The TREE_SITTER_RED_OPTIMIZED build accepts
+# that cost once in exchange for a faster lexer.
+
+file(READ "${INPUT}" source)
+foreach(pragma
+        "#pragma optimize(\"\", off)"
+        "#pragma clang optimize off"
+        "#pragma GCC optimize (\"O0\")")
+  string(REPLACE "${pragma}" "" source "${source}")
+endforeach()
+file(WRITE "${OUTPUT}" "${source}")
@@ -42,6 +42,11 @@ class EggInfo(egg_info):
         super().find_sources()
         self.filelist.recursive_include("queries", "*.scm")
         self.filelist.include("src/tree_sitter/*.h")
+        self.filelist.include("bindings/c/src/cache.c")
+        self.filelist.include("bindings/c/src/stream.c")
+        self.filelist.include("bindings/c/tree_sitter/tree-sitter-red-cache.h")
+        self.filelist.include("bindings/c/tree_sitter/tree-sitter-red-stream.h")
+        self.filelist.include("bindings/c/tree_sitter/tree-sitter-red-symbols.h")
 
 
 setup(
@@ -57,13 +62,15 @@ setup(
             name="_binding",
             sources=[
                 "bindings/python/tree_sitter_red/binding.c",
+                "bindings/c/src/cache.c",
+                "bindings/c/src/stream.c",
                 "src/parser.c",
             ],
             define_macros=[
                 ("PY_SSIZE_T_CLEAN", None),
                 ("TREE_SITTER_HIDE_SYMBOLS", None),
             ],
-            include_dirs=["src"],
+            include_dirs=["src", "bindings/c"],
             py_limited_api=not get_config_var("Py_GIL_DISABLED"),
         )
     ],
@@ -1,7 +1,6 @@
 #include "tree_sitter/parser.h"
 #include <stdbool.h>
 #include <stdint.h>
-#include <stdlib.h>
 #include <wctype.h>
 
 #ifndef TREE_SITTER_LANGUAGE
@@ -27,15 +26,6 @@
 #define tracef(format, ...)
 #endif
 
-struct Scanner {
-  uint32_t delimiter_length;
-};
-
-#if __STDC_VERSION__ >= 201112L
-_Static_assert(sizeof(struct Scanner) <= TREE_SITTER_SERIALIZATION_BUFFER_SIZE,
-               "Scanner too large");
-#endif
-
 enum TokenType {
   INFIX_OP,
   RED_HEXA,
@@ -55,37 +45,116 @@ static const char *const symbol_names[] = {
 };
 #endif
 
-void tree_sitter_external_scanner(reset)(void *payload) {
-  struct Scanner *scanner = payload;
-  scanner->delimiter_length = 0;
-}
+// Every external token is scanned to completion within a single `scan` call,
+// so the raw-string `%` depth and the multiline-string brace depth never
+// outlive it. No state survives between tokens: the scanner needs no payload
+// and serializes to zero bytes.
 
-void *tree_sitter_external_scanner(create)(void) {
-  struct Scanner *scanner = malloc(sizeof(struct Scanner));
-  tree_sitter_external_scanner(reset)(scanner);
-  return scanner;
-}
+void *tree_sitter_external_scanner(create)(void) { return NULL; }
 
-void tree_sitter_external_scanner(destroy)(void *payload) { free(payload); }
+void tree_sitter_external_scanner(destroy)(void *payload) { (void)payload; }
 
 unsigned tree_sitter_external_scanner(serialize)(void *payload, char *buffer) {
+  (void)payload;
+  (void)buffer;
   trace("serializing\n");
-  *(struct Scanner *)buffer = *(struct Scanner *)payload;
-  return sizeof(struct Scanner);
+  return 0;
 }
 
 void tree_sitter_external_scanner(deserialize)(void *payload,
                                                const char *buffer,
                                                unsigned length) {
-  tree_sitter_external_scanner(reset)(payload);
-  if (length != sizeof(struct Scanner)) {
-    return;
-  }
-  *(struct Scanner *)payload = *(struct Scanner *)buffer;
+  (void)payload;
+  (void)buffer;
+  (void)length;
+}
+
+// Built with TREE_SITTER_RED_STATS, the scanner counts its calls and the
+// characters it advances over, per thread. TSRedScannerStats in
+// bindings/c/tree_sitter/tree-sitter-red-stats.h has the same layout.
+struct TSRedScannerStats {
+  uint32_t calls[1 << (ERROR_SENTINEL + 1)];
+  uint32_t tokens;
+  uint64_t advanced;
+  uint64_t discarded;
+};
+
+#ifdef TREE_SITTER_RED_STATS
+#if defined(_MSC_VER) && !defined(__clang__)
+#define thread_local __declspec(thread)
+#else
+#define thread_local _Thread_local
+#endif
+static thread_local struct TSRedScannerStats stats;
+// The characters advanced over in this call, and up to its last mark_end.
+static thread_local uint32_t advanced, marked;
+#define count_advance() advanced++
+#define count_mark_end() marked = advanced
+#else
+#define count_advance()
+#define count_mark_end()
+#endif
+
+bool tree_sitter_external_scanner(stats)(struct TSRedScannerStats *copy) {
+#ifdef TREE_SITTER_RED_STATS
+  *copy = stats;
+  return true;
+#else
+  *copy = (struct TSRedScannerStats){0};
+  return false;
+#endif
+}
+
+void tree_sitter_external_scanner(stats_reset)(void) {
+#ifdef TREE_SITTER_RED_STATS
+  stats = (struct TSRedScannerStats){0};
+#endif
 }
 
-static void advance(TSLexer *lexer) { lexer->advance(lexer, false); }
-static void skip(TSLexer *lexer) { lexer->advance(lexer, true); }
+// The most characters the body of a raw or multiline string may span; 0 for
+// no limit. An unclosed `{` makes every later call that may start a string
+// scan to the end of the input, so without a limit error recovery over a
+// large script is quadratic. A string cut short is an error in the tree:
+// a multiline string never ends in front of a `}`, so the parser reports
+// its closing brace as missing, and a raw string, whose delimiters are part
+// of its token, becomes an `error_sentinel`, which no rule accepts.
+//
+// Per thread, as a parse runs on the thread that calls it: a budget set for
+// one parse never reaches parsers on other threads. tree_sitter_red_parse
+// sets it for a single parse from its options.
+#if defined(_MSC_VER) && !defined(__clang__)
+static __declspec(thread) uint32_t token_budget;
+#elif defined(__GNUC__)
+static __thread uint32_t token_budget;
+#else
+static _Thread_local uint32_t token_budget;
+#endif
+
+uint32_t tree_sitter_external_scanner(set_budget)(uint32_t characters) {
+  uint32_t previous = token_budget;
+  token_budget = characters;
+  return previous;
+}
+
+static uint32_t budget(void) {
+  uint32_t characters = token_budget;
+  return characters ? characters : UINT32_MAX;
+}
+
+static void advance(TSLexer *lexer) {
+  count_advance();
+  lexer->advance(lexer, false);
+}
+
+static void skip(TSLexer *lexer) {
+  count_advance();
+  lexer->advance(lexer, true);
+}
+
+static void mark_end(TSLexer *lexer) {
+  count_mark_end();
+  lexer->mark_end(lexer);
+}
 
 static void skip_spaces(TSLexer *lexer) {
   while (iswspace(lexer->lookahead) && !lexer->eof(lexer)) {
@@ -128,18 +197,19 @@ static int scan_raw_string(TSLexer *lexer, int start) {
     return S_RETURN;
   advance(lexer);
 
-  for (int delimiter_index = -1;;) {
+  uint32_t left_over = budget();
+  for (int delimiter_index = -1;; left_over--) {
     // If we hit EOF, consider the content to terminate there.
     // This forms an incomplete raw_string, and models the code well.
     if (lexer->eof(lexer)) {
-      lexer->mark_end(lexer);
+      mark_end(lexer);
       lexer->result_symbol = RAW_STRING;
       return S_OK;
     }
 
     if (delimiter_index >= 0) {
       if (delimiter_index == left) {
-        lexer->mark_end(lexer);
+        mark_end(lexer);
         lexer->result_symbol = RAW_STRING;
         return S_OK;
       } else {
@@ -150,6 +220,11 @@ static int scan_raw_string(TSLexer *lexer, int start) {
         }
       }
     }
+    if (left_over == 0) {
+      mark_end(lexer);
+      lexer->result_symbol = ERROR_SENTINEL;
+      return S_OK;
+    }
     if (delimiter_index == -1 && lexer->lookahead == '}') {
       delimiter_index = 0;
     }
@@ -159,11 +234,14 @@ static int scan_raw_string(TSLexer *lexer, int start) {
 }
 
 static bool scan_multiline_string(TSLexer *lexer) {
-  for (int cnt = 1;;) {
+  uint32_t left_over = budget();
+  for (int cnt = 1;; left_over -= left_over > 0) {
     // If we hit EOF, consider the content to terminate there.
     // This forms an incomplete raw_string, and models the code well.
-    if (lexer->eof(lexer)) {
-      lexer->mark_end(lexer);
+    // Out of budget, go on past nested closing braces: the `}` that follows
+    // the body must not be one.
+    if (lexer->eof(lexer) || (left_over == 0 && lexer->lookahead != '}')) {
+      mark_end(lexer);
       lexer->result_symbol = MULTILINE_STRING;
       return true;
     }
@@ -175,7 +253,7 @@ static bool scan_multiline_string(TSLexer *lexer) {
     case '}':
       cnt--;
       if (cnt == 0) {
-        lexer->mark_end(lexer);
+        mark_end(lexer);
         lexer->result_symbol = MULTILINE_STRING;
         return true;
       }
@@ -262,7 +340,7 @@ static int scan_infix_op(TSLexer *lexer) {
       }
       return S_RETURN;
     }
-    lexer->mark_end(lexer);
+    mark_end(lexer);
     lexer->result_symbol = INFIX_OP;
     return S_OK;
   }
@@ -284,7 +362,7 @@ static bool scan_remaining_ipv4_octets(TSLexer *lexer) {
   for (int i = 0; i < 3; i++) {
     if (lexer->lookahead != '.')
       return false;
-    lexer->advance(lexer, false); // consume '.'
+    advance(lexer); // consume '.'
 
     int value = 0;
     int digits = 0;
@@ -297,7 +375,7 @@ static bool scan_remaining_ipv4_octets(TSLexer *lexer) {
       digits++;
       if (digits > 3 || value > 255)
         return false;
-      lexer->advance(lexer, false);
+      advance(lexer);
     }
   }
   return true;
@@ -314,10 +392,10 @@ int scan_ipv6(TSLexer *lexer, int start) {
 
     // start with "::"
     if (c == ':') {
-      lexer->advance(lexer, false);
+      advance(lexer);
       if (lexer->lookahead != ':')
         return S_RETURN;
-      lexer->advance(lexer, false);
+      advance(lexer);
       seen_double_colon = true;
     }
   }
@@ -341,7 +419,7 @@ int scan_ipv6(TSLexer *lexer, int start) {
         }
       }
 
-      lexer->advance(lexer, false);
+      advance(lexer);
       hex_count++;
     }
 
@@ -372,13 +450,13 @@ int scan_ipv6(TSLexer *lexer, int start) {
     if (lexer->lookahead != ':')
       break;
 
-    lexer->advance(lexer, false);
+    advance(lexer);
 
     if (lexer->lookahead == ':') {
       if (seen_double_colon)
         return S_RETURN;
       seen_double_colon = true;
-      lexer->advance(lexer, false);
+      advance(lexer);
       continue;
     }
 
@@ -395,13 +473,12 @@ int scan_ipv6(TSLexer *lexer, int start) {
       return S_RETURN;
   }
 
-  lexer->mark_end(lexer);
+  mark_end(lexer);
   lexer->result_symbol = IPV6_ADDRESS;
   return S_OK;
 }
 
-bool tree_sitter_external_scanner(scan)(void *payload, TSLexer *lexer,
-                                        const bool *valid_symbols) {
+static bool scan(TSLexer *lexer, const bool *valid_symbols) {
   trace("==========\n");
   tracef("lookahead: %d\n", lexer->lookahead);
   trace_valid_symbols(valid_symbols);
@@ -439,7 +516,7 @@ bool tree_sitter_external_scanner(scan)(void *payload, TSLexer *lexer,
       // check valid tail chars
       if (iswspace(c) || c == ']' || c == '[' || c == '{' || c == '"' ||
           c == '(' || c == ')' || c == '<' || lexer->eof(lexer)) {
-        lexer->mark_end(lexer);
+        mark_end(lexer);
         lexer->result_symbol = RED_HEXA;
         return true;
       }
@@ -482,3 +559,27 @@ bool tree_sitter_external_scanner(scan)(void *payload, TSLexer *lexer,
 
   return false;
 }
+
+bool tree_sitter_external_scanner(scan)(void *payload, TSLexer *lexer,
+                                        const bool *valid_symbols) {
+  (void)payload;
+#ifdef TREE_SITTER_RED_STATS
+  unsigned combination = 0;
+  for (int i = INFIX_OP; i <= ERROR_SENTINEL; i++) {
+    combination |= (unsigned)valid_symbols[i] << i;
+  }
+  stats.calls[combination]++;
+  advanced = 0;
+  marked = UINT32_MAX;
+  bool found = scan(lexer, valid_symbols);
+  stats.tokens += found;
+  stats.advanced += advanced;
+  // A token ends at its last mark_end, or where the scanner stopped.
+  stats.discarded += !found                ? advanced
+                     : marked == UINT32_MAX ? 0
+                                            : advanced - marked;
+  return found;
+#else
+  return scan(lexer, valid_symbols);
+#endif
+}
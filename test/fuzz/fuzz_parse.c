@@ -0,0 +1,223 @@
+// A libFuzzer harness for the grammar and the external scanner.
+//
+//   clang -fsanitize=fuzzer,address -Isrc -Ibindings/c
+//       test/fuzz/fuzz_parse.c src/parser.c src/scanner.c -ltree-sitter
+//   node scripts/extract-corpus.js seeds
+//   ./a.out -dict=test/fuzz/red.dict seeds
+//
+// or configure CMake with -DTREE_SITTER_RED_FUZZ=ON and run `fuzz-parse`.
+// AFL++ runs the same harness when built with afl-clang-fast.
+//
+// Besides crashes, it fails on inputs that are slow or memory-hungry for
+// their size: parse time over TREE_SITTER_RED_FUZZ_NS_PER_BYTE (default
+// 20000) or peak parser memory over TREE_SITTER_RED_FUZZ_BYTES_PER_BYTE
+// (default 4096) times the input length, beyond a fixed allowance for
+// small inputs. Minimize a finding with `-minimize_crash=1` and add it to
+// test/fuzz/regressions, which the `bench` target parses on every run.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../../tools/common.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <tree_sitter/api.h>
+
+// Time and memory any input may take regardless of its length.
+#define TIME_ALLOWANCE_NS 50000000ull
+#define MEMORY_ALLOWANCE (1u << 20)
+
+size_t LLVMFuzzerMutate(uint8_t *data, size_t size, size_t max_size);
+
+static TSParser *parser;
+static uint64_t ns_per_byte = 20000;
+static uint64_t bytes_per_byte = 4096;
+
+// Allocations carry their size in front so that frees can be counted.
+typedef union {
+  size_t size;
+  max_align_t align;
+} Header;
+
+static size_t allocated, peak;
+
+static void *count_malloc(size_t size) {
+  Header *header = malloc(sizeof(Header) + size);
+  if (!header) {
+    return NULL;
+  }
+  header->size = size;
+  allocated += size;
+  peak = allocated > peak ? allocated : peak;
+  return header + 1;
+}
+
+static void *count_calloc(size_t count, size_t size) {
+  void *data = count_malloc(count * size);
+  if (data) {
+    memset(data, 0, count * size);
+  }
+  return data;
+}
+
+static void count_free(void *data) {
+  if (data) {
+    Header *header = (Header *)data - 1;
+    allocated -= header->size;
+    free(header);
+  }
+}
+
+static void *count_realloc(void *data, size_t size) {
+  if (!data) {
+    return count_malloc(size);
+  }
+  Header *header = (Header *)data - 1;
+  size_t old_size = header->size;
+  header = realloc(header, sizeof(Header) + size);
+  if (!header) {
+    return NULL;
+  }
+  header->size = size;
+  allocated = allocated - old_size + size;
+  peak = allocated > peak ? allocated : peak;
+  return header + 1;
+}
+
+static uint64_t env_limit(const char *name, uint64_t fallback) {
+  const char *value = getenv(name);
+  return value && *value ? strtoull(value, NULL, 10) : fallback;
+}
+
+int LLVMFuzzerInitialize(int *argc, char ***argv) {
+  (void)argc;
+  (void)argv;
+  ns_per_byte = env_limit("TREE_SITTER_RED_FUZZ_NS_PER_BYTE", ns_per_byte);
+  bytes_per_byte =
+      env_limit("TREE_SITTER_RED_FUZZ_BYTES_PER_BYTE", bytes_per_byte);
+  ts_set_allocator(count_malloc, count_calloc, count_realloc, count_free);
+  parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_red());
+  return 0;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  if (size > UINT32_MAX) {
+    return -1;
+  }
+  peak = allocated;
+  size_t base = allocated;
+  uint64_t start = now();
+  TSTree *tree =
+      ts_parser_parse_string(parser, NULL, (const char *)data, (uint32_t)size);
+  uint64_t elapsed = now() - start;
+  size_t memory = peak - base;
+
+  // Walk the whole tree so that broken node links are found here.
+  TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+  for (bool more = true; more;) {
+    if (ts_tree_cursor_goto_first_child(&cursor)) {
+      continue;
+    }
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        more = false;
+        break;
+      }
+    }
+  }
+  ts_tree_cursor_delete(&cursor);
+  ts_tree_delete(tree);
+  ts_parser_reset(parser);
+
+  if (elapsed > TIME_ALLOWANCE_NS + ns_per_byte * size) {
+    fprintf(stderr, "slow input: %zu bytes parsed in %llu ns\n", size,
+            (unsigned long long)elapsed);
+    abort();
+  }
+  if (memory > MEMORY_ALLOWANCE + bytes_per_byte * size) {
+    fprintf(stderr, "memory-hungry input: %zu bytes needed %zu bytes\n", size,
+            memory);
+    abort();
+  }
+  return 0;
+}
+
+// Fragments that start or end the lexically tricky tokens: raw and
+// multiline strings, binaries, paths, files, escapes and refinements.
+static const char *const fragments[] = {
+    "%{",   "}%",   "%%{",   "}%%",   "%",     "%\"",  "^",     "^(",
+    "^/",   "{",    "}",     "[",     "]",     "(",    ")",     "\"",
+    "#{",   "2#{",  "16#{",  "64#{",  "#(",    "#[",   "/",     "//",
+    "a/b",  ":a",   "a:",    "'a",    "a/b:",  ":a/b", "/ref",  "<",
+    ">",    "<tag>", ";",    "\n",    " ",     "@",    "a@b.c", "http://",
+    "1.2.3", "1x2", "$1.00", "12:00", "1-Jan-2000", "1e10", "#\"a\"",
+    "Red []\n", "func", "does", "context", "make object!",
+};
+#define FRAGMENT_COUNT (sizeof(fragments) / sizeof(fragments[0]))
+
+// Insert a fragment, repeat or nest a slice, or fall back to libFuzzer's
+// byte-level mutations. Repetition and nesting are what reach the deep and
+// long shapes that cost the most per byte.
+size_t LLVMFuzzerCustomMutator(uint8_t *data, size_t size, size_t max_size,
+                               unsigned int seed) {
+  srand(seed);
+  size_t at = size ? (size_t)rand() % (size + 1) : 0;
+  switch (rand() % 4) {
+  case 0: {
+    const char *fragment = fragments[(size_t)rand() % FRAGMENT_COUNT];
+    size_t length = strlen(fragment);
+    if (size + length > max_size) {
+      break;
+    }
+    memmove(data + at + length, data + at, size - at);
+    memcpy(data + at, fragment, length);
+    return size + length;
+  }
+  case 1: {
+    if (size == 0) {
+      break;
+    }
+    size_t start = (size_t)rand() % size;
+    size_t length = 1 + (size_t)rand() % (size - start < 16 ? size - start : 16);
+    size_t times = 2 + (size_t)rand() % 64;
+    while (times > 1 && size + length * times > max_size) {
+      times--;
+    }
+    if (size + length * times > max_size) {
+      break;
+    }
+    uint8_t slice[16];
+    memcpy(slice, data + start, length);
+    memmove(data + start + length * times, data + start, size - start);
+    for (size_t i = 0; i < times; i++) {
+      memcpy(data + start + length * i, slice, length);
+    }
+    return size + length * times;
+  }
+  case 2: {
+    static const char *const pairs[][2] = {
+        {"[", "]"}, {"(", ")"}, {"{", "}"}, {"#(", ")"}, {"%{", "}%"}};
+    const char *const *pair = pairs[(size_t)rand() % 5];
+    size_t open = strlen(pair[0]), close = strlen(pair[1]);
+    size_t end = at + (size_t)rand() % (size - at + 1);
+    if (size + open + close > max_size) {
+      break;
+    }
+    memmove(data + end + open + close, data + end, size - end);
+    memcpy(data + end + open, pair[1], close);
+    memmove(data + at + open, data + at, end - at);
+    memcpy(data + at, pair[0], open);
+    return size + open + close;
+  }
+  default:
+    break;
+  }
+  return LLVMFuzzerMutate(data, size, max_size);
+}
@@ -0,0 +1,365 @@
+// tree-sitter-red-bench: measure parse throughput.
+//
+//   tree-sitter-red-bench [--iterations N] [--max-ns-per-byte N]
+//                         [--max-bytes-per-byte N] [--stats]
+//                         [--threads N] [--stream WINDOW] PATH...
+//
+// Parses each file, and every .red and .reds file under each directory,
+// N times (default 10) and prints the fastest time, the throughput and the
+// peak memory the parser allocated, each also per input byte. Exits with 1
+// if a file is over one of the limits, which is how the `bench` target
+// keeps the fuzzing regressions in test/fuzz/regressions from coming back.
+//
+// With --stats, each file is parsed once more with a stats collector and
+// its counters are printed: stack versions, re-lexes and error recovery,
+// and, if the library was built with TREE_SITTER_RED_STATS, external
+// scanner calls by `valid_symbols` combination.
+//
+// With --threads, each file is also parsed in chunks of its top-level lines
+// on N threads, and the fastest time and its speedup over one parser are
+// printed.
+//
+// With --stream, each file is also parsed from a memory-mapped stream that
+// the parser reads WINDOW bytes at a time, and the fastest time and the
+// peak memory of the parser and the window are printed.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include "tree_sitter/tree-sitter-red-split.h"
+#include "tree_sitter/tree-sitter-red-stats.h"
+#include "tree_sitter/tree-sitter-red-stream.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <dirent.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include <tree_sitter/api.h>
+
+typedef struct {
+  TSParser *parser;
+  unsigned iterations;
+  double max_ns_per_byte;
+  double max_bytes_per_byte;
+  bool stats;
+  unsigned threads;
+  uint32_t window;
+  uint64_t total_bytes;
+  uint64_t total_ns;
+  unsigned over_limit;
+  unsigned failed;
+} Bench;
+
+// Allocations carry their size in front so that frees can be counted.
+typedef union {
+  size_t size;
+  max_align_t align;
+} Header;
+
+static size_t allocated, peak;
+
+static void *count_malloc(size_t size) {
+  Header *header = malloc(sizeof(Header) + size);
+  if (!header) {
+    return NULL;
+  }
+  header->size = size;
+  allocated += size;
+  peak = allocated > peak ? allocated : peak;
+  return header + 1;
+}
+
+static void *count_calloc(size_t count, size_t size) {
+  void *data = count_malloc(count * size);
+  if (data) {
+    memset(data, 0, count * size);
+  }
+  return data;
+}
+
+static void count_free(void *data) {
+  if (data) {
+    Header *header = (Header *)data - 1;
+    allocated -= header->size;
+    free(header);
+  }
+}
+
+static void *count_realloc(void *data, size_t size) {
+  if (!data) {
+    return count_malloc(size);
+  }
+  Header *header = (Header *)data - 1;
+  size_t old_size = header->size;
+  header = realloc(header, sizeof(Header) + size);
+  if (!header) {
+    return NULL;
+  }
+  header->size = size;
+  allocated = allocated - old_size + size;
+  peak = allocated > peak ? allocated : peak;
+  return header + 1;
+}
+
+static int usage(void) {
+  fprintf(stderr, "usage: tree-sitter-red-bench [--iterations N] "
+                  "[--max-ns-per-byte N] [--max-bytes-per-byte N] [--stats] "
+                  "[--threads N] [--stream WINDOW] PATH...\n");
+  return 2;
+}
+
+static void print_stats(Bench *bench, const char *source, uint32_t length) {
+  TSRedParseStats stats = {0};
+  TSRedScannerStats scanner;
+  tree_sitter_red_external_scanner_stats_reset();
+  tree_sitter_red_stats_attach(bench->parser, &stats);
+  ts_tree_delete(ts_parser_parse_string(bench->parser, NULL, source, length));
+  tree_sitter_red_stats_detach(bench->parser);
+  bool counted = tree_sitter_red_external_scanner_stats(&scanner);
+
+  printf("  versions: %u max; lexes: %u, %u external, %u relexed; characters: "
+         "%llu consumed, %llu skipped\n",
+         stats.max_versions, stats.lexes, stats.external_lexes, stats.relexes,
+         (unsigned long long)stats.consumed, (unsigned long long)stats.skipped);
+  printf("  errors: %u; recoveries: %u; skipped tokens: %u\n", stats.errors,
+         stats.recoveries, stats.skipped_tokens);
+  if (!counted) {
+    return;
+  }
+  uint32_t calls = 0;
+  for (unsigned i = 0; i < 1 << TSRedScannerTokenCount; i++) {
+    calls += scanner.calls[i];
+  }
+  printf("  scanner: %u calls, %u tokens; characters: %llu advanced, %llu "
+         "discarded\n",
+         calls, scanner.tokens, (unsigned long long)scanner.advanced,
+         (unsigned long long)scanner.discarded);
+  for (unsigned i = 0; i < 1 << TSRedScannerTokenCount; i++) {
+    if (!scanner.calls[i]) {
+      continue;
+    }
+    printf("    %9u ", scanner.calls[i]);
+    const char *separator = "";
+    for (unsigned token = 0; token < TSRedScannerTokenCount; token++) {
+      if (i & (1u << token)) {
+        printf("%s%s", separator, tree_sitter_red_scanner_token_name(token));
+        separator = " ";
+      }
+    }
+    printf("\n");
+  }
+}
+
+// Chunks smaller than this cost more to hand out than they save.
+#define MIN_CHUNK_SIZE (64u << 10)
+
+static void print_chunks(Bench *bench, const char *source, uint32_t length,
+                         uint64_t single) {
+  // Four chunks per thread, so that uneven ones even out.
+  uint32_t chunk_size = length / (4 * bench->threads);
+  chunk_size = chunk_size < MIN_CHUNK_SIZE ? MIN_CHUNK_SIZE : chunk_size;
+  uint64_t best = UINT64_MAX;
+  uint32_t count = 0;
+  // The counting allocator is for one thread. Everything allocated here is
+  // freed here too.
+  ts_set_allocator(malloc, calloc, realloc, free);
+  for (unsigned i = 0; i < bench->iterations; i++) {
+    TSRedChunks chunks;
+    uint64_t start = now();
+    if (!tree_sitter_red_parse_chunks(source, length, chunk_size,
+                                      bench->threads, &chunks)) {
+      printf("  chunks: failed\n");
+      bench->failed++;
+      break;
+    }
+    uint64_t elapsed = now() - start;
+    count = chunks.count;
+    tree_sitter_red_chunks_delete(&chunks);
+    best = elapsed < best ? elapsed : best;
+  }
+  ts_set_allocator(count_malloc, count_calloc, count_realloc, count_free);
+  if (best == UINT64_MAX) {
+    return;
+  }
+  printf("  chunks: %u on %u threads, %.3f ms, %.2fx (split: %s)\n", count,
+         bench->threads, (double)best / 1e6,
+         (double)single / (double)(best ? best : 1),
+         tree_sitter_red_split_implementation());
+}
+
+static void print_stream(Bench *bench, const char *path, uint64_t single) {
+  uint64_t best = UINT64_MAX;
+  size_t memory = 0;
+  for (unsigned i = 0; i < bench->iterations; i++) {
+    TSRedStream *stream = tree_sitter_red_stream_open(path, bench->window);
+    if (!stream) {
+      printf("  stream: cannot open\n");
+      bench->failed++;
+      return;
+    }
+    size_t base = peak = allocated;
+    uint64_t start = now();
+    TSTree *tree = ts_parser_parse(bench->parser, NULL,
+                                   tree_sitter_red_stream_input(stream));
+    uint64_t elapsed = now() - start;
+    memory = peak - base;
+    ts_tree_delete(tree);
+    if (i == 0 && tree_sitter_red_stream_invalid_offset(stream) != UINT32_MAX) {
+      printf("  stream: invalid %s at byte %u\n",
+             tree_sitter_red_stream_encoding(stream) == TSRedStreamUtf8
+                 ? "UTF-8"
+                 : "UTF-16",
+             tree_sitter_red_stream_invalid_offset(stream));
+    }
+    tree_sitter_red_stream_delete(stream);
+    best = elapsed < best ? elapsed : best;
+  }
+  printf("  stream: %u B window, %.3f ms, %.2fx, %zu B parser + window\n",
+         bench->window, (double)best / 1e6,
+         (double)single / (double)(best ? best : 1), memory + bench->window);
+}
+
+static void bench_file(Bench *bench, const char *path) {
+  uint32_t length;
+  char *source = tree_sitter_red_read_file(path, &length);
+  if (!source) {
+    fprintf(stderr, "tree-sitter-red-bench: cannot read %s\n", path);
+    bench->failed++;
+    return;
+  }
+
+  uint64_t best = UINT64_MAX;
+  size_t memory = 0;
+  for (unsigned i = 0; i < bench->iterations; i++) {
+    size_t base = peak = allocated;
+    uint64_t start = now();
+    TSTree *tree = ts_parser_parse_string(bench->parser, NULL, source, length);
+    uint64_t elapsed = now() - start;
+    memory = peak - base;
+    ts_tree_delete(tree);
+    best = elapsed < best ? elapsed : best;
+  }
+
+  double bytes = length ? length : 1;
+  double ns_per_byte = (double)best / bytes;
+  double bytes_per_byte = (double)memory / bytes;
+  bool over = (bench->max_ns_per_byte > 0 && ns_per_byte > bench->max_ns_per_byte) ||
+              (bench->max_bytes_per_byte > 0 &&
+               bytes_per_byte > bench->max_bytes_per_byte);
+  printf("%-40s %9u B %10.3f ms %8.2f MB/s %9.1f ns/B %8.1f B/B%s\n", path,
+         length, (double)best / 1e6, bytes * 1e3 / (double)(best ? best : 1),
+         ns_per_byte, bytes_per_byte, over ? "  OVER LIMIT" : "");
+  bench->total_bytes += length;
+  bench->total_ns += best;
+  bench->over_limit += over;
+  if (bench->stats) {
+    print_stats(bench, source, length);
+  }
+  if (bench->threads) {
+    print_chunks(bench, source, length, best);
+  }
+  free(source);
+  if (bench->window) {
+    print_stream(bench, path, best);
+  }
+}
+
+static int compare_names(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static void bench_path(Bench *bench, const char *path, bool named) {
+  struct stat info;
+  if (stat(path, &info) != 0) {
+    fprintf(stderr, "tree-sitter-red-bench: cannot read %s\n", path);
+    bench->failed++;
+    return;
+  }
+  if (!S_ISDIR(info.st_mode)) {
+    if (named || tree_sitter_red_has_script_extension(path)) {
+      bench_file(bench, path);
+    }
+    return;
+  }
+
+  DIR *dir = opendir(path);
+  if (!dir) {
+    bench->failed++;
+    return;
+  }
+  char **names = NULL;
+  size_t count = 0, capacity = 0;
+  struct dirent *entry;
+  while ((entry = readdir(dir))) {
+    if (entry->d_name[0] == '.') {
+      continue;
+    }
+    if (count == capacity) {
+      capacity = capacity ? capacity * 2 : 32;
+      char **grown = realloc(names, capacity * sizeof(char *));
+      if (!grown) {
+        break;
+      }
+      names = grown;
+    }
+    size_t length = strlen(path) + strlen(entry->d_name) + 2;
+    if (!(names[count] = malloc(length))) {
+      break;
+    }
+    bool slash = path[strlen(path) - 1] == '/';
+    snprintf(names[count++], length, "%s%s%s", path, slash ? "" : "/",
+             entry->d_name);
+  }
+  closedir(dir);
+  qsort(names, count, sizeof(char *), compare_names);
+  for (size_t i = 0; i < count; i++) {
+    bench_path(bench, names[i], false);
+    free(names[i]);
+  }
+  free(names);
+}
+
+int main(int argc, char **argv) {
+  Bench bench = {.iterations = 10};
+  int i = 1;
+  for (; i < argc && argv[i][0] == '-'; i++) {
+    if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      bench.iterations = (unsigned)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--max-ns-per-byte") == 0 && i + 1 < argc) {
+      bench.max_ns_per_byte = strtod(argv[++i], NULL);
+    } else if (strcmp(argv[i], "--max-bytes-per-byte") == 0 && i + 1 < argc) {
+      bench.max_bytes_per_byte = strtod(argv[++i], NULL);
+    } else if (strcmp(argv[i], "--stats") == 0) {
+      bench.stats = true;
+    } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      bench.threads = (unsigned)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--stream") == 0 && i + 1 < argc) {
+      bench.window = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else {
+      return usage();
+    }
+  }
+  if (i == argc || bench.iterations == 0) {
+    return usage();
+  }
+
+  ts_set_allocator(count_malloc, count_calloc, count_realloc, count_free);
+  bench.parser = ts_parser_new();
+  if (!ts_parser_set_language(bench.parser, tree_sitter_red())) {
+    fprintf(stderr, "tree-sitter-red-bench: incompatible runtime\n");
+    return 2;
+  }
+  for (; i < argc; i++) {
+    bench_path(&bench, argv[i], true);
+  }
+  printf("total: %llu bytes, %.2f MB/s\n", (unsigned long long)bench.total_bytes,
+         (double)bench.total_bytes * 1e3 /
+             (double)(bench.total_ns ? bench.total_ns : 1));
+  ts_parser_delete(bench.parser);
+  return bench.over_limit || bench.failed ? 1 : 0;
+}
@@ -0,0 +1,216 @@
+// tree-sitter-red-check: report the syntax errors of Red scripts.
+//
+//   tree-sitter-red-check [--cache DIR] PATH...
+//
+// Checks each file, and every .red and .reds file under each directory.
+// Prints one line per error,
+//
+//   path:line:column: unexpected `text`, expected one of: a, b, c
+//   path:line:column: missing "]"
+//
+// with one-based lines and columns, and exits with 1 if there was any.
+// With `--cache`, files that did not change since the last run are not
+// parsed again.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include "tree_sitter/tree-sitter-red-cache.h"
+#include "tree_sitter/tree-sitter-red-errors.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <tree_sitter/api.h>
+
+// Longer tokens are cut short in messages.
+#define MAX_TOKEN_LENGTH 40
+
+typedef struct {
+  TSParser *parser;
+  TSRedCache *cache;
+  uint32_t checked;
+  uint32_t failed;
+  uint32_t errors;
+} Checker;
+
+static int usage(void) {
+  fprintf(stderr, "usage: tree-sitter-red-check [--cache DIR] PATH...\n");
+  return 2;
+}
+
+static void print_token(const char *source, uint32_t start, uint32_t end) {
+  putchar('`');
+  for (uint32_t i = start; i < end && i < start + MAX_TOKEN_LENGTH; i++) {
+    char c = source[i];
+    putchar(c == '\n' || c == '\r' || c == '\t' ? ' ' : c);
+  }
+  if (end - start > MAX_TOKEN_LENGTH) {
+    fputs("...", stdout);
+  }
+  putchar('`');
+}
+
+static void print_errors(const char *path, const char *source,
+                         const TSRedErrorList *errors) {
+  const TSLanguage *language = tree_sitter_red();
+  for (uint32_t i = 0; i < errors->count; i++) {
+    const TSRedError *error = &errors->items[i];
+    printf("%s:%u:%u: ", path, error->row + 1, error->column + 1);
+    if (error->kind == TSRedErrorMissing) {
+      printf("missing \"%s\"",
+             ts_language_symbol_name(language, error->symbol));
+    } else if (error->token_start == error->token_end) {
+      fputs("unexpected end of input", stdout);
+    } else {
+      fputs("unexpected ", stdout);
+      print_token(source, error->token_start, error->token_end);
+    }
+    for (uint32_t j = 0; j < error->expected_count; j++) {
+      uint16_t symbol = errors->expected[error->expected_offset + j];
+      printf("%s%s", j == 0 ? ", expected one of: " : ", ",
+             ts_language_symbol_name(language, symbol));
+    }
+    putchar('\n');
+  }
+}
+
+static bool collect(Checker *checker, const char *source, uint32_t length,
+                    TSRedErrorList *errors) {
+  uint64_t hash = tree_sitter_red_hash(source, length, 0);
+  uint8_t *value;
+  size_t size;
+  if (checker->cache &&
+      tree_sitter_red_cache_get(checker->cache, hash, TSRedCacheErrors, &value,
+                                &size)) {
+    bool decoded = tree_sitter_red_errors_decode(value, size, errors);
+    free(value);
+    if (decoded) {
+      return true;
+    }
+  }
+
+  TSTree *tree = ts_parser_parse_string(checker->parser, NULL, source, length);
+  bool ok = tree && tree_sitter_red_errors_collect(tree, errors);
+  ts_tree_delete(tree);
+  if (ok && checker->cache && tree_sitter_red_errors_encode(errors, &value, &size)) {
+    tree_sitter_red_cache_put(checker->cache, hash, TSRedCacheErrors, value, size);
+    free(value);
+  }
+  return ok;
+}
+
+static void check_file(Checker *checker, const char *path) {
+  uint32_t length;
+  char *source = tree_sitter_red_read_file(path, &length);
+  TSRedErrorList errors = {0};
+  if (!source || !collect(checker, source, length, &errors)) {
+    fprintf(stderr, "tree-sitter-red-check: cannot check %s\n", path);
+    checker->failed++;
+  } else {
+    print_errors(path, source, &errors);
+    checker->errors += errors.count;
+  }
+  checker->checked++;
+  tree_sitter_red_errors_delete(&errors);
+  free(source);
+}
+
+static int compare_names(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static void check_path(Checker *checker, const char *path, bool named) {
+  struct stat info;
+  if (stat(path, &info) != 0) {
+    fprintf(stderr, "tree-sitter-red-check: cannot read %s\n", path);
+    checker->failed++;
+    return;
+  }
+  if (!S_ISDIR(info.st_mode)) {
+    // Files named on the command line are checked whatever their extension.
+    if (named || tree_sitter_red_has_script_extension(path)) {
+      check_file(checker, path);
+    }
+    return;
+  }
+
+  DIR *dir = opendir(path);
+  if (!dir) {
+    fprintf(stderr, "tree-sitter-red-check: cannot read %s\n", path);
+    checker->failed++;
+    return;
+  }
+  // Visit entries in name order so that output is stable.
+  char **names = NULL;
+  size_t count = 0, capacity = 0;
+  struct dirent *entry;
+  while ((entry = readdir(dir))) {
+    if (entry->d_name[0] == '.') {
+      continue;
+    }
+    if (count == capacity) {
+      capacity = capacity ? capacity * 2 : 32;
+      char **grown = realloc(names, capacity * sizeof(char *));
+      if (!grown) {
+        break;
+      }
+      names = grown;
+    }
+    size_t length = strlen(path) + strlen(entry->d_name) + 2;
+    if (!(names[count] = malloc(length))) {
+      break;
+    }
+    bool slash = path[strlen(path) - 1] == '/';
+    snprintf(names[count++], length, "%s%s%s", path, slash ? "" : "/",
+             entry->d_name);
+  }
+  closedir(dir);
+  qsort(names, count, sizeof(char *), compare_names);
+  for (size_t i = 0; i < count; i++) {
+    check_path(checker, names[i], false);
+    free(names[i]);
+  }
+  free(names);
+}
+
+int main(int argc, char **argv) {
+  Checker checker = {0};
+  const char *cache_directory = NULL;
+  int first = 1;
+  if (argc > 2 && strcmp(argv[1], "--cache") == 0) {
+    cache_directory = argv[2];
+    first = 3;
+  }
+  if (first >= argc) {
+    return usage();
+  }
+
+  checker.parser = ts_parser_new();
+  if (!ts_parser_set_language(checker.parser, tree_sitter_red())) {
+    fprintf(stderr, "tree-sitter-red-check: incompatible runtime\n");
+    ts_parser_delete(checker.parser);
+    return 2;
+  }
+  if (cache_directory) {
+    checker.cache = tree_sitter_red_cache_open(cache_directory, 0);
+    if (!checker.cache) {
+      fprintf(stderr, "tree-sitter-red-check: cannot open cache %s\n",
+              cache_directory);
+    }
+  }
+
+  for (int i = first; i < argc; i++) {
+    check_path(&checker, argv[i], true);
+  }
+  fprintf(stderr, "%u file(s) checked, %u error(s)\n", checker.checked,
+          checker.errors);
+
+  tree_sitter_red_cache_close(checker.cache);
+  ts_parser_delete(checker.parser);
+  return checker.errors || checker.failed ? 1 : 0;
+}
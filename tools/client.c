@@ -0,0 +1,168 @@
+// tree-sitter-red-client: talk to a running tree-sitter-red-daemon.
+//
+//   tree-sitter-red-client --socket PATH ping
+//   tree-sitter-red-client --socket PATH shutdown
+//   tree-sitter-red-client --socket PATH check FILE...
+//   tree-sitter-red-client --socket PATH outline FILE...
+//   tree-sitter-red-client --socket PATH close FILE...
+//
+// `check` prints one line per syntax error and exits with 1 if there was any;
+// `check` and `outline` send the current contents of each file.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include "tree_sitter/tree-sitter-red-daemon.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int usage(void) {
+  fprintf(stderr, "usage: tree-sitter-red-client --socket PATH "
+                  "(ping | shutdown | check FILE... | outline FILE... | "
+                  "close FILE...)\n");
+  return 2;
+}
+
+// Send a request of `op` naming `path` and check the response status.
+static bool call(int fd, TSRedMessage *message, uint8_t op, const char *path,
+                 TSRedMessageReader *reader) {
+  tree_sitter_red_message_reset(message);
+  tree_sitter_red_message_put_u8(message, op);
+  if (path) {
+    tree_sitter_red_message_put_bytes(message, path, (uint32_t)strlen(path));
+  }
+  if (!tree_sitter_red_daemon_call(fd, message)) {
+    fprintf(stderr, "tree-sitter-red-client: lost the connection\n");
+    return false;
+  }
+  *reader = tree_sitter_red_message_reader(message);
+  uint8_t status = tree_sitter_red_message_get_u8(reader);
+  if (status != TSRedDaemonOk) {
+    fprintf(stderr, "tree-sitter-red-client: %s: request failed (%u)\n",
+            path ? path : "daemon", status);
+    return false;
+  }
+  return true;
+}
+
+static bool send_file(int fd, TSRedMessage *message, const char *path) {
+  uint32_t length;
+  char *source = tree_sitter_red_read_file(path, &length);
+  if (!source) {
+    perror(path);
+    return false;
+  }
+  if (length > TREE_SITTER_RED_DAEMON_MAX_PAYLOAD) {
+    fprintf(stderr, "tree-sitter-red-client: %s: too large\n", path);
+    free(source);
+    return false;
+  }
+  tree_sitter_red_message_reset(message);
+  tree_sitter_red_message_put_u8(message, TSRedDaemonParse);
+  tree_sitter_red_message_put_bytes(message, path, (uint32_t)strlen(path));
+  tree_sitter_red_message_put_bytes(message, source, length);
+  free(source);
+  bool ok = tree_sitter_red_daemon_call(fd, message);
+  TSRedMessageReader reader = tree_sitter_red_message_reader(message);
+  if (!ok || tree_sitter_red_message_get_u8(&reader) != TSRedDaemonOk) {
+    fprintf(stderr, "tree-sitter-red-client: %s: cannot parse\n", path);
+    return false;
+  }
+  return true;
+}
+
+// Returns 0 if the file has no errors, 1 if it has, and 2 on failure.
+static int check(int fd, TSRedMessage *message, const char *path) {
+  TSRedMessageReader reader;
+  if (!send_file(fd, message, path) ||
+      !call(fd, message, TSRedDaemonDiagnostics, path, &reader)) {
+    return 2;
+  }
+  uint32_t count = tree_sitter_red_message_get_u32(&reader);
+  for (uint32_t i = 0; i < count && !reader.failed; i++) {
+    uint8_t missing = tree_sitter_red_message_get_u8(&reader);
+    uint32_t length;
+    const uint8_t *symbol = tree_sitter_red_message_get_bytes(&reader, &length);
+    tree_sitter_red_message_get_u32(&reader);
+    tree_sitter_red_message_get_u32(&reader);
+    uint32_t row = tree_sitter_red_message_get_u32(&reader);
+    uint32_t column = tree_sitter_red_message_get_u32(&reader);
+    if (missing) {
+      printf("%s:%u:%u: missing %.*s\n", path, row + 1, column + 1,
+             (int)length, (const char *)symbol);
+    } else {
+      printf("%s:%u:%u: syntax error\n", path, row + 1, column + 1);
+    }
+  }
+  return reader.failed ? 2 : count > 0;
+}
+
+static int outline(int fd, TSRedMessage *message, const char *path) {
+  TSRedMessageReader reader;
+  if (!send_file(fd, message, path) ||
+      !call(fd, message, TSRedDaemonOutline, path, &reader)) {
+    return 2;
+  }
+  uint32_t count = tree_sitter_red_message_get_u32(&reader);
+  for (uint32_t i = 0; i < count && !reader.failed; i++) {
+    tree_sitter_red_message_get_u32(&reader);
+    tree_sitter_red_message_get_u32(&reader);
+    uint32_t row = tree_sitter_red_message_get_u32(&reader);
+    uint32_t column = tree_sitter_red_message_get_u32(&reader);
+    uint32_t context_length, name_length;
+    const uint8_t *context =
+        tree_sitter_red_message_get_bytes(&reader, &context_length);
+    const uint8_t *name =
+        tree_sitter_red_message_get_bytes(&reader, &name_length);
+    printf("%s:%u:%u: %.*s %.*s\n", path, row + 1, column + 1,
+           (int)context_length, (const char *)context, (int)name_length,
+           (const char *)name);
+  }
+  return reader.failed ? 2 : 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 4 || strcmp(argv[1], "--socket") != 0) {
+    return usage();
+  }
+  const char *command = argv[3];
+  int fd = tree_sitter_red_daemon_connect(argv[2]);
+  if (fd < 0) {
+    fprintf(stderr, "tree-sitter-red-client: cannot connect to %s\n", argv[2]);
+    return 2;
+  }
+
+  TSRedMessage message;
+  TSRedMessageReader reader;
+  tree_sitter_red_message_init(&message);
+  int result = 0;
+  if (strcmp(command, "ping") == 0 && argc == 4) {
+    result = call(fd, &message, TSRedDaemonPing, NULL, &reader) ? 0 : 2;
+  } else if (strcmp(command, "shutdown") == 0 && argc == 4) {
+    result = call(fd, &message, TSRedDaemonShutdown, NULL, &reader) ? 0 : 2;
+  } else if (strcmp(command, "check") == 0) {
+    for (int i = 4; i < argc; i++) {
+      int status = check(fd, &message, argv[i]);
+      result = status > result ? status : result;
+    }
+  } else if (strcmp(command, "outline") == 0) {
+    for (int i = 4; i < argc; i++) {
+      int status = outline(fd, &message, argv[i]);
+      result = status > result ? status : result;
+    }
+  } else if (strcmp(command, "close") == 0) {
+    for (int i = 4; i < argc; i++) {
+      if (!call(fd, &message, TSRedDaemonClose, argv[i], &reader)) {
+        result = 2;
+      }
+    }
+  } else {
+    result = usage();
+  }
+  tree_sitter_red_message_delete(&message);
+  close(fd);
+  return result;
+}
@@ -0,0 +1,19 @@
+#ifndef TREE_SITTER_RED_TOOLS_COMMON_H_
+#define TREE_SITTER_RED_TOOLS_COMMON_H_
+
+// Helpers shared by the tools, the benchmarks and the fuzzer. Include it after
+// defining _POSIX_C_SOURCE.
+
+#include "../bindings/c/src/io.h"
+
+#include <stdint.h>
+#include <time.h>
+
+// Monotonic time in nanoseconds.
+static inline uint64_t now(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (uint64_t)time.tv_sec * 1000000000u + (uint64_t)time.tv_nsec;
+}
+
+#endif // TREE_SITTER_RED_TOOLS_COMMON_H_
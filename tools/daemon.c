@@ -0,0 +1,84 @@
+// tree-sitter-red-daemon: serve parse requests over a Unix socket.
+//
+//   tree-sitter-red-daemon --socket PATH [--queries DIR] [--timeout MS]
+//
+// With --timeout, a parse that takes longer than MS milliseconds fails.
+//
+// See tree_sitter/tree-sitter-red-daemon.h for the protocol.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-red-daemon.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef TREE_SITTER_RED_QUERIES_DIR
+#define TREE_SITTER_RED_QUERIES_DIR "queries"
+#endif
+
+static int usage(void) {
+  fprintf(stderr, "usage: tree-sitter-red-daemon --socket PATH [--queries DIR] "
+                  "[--timeout MS]\n");
+  return 2;
+}
+
+int main(int argc, char **argv) {
+  const char *socket_path = NULL;
+  const char *queries = TREE_SITTER_RED_QUERIES_DIR;
+  unsigned long timeout = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+      socket_path = argv[++i];
+    } else if (strcmp(argv[i], "--queries") == 0 && i + 1 < argc) {
+      queries = argv[++i];
+    } else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+      char *end;
+      timeout = strtoul(argv[++i], &end, 10);
+      if (*end != '\0' || end == argv[i]) {
+        return usage();
+      }
+    } else {
+      return usage();
+    }
+  }
+  if (!socket_path) {
+    return usage();
+  }
+
+  struct sockaddr_un address;
+  if (strlen(socket_path) >= sizeof(address.sun_path)) {
+    fprintf(stderr, "tree-sitter-red-daemon: socket path too long\n");
+    return 1;
+  }
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strcpy(address.sun_path, socket_path);
+
+  TSRedDaemon *daemon = tree_sitter_red_daemon_new(queries);
+  if (!daemon) {
+    fprintf(stderr, "tree-sitter-red-daemon: cannot create the parser\n");
+    return 1;
+  }
+  tree_sitter_red_daemon_set_timeout(daemon, (uint64_t)timeout * 1000u);
+  signal(SIGPIPE, SIG_IGN);
+  unlink(socket_path);
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+      listen(fd, 16) != 0) {
+    perror("tree-sitter-red-daemon");
+    tree_sitter_red_daemon_delete(daemon);
+    return 1;
+  }
+
+  bool ok = tree_sitter_red_daemon_serve(daemon, fd);
+  close(fd);
+  unlink(socket_path);
+  tree_sitter_red_daemon_delete(daemon);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,246 @@
+// tree-sitter-red-decodebench: measure the literal decoders.
+//
+//   tree-sitter-red-decodebench [--iterations N] FILE...
+//
+// Splits each file into string literals and words between whitespace and
+// brackets, sorts the words that decode as dates, times, numbers, money and
+// pairs by type, then decodes each type N times (default 10) and prints the
+// fastest time per literal. It needs no tree-sitter runtime.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include "tree_sitter/tree-sitter-red-binary.h"
+#include "tree_sitter/tree-sitter-red-dates.h"
+#include "tree_sitter/tree-sitter-red-numbers.h"
+#include "tree_sitter/tree-sitter-red-strings.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+  const char *text;
+  uint32_t length;
+} Span;
+
+typedef bool (*Decode)(const char *text, uint32_t length);
+
+typedef struct {
+  const char *name;
+  Decode decode;
+  Span *spans;
+  uint32_t count;
+  uint32_t capacity;
+} Kind;
+
+static bool decode_date(const char *text, uint32_t length) {
+  TSRedDate date;
+  return tree_sitter_red_date_decode(text, length, &date);
+}
+
+static bool decode_time(const char *text, uint32_t length) {
+  TSRedTime time;
+  return tree_sitter_red_time_decode(text, length, &time);
+}
+
+static bool decode_number(const char *text, uint32_t length) {
+  TSRedNumber number;
+  return tree_sitter_red_number_decode(text, length, &number);
+}
+
+static bool decode_money(const char *text, uint32_t length) {
+  TSRedMoney money;
+  return tree_sitter_red_money_decode(text, length, &money);
+}
+
+static bool decode_pair(const char *text, uint32_t length) {
+  TSRedPair pair;
+  return tree_sitter_red_pair_decode(text, length, &pair);
+}
+
+// Large enough for the longest string literal.
+static char *string_buffer;
+static uint32_t string_capacity;
+
+static bool decode_string(const char *text, uint32_t length) {
+  TSRedString string;
+  return tree_sitter_red_string_decode(text, length, string_buffer,
+                                       string_capacity, &string);
+}
+
+static bool decode_binary(const char *text, uint32_t length) {
+  uint32_t size;
+  return tree_sitter_red_binary_decode(text, length, (uint8_t *)string_buffer,
+                                       string_capacity, &size);
+}
+
+// Strings and binaries come first: they are added by the splitter, not by
+// type.
+static Kind kinds[] = {
+    {"string", decode_string, NULL, 0, 0}, {"binary", decode_binary, NULL, 0, 0},
+    {"date", decode_date, NULL, 0, 0},
+    {"time", decode_time, NULL, 0, 0},     {"number", decode_number, NULL, 0, 0},
+    {"money", decode_money, NULL, 0, 0},   {"pair", decode_pair, NULL, 0, 0},
+};
+
+#define KIND_COUNT (sizeof(kinds) / sizeof(*kinds))
+
+static bool is_delimiter(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '[' ||
+         c == ']' || c == '(' || c == ')' || c == '{' || c == '}' ||
+         c == '"' || c == ';' || c == ',';
+}
+
+static bool add_span(Kind *kind, const char *text, uint32_t length) {
+  if (kind->count == kind->capacity) {
+    uint32_t capacity = kind->capacity ? kind->capacity * 2 : 256;
+    Span *spans = realloc(kind->spans, capacity * sizeof(Span));
+    if (!spans) {
+      return false;
+    }
+    kind->spans = spans;
+    kind->capacity = capacity;
+  }
+  kind->spans[kind->count++] = (Span){text, length};
+  return true;
+}
+
+static bool add_word(const char *text, uint32_t length) {
+  for (size_t k = 2; k < KIND_COUNT; k++) {
+    if (kinds[k].decode(text, length)) {
+      return add_span(&kinds[k], text, length);
+    }
+  }
+  return true;
+}
+
+// The end of the "quoted" or {braced} string at `source[start]`, or 0 if it
+// is not closed.
+static uint32_t string_end(const char *source, uint32_t length,
+                           uint32_t start) {
+  uint32_t depth = 0;
+  for (uint32_t i = start; i < length; i++) {
+    char c = source[i];
+    if (c == '^') {
+      i++;
+    } else if (source[start] == '"') {
+      if (i > start && c == '"') {
+        return i + 1;
+      }
+      if (c == '\n') {
+        return 0;
+      }
+    } else if (c == '{') {
+      depth++;
+    } else if (c == '}' && --depth == 0) {
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+static bool add_strings_and_words(const char *source, uint32_t length) {
+  for (uint32_t start = 0, end = 0; start < length; start = end + 1) {
+    char c = source[start];
+    if (c == ';') {
+      for (end = start; end < length && source[end] != '\n'; end++) {
+      }
+      continue;
+    }
+    if (c == '"' || c == '{') {
+      uint32_t string = string_end(source, length, start);
+      // The base of a binary, which was split off as a word.
+      uint32_t base = start;
+      if (c == '{' && base > 0 && source[base - 1] == '#') {
+        for (base--; base > 0 && source[base - 1] >= '0' &&
+                     source[base - 1] <= '9';
+             base--) {
+        }
+      }
+      if (string) {
+        if (string - start > string_capacity) {
+          string_capacity = string - start;
+          free(string_buffer);
+          string_buffer = malloc(string_capacity);
+          if (!string_buffer) {
+            return false;
+          }
+        }
+        if (!add_span(&kinds[base < start], source + base, string - base)) {
+          return false;
+        }
+        end = string - 1;
+        continue;
+      }
+    }
+    for (end = start; end < length && !is_delimiter(source[end]); end++) {
+    }
+    if (end > start && !add_word(source + start, end - start)) {
+      return false;
+    }
+    // A string right after a word, as in `64#{...}`, starts the next span.
+    if (end > start && end < length &&
+        (source[end] == '"' || source[end] == '{')) {
+      end--;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  unsigned iterations = 10;
+  int i = 1;
+  if (argc > 2 && strcmp(argv[1], "--iterations") == 0) {
+    iterations = (unsigned)strtoul(argv[2], NULL, 10);
+    i = 3;
+  }
+  if (i == argc || iterations == 0) {
+    fprintf(stderr,
+            "usage: tree-sitter-red-decodebench [--iterations N] FILE...\n");
+    return 2;
+  }
+
+  // The sources stay allocated: the spans point into them.
+  int status = 0;
+  for (; i < argc; i++) {
+    uint32_t length;
+    char *source = tree_sitter_red_read_file(argv[i], &length);
+    if (!source) {
+      fprintf(stderr, "tree-sitter-red-decodebench: cannot read %s\n", argv[i]);
+      status = 1;
+      continue;
+    }
+    if (!add_strings_and_words(source, length)) {
+      fprintf(stderr, "tree-sitter-red-decodebench: out of memory\n");
+      return 1;
+    }
+  }
+
+  for (size_t k = 0; k < KIND_COUNT; k++) {
+    const Kind *kind = &kinds[k];
+    if (kind->count == 0) {
+      continue;
+    }
+    uint64_t best = UINT64_MAX, bytes = 0;
+    uint32_t decoded = 0;
+    for (uint32_t s = 0; s < kind->count; s++) {
+      bytes += kind->spans[s].length;
+    }
+    for (unsigned run = 0; run < iterations; run++) {
+      uint64_t start = now();
+      decoded = 0;
+      for (uint32_t s = 0; s < kind->count; s++) {
+        decoded += kind->decode(kind->spans[s].text, kind->spans[s].length);
+      }
+      uint64_t elapsed = now() - start;
+      best = elapsed < best ? elapsed : best;
+    }
+    printf("%-8s %9u literals %10.3f ms %8.1f ns/literal %8.2f MB/s\n",
+           kind->name, decoded, (double)best / 1e6,
+           (double)best / kind->count,
+           (double)bytes * 1e3 / (double)(best ? best : 1));
+  }
+  return status;
+}
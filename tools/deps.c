@@ -0,0 +1,126 @@
+// tree-sitter-red-deps: print the dependency graph of a directory of scripts.
+//
+//   tree-sitter-red-deps [--jobs N] [--cache DIR] [--edges] DIRECTORY
+//
+// Prints every file after the files it depends on, one per line. With
+// `--edges`, prints `FROM KIND TO` lines instead, where KIND is `do`,
+// `include` or `load`, and marks targets that do not exist with a trailing
+// ` (missing)`. Cycles are reported on stderr and make the exit status 1.
+// With `--cache`, files that did not change since the last run are not
+// parsed again.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-red-cache.h"
+#include "tree_sitter/tree-sitter-red-deps.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int usage(void) {
+  fprintf(stderr, "usage: tree-sitter-red-deps [--jobs N] [--cache DIR] "
+                  "[--edges] DIRECTORY\n");
+  return 2;
+}
+
+static void print_edge(void *payload, uint32_t from, uint32_t to,
+                       TSRedDependencyKind kind) {
+  static const char *const kinds[] = {"do", "include", "load"};
+  const TSRedDependencyGraph *graph = payload;
+  printf("%s %s %s%s\n", tree_sitter_red_deps_graph_path(graph, from),
+         kinds[kind], tree_sitter_red_deps_graph_path(graph, to),
+         tree_sitter_red_deps_graph_exists(graph, to) ? "" : " (missing)");
+}
+
+// Report each component that is a cycle, listing its files in order.
+static void print_cycles(const TSRedDependencyGraph *graph,
+                         const TSRedDependencyOrder *order) {
+  uint32_t count = tree_sitter_red_deps_graph_file_count(graph);
+  for (uint32_t i = 0; i < count;) {
+    uint32_t end = i + 1;
+    while (end < count &&
+           order->component[order->order[end]] ==
+               order->component[order->order[i]]) {
+      end++;
+    }
+    if (end - i > 1) {
+      fprintf(stderr, "cycle:");
+      for (uint32_t j = i; j < end; j++) {
+        fprintf(stderr, " %s", tree_sitter_red_deps_graph_path(graph, order->order[j]));
+      }
+      fprintf(stderr, "\n");
+    }
+    i = end;
+  }
+}
+
+static void print_self_cycle(void *payload, uint32_t from, uint32_t to,
+                             TSRedDependencyKind kind) {
+  (void)kind;
+  if (from == to) {
+    fprintf(stderr, "cycle: %s\n",
+            tree_sitter_red_deps_graph_path(payload, from));
+  }
+}
+
+int main(int argc, char **argv) {
+  const char *directory = NULL, *cache_directory = NULL;
+  unsigned jobs = 0;
+  bool edges = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+      jobs = (unsigned)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+      cache_directory = argv[++i];
+    } else if (strcmp(argv[i], "--edges") == 0) {
+      edges = true;
+    } else if (argv[i][0] != '-' && !directory) {
+      directory = argv[i];
+    } else {
+      return usage();
+    }
+  }
+  if (!directory) {
+    return usage();
+  }
+
+  TSRedCache *cache = NULL;
+  if (cache_directory) {
+    cache = tree_sitter_red_cache_open(cache_directory, 0);
+    if (!cache) {
+      fprintf(stderr, "tree-sitter-red-deps: cannot open cache %s\n",
+              cache_directory);
+    }
+  }
+  TSRedDependencyGraph *graph = tree_sitter_red_deps_scan(directory, jobs, cache);
+  tree_sitter_red_cache_close(cache);
+  if (!graph) {
+    fprintf(stderr, "tree-sitter-red-deps: cannot scan %s\n", directory);
+    return 1;
+  }
+
+  TSRedDependencyOrder order;
+  if (!tree_sitter_red_deps_graph_sort(graph, &order)) {
+    tree_sitter_red_deps_graph_delete(graph);
+    fprintf(stderr, "tree-sitter-red-deps: out of memory\n");
+    return 1;
+  }
+  if (edges) {
+    tree_sitter_red_deps_graph_edges(graph, print_edge, graph);
+  } else {
+    uint32_t count = tree_sitter_red_deps_graph_file_count(graph);
+    for (uint32_t i = 0; i < count; i++) {
+      puts(tree_sitter_red_deps_graph_path(graph, order.order[i]));
+    }
+  }
+  if (order.has_cycle) {
+    print_cycles(graph, &order);
+    tree_sitter_red_deps_graph_edges(graph, print_self_cycle, graph);
+  }
+
+  int status = order.has_cycle ? 1 : 0;
+  tree_sitter_red_deps_order_delete(&order);
+  tree_sitter_red_deps_graph_delete(graph);
+  return status;
+}
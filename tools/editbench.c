@@ -0,0 +1,536 @@
+// tree-sitter-red-editbench: measure incremental reparses of editor sessions.
+//
+//   tree-sitter-red-editbench [--iterations N] [--max-p99-us N] TRACE...
+//   tree-sitter-red-editbench --seed DIRECTORY SOURCE
+//
+// Replays each trace (see tree-sitter-red-trace.h) N times (default 5):
+// every keystroke applies its edits with `ts_tree_edit` and reparses with
+// the previous tree. Prints the distribution of the fastest reparse time of
+// each keystroke next to a full parse of the starting document, then, from
+// one more replay with a stats collector, the changed ranges and the
+// characters lexed and nodes reused per keystroke. Characters the external
+// scanner advanced over are counted when the library was built with
+// TREE_SITTER_RED_STATS. Exits with 1 if the 99th percentile of a trace is
+// over the limit.
+//
+// With --seed, records the standard sessions against SOURCE into
+// DIRECTORY: typing a function, opening a brace before a large region,
+// pasting a 64#{...} blob and commenting out a block, which is how the
+// traces in test/traces were made.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include "tree_sitter/tree-sitter-red-deps.h"
+#include "tree_sitter/tree-sitter-red-stats.h"
+#include "tree_sitter/tree-sitter-red-trace.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <tree_sitter/api.h>
+
+typedef struct {
+  TSParser *parser;
+  unsigned iterations;
+  double max_p99_us;
+  unsigned over_limit;
+  unsigned failed;
+} Bench;
+
+static int usage(void) {
+  fprintf(stderr,
+          "usage: tree-sitter-red-editbench [--iterations N] "
+          "[--max-p99-us N] TRACE...\n"
+          "       tree-sitter-red-editbench --seed DIRECTORY SOURCE\n");
+  return 2;
+}
+
+// The document a trace starts from, in a buffer that edits can grow.
+static char *read_source(const char *trace_path, const TSRedTrace *trace,
+                         uint32_t *length, uint32_t *capacity) {
+  *length = *capacity = 0;
+  if (!trace->source) {
+    return malloc(1);
+  }
+  char *path = tree_sitter_red_deps_resolve(trace_path, trace->source);
+  char *source = path ? tree_sitter_red_read_file(path, length) : NULL;
+  free(path);
+  *capacity = *length;
+  return source;
+}
+
+static TSInputEdit input_edit(const TSRedTraceEdit *edit) {
+  TSInputEdit input;
+  input.start_byte = edit->start_byte;
+  input.old_end_byte = edit->old_end_byte;
+  input.new_end_byte = edit->new_end_byte;
+  input.start_point = (TSPoint){edit->start_point.row, edit->start_point.column};
+  input.old_end_point =
+      (TSPoint){edit->old_end_point.row, edit->old_end_point.column};
+  input.new_end_point =
+      (TSPoint){edit->new_end_point.row, edit->new_end_point.column};
+  return input;
+}
+
+typedef struct {
+  // Per keystroke: the fastest reparse, and from the stats replay the bytes
+  // in changed ranges, the characters lexed and scanned and the nodes reused.
+  uint64_t *ns;
+  uint64_t *changed;
+  uint64_t *lexed;
+  uint64_t *scanned;
+  uint64_t *reused;
+  uint64_t full_ns;
+} Results;
+
+// Replay `trace` once, keeping the fastest time of each keystroke, or with
+// `stats`, collecting the counters instead.
+static bool replay(Bench *bench, const TSRedTrace *trace, const char *source,
+                   uint32_t source_length, Results *results, bool stats) {
+  uint32_t length = source_length, capacity = source_length;
+  char *document = malloc(capacity ? capacity : 1);
+  if (!document) {
+    return false;
+  }
+  memcpy(document, source, length);
+
+  uint64_t start = now();
+  TSTree *tree = ts_parser_parse_string(bench->parser, NULL, document, length);
+  uint64_t elapsed = now() - start;
+  if (elapsed < results->full_ns) {
+    results->full_ns = elapsed;
+  }
+
+  bool ok = true;
+  uint32_t keystroke = 0;
+  for (uint32_t i = 0; ok && i < trace->count; keystroke++) {
+    // Apply the text of every edit of the keystroke first, so that only
+    // the tree edits and the reparse are timed.
+    uint32_t end = i + 1;
+    while (end < trace->count && trace->edits[end].joined) {
+      end++;
+    }
+    for (uint32_t j = i; ok && j < end; j++) {
+      ok = tree_sitter_red_trace_apply(trace, &trace->edits[j], &document,
+                                       &length, &capacity);
+    }
+    if (!ok) {
+      break;
+    }
+
+    TSRedParseStats parse_stats = {0};
+    if (stats) {
+      tree_sitter_red_external_scanner_stats_reset();
+      tree_sitter_red_stats_attach(bench->parser, &parse_stats);
+    }
+    start = now();
+    for (uint32_t j = i; j < end; j++) {
+      TSInputEdit edit = input_edit(&trace->edits[j]);
+      ts_tree_edit(tree, &edit);
+    }
+    TSTree *new_tree =
+        ts_parser_parse_string(bench->parser, tree, document, length);
+    elapsed = now() - start;
+
+    if (stats) {
+      tree_sitter_red_stats_detach(bench->parser);
+      TSRedScannerStats scanner;
+      results->scanned[keystroke] =
+          tree_sitter_red_external_scanner_stats(&scanner) ? scanner.advanced
+                                                           : 0;
+      results->lexed[keystroke] = parse_stats.consumed + parse_stats.skipped;
+      results->reused[keystroke] = parse_stats.reused_nodes;
+      uint32_t count;
+      TSRange *ranges = ts_tree_get_changed_ranges(tree, new_tree, &count);
+      uint64_t changed = 0;
+      for (uint32_t r = 0; r < count; r++) {
+        changed += ranges[r].end_byte - ranges[r].start_byte;
+      }
+      results->changed[keystroke] = changed;
+      free(ranges);
+    } else if (elapsed < results->ns[keystroke]) {
+      results->ns[keystroke] = elapsed;
+    }
+    ts_tree_delete(tree);
+    tree = new_tree;
+    i = end;
+  }
+  ts_tree_delete(tree);
+  free(document);
+  return ok;
+}
+
+static int compare_u64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+// The nearest-rank percentile of `values`, which this sorts.
+static uint64_t percentile(uint64_t *values, uint32_t count, unsigned p) {
+  qsort(values, count, sizeof(uint64_t), compare_u64);
+  return values[(uint64_t)(count - 1) * p / 100];
+}
+
+static double mean(const uint64_t *values, uint32_t count) {
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    total += values[i];
+  }
+  return (double)total / count;
+}
+
+static void bench_trace(Bench *bench, const char *path) {
+  uint32_t size, line;
+  char *data = tree_sitter_red_read_file(path, &size);
+  TSRedTrace trace;
+  if (!data || !tree_sitter_red_trace_decode(data, size, &trace, &line)) {
+    if (data) {
+      fprintf(stderr, "%s:%u: not a trace line\n", path, line);
+    } else {
+      fprintf(stderr, "tree-sitter-red-editbench: cannot read %s\n", path);
+    }
+    free(data);
+    bench->failed++;
+    return;
+  }
+  free(data);
+
+  uint32_t length, capacity, keystrokes = 0;
+  char *source = read_source(path, &trace, &length, &capacity);
+  for (uint32_t i = 0; i < trace.count; i++) {
+    keystrokes += !trace.edits[i].joined;
+  }
+  Results results = {0};
+  results.full_ns = UINT64_MAX;
+  uint64_t *columns = calloc(5 * (size_t)keystrokes + 1, sizeof(uint64_t));
+  if (!source || !columns || keystrokes == 0) {
+    if (!source) {
+      fprintf(stderr, "tree-sitter-red-editbench: cannot read %s\n",
+              trace.source);
+    } else {
+      fprintf(stderr, "%s: no edits\n", path);
+    }
+    free(source);
+    free(columns);
+    tree_sitter_red_trace_delete(&trace);
+    bench->failed++;
+    return;
+  }
+  results.ns = columns;
+  results.changed = columns + keystrokes;
+  results.lexed = columns + 2 * (size_t)keystrokes;
+  results.scanned = columns + 3 * (size_t)keystrokes;
+  results.reused = columns + 4 * (size_t)keystrokes;
+  for (uint32_t i = 0; i < keystrokes; i++) {
+    results.ns[i] = UINT64_MAX;
+  }
+
+  bool ok = true;
+  for (unsigned i = 0; ok && i < bench->iterations; i++) {
+    ok = replay(bench, &trace, source, length, &results, false);
+  }
+  ok = ok && replay(bench, &trace, source, length, &results, true);
+  if (!ok) {
+    fprintf(stderr, "%s: an edit is outside the document\n", path);
+    bench->failed++;
+  } else {
+    TSRedScannerStats scanner;
+    bool scanner_counted = tree_sitter_red_external_scanner_stats(&scanner);
+    double lexed = mean(results.lexed, keystrokes);
+    double scanned = mean(results.scanned, keystrokes);
+    double reused = mean(results.reused, keystrokes);
+    double changed_mean = mean(results.changed, keystrokes);
+    uint64_t p50 = percentile(results.ns, keystrokes, 50);
+    uint64_t p90 = percentile(results.ns, keystrokes, 90);
+    uint64_t p99 = percentile(results.ns, keystrokes, 99);
+    uint64_t max = percentile(results.ns, keystrokes, 100);
+    bool over = bench->max_p99_us > 0 && (double)p99 / 1e3 > bench->max_p99_us;
+
+    printf("%-40s %6u keystrokes, full parse %9.1f us%s\n", path, keystrokes,
+           (double)results.full_ns / 1e3, over ? "  OVER LIMIT" : "");
+    printf("  reparse: p50 %.1f us, p90 %.1f us, p99 %.1f us, max %.1f us\n",
+           (double)p50 / 1e3, (double)p90 / 1e3, (double)p99 / 1e3,
+           (double)max / 1e3);
+    printf("  changed: p50 %llu B, max %llu B, mean %.0f B\n",
+           (unsigned long long)percentile(results.changed, keystrokes, 50),
+           (unsigned long long)percentile(results.changed, keystrokes, 100),
+           changed_mean);
+    printf("  per keystroke: %.0f characters lexed", lexed);
+    if (scanner_counted) {
+      printf(", %.0f scanned", scanned);
+    }
+    printf(", %.0f nodes reused\n", reused);
+    bench->over_limit += over;
+  }
+  free(columns);
+  free(source);
+  tree_sitter_red_trace_delete(&trace);
+}
+
+// Recording the standard sessions.
+
+typedef struct {
+  TSRedTrace trace;
+  char *document;
+  uint32_t length;
+  uint32_t capacity;
+  bool ok;
+} Session;
+
+static void record(Session *session, uint32_t start, uint32_t old_end,
+                   const char *text, uint32_t text_length, bool joined) {
+  session->ok = session->ok &&
+                tree_sitter_red_trace_record(&session->trace, session->document,
+                                             session->length, start, old_end,
+                                             text, text_length, joined) &&
+                tree_sitter_red_trace_apply(
+                    &session->trace,
+                    &session->trace.edits[session->trace.count - 1],
+                    &session->document, &session->length, &session->capacity);
+}
+
+// Type `text` a byte at a time at `at`, keeping UTF-8 sequences together.
+static void type(Session *session, uint32_t at, const char *text) {
+  for (uint32_t i = 0, length = (uint32_t)strlen(text); i < length;) {
+    uint32_t end = i + 1;
+    while (end < length && ((unsigned char)text[end] & 0xc0) == 0x80) {
+      end++;
+    }
+    record(session, at + i, at + i, text + i, end - i, false);
+    i = end;
+  }
+}
+
+// The offset of the start of line `row`, or the end of the document.
+static uint32_t line_start(const Session *session, uint32_t row) {
+  uint32_t offset = 0;
+  for (; row > 0 && offset < session->length; row--) {
+    const char *newline = memchr(session->document + offset, '\n',
+                                 session->length - offset);
+    if (!newline) {
+      return session->length;
+    }
+    offset = (uint32_t)(newline - session->document) + 1;
+  }
+  return offset;
+}
+
+static uint32_t count_lines(const Session *session) {
+  uint32_t lines = 0;
+  for (uint32_t i = 0; i < session->length; i++) {
+    lines += session->document[i] == '\n';
+  }
+  return lines;
+}
+
+static void type_function(Session *session) {
+  uint32_t at = line_start(session, count_lines(session) / 2);
+  type(session, at,
+       "greet: func [\n"
+       "\t\"Print a greeting\"\n"
+       "\tname [string!]\n"
+       "\t/loud \"In capitals\"\n"
+       "][\n"
+       "\tmessage: rejoin [\"Hello, \" name \"!\"]\n"
+       "\tprint either loud [uppercase message][message]\n"
+       "]\n");
+  // Then fix a typo: `Hello` to `Hi`.
+  const char *hello = strstr(session->document + at, "Hello");
+  if (hello) {
+    uint32_t offset = (uint32_t)(hello - session->document);
+    for (uint32_t i = 5; i > 1; i--) {
+      record(session, offset + i - 1, offset + i, "", 0, false);
+    }
+    type(session, offset + 1, "i");
+  }
+}
+
+static void open_brace(Session *session) {
+  uint32_t lines = count_lines(session);
+  uint32_t at = line_start(session, 2);
+  // An unclosed brace turns the rest of the document into a string until
+  // its closing brace is typed, which is the worst case for reuse.
+  record(session, at, at, "{", 1, false);
+  uint32_t close = line_start(session, lines / 2);
+  record(session, close, close, "}", 1, false);
+  record(session, close, close + 1, "", 0, false);
+  record(session, at, at + 1, "", 0, false);
+  record(session, at, at, "[", 1, false);
+  record(session, close, close, "]", 1, false);
+  record(session, close, close + 1, "", 0, false);
+  record(session, at, at + 1, "", 0, false);
+}
+
+static void paste_binary(Session *session) {
+  static const char digits[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  uint32_t lines = 256, width = 64;
+  uint32_t size = 16 + lines * (width + 2);
+  char *blob = malloc(size);
+  if (!blob) {
+    session->ok = false;
+    return;
+  }
+  uint32_t n = (uint32_t)sprintf(blob, "data: 64#{\n");
+  uint32_t state = 12345;
+  for (uint32_t line = 0; line < lines; line++) {
+    blob[n++] = '\t';
+    for (uint32_t i = 0; i < width; i++) {
+      state = state * 1103515245u + 12345u;
+      blob[n++] = digits[(state >> 16) & 63];
+    }
+    blob[n++] = '\n';
+  }
+  n += (uint32_t)sprintf(blob + n, "}\n");
+
+  uint32_t at = line_start(session, count_lines(session) / 3);
+  record(session, at, at, blob, n, false);
+  // Keep typing after the blob, then undo the paste.
+  type(session, at + n, "size: length? data\n");
+  record(session, at, at + n, "", 0, false);
+  free(blob);
+}
+
+static void comment_block(Session *session) {
+  uint32_t first = count_lines(session) / 4, rows = 40;
+  // A multi-cursor `;` at the start of every line, undone the same way,
+  // then a line comment command repeated line by line. Later lines come
+  // first so that earlier offsets stay put within a keystroke.
+  for (int pass = 0; pass < 2; pass++) {
+    for (uint32_t row = first + rows; row-- > first;) {
+      uint32_t at = line_start(session, row);
+      if (pass == 0) {
+        record(session, at, at, ";", 1, row != first + rows - 1);
+      } else {
+        record(session, at, at + 1, "", 0, row != first + rows - 1);
+      }
+    }
+  }
+  for (uint32_t row = first; row < first + rows; row++) {
+    uint32_t at = line_start(session, row);
+    record(session, at, at, ";", 1, false);
+  }
+}
+
+static int seed(const char *directory, const char *source_path) {
+  static const struct {
+    const char *name;
+    const char *comment;
+    void (*record)(Session *session);
+  } sessions[] = {
+      {"type-function", "typing a function, then fixing a typo", type_function},
+      {"open-brace", "opening a { and a [ before most of the document",
+       open_brace},
+      {"paste-binary", "pasting a 16 KB 64#{...} blob, typing after it and "
+                       "undoing the paste",
+       paste_binary},
+      {"comment-block", "commenting out 40 lines at once and line by line",
+       comment_block},
+  };
+
+  uint32_t source_length;
+  char *source = tree_sitter_red_read_file(source_path, &source_length);
+  if (!source) {
+    fprintf(stderr, "tree-sitter-red-editbench: cannot read %s\n", source_path);
+    return 1;
+  }
+  // Traces name their source relative to themselves.
+  char *relative = NULL;
+  if (source_path[0] == '/') {
+    relative = malloc(strlen(source_path) + 1);
+    if (relative) {
+      strcpy(relative, source_path);
+    }
+  } else {
+    // One `..` for each directory name, skipping `.` and empty ones.
+    size_t depth = 0;
+    for (const char *p = directory; *p;) {
+      size_t name = strcspn(p, "/");
+      depth += name > 0 && !(name == 1 && p[0] == '.');
+      p += name + (p[name] == '/');
+    }
+    relative = malloc(depth * 3 + strlen(source_path) + 1);
+    if (relative) {
+      relative[0] = '\0';
+      for (size_t i = 0; i < depth; i++) {
+        strcat(relative, "../");
+      }
+      strcat(relative, source_path);
+    }
+  }
+
+  int status = relative ? 0 : 1;
+  for (size_t i = 0; status == 0 && i < sizeof(sessions) / sizeof(sessions[0]);
+       i++) {
+    Session session = {{0}, malloc(source_length ? source_length : 1),
+                       source_length, source_length, true};
+    if (session.document) {
+      memcpy(session.document, source, source_length);
+    }
+    session.ok = session.document &&
+                 tree_sitter_red_trace_set_source(&session.trace, relative);
+    sessions[i].record(&session);
+
+    char *data = NULL;
+    size_t size = 0;
+    size_t path_length = strlen(directory) + strlen(sessions[i].name) + 8;
+    char *path = malloc(path_length);
+    FILE *file = NULL;
+    if (session.ok && path &&
+        tree_sitter_red_trace_encode(&session.trace, &data, &size)) {
+      snprintf(path, path_length, "%s/%s.trace", directory, sessions[i].name);
+      file = fopen(path, "wb");
+    }
+    if (!file || fprintf(file, "# %s\n", sessions[i].comment) < 0 ||
+        fwrite(data, 1, size, file) != size) {
+      fprintf(stderr, "tree-sitter-red-editbench: cannot write %s.trace\n",
+              sessions[i].name);
+      status = 1;
+    }
+    if (file && fclose(file) != 0) {
+      status = 1;
+    }
+    free(path);
+    free(data);
+    free(session.document);
+    tree_sitter_red_trace_delete(&session.trace);
+  }
+  free(relative);
+  free(source);
+  return status;
+}
+
+int main(int argc, char **argv) {
+  Bench bench = {.iterations = 5};
+  int i = 1;
+  if (argc == 4 && strcmp(argv[1], "--seed") == 0) {
+    return seed(argv[2], argv[3]);
+  }
+  for (; i < argc && argv[i][0] == '-'; i++) {
+    if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      bench.iterations = (unsigned)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--max-p99-us") == 0 && i + 1 < argc) {
+      bench.max_p99_us = strtod(argv[++i], NULL);
+    } else {
+      return usage();
+    }
+  }
+  if (i == argc || bench.iterations == 0) {
+    return usage();
+  }
+
+  bench.parser = ts_parser_new();
+  if (!ts_parser_set_language(bench.parser, tree_sitter_red())) {
+    fprintf(stderr, "tree-sitter-red-editbench: incompatible runtime\n");
+    return 2;
+  }
+  for (; i < argc; i++) {
+    bench_trace(&bench, argv[i]);
+  }
+  ts_parser_delete(bench.parser);
+  return bench.over_limit || bench.failed ? 1 : 0;
+}
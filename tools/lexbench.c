@@ -0,0 +1,180 @@
+// tree-sitter-red-lexbench: measure the generated lexer on its own.
+//
+//   tree-sitter-red-lexbench [--iterations N] FILE...
+//
+// Runs `ts_lex`, and `ts_lex_keywords` on word tokens, over each file
+// token by token in the lex state of the start of a script, and prints the
+// fastest of N runs (default 10) in MB/s, with the share of the input the
+// lexer read past the end of a token and had to backtrack over. It needs
+// only the parser tables, not the tree-sitter runtime, so it shows what
+// compiling the lexer with TREE_SITTER_RED_OPTIMIZED gains, and serves as
+// the PGO training run where the runtime is not installed.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include "tree_sitter/parser.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+const TSLanguage *tree_sitter_red(void);
+
+typedef struct {
+  TSLexer lexer;
+  const uint8_t *source;
+  uint32_t length;
+  uint32_t position;
+  // The size in bytes of the lookahead character.
+  uint32_t width;
+  uint32_t token_start;
+  uint32_t token_end;
+  bool marked;
+  // Characters read past the ends of tokens.
+  uint64_t backtracked;
+} Lexer;
+
+static void decode(Lexer *self) {
+  const uint8_t *p = self->source + self->position;
+  uint32_t left = self->length - self->position;
+  if (left == 0) {
+    self->lexer.lookahead = 0;
+    self->width = 0;
+    return;
+  }
+  uint32_t width = p[0] < 0x80 ? 1 : p[0] < 0xe0 ? 2 : p[0] < 0xf0 ? 3 : 4;
+  if (width > left) {
+    width = 1;
+  }
+  int32_t c = width == 1 ? p[0] : p[0] & (0x7f >> width);
+  for (uint32_t i = 1; i < width; i++) {
+    c = (c << 6) | (p[i] & 0x3f);
+  }
+  self->lexer.lookahead = c;
+  self->width = width;
+}
+
+static void advance(TSLexer *lexer, bool skip) {
+  Lexer *self = (Lexer *)lexer;
+  self->position += self->width;
+  if (skip) {
+    self->token_start = self->position;
+  }
+  decode(self);
+}
+
+static void mark_end(TSLexer *lexer) {
+  Lexer *self = (Lexer *)lexer;
+  self->token_end = self->position;
+  self->marked = true;
+}
+
+static uint32_t get_column(TSLexer *lexer) {
+  Lexer *self = (Lexer *)lexer;
+  uint32_t column = 0;
+  for (uint32_t i = self->position; i > 0 && self->source[i - 1] != '\n'; i--) {
+    column++;
+  }
+  return column;
+}
+
+static bool is_at_included_range_start(const TSLexer *lexer) {
+  (void)lexer;
+  return false;
+}
+
+static bool eof(const TSLexer *lexer) {
+  const Lexer *self = (const Lexer *)lexer;
+  return self->position >= self->length;
+}
+
+static void lex_log(const TSLexer *lexer, const char *format, ...) {
+  (void)lexer;
+  (void)format;
+}
+
+static bool lex_at(Lexer *self, bool (*lex)(TSLexer *, TSStateId),
+                   TSStateId state, uint32_t start) {
+  self->position = self->token_start = self->token_end = start;
+  self->marked = false;
+  decode(self);
+  bool found = lex(&self->lexer, state);
+  if (!self->marked) {
+    self->token_end = self->position;
+  }
+  return found;
+}
+
+// Lex the whole source and return the number of tokens.
+static uint32_t lex_all(Lexer *self, const TSLanguage *language) {
+  TSStateId state = language->lex_modes[1].lex_state;
+  uint32_t tokens = 0, start = 0;
+  while (start < self->length) {
+    if (!lex_at(self, language->lex_fn, state, start) ||
+        self->token_end <= start) {
+      // Skip what the start state cannot lex, such as the inside of strings.
+      start++;
+      continue;
+    }
+    uint32_t end = self->token_end;
+    self->backtracked += self->position - end;
+    if (self->lexer.result_symbol == language->keyword_capture_token &&
+        language->keyword_lex_fn) {
+      lex_at(self, language->keyword_lex_fn, 0, self->token_start);
+    }
+    tokens++;
+    start = end;
+  }
+  return tokens;
+}
+
+int main(int argc, char **argv) {
+  unsigned iterations = 10;
+  int i = 1;
+  if (argc > 2 && strcmp(argv[1], "--iterations") == 0) {
+    iterations = (unsigned)strtoul(argv[2], NULL, 10);
+    i = 3;
+  }
+  if (i == argc || iterations == 0) {
+    fprintf(stderr, "usage: tree-sitter-red-lexbench [--iterations N] FILE...\n");
+    return 2;
+  }
+
+  const TSLanguage *language = tree_sitter_red();
+  Lexer lexer = {.lexer = {0, 0, advance, mark_end, get_column,
+                           is_at_included_range_start, eof, lex_log}};
+  uint64_t total_bytes = 0, total_ns = 0;
+  int status = 0;
+  for (; i < argc; i++) {
+    uint32_t length;
+    uint8_t *source = (uint8_t *)tree_sitter_red_read_file(argv[i], &length);
+    if (!source) {
+      fprintf(stderr, "tree-sitter-red-lexbench: cannot read %s\n", argv[i]);
+      status = 1;
+      continue;
+    }
+    lexer.source = source;
+    lexer.length = length;
+    uint64_t best = UINT64_MAX;
+    uint32_t tokens = 0;
+    for (unsigned run = 0; run < iterations; run++) {
+      lexer.backtracked = 0;
+      uint64_t start = now();
+      tokens = lex_all(&lexer, language);
+      uint64_t elapsed = now() - start;
+      best = elapsed < best ? elapsed : best;
+    }
+    printf("%-40s %9u B %8u tokens %10.3f ms %8.2f MB/s %6.2f%% backtracked\n",
+           argv[i], length, tokens, (double)best / 1e6,
+           (double)length * 1e3 / (double)(best ? best : 1),
+           100.0 * (double)lexer.backtracked / (double)(length ? length : 1));
+    total_bytes += length;
+    total_ns += best;
+    free(source);
+  }
+  printf("total: %llu bytes, %.2f MB/s\n", (unsigned long long)total_bytes,
+         (double)total_bytes * 1e3 / (double)(total_ns ? total_ns : 1));
+  return status;
+}
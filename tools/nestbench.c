@@ -0,0 +1,406 @@
+// tree-sitter-red-nestbench: measure parsing deeply nested input.
+//
+//   tree-sitter-red-nestbench [--max-depth N] [--max-growth X]
+//                             [--max-stack-growth BYTES] [--queries DIR]
+//
+// Generates blocks `[[...]]`, parens `((...))`, maps `#[#[...]]`, paths
+// `a/(a/(...))`, multiline strings `{{...}}` and unclosed blocks `[[[...`,
+// each nested 1, 10, 100 ... up to N levels deep (default 1000000). Each is
+// parsed, walked with tree_sitter_red_tree_shape, searched for errors and
+// matched against the highlights query, and the tree deleted. Prints the
+// fastest time of each step, the peak memory the parser allocated per
+// level, and the C stack all of it used, which is measured on a thread of
+// its own whose stack is filled with a pattern beforehand.
+//
+// Exits with 1 if, at the deepest level, a step takes more than X times
+// (default 8) as long per level as it does at 1000 levels, the memory per
+// level grew as much, or the stack grew by more than BYTES (default 65536)
+// over that of a single level: nesting must cost linear time and memory,
+// and constant stack. Something that recursed per level would overflow the
+// stack and crash, which fails too. This is how the `nestbench` target
+// keeps the parser, the helpers and the queries from degrading on the
+// nested data `load-json` produces.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include "tree_sitter/tree-sitter-red-errors.h"
+#include "tree_sitter/tree-sitter-red-query.h"
+#include "tree_sitter/tree-sitter-red-walk.h"
+#include "tree_sitter/tree-sitter-red.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <tree_sitter/api.h>
+
+#ifndef TREE_SITTER_RED_QUERIES_DIR
+#define TREE_SITTER_RED_QUERIES_DIR "queries"
+#endif
+
+// The stack of the measured thread. A recursive walk a million levels deep
+// needs more and runs into the guard page below it.
+#define STACK_SIZE (16u << 20)
+#define STACK_PATTERN 0xa5
+
+// The depth that later ones are compared with.
+#define BASELINE_DEPTH 1000
+
+typedef struct {
+  const char *name;
+  const char *open;
+  const char *middle;
+  const char *close;
+} Shape;
+
+static const Shape shapes[] = {
+    {"blocks", "[", "", "]"},      {"parens", "(", "", ")"},
+    {"maps", "#[", "", "]"},       {"paths", "a/(", "a", ")"},
+    {"strings", "{", "", "}"},     {"unclosed", "[", "", ""},
+};
+
+typedef enum {
+  StepParse,
+  StepWalk,
+  StepErrors,
+  StepQuery,
+  StepDelete,
+  StepCount,
+} Step;
+
+static const char *const step_names[StepCount] = {"parse", "walk", "errors",
+                                                  "query", "delete"};
+
+typedef struct {
+  TSParser *parser;
+  TSRedQuery *highlights;
+  TSQueryCursor *cursor;
+  const char *source;
+  uint32_t length;
+  unsigned iterations;
+  // Results.
+  uint64_t ns[StepCount];
+  size_t memory;
+  TSRedTreeShape shape;
+  uint32_t errors;
+  uint32_t captures;
+  bool failed;
+} Run;
+
+// Allocations carry their size in front so that frees can be counted.
+typedef union {
+  size_t size;
+  max_align_t align;
+} Header;
+
+static size_t allocated, peak;
+
+static void *count_malloc(size_t size) {
+  Header *header = malloc(sizeof(Header) + size);
+  if (!header) {
+    return NULL;
+  }
+  header->size = size;
+  allocated += size;
+  peak = allocated > peak ? allocated : peak;
+  return header + 1;
+}
+
+static void *count_calloc(size_t count, size_t size) {
+  void *data = count_malloc(count * size);
+  if (data) {
+    memset(data, 0, count * size);
+  }
+  return data;
+}
+
+static void count_free(void *data) {
+  if (data) {
+    Header *header = (Header *)data - 1;
+    allocated -= header->size;
+    free(header);
+  }
+}
+
+static void *count_realloc(void *data, size_t size) {
+  if (!data) {
+    return count_malloc(size);
+  }
+  Header *header = (Header *)data - 1;
+  size_t old_size = header->size;
+  header = realloc(header, sizeof(Header) + size);
+  if (!header) {
+    return NULL;
+  }
+  header->size = size;
+  allocated = allocated - old_size + size;
+  peak = allocated > peak ? allocated : peak;
+  return header + 1;
+}
+
+static int usage(void) {
+  fprintf(stderr, "usage: tree-sitter-red-nestbench [--max-depth N] "
+                  "[--max-growth X] [--max-stack-growth BYTES] "
+                  "[--queries DIR]\n");
+  return 2;
+}
+
+static char *generate(const Shape *shape, uint32_t depth, uint32_t *length) {
+  size_t open = strlen(shape->open), middle = strlen(shape->middle),
+         close = strlen(shape->close);
+  size_t size = depth * (open + close) + middle;
+  if (size > UINT32_MAX) {
+    return NULL;
+  }
+  char *source = malloc(size + 1);
+  if (!source) {
+    return NULL;
+  }
+  char *end = source;
+  for (uint32_t i = 0; i < depth; i++, end += open) {
+    memcpy(end, shape->open, open);
+  }
+  memcpy(end, shape->middle, middle);
+  end += middle;
+  for (uint32_t i = 0; i < depth; i++, end += close) {
+    memcpy(end, shape->close, close);
+  }
+  *end = '\0';
+  *length = (uint32_t)size;
+  return source;
+}
+
+static void keep_fastest(Run *run, Step step, uint64_t start) {
+  uint64_t elapsed = now() - start;
+  if (elapsed < run->ns[step]) {
+    run->ns[step] = elapsed;
+  }
+}
+
+static void *run_steps(void *payload) {
+  Run *run = payload;
+  for (Step step = 0; step < StepCount; step++) {
+    run->ns[step] = UINT64_MAX;
+  }
+  for (unsigned i = 0; i < run->iterations; i++) {
+    size_t base = peak = allocated;
+    uint64_t start = now();
+    TSTree *tree =
+        ts_parser_parse_string(run->parser, NULL, run->source, run->length);
+    keep_fastest(run, StepParse, start);
+    run->memory = peak - base;
+    if (!tree) {
+      run->failed = true;
+      return NULL;
+    }
+    TSNode root = ts_tree_root_node(tree);
+
+    start = now();
+    run->shape = tree_sitter_red_tree_shape(root);
+    keep_fastest(run, StepWalk, start);
+
+    TSRedErrorList errors = {0};
+    start = now();
+    run->failed |= !tree_sitter_red_errors_collect(tree, &errors);
+    keep_fastest(run, StepErrors, start);
+    run->errors = errors.count;
+    tree_sitter_red_errors_delete(&errors);
+
+    start = now();
+    run->captures = 0;
+    if (run->highlights) {
+      TSQueryMatch match;
+      uint32_t capture_index;
+      ts_query_cursor_exec(run->cursor,
+                           tree_sitter_red_query_raw(run->highlights), root);
+      while (ts_query_cursor_next_capture(run->cursor, &match,
+                                          &capture_index)) {
+        run->captures += tree_sitter_red_query_satisfies(run->highlights,
+                                                         &match, run->source);
+      }
+    }
+    keep_fastest(run, StepQuery, start);
+
+    start = now();
+    ts_tree_delete(tree);
+    keep_fastest(run, StepDelete, start);
+  }
+  return NULL;
+}
+
+// Run the steps on a thread with a painted stack, and return how much of
+// the stack they used, or 0 if the thread could not be started. Stacks grow
+// down on every platform this runs on.
+static size_t run_measured(Run *run) {
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  void *memory;
+  if (posix_memalign(&memory, page, STACK_SIZE) != 0) {
+    return 0;
+  }
+  unsigned char *stack = memory;
+  memset(stack, STACK_PATTERN, STACK_SIZE);
+  // A guard page, so that overflowing the stack faults instead of writing
+  // over the heap.
+  bool guarded = mprotect(stack, page, PROT_NONE) == 0;
+
+  pthread_attr_t attributes;
+  pthread_t thread;
+  bool started =
+      pthread_attr_init(&attributes) == 0 &&
+      pthread_attr_setstack(&attributes, stack, STACK_SIZE) == 0 &&
+      pthread_create(&thread, &attributes, run_steps, run) == 0;
+  size_t used = 0;
+  if (started) {
+    pthread_join(thread, NULL);
+    size_t untouched = guarded ? page : 0;
+    while (untouched < STACK_SIZE && stack[untouched] == STACK_PATTERN) {
+      untouched++;
+    }
+    used = STACK_SIZE - untouched;
+  }
+  pthread_attr_destroy(&attributes);
+  if (guarded) {
+    mprotect(stack, page, PROT_READ | PROT_WRITE);
+  }
+  free(memory);
+  return used;
+}
+
+typedef struct {
+  uint32_t max_depth;
+  double max_growth;
+  size_t max_stack_growth;
+  unsigned over_limit;
+  unsigned failed;
+} Bench;
+
+static double per_level(uint64_t value, uint32_t depth) {
+  return (double)value / depth;
+}
+
+// Whether `value` at `depth` grew per level more than allowed over
+// `baseline` at BASELINE_DEPTH. Baselines under a microsecond or a
+// kilobyte are rounded up, so that timer noise does not count.
+static bool grew(const Bench *bench, uint64_t value, uint64_t baseline,
+                 uint32_t depth) {
+  baseline = baseline < 1000 ? 1000 : baseline;
+  return per_level(value, depth) >
+         bench->max_growth * per_level(baseline, BASELINE_DEPTH);
+}
+
+static void bench_shape(Bench *bench, Run *run, const Shape *shape) {
+  uint64_t baseline_ns[StepCount] = {0};
+  size_t baseline_memory = 0, first_stack = 0;
+  bool have_baseline = false;
+  for (uint32_t depth = 1; depth <= bench->max_depth; depth *= 10) {
+    uint32_t length;
+    char *source = generate(shape, depth, &length);
+    if (!source) {
+      fprintf(stderr, "tree-sitter-red-nestbench: out of memory\n");
+      bench->failed++;
+      return;
+    }
+    run->source = source;
+    run->length = length;
+    run->iterations = depth <= 10000 ? 5 : 1;
+    run->failed = false;
+    size_t stack = run_measured(run);
+    free(source);
+    if (stack == 0 || run->failed) {
+      fprintf(stderr, "tree-sitter-red-nestbench: %s at %u levels failed\n",
+              shape->name, depth);
+      bench->failed++;
+      return;
+    }
+
+    if (depth == 1) {
+      first_stack = stack;
+    }
+    if (depth == BASELINE_DEPTH) {
+      memcpy(baseline_ns, run->ns, sizeof(baseline_ns));
+      baseline_memory = run->memory;
+      have_baseline = true;
+    }
+    bool last = depth > bench->max_depth / 10;
+    bool over = last && stack > first_stack + bench->max_stack_growth;
+    if (last && have_baseline) {
+      over |= grew(bench, run->memory, baseline_memory, depth);
+      for (Step step = 0; step < StepCount; step++) {
+        if (grew(bench, run->ns[step], baseline_ns[step], depth)) {
+          printf("  %s takes %.1f ns per level, %.1f at %u levels\n",
+                 step_names[step], per_level(run->ns[step], depth),
+                 per_level(baseline_ns[step], BASELINE_DEPTH), BASELINE_DEPTH);
+          over = true;
+        }
+      }
+    }
+    printf("%-8s %7u levels %8u B", shape->name, depth, length);
+    for (Step step = 0; step < StepCount; step++) {
+      printf("  %s %8.3f ms", step_names[step], (double)run->ns[step] / 1e6);
+    }
+    printf("  %7.1f B/level  stack %6zu B  depth %u  errors %u  captures "
+           "%u%s\n",
+           per_level(run->memory, depth), stack, run->shape.depth, run->errors,
+           run->captures, over ? "  OVER LIMIT" : "");
+    bench->over_limit += over;
+    if (depth > UINT32_MAX / 10) {
+      break;
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  Bench bench = {1000000, 8, 65536, 0, 0};
+  const char *queries = TREE_SITTER_RED_QUERIES_DIR;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--max-depth") == 0 && i + 1 < argc) {
+      bench.max_depth = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--max-growth") == 0 && i + 1 < argc) {
+      bench.max_growth = strtod(argv[++i], NULL);
+    } else if (strcmp(argv[i], "--max-stack-growth") == 0 && i + 1 < argc) {
+      bench.max_stack_growth = (size_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--queries") == 0 && i + 1 < argc) {
+      queries = argv[++i];
+    } else {
+      return usage();
+    }
+  }
+  if (bench.max_depth == 0 || bench.max_growth <= 0) {
+    return usage();
+  }
+
+  ts_set_allocator(count_malloc, count_calloc, count_realloc, count_free);
+  Run run = {0};
+  run.parser = ts_parser_new();
+  run.cursor = ts_query_cursor_new();
+  if (!ts_parser_set_language(run.parser, tree_sitter_red())) {
+    fprintf(stderr, "tree-sitter-red-nestbench: incompatible runtime\n");
+    return 2;
+  }
+  size_t length = strlen(queries) + sizeof("/highlights.scm");
+  char *path = malloc(length);
+  if (path) {
+    snprintf(path, length, "%s/highlights.scm", queries);
+    run.highlights = tree_sitter_red_query_load(path);
+    free(path);
+  }
+  if (!run.highlights) {
+    fprintf(stderr, "tree-sitter-red-nestbench: no highlights query in %s, "
+                    "skipping queries\n",
+            queries);
+  }
+
+  for (size_t i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+    bench_shape(&bench, &run, &shapes[i]);
+  }
+  tree_sitter_red_query_delete(run.highlights);
+  ts_query_cursor_delete(run.cursor);
+  ts_parser_delete(run.parser);
+  return bench.over_limit || bench.failed ? 1 : 0;
+}